@@ -29,6 +29,7 @@
 #include <QStandardItem>
 #include <QStandardItemModel>
 #include <QItemDelegate>
+#include <QHash>
 
 // C++
 #include <cstring>
@@ -166,15 +167,26 @@ AdjacencyMatrixTabularReport::Entry::Entry(const SegmentationAdapterList segment
   std::memset(connectionsVertical, 0, sizeof(int)*m_verticalHeaders.size());
   std::memset(connectionsHorizontal, 0, sizeof(int)*m_horizontalHeaders.size());
 
+  QHash<SegmentationAdapterPtr, int> columns;
+  for(int j = 0; j < m_horizontalHeaders.size(); ++j)
+  {
+    columns.insert(m_horizontalHeaders.at(j), j);
+  }
+
+  // the connections of each segmentation are retrieved once instead of querying every pair.
   int tableValues[m_verticalHeaders.size()][m_horizontalHeaders.size()];
   for(int i = 0; i < m_verticalHeaders.size(); ++i)
   {
-    auto seg_i = model->smartPointer(m_verticalHeaders.at(i));
-    for(int j = 0; j < m_horizontalHeaders.size(); ++j)
+    std::memset(tableValues[i], 0, sizeof(int)*m_horizontalHeaders.size());
+
+    for(auto connection: model->connections(model->smartPointer(m_verticalHeaders.at(i))))
     {
-      tableValues[i][j] = model->connections(seg_i, model->smartPointer(m_horizontalHeaders.at(j))).size();
-      connectionsVertical[i] += tableValues[i][j];
-      connectionsHorizontal[j] += tableValues[i][j];
+      auto column = columns.value(connection.item2.get(), -1);
+      if(column == -1) continue;
+
+      ++tableValues[i][column];
+      ++connectionsVertical[i];
+      ++connectionsHorizontal[column];
     }
   }
 
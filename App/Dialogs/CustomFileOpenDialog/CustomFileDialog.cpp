@@ -23,6 +23,7 @@
 #include <Dialogs/CustomFileOpenDialog/CustomFileDialog.h>
 #include <Dialogs/CustomFileOpenDialog/OptionsPanel.h>
 #include <Core/Analysis/Filters/VolumetricStreamReader.h>
+#include <Core/IO/SegFile_V5.h>
 
 // Qt
 #include <QGridLayout>
@@ -102,7 +103,9 @@ const IO::LoadOptions CustomFileDialog::options() const
   LoadOptions options;
 
   options.insert(VolumetricStreamReader::STREAMING_OPTION, QVariant::fromValue(m_options->streamingValue()));
+  options.insert(VolumetricStreamReader::MULTIRESOLUTION_OPTION, QVariant::fromValue(m_options->multiResolutionValue()));
   options.insert(tr("Load Tool Settings"), QVariant::fromValue(m_options->toolSettingsValue()));
+  options.insert(SegFile::SegFile_V5::LAZY_LOADING_OPTION, QVariant::fromValue(m_options->lazyLoadingValue()));
   options.insert(tr("Check analysis"), QVariant::fromValue(m_options->checkAnalysisValue()));
 
   return options;
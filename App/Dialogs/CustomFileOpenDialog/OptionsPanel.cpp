@@ -34,6 +34,8 @@ OptionsPanel::OptionsPanel(QWidget* parent, Qt::WindowFlags flags)
   m_usePreviousSettings->setChecked(true);
   m_useStackStreaming->setChecked(false);
   m_toolSettings->setChecked(true);
+  m_lazyLoading->setChecked(true);
+  m_multiResolution->setChecked(true);
   m_checkAnalysis->setChecked(true);
 }
 
@@ -51,6 +53,18 @@ bool ESPINA::OptionsPanel::toolSettingsValue() const
   return m_toolSettings->isChecked();
 }
 
+//--------------------------------------------------------------------
+bool OptionsPanel::lazyLoadingValue() const
+{
+  return m_lazyLoading->isChecked();
+}
+
+//--------------------------------------------------------------------
+bool OptionsPanel::multiResolutionValue() const
+{
+  return m_multiResolution->isChecked();
+}
+
 //--------------------------------------------------------------------
 bool OptionsPanel::checkAnalysisValue() const
 {
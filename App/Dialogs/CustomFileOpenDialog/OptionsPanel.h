@@ -62,6 +62,16 @@ namespace ESPINA
        */
       bool toolSettingsValue() const;
 
+      /** \brief Returns true if the 'load segmentations data on demand' checkbox is checked and false otherwise.
+       *
+       */
+      bool lazyLoadingValue() const;
+
+      /** \brief Returns true if the 'use multi-resolution levels' checkbox is checked and false otherwise.
+       *
+       */
+      bool multiResolutionValue() const;
+
       /** \brief Returns true if the 'check analysis' checkbox is checked and false otherwise.
        *
        */
@@ -29,6 +29,7 @@
 #include <Core/Analysis/Data/Mesh/MarchingCubesMesh.h>
 #include <Core/Utils/EspinaException.h>
 #include <Core/Utils/Bounds.h>
+#include <Core/Utils/VolumeOverlapEngine.h>
 #include <Extensions/Issues/ItemIssues.h>
 #include <Extensions/Notes/SegmentationNotes.h>
 #include <GUI/Model/Utils/QueryAdapter.h>
@@ -844,49 +845,105 @@ CheckDuplicatedSegmentationsTask::CheckDuplicatedSegmentationsTask(Support::Cont
 //------------------------------------------------------------------------
 void CheckDuplicatedSegmentationsTask::run()
 {
-  for (int i = 0; i < m_segmentations.size(); ++i)
+  // only segmentations of the same category can be duplicated, so each category is compared on its own.
+  QMap<CategoryAdapterPtr, SegmentationAdapterList> categories;
+
+  for (auto segmentation: m_segmentations)
+  {
+    const auto seg = segmentation.get();
+    if(!seg) continue;
+
+    auto output = seg->output();
+    if(!output || !output->isValid() || !hasVolumetricData(output)) continue;
+
+    categories[seg->category().get()] << seg;
+  }
+
+  SegmentationAdapterList indexed;
+  SegmentationAdapterList incompatible;
+
+  for (auto category: categories)
   {
-    const auto seg_i = m_segmentations[i].get();
-    if(seg_i)
+    // the segmentations of the category are compared in a single sweep of the volumes instead of comparing each pair.
+    Core::Utils::VolumeOverlapEngine engine;
+
+    QVector<SegmentationAdapterPtr> engineSegmentations;
+
+    for (auto seg: category)
     {
-      auto output_i = seg_i->output();
-      if(!output_i || !output_i->isValid() || !hasVolumetricData(output_i)) continue;
+      if(!canExecute()) return;
+
+      if(engine.add(seg->output()) == -1)
+      {
+        incompatible << seg;
+      }
+      else
+      {
+        engineSegmentations << seg;
+        indexed             << seg;
+      }
+    }
+
+    if(engineSegmentations.size() < 2) continue;
+
+    const auto overlaps = engine.overlaps([this]() { return canExecute(); });
 
-      const auto bounds_i = readLockVolume(output_i)->bounds();
+    if(!canExecute()) return;
 
-      for (int j = i + 1; j < m_segmentations.size(); ++j)
+    for (auto overlap: overlaps)
+    {
+      if (overlap.voxels > 0)
       {
-        const auto seg_j = m_segmentations[j].get();
-        if(seg_j)
-        {
-          auto output_j = seg_j->output();
-          if(!output_j || !output_j->isValid() || !hasVolumetricData(output_j)) continue;
+        const auto seg_i = engineSegmentations.at(overlap.first);
+        const auto seg_j = engineSegmentations.at(overlap.second);
+
+        reportIssue(seg_i, possibleDuplication(seg_i, seg_j, overlap.voxels));
+        reportIssue(seg_j, possibleDuplication(seg_j, seg_i, overlap.voxels));
+      }
+    }
+  }
 
-          const auto bounds_j = readLockVolume(output_j)->bounds();
+  // segmentations with a different spacing are compared with the rest one by one.
+  for (int i = 0; i < incompatible.size(); ++i)
+  {
+    for (auto seg_j: indexed)
+    {
+      if(!canExecute()) return;
 
-          if(!canExecute()) return;
+      checkDuplicated(incompatible.at(i), seg_j);
+    }
 
-          if (seg_i->category() == seg_j->category())
-          {
-            if(intersect(bounds_i, bounds_j))
-            {
-              const auto commonBounds = intersection(bounds_i, bounds_j);
-
-              if(commonBounds.areValid())
-              {
-                const auto image1 = readLockVolume(seg_i->output())->itkImage(commonBounds);
-                const auto image2 = readLockVolume(seg_j->output())->itkImage(commonBounds);
-                auto duplicated   = compare_images<itkVolumeType>(image1, image2, commonBounds);
-
-                if(duplicated > 0)
-                {
-                  reportIssue(seg_i, possibleDuplication(seg_i, seg_j, duplicated));
-                  reportIssue(seg_j, possibleDuplication(seg_j, seg_i, duplicated));
-                }
-              }
-            }
-          }
-        }
+    for (int j = i + 1; j < incompatible.size(); ++j)
+    {
+      if(!canExecute()) return;
+
+      checkDuplicated(incompatible.at(i), incompatible.at(j));
+    }
+  }
+}
+
+//------------------------------------------------------------------------
+void CheckDuplicatedSegmentationsTask::checkDuplicated(SegmentationAdapterPtr seg_i, SegmentationAdapterPtr seg_j) const
+{
+  if (seg_i->category() != seg_j->category()) return;
+
+  const auto bounds_i = readLockVolume(seg_i->output())->bounds();
+  const auto bounds_j = readLockVolume(seg_j->output())->bounds();
+
+  if(intersect(bounds_i, bounds_j))
+  {
+    const auto commonBounds = intersection(bounds_i, bounds_j);
+
+    if(commonBounds.areValid())
+    {
+      const auto image1 = readLockVolume(seg_i->output())->itkImage(commonBounds);
+      const auto image2 = readLockVolume(seg_j->output())->itkImage(commonBounds);
+      auto duplicated   = compare_images<itkVolumeType>(image1, image2, commonBounds);
+
+      if(duplicated > 0)
+      {
+        reportIssue(seg_i, possibleDuplication(seg_i, seg_j, duplicated));
+        reportIssue(seg_j, possibleDuplication(seg_j, seg_i, duplicated));
       }
     }
   }
@@ -490,6 +490,13 @@ namespace ESPINA
     private:
       virtual void run() override final;
 
+      /** \brief Compares the voxels of the given segmentations and reports an issue if they are duplicated.
+       * \param[in] seg_i segmentation.
+       * \param[in] seg_j segmentation.
+       *
+       */
+      void checkDuplicated(SegmentationAdapterPtr seg_i, SegmentationAdapterPtr seg_j) const;
+
       /** \brief Returns an issue reporting the possible duplication of 'original' segmentation by 'duplicated' segmentation.
        * \param[in] original segmentation.
        * \param[in] duplicated segmentation.
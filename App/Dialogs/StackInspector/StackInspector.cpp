@@ -46,6 +46,7 @@
 #include <GUI/Widgets/HistogramBarsView.h>
 #include <GUI/Widgets/Styles.h>
 #include <Support/Representations/SliceManager.h>
+#include <Support/Representations/RepresentationUtils.h>
 #include "SLICRepresentation2D.h"
 
 #if USE_METADONA
@@ -547,6 +548,7 @@ void StackInspector::initSliceView()
   auto poolXY     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::CHANNEL, Plane::XY, pipelineXY, getScheduler(), 10);
 
   poolXY->setPipelineSources(&m_sources);
+  poolXY->setMemoryBudget(Support::Representations::Utils::slicesMemoryBudget());
 
   auto sliceManager = std::make_shared<SliceManager>(poolXY, RepresentationPoolSPtr(), RepresentationPoolSPtr());
 
@@ -27,6 +27,7 @@
 #include <App/Utils/UpdateCheck.h>
 
 // Qt
+#include <QStandardItemModel>
 #include <QToolButton>
 
 using namespace ESPINA;
@@ -49,6 +50,17 @@ GeneralSettingsPanel::GeneralSettingsPanel(AutoSave &autoSave, Support::GeneralS
   m_temporalPath      ->setText(QDir::toNativeSeparators(m_settings->temporalPath()));
   m_doCheck           ->setChecked(m_settings->performAnalysisCheckOnLoad());
   m_updateCombo       ->setCurrentIndex(static_cast<int>(m_settings->updateCheckPeriodicity()));
+  m_volumeCodec       ->setCurrentIndex(static_cast<int>(m_settings->volumeCodec()));
+  m_slicesMemoryBudget->setValue(static_cast<int>(m_settings->slicesMemoryBudget()));
+
+  auto codecs = qobject_cast<QStandardItemModel *>(m_volumeCodec->model());
+  if(codecs)
+  {
+    for(int i = 0; i < m_volumeCodec->count(); ++i)
+    {
+      codecs->item(i)->setEnabled(IO::VolumeCodec::isAvailable(static_cast<IO::VolumeCodec::Type>(i)));
+    }
+  }
 
   auto isSystemTemporalPath = (m_settings->temporalPath() == QDir::tempPath());
   m_systemPathCheckbox->setChecked(isSystemTemporalPath);
@@ -74,6 +86,8 @@ void GeneralSettingsPanel::acceptChanges()
   m_settings->setTemporalPath(m_temporalPath->text());
   m_settings->setPerformAnalysisCheckOnLoad(m_doCheck->isChecked());
   m_settings->setUpdateCheckPeriodicity(static_cast<Support::ApplicationSettings::UpdateCheckPeriodicity>(m_updateCombo->currentIndex()));
+  m_settings->setVolumeCodec(static_cast<IO::VolumeCodec::Type>(m_volumeCodec->currentIndex()));
+  m_settings->setSlicesMemoryBudget(static_cast<unsigned int>(m_slicesMemoryBudget->value()));
   m_autoSave.setPath(m_autosavePath->text());
   m_autoSave.setInterval(m_autosaveInterval->value());
   m_autoSave.setSaveInThread(m_autoSaveBackground->isChecked());
@@ -89,7 +103,9 @@ bool GeneralSettingsPanel::modified() const
       || (m_loadSEGSettings->isChecked()    != m_settings->loadSEGfileSettings())
       || (m_temporalPath->text()            != QDir::toNativeSeparators(m_settings->temporalPath()))
       || (m_doCheck->isChecked()            != m_settings->performAnalysisCheckOnLoad())
-      || (m_updateCombo->currentIndex()     != static_cast<int>(m_settings->updateCheckPeriodicity()));
+      || (m_updateCombo->currentIndex()     != static_cast<int>(m_settings->updateCheckPeriodicity()))
+      || (m_volumeCodec->currentIndex()     != static_cast<int>(m_settings->volumeCodec()))
+      || (m_slicesMemoryBudget->value()     != static_cast<int>(m_settings->slicesMemoryBudget()));
 }
 
 //------------------------------------------------------------------------
@@ -169,5 +185,6 @@ void GeneralSettingsPanel::showEvent(QShowEvent* e)
   m_pathLabel->setMinimumWidth(labelWidth);
   m_temporalPathLabel->setMinimumWidth(labelWidth);
   m_nameLabel->setMinimumWidth(labelWidth);
+  m_volumeCodecLabel->setMinimumWidth(labelWidth);
   m_pathLabel->resize(labelWidth, m_pathLabel->height());
 }
@@ -407,10 +407,14 @@ void DistanceComputationManagerThread::run()
   // wait until finished or cancelled
   while(!m_finished && canExecute())
   {
+    m_scheduler->beginBlockingWait();
+
     m_waitMutex.lock();
     if(!m_finished) m_waiter.wait(&m_waitMutex);
     m_waitMutex.unlock();
 
+    m_scheduler->endBlockingWait();
+
     if(progress() != currentProgress)
     {
       currentProgress = progress();
@@ -23,6 +23,7 @@
 #include "AutoSave.h"
 #include "RecentDocuments.h"
 #include <Core/IO/ProgressReporter.h>
+#include <Core/IO/SegFile_V5.h>
 #include <Core/Analysis/Filters/VolumetricStreamReader.h>
 #include <Core/Utils/AnalysisUtils.h>
 #include <Core/Utils/EspinaException.h>
@@ -119,6 +120,8 @@ void FileOpenTool::onTriggered()
       IO::LoadOptions options;
       options.insert(tr("Load Tool Settings"), QVariant::fromValue(true));
       options.insert(tr("Check analysis"), QVariant::fromValue(true));
+      options.insert(IO::SegFile::SegFile_V5::LAZY_LOADING_OPTION, QVariant::fromValue(true));
+      options.insert(VolumetricStreamReader::MULTIRESOLUTION_OPTION, QVariant::fromValue(true));
 
       load(fileNames, options);
     }
@@ -149,7 +149,7 @@ bool FileSaveTool::saveAnalysis(const QString &filename)
     {
       setIcon(saveIcon());
 
-      m_thread = std::make_shared<SaveThread>(getContext().scheduler(), m_analysis.get(), info, reporter, m_errorHandler);
+      m_thread = std::make_shared<SaveThread>(getContext().scheduler(), m_analysis.get(), info, reporter, m_errorHandler, SegFile::SaveMode::INCREMENTAL);
       m_thread->setHidden(false);
       m_thread->setDescription(tr("Session Auto-save"));
 
@@ -164,7 +164,9 @@ bool FileSaveTool::saveAnalysis(const QString &filename)
 
       try
       {
-        SegFile::save(m_analysis.get(), info, reporter.get(), m_errorHandler);
+        auto mode = isAutoSave ? SegFile::SaveMode::INCREMENTAL : SegFile::SaveMode::FULL;
+
+        SegFile::save(m_analysis.get(), info, reporter.get(), m_errorHandler, mode);
 
         successValue = true;
       }
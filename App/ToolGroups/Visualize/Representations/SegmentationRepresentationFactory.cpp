@@ -99,13 +99,21 @@ void SegmentationRepresentationFactory::createSliceRepresentation(Representation
   auto pipelineSliceXY = std::make_shared<SegmentationSlicePipeline>(Plane::XY, colorEngine);
   auto pipelineSliceXZ = std::make_shared<SegmentationSlicePipeline>(Plane::XZ, colorEngine);
   auto pipelineSliceYZ = std::make_shared<SegmentationSlicePipeline>(Plane::YZ, colorEngine);
+
+  for(auto pipeline: {pipelineSliceXY, pipelineSliceXZ, pipelineSliceYZ})
+  {
+    pipeline->setCompositing(true);
+  }
+
   auto poolSliceXY     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::SEGMENTATION, Plane::XY, pipelineSliceXY, scheduler, WINDOW_SIZE, locator);
   auto poolSliceXZ     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::SEGMENTATION, Plane::XZ, pipelineSliceXZ, scheduler, WINDOW_SIZE, locator);
   auto poolSliceYZ     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::SEGMENTATION, Plane::YZ, pipelineSliceYZ, scheduler, WINDOW_SIZE, locator);
 
-  poolSliceXY->setSettings(sliceSettings);
-  poolSliceXZ->setSettings(sliceSettings);
-  poolSliceYZ->setSettings(sliceSettings);
+  for(auto pool: {poolSliceXY, poolSliceXZ, poolSliceYZ})
+  {
+    pool->setSettings(sliceSettings);
+    pool->setMemoryBudget(slicesMemoryBudget());
+  }
 
   representation.Pools << poolSliceXY << poolSliceXZ << poolSliceYZ;
   representation.Settings << sliceSettings;
@@ -59,6 +59,11 @@ void StackRepresentationFactory::createSliceRepresentation(Representation &repre
   auto poolXZ     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::CHANNEL, Plane::XZ, pipelineXZ, scheduler, WINDOW_SIZE);
   auto poolYZ     = std::make_shared<BufferedRepresentationPool>(ItemAdapter::Type::CHANNEL, Plane::YZ, pipelineYZ, scheduler, WINDOW_SIZE);
 
+  for(auto pool: {poolXY, poolXZ, poolYZ})
+  {
+    pool->setMemoryBudget(slicesMemoryBudget());
+  }
+
   if (supportedViews.testFlag(ESPINA::VIEW_2D))
   {
     auto sliceManager   = std::make_shared<SliceManager>(poolXY, poolXZ, poolYZ);
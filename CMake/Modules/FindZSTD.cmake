@@ -0,0 +1,27 @@
+# - Try to find Zstandard
+# Once done this will define: 
+#  ZSTD_FOUND - System has Zstandard
+#  ZSTD_INCLUDE_DIRS - The Zstandard include directories
+#  ZSTD_LIBRARIES - The libraries needed to use Zstandard
+
+find_package(PkgConfig)
+pkg_check_modules(PC_ZSTD QUIET libzstd)
+
+set(ZSTD_DEFINITIONS ${PC_ZSTD_CFLAGS_OTHER})
+
+find_path(ZSTD_INCLUDE_DIR zstd.h
+          HINTS ${PC_ZSTD_INCLUDEDIR} ${PC_ZSTD_INCLUDE_DIRS})
+
+find_library(ZSTD_LIBRARY NAMES zstd libzstd
+             HINTS ${PC_ZSTD_LIBDIR} ${PC_ZSTD_LIBRARY_DIRS} )
+
+set(ZSTD_LIBRARIES ${ZSTD_LIBRARY} )
+set(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR} )
+
+include(FindPackageHandleStandardArgs)
+# handle the QUIETLY and REQUIRED arguments and set ZSTD_FOUND to TRUE
+# if all listed variables are TRUE
+find_package_handle_standard_args(ZSTD
+                                  REQUIRED_VARS ZSTD_LIBRARIES ZSTD_INCLUDE_DIR)
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY )
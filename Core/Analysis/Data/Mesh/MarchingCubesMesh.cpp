@@ -29,6 +29,17 @@
 
 #include "Core/Analysis/Data/VolumetricDataUtils.hxx"
 
+// VTK
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+
+// C++
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+
 using namespace ESPINA;
 
 //----------------------------------------------------------------------------
@@ -71,33 +82,189 @@ void MarchingCubesMesh::updateMesh()
 {
   if(!needsUpdate()) return;
 
+  QMutexLocker updateLock(&m_updateLock);
+
+  // other thread could have updated the mesh while waiting.
+  if(!needsUpdate()) return;
+
   vtkSmartPointer<vtkImageData> image = nullptr;
   TimeStamp volumeTime{VTK_UNSIGNED_LONG_LONG_MAX};
+  VolumeBounds volumeBounds;
+  BoundsList   editedRegions;
+  BlockIndexes modifiedBlocks;
+  itkVolumeType::RegionType volumeRegion;
 
   {
     auto volume = readLockVolume(m_output, DataUpdatePolicy::Ignore);
 
     if(!volume->isValid()) return;
 
-    image = vtkImage(volume, volume->bounds());
-    if(!image)
+    volumeTime    = volume->lastModified();
+    volumeBounds  = volume->bounds();
+    editedRegions = volume->editedRegions();
+    volumeRegion  = equivalentRegion<itkVolumeType>(volumeBounds);
+
+    if(canUpdateBlocks(volumeBounds, editedRegions))
     {
-      qWarning() << "MarchingCubesMesh::updateMesh() -> invalid image for marching cubes.";
-      return;
+      QMutexLocker lock(&m_lock);
+
+      for(int i = m_lastEditedRegions.size(); i < editedRegions.size(); ++i)
+      {
+        auto region = equivalentRegion<itkVolumeType>(volumeBounds.origin(), volumeBounds.spacing(), editedRegions.at(i));
+
+        addAffectedBlocks(region, volumeRegion, modifiedBlocks);
+      }
     }
+    else
+    {
+      m_blocks.clear();
+
+      addAffectedBlocks(volumeRegion, volumeRegion, modifiedBlocks);
+    }
+
+    if(!modifiedBlocks.isEmpty())
+    {
+      auto region = blocksRegion(modifiedBlocks, volumeRegion);
+
+      image = vtkImage(volume, equivalentBounds<itkVolumeType>(volumeBounds.origin(), volumeBounds.spacing(), region));
+      if(!image)
+      {
+        qWarning() << "MarchingCubesMesh::updateMesh() -> invalid image for marching cubes.";
+        return;
+      }
+    }
+  }
+
+  for(auto index: modifiedBlocks.keys())
+  {
+    auto block = blockMesh(image, index, volumeRegion);
+
+    if(block.mesh)
+    {
+      m_blocks.insert(index, block);
+    }
+    else
+    {
+      m_blocks.remove(index);
+    }
+  }
+
+  auto mesh = mergeBlocks();
+
+  {
+    QMutexLocker lock(&m_lock);
+
+    m_lastVolumeModification = volumeTime;
+    m_lastVolumeBounds       = volumeBounds;
+    m_lastEditedRegions      = editedRegions;
+  }
+
+  setMesh(mesh, false);
+}
+
+//----------------------------------------------------------------------------
+bool MarchingCubesMesh::canUpdateBlocks(const VolumeBounds &bounds, const BoundsList &regions) const
+{
+  QMutexLocker lock(&m_lock);
+
+  if(!m_lastVolumeBounds.areValid() || !RawMesh::mesh()) return false;
 
-    volumeTime = volume->lastModified();
+  // shrinking the volume removes voxels outside the edited regions, growing it only adds empty voxels.
+  if(!contains(bounds, m_lastVolumeBounds)) return false;
+
+  // volume modifications without new edited regions (i.e. replacing the volume) can change any voxel.
+  if(regions.size() <= m_lastEditedRegions.size()) return false;
+
+  for(int i = 0; i < m_lastEditedRegions.size(); ++i)
+  {
+    if(regions.at(i) != m_lastEditedRegions.at(i)) return false;
   }
 
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void MarchingCubesMesh::addAffectedBlocks(const itkVolumeType::RegionType &region, const itkVolumeType::RegionType &volumeRegion, BlockIndexes &indexes) const
+{
+  auto blockIndex = [](long long value)
+  {
+    return (value >= 0) ? value / BLOCK_SIZE : -((-value + BLOCK_SIZE - 1) / BLOCK_SIZE);
+  };
+
+  long long first[3], last[3];
+  for(auto i: {0, 1, 2})
+  {
+    // cubes use the voxels of their corners, the volume is padded with one empty voxel.
+    auto lower = std::max<long long>(region.GetIndex(i) - 1, volumeRegion.GetIndex(i) - 1);
+    auto upper = std::min<long long>(region.GetUpperIndex()[i], volumeRegion.GetUpperIndex()[i]);
+
+    if(upper < lower) return;
+
+    first[i] = blockIndex(lower);
+    last[i]  = blockIndex(upper);
+  }
+
+  for(auto z = first[2]; z <= last[2]; ++z)
+  {
+    for(auto y = first[1]; y <= last[1]; ++y)
+    {
+      for(auto x = first[0]; x <= last[0]; ++x)
+      {
+        indexes.insert(lliVector3{x, y, z}, true);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+itkVolumeType::RegionType MarchingCubesMesh::blocksRegion(const BlockIndexes &indexes, const itkVolumeType::RegionType &volumeRegion) const
+{
+  long long lower[3], upper[3];
+  for(auto i: {0, 1, 2})
+  {
+    lower[i] = std::numeric_limits<long long>::max();
+    upper[i] = std::numeric_limits<long long>::min();
+  }
+
+  for(auto index: indexes.keys())
+  {
+    for(auto i: {0, 1, 2})
+    {
+      // the cubes of the block use the voxels of the first corners of the next block.
+      lower[i] = std::min(lower[i], index[i] * BLOCK_SIZE);
+      upper[i] = std::max(upper[i], (index[i] + 1) * BLOCK_SIZE);
+    }
+  }
+
+  itkVolumeType::RegionType region;
+  for(auto i: {0, 1, 2})
+  {
+    lower[i] = std::max<long long>(lower[i], volumeRegion.GetIndex(i));
+    upper[i] = std::min<long long>(upper[i], volumeRegion.GetUpperIndex()[i]);
+
+    region.SetIndex(i, lower[i]);
+    region.SetSize(i, std::max<long long>(upper[i] - lower[i] + 1, 0));
+  }
+
+  return region;
+}
+
+//----------------------------------------------------------------------------
+MarchingCubesMesh::BlockMesh MarchingCubesMesh::blockMesh(vtkSmartPointer<vtkImageData> image, const lliVector3 &index, const itkVolumeType::RegionType &volumeRegion) const
+{
+  BlockMesh block;
+
+  if(!image) return block;
+
   int extent[6];
-  image->GetExtent(extent);
+  for(auto i: {0, 1, 2})
+  {
+    // the block has the cubes with its first corner inside the block.
+    extent[2*i]   = std::max<long long>(index[i] * BLOCK_SIZE, volumeRegion.GetIndex(i) - 1);
+    extent[2*i+1] = std::min<long long>((index[i] + 1) * BLOCK_SIZE, volumeRegion.GetUpperIndex()[i] + 1);
 
-  --extent[0];
-  ++extent[1];
-  --extent[2];
-  ++extent[3];
-  --extent[4];
-  ++extent[5];
+    if(extent[2*i+1] <= extent[2*i]) return block;
+  }
 
   // segmentation image need to be padded to avoid segmentation voxels from touching
   // the edges of the image (and create morphologically correct actors)
@@ -118,13 +285,122 @@ void MarchingCubesMesh::updateMesh()
   marchingCubes->SetInputData(padding->GetOutput());
   marchingCubes->UpdateWholeExtent();
 
+  auto mesh = marchingCubes->GetOutput();
+
+  if(mesh->GetNumberOfCells() == 0) return block;
+
+  // faces not clipped by the volume limits are shared with the adjacent blocks. Points are either on
+  // voxel centers or halfway between them, so a quarter voxel tolerance tells apart the points of the faces.
+  double origin[3], spacing[3];
+  image->GetOrigin(origin);
+  image->GetSpacing(spacing);
+
+  const auto points = mesh->GetPoints();
+  block.seams.resize(points->GetNumberOfPoints(), false);
+
+  for(auto i: {0, 1, 2})
   {
-    QMutexLocker lock(&m_lock);
+    const double tolerance = spacing[i] / 4;
+    const bool lowerShared = (extent[2*i]   == index[i] * BLOCK_SIZE);
+    const bool upperShared = (extent[2*i+1] == (index[i] + 1) * BLOCK_SIZE);
+    const double lower     = origin[i] + extent[2*i]   * spacing[i];
+    const double upper     = origin[i] + extent[2*i+1] * spacing[i];
 
-    m_lastVolumeModification = volumeTime;
+    for(vtkIdType id = 0; id < points->GetNumberOfPoints(); ++id)
+    {
+      const double value = points->GetPoint(id)[i];
+
+      if((lowerShared && std::abs(value - lower) < tolerance) || (upperShared && std::abs(value - upper) < tolerance))
+      {
+        block.seams[id] = true;
+      }
+    }
+  }
+
+  block.mesh = mesh;
+
+  return block;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> MarchingCubesMesh::mergeBlocks() const
+{
+  if(m_blocks.isEmpty()) return vtkSmartPointer<vtkPolyData>::New();
+
+  if(m_blocks.size() == 1) return m_blocks.first().mesh;
+
+  vtkIdType numPoints = 0;
+  vtkIdType numCells  = 0;
+  for(auto it = m_blocks.cbegin(); it != m_blocks.cend(); ++it)
+  {
+    numPoints += it.value().mesh->GetNumberOfPoints();
+    numCells  += it.value().mesh->GetNumberOfPolys();
+  }
+
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(m_blocks.first().mesh->GetPoints()->GetDataType());
+  points->Allocate(numPoints);
+
+  auto polys = vtkSmartPointer<vtkCellArray>::New();
+  polys->Allocate(polys->EstimateSize(numCells, 3));
+
+  // points on the faces shared by two blocks are generated by both, equal seam points are merged.
+  std::map<std::array<double, 3>, vtkIdType> seamIds;
+  std::vector<vtkIdType> ids;
+  std::vector<vtkIdType> cellIds;
+
+  for(auto it = m_blocks.cbegin(); it != m_blocks.cend(); ++it)
+  {
+    const auto &block      = it.value();
+    const auto blockPoints = block.mesh->GetPoints();
+
+    ids.resize(blockPoints->GetNumberOfPoints());
+
+    for(vtkIdType id = 0; id < blockPoints->GetNumberOfPoints(); ++id)
+    {
+      std::array<double, 3> point;
+      blockPoints->GetPoint(id, point.data());
+
+      if(block.seams[id])
+      {
+        auto seam = seamIds.find(point);
+        if(seam != seamIds.end())
+        {
+          ids[id] = seam->second;
+          continue;
+        }
+
+        ids[id] = points->InsertNextPoint(point.data());
+        seamIds.emplace(point, ids[id]);
+      }
+      else
+      {
+        ids[id] = points->InsertNextPoint(point.data());
+      }
+    }
+
+    auto cells = block.mesh->GetPolys();
+
+    vtkIdType  npts = 0;
+    vtkIdType *indx = nullptr;
+
+    for(cells->InitTraversal(); cells->GetNextCell(npts, indx); )
+    {
+      cellIds.resize(npts);
+      for(vtkIdType i = 0; i < npts; ++i)
+      {
+        cellIds[i] = ids[indx[i]];
+      }
+
+      polys->InsertNextCell(npts, cellIds.data());
+    }
   }
 
-  setMesh(marchingCubes->GetOutput(), false);
+  auto mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(polys);
+
+  return mesh;
 }
 
 //----------------------------------------------------------------------------
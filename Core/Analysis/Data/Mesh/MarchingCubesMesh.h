@@ -32,21 +32,39 @@
 
 // ESPINA
 #include "RawMesh.h"
+#include <Core/Utils/BlockHashMap.hxx>
 
 // VTK
 #include <vtkSmartPointer.h>
 #include <vtkImageConstantPad.h>
 #include <vtkDiscreteMarchingCubes.h>
+#include <vtkImageData.h>
+#include <vtkPolyData.h>
 
 // Qt
 #include <QMutex>
 
+// C++
+#include <vector>
+
 namespace ESPINA
 {
+  /** \class MarchingCubesMesh
+   * \brief Mesh generated from the volumetric data of its output.
+   *
+   * The surface is computed in blocks of BLOCK_SIZE^3 marching cubes. When the volume has been
+   * edited only the blocks affected by the new edited regions are recomputed and stitched with
+   * the rest, the whole surface is computed again otherwise. The points of each block on the faces
+   * shared with other blocks are found when the block is computed, so stitching the blocks only
+   * merges those points.
+   *
+   */
   class EspinaCore_EXPORT MarchingCubesMesh
   : public RawMesh
   {
     public:
+      static const long long BLOCK_SIZE = 32; /** size in voxels of the mesh blocks. */
+
       /** \brief MarchingCubesMesh class constructor.
        * \param[in] output to obtain the volumetric data from
        *
@@ -69,11 +87,61 @@ namespace ESPINA
       virtual VolumeBounds bounds() const override;
 
     private:
+      /** \struct BlockMesh
+       * \brief Surface of a block.
+       *
+       */
+      struct BlockMesh
+      {
+        vtkSmartPointer<vtkPolyData> mesh;  /** block surface.                                            */
+        std::vector<bool>            seams; /** true for the points on the faces shared with other blocks. */
+      };
+
+      using BlockIndexes = Core::Utils::BlockHashMap<bool>;
+      using BlockMeshes  = Core::Utils::BlockHashMap<BlockMesh>;
+
       /** \brief Applies marching cubes algorithm to the volumetric data of its output to generate a mesh.
        *
        */
       void updateMesh();
 
+      /** \brief Returns true if the current blocks can be updated using only the new edited regions
+       * of the volume.
+       * \param[in] bounds current volume bounds.
+       * \param[in] regions current volume edited regions.
+       *
+       */
+      bool canUpdateBlocks(const VolumeBounds &bounds, const BoundsList &regions) const;
+
+      /** \brief Adds the indexes of the blocks whose marching cubes use voxels of the given region.
+       * \param[in] region edited voxels region.
+       * \param[in] volumeRegion voxels region of the volume.
+       * \param[inout] indexes block indexes.
+       *
+       */
+      void addAffectedBlocks(const itkVolumeType::RegionType &region, const itkVolumeType::RegionType &volumeRegion, BlockIndexes &indexes) const;
+
+      /** \brief Returns the voxels region of the volume needed to compute the given blocks.
+       * \param[in] indexes block indexes.
+       * \param[in] volumeRegion voxels region of the volume.
+       *
+       */
+      itkVolumeType::RegionType blocksRegion(const BlockIndexes &indexes, const itkVolumeType::RegionType &volumeRegion) const;
+
+      /** \brief Returns the surface of the given block, with a nullptr mesh if it's empty.
+       * \param[in] image volume image containing the voxels of the block.
+       * \param[in] index block index.
+       * \param[in] volumeRegion voxels region of the volume.
+       *
+       */
+      BlockMesh blockMesh(vtkSmartPointer<vtkImageData> image, const lliVector3 &index, const itkVolumeType::RegionType &volumeRegion) const;
+
+      /** \brief Returns the surface resulting of merging the surfaces of the blocks. Only the seam points
+       * of the blocks are looked up to merge the duplicated ones, the rest are copied.
+       *
+       */
+      vtkSmartPointer<vtkPolyData> mergeBlocks() const;
+
       virtual QList<Data::Type> updateDependencies() const override;
 
       /** \brief Returns true if the mesh need to be updated.
@@ -82,9 +150,13 @@ namespace ESPINA
       const bool needsUpdate() const;
 
     private:
-      Output        *m_output;                 /** output this data belongs to.    */
-      TimeStamp      m_lastVolumeModification; /** last time the mesh was updated. */
-      mutable QMutex m_lock;                   /** protects internal data.         */
+      Output        *m_output;                 /** output this data belongs to.                     */
+      TimeStamp      m_lastVolumeModification; /** last time the mesh was updated.                  */
+      VolumeBounds   m_lastVolumeBounds;       /** volume bounds in the last update.                */
+      BoundsList     m_lastEditedRegions;      /** volume edited regions in the last update.        */
+      BlockMeshes    m_blocks;                 /** surfaces of the non empty blocks.                */
+      mutable QMutex m_lock;                   /** protects internal data.                          */
+      QMutex         m_updateLock;             /** serializes the updates of the mesh and blocks.   */
   };
 
 } // namespace ESPINA
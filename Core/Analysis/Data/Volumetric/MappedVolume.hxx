@@ -0,0 +1,385 @@
+/*
+ File: MappedVolume.hxx
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_ANALYSIS_DATA_VOLUMETRIC_MAPPEDVOLUME_HXX_
+#define CORE_ANALYSIS_DATA_VOLUMETRIC_MAPPEDVOLUME_HXX_
+
+// ESPINA
+#include <Core/Analysis/Data/Volumetric/StreamedVolume.hxx>
+
+// ITK
+#include <itkImportImageContainer.h>
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSysInfo>
+
+// C++
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace ESPINA
+{
+  namespace Core
+  {
+    /** \class MappedImageContainer
+     * \brief Pixel container of an image whose pixels are stored in memory owned by other object,
+     * that is kept alive while the container exists.
+     *
+     */
+    template<typename TElement>
+    class MappedImageContainer
+    : public itk::ImportImageContainer<itk::SizeValueType, TElement>
+    {
+      public:
+        using Self         = MappedImageContainer;
+        using Superclass   = itk::ImportImageContainer<itk::SizeValueType, TElement>;
+        using Pointer      = itk::SmartPointer<Self>;
+        using ConstPointer = itk::SmartPointer<const Self>;
+
+        itkNewMacro(Self);
+
+        itkTypeMacro(MappedImageContainer, ImportImageContainer);
+
+        /** \brief Sets the container pixels.
+         * \param[in] buffer pointer to the first element.
+         * \param[in] size number of elements.
+         * \param[in] owner owner of the buffer memory.
+         *
+         */
+        void setBuffer(TElement *buffer, const itk::SizeValueType size, std::shared_ptr<void> owner)
+        {
+          this->SetImportPointer(buffer, size, false);
+          m_owner = owner;
+        }
+
+      protected:
+        /** \brief MappedImageContainer class protected constructor.
+         *
+         */
+        MappedImageContainer()
+        {}
+
+        /** \brief MappedImageContainer class protected destructor.
+         *
+         */
+        virtual ~MappedImageContainer()
+        {}
+
+      private:
+        std::shared_ptr<void> m_owner; /** owner of the buffer memory. */
+    };
+
+    /** \class MappedVolume
+     * \brief Read-only streamed volume of an uncompressed MetaImage file whose data is mapped in
+     * memory.
+     *
+     * Regions that are contiguous in the file (complete slices or groups of slices) are returned as
+     * images whose buffer is the mapped file, without any copy. The rest of the regions are copied
+     * row by row from the mapped file. The file is mapped copy-on-write, so modifying the returned
+     * images never modifies the file, but the modification is visible to all the views of the same
+     * region and must be avoided, as with the images returned by other volumes.
+     *
+     * Files that can't be mapped (compressed data, different byte order, multiple data files...)
+     * are read like any other streamed volume.
+     *
+     */
+    template<typename T>
+    class MappedVolume
+    : public StreamedVolume<T>
+    {
+      public:
+        /** \brief MappedVolume class constructor.
+         * \param[in] fileName name of the MetaImage header file.
+         *
+         */
+        explicit MappedVolume(const QFileInfo &fileName);
+
+        /** \brief MappedVolume class virtual destructor.
+         *
+         */
+        virtual ~MappedVolume()
+        {};
+
+        /** \brief Returns true if the image data is mapped in memory and false if the volume is
+         * read using the streamed volume tile cache.
+         *
+         */
+        bool isMapped() const
+        { return m_mapping != nullptr; }
+
+        virtual const typename T::Pointer read(const typename T::RegionType &region) const override;
+
+      private:
+        /** \struct Mapping
+         * \brief Mapped data file.
+         *
+         */
+        struct Mapping
+        {
+          QFile  file; /** mapped file.                  */
+          uchar *data; /** mapped data, nullptr on error. */
+
+          ~Mapping()
+          { if(data) file.unmap(data); }
+        };
+
+        /** \brief Maps the data file of the given header if it's uncompressed and has the pixel
+         * type and dimension of the volume. Returns nullptr otherwise.
+         * \param[in] header MetaImage header file.
+         *
+         */
+        std::shared_ptr<Mapping> map(const QFileInfo &header);
+
+        /** \brief Returns true if the given MetaImage element type is equivalent to the internal
+         * pixel type of the volume.
+         * \param[in] elementType MetaImage element type.
+         *
+         */
+        static bool isInternalPixelType(const QString &elementType);
+
+        using InternalPixelType = typename T::InternalPixelType;
+
+        std::shared_ptr<Mapping> m_mapping; /** mapped data file or nullptr if not mapped. */
+        InternalPixelType       *m_data;    /** first pixel of the image in the mapped data. */
+    };
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    MappedVolume<T>::MappedVolume(const QFileInfo &fileName)
+    : StreamedVolume<T>(fileName)
+    , m_mapping        {nullptr}
+    , m_data           {nullptr}
+    {
+      if(fileName.suffix().compare("mhd", Qt::CaseInsensitive) == 0 || fileName.suffix().compare("mha", Qt::CaseInsensitive) == 0)
+      {
+        m_mapping = map(fileName);
+      }
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    std::shared_ptr<typename MappedVolume<T>::Mapping> MappedVolume<T>::map(const QFileInfo &header)
+    {
+      QFile headerFile{header.absoluteFilePath()};
+      if(!headerFile.open(QIODevice::ReadOnly)) return nullptr;
+
+      // the element data file is always the last field of the header.
+      QMap<QString, QString> fields;
+      qint64 localOffset = 0;
+      while(!headerFile.atEnd() && !fields.contains("ElementDataFile"))
+      {
+        auto line = QString::fromLatin1(headerFile.readLine()).trimmed();
+        if(line.isEmpty()) continue;
+
+        auto parts = line.split('=');
+        if(parts.size() != 2) return nullptr;
+
+        fields.insert(parts.first().trimmed(), parts.last().trimmed());
+        localOffset = headerFile.pos();
+      }
+      headerFile.close();
+
+      const auto dimension  = T::GetImageDimension();
+      const auto isTrue     = [](const QString &value) { return value.compare("True", Qt::CaseInsensitive) == 0 || value == "1"; };
+      const bool bigEndian  = (QSysInfo::ByteOrder == QSysInfo::BigEndian);
+      const auto dataFile   = fields.value("ElementDataFile");
+      const auto byteOrder  = fields.value("BinaryDataByteOrderMSB", fields.value("ByteOrderMSB", fields.value("ElementByteOrderMSB")));
+      const auto channels   = fields.value("ElementNumberOfChannels", "1").toUInt();
+
+      if(dataFile.isEmpty() || dataFile.startsWith("LIST", Qt::CaseInsensitive) || dataFile.contains('%')) return nullptr;
+      if(isTrue(fields.value("CompressedData"))) return nullptr;
+      if(!byteOrder.isEmpty() && isTrue(byteOrder) != bigEndian) return nullptr;
+      if(fields.value("NDims").toUInt() != dimension) return nullptr;
+      if(channels != this->m_vectorLength || !isInternalPixelType(fields.value("ElementType"))) return nullptr;
+
+      const auto dataSize = static_cast<qint64>(this->m_region.GetNumberOfPixels() * this->m_vectorLength * sizeof(InternalPixelType));
+
+      auto mapping = std::make_shared<Mapping>();
+      mapping->data = nullptr;
+
+      qint64 offset = 0;
+      if(dataFile.compare("LOCAL", Qt::CaseInsensitive) == 0)
+      {
+        mapping->file.setFileName(header.absoluteFilePath());
+        offset = localOffset;
+      }
+      else
+      {
+        mapping->file.setFileName(QDir{header.absolutePath()}.absoluteFilePath(dataFile));
+      }
+
+      if(!mapping->file.open(QIODevice::ReadOnly)) return nullptr;
+
+      const auto headerSize = fields.value("HeaderSize", "0").toLongLong();
+      if(headerSize == -1)
+      {
+        // data is at the end of the file.
+        offset = mapping->file.size() - dataSize;
+      }
+      else
+      {
+        offset += headerSize;
+      }
+
+      if(offset < 0 || mapping->file.size() < offset + dataSize) return nullptr;
+
+      mapping->data = mapping->file.map(0, offset + dataSize, QFileDevice::MapPrivateOption);
+      if(!mapping->data) return nullptr;
+
+      m_data = reinterpret_cast<InternalPixelType *>(mapping->data + offset);
+
+      return mapping;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    bool MappedVolume<T>::isInternalPixelType(const QString &elementType)
+    {
+      using Limits = std::numeric_limits<InternalPixelType>;
+
+      const auto size     = sizeof(InternalPixelType);
+      const auto isSigned = Limits::is_signed;
+
+      if(!Limits::is_integer)
+      {
+        return (elementType == "MET_FLOAT" && size == sizeof(float)) || (elementType == "MET_DOUBLE" && size == sizeof(double));
+      }
+
+      if(elementType == "MET_UCHAR")      return size == 1 && !isSigned;
+      if(elementType == "MET_CHAR")       return size == 1 && isSigned;
+      if(elementType == "MET_USHORT")     return size == 2 && !isSigned;
+      if(elementType == "MET_SHORT")      return size == 2 && isSigned;
+      if(elementType == "MET_UINT")       return size == 4 && !isSigned;
+      if(elementType == "MET_INT")        return size == 4 && isSigned;
+      if(elementType == "MET_ULONG_LONG") return size == 8 && !isSigned;
+      if(elementType == "MET_LONG_LONG")  return size == 8 && isSigned;
+
+      return false;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    const typename T::Pointer MappedVolume<T>::read(const typename T::RegionType &region) const
+    {
+      if(!isMapped()) return StreamedVolume<T>::read(region);
+
+      QReadLocker lock(&this->m_lock);
+
+      if (!this->isValid())
+      {
+        auto message = QObject::tr("Uninitialized MappedVolume. File: %1").arg(this->m_fileName.absoluteFilePath());
+        auto details = QObject::tr("MappedVolume::read(region) -> ") + message;
+
+        throw Core::Utils::EspinaException(message, details);
+      }
+
+      if(!this->m_region.IsInside(region))
+      {
+        auto message = QObject::tr("Requested region is totally/partially outside the image region. File: %1").arg(this->m_fileName.absoluteFilePath());
+        auto details = QObject::tr("MappedVolume::read(region) -> ") + message;
+
+        throw Core::Utils::EspinaException(message, details);
+      }
+
+      const auto dimension  = T::GetImageDimension();
+      const auto size       = this->m_region.GetSize();
+      // pixels of itk::VectorImage are stored as consecutive components in the buffer.
+      const auto components = std::is_same<typename T::PixelType, InternalPixelType>::value ? 1 : this->m_vectorLength;
+
+      // region on disk and position of its first pixel in the mapped data.
+      auto diskIndex = region.GetIndex();
+      itk::SizeValueType offset = 0, stride = 1;
+      for(unsigned int i = 0; i < dimension; ++i)
+      {
+        diskIndex[i] -= this->m_region.GetIndex(i);
+
+        offset += diskIndex[i] * stride;
+        stride *= size[i];
+      }
+
+      // regions are contiguous in the file if only the first incomplete dimension and the following
+      // ones can have sizes different from the image size, and these have size 1.
+      bool contiguous = true;
+      bool complete   = true;
+      for(unsigned int i = 0; i < dimension && contiguous; ++i)
+      {
+        contiguous = complete || region.GetSize(i) == 1;
+        complete  &= (region.GetSize(i) == size[i]);
+      }
+
+      typename T::Pointer image = T::New();
+      image->SetNumberOfComponentsPerPixel(this->m_vectorLength);
+      image->SetRegions(region);
+      image->SetSpacing(this->m_spacing);
+
+      auto origin = image->GetOrigin();
+      for(unsigned int i = 0; i < dimension; ++i)
+      {
+        origin.SetElement(i,0);
+      }
+      image->SetOrigin(origin);
+
+      if(contiguous)
+      {
+        auto container = MappedImageContainer<InternalPixelType>::New();
+        container->setBuffer(m_data + offset * components, region.GetNumberOfPixels() * components, m_mapping);
+
+        image->SetPixelContainer(container);
+
+        return image;
+      }
+
+      image->Allocate();
+
+      const auto rowBytes = region.GetSize(0) * components * sizeof(InternalPixelType);
+
+      // iterate over the first voxel of each row of the region.
+      auto rows = region;
+      rows.SetSize(0, 1);
+
+      itk::ImageRegionConstIteratorWithIndex<T> it(image, rows);
+      while(!it.IsAtEnd())
+      {
+        auto index = it.GetIndex();
+
+        itk::SizeValueType position = 0;
+        stride = 1;
+        for(unsigned int i = 0; i < dimension; ++i)
+        {
+          position += (index[i] - this->m_region.GetIndex(i)) * stride;
+          stride   *= size[i];
+        }
+
+        std::memcpy(image->GetBufferPointer() + image->ComputeOffset(index) * components, m_data + position * components, rowBytes);
+
+        ++it;
+      }
+
+      return image;
+    }
+
+  } // namespace Core
+} // namespace ESPINA
+
+#endif // CORE_ANALYSIS_DATA_VOLUMETRIC_MAPPEDVOLUME_HXX_
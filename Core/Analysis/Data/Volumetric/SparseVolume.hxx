@@ -34,7 +34,10 @@
 // ESPINA
 #include <Core/Analysis/Data/VolumetricData.hxx>
 #include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Analysis/Data/Volumetric/SparseVolumeBlock.hxx>
+#include <Core/Analysis/Data/Volumetric/SparseVolumeBlockPool.hxx>
 #include <Core/Utils/BinaryMask.hxx>
+#include <Core/Utils/BlockHashMap.hxx>
 #include <Core/Utils/EspinaException.h>
 #include <Core/Utils/SpatialUtils.hxx>
 #include <Core/Utils/TemporalStorage.h>
@@ -48,7 +51,6 @@
 #include <vtkImplicitFunction.h>
 
 // Qt
-#include <QMap>
 #include <QReadWriteLock>
 
 namespace ESPINA
@@ -57,7 +59,8 @@ namespace ESPINA
    *  edition operations
    *
    *  Voxels which don't belong to any block are assigned the value
-   *  defined as background value.
+   *  defined as background value. Blocks are compressed after each
+   *  edition (see SparseVolumeBlock) and decompressed only to be edited.
    *
    */
   template<typename T>
@@ -87,8 +90,7 @@ namespace ESPINA
       /** \brief SparseVolume class virtual destructor.
        *
        */
-      virtual ~SparseVolume()
-      {}
+      virtual ~SparseVolume();
 
       /** \brief Returns the memory usage in bytes of the volume.
        *
@@ -168,11 +170,44 @@ namespace ESPINA
        */
       Bounds editRegion(const ESPINA::VolumeBounds &bounds);
 
-      /** \brief Creates a block for the given index
+      /** \brief Returns the region of the block of the given index.
        * \param[in] index block index.
        *
        */
-      void createBlock(const lliVector3 &index);
+      typename T::RegionType blockRegion(const lliVector3 &index) const;
+
+      /** \brief Creates a block for the given index and returns its image.
+       * \param[in] index block index.
+       *
+       */
+      typename T::Pointer createBlock(const lliVector3 &index);
+
+      /** \brief Returns the image of the block of the given index, decompressing the block if
+       * necessary, or nullptr if there is no block for that index.
+       * \param[in] index block index.
+       *
+       */
+      typename T::Pointer editableBlock(const lliVector3 &index);
+
+      /** \brief Compresses the block of the given index after being edited, removing it if all
+       * its voxels are background. The caller must not keep references to the block image.
+       * \param[in] index block index.
+       *
+       */
+      void compactBlock(const lliVector3 &index);
+
+      /** \brief Removes the block of the given index and returns its image to the blocks pool.
+       * \param[in] index block index.
+       *
+       */
+      void releaseBlock(const lliVector3 &index);
+
+      /** \brief Returns true if all the voxels of the block of the given index have the given value.
+       * \param[in] index block index.
+       * \param[in] value voxel value.
+       *
+       */
+      bool isUniform(const lliVector3 &index, const typename T::ValueType value) const;
 
       /** \brief Returns true if the block associated with the given index is empty.
        * \param[in] index block index.
@@ -180,13 +215,20 @@ namespace ESPINA
        */
       bool isEmpty(const lliVector3 &index) const;
 
-      /** \brief Returns an iterator to iterate all pixels of block containted in bounds
-       * \param[in] block index
-       * \param[in] bounds to iterate its voxels
+      /** \brief Returns the intersection of the given bounds and the bounds of the block.
+       * \param[in] block block image.
+       * \param[in] bounds bounds to intersect.
        *
        */
       Bounds blockIntersection(typename T::Pointer block, const Bounds &bounds) const;
 
+      /** \brief Returns the intersection of the given bounds and the bounds of the block.
+       * \param[in] index block index.
+       * \param[in] bounds bounds to intersect.
+       *
+       */
+      Bounds blockIntersection(const lliVector3 &index, const Bounds &bounds) const;
+
       /** \brief Helper method to assist fetching data from disk.
        *
        */
@@ -225,7 +267,7 @@ namespace ESPINA
 
     protected:
       const unsigned int s_blockSize = 25;
-      QMap<lliVector3, typename T::Pointer> m_blocks;
+      Core::Utils::BlockHashMap<SparseVolumeBlock<T>> m_blocks; /** blocks of the volume indexed by block coordinates. */
 
       mutable QReadWriteLock m_blockMutex;
   };
@@ -255,11 +297,33 @@ namespace ESPINA
     this->clearEditedRegions();
   }
 
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  SparseVolume<T>::~SparseVolume()
+  {
+    auto &pool = SparseVolumeBlockPool<T>::instance();
+
+    for(auto &block: m_blocks)
+    {
+      auto image = block.image();
+      block = SparseVolumeBlock<T>();
+
+      pool.release(image);
+    }
+  }
+
   //-----------------------------------------------------------------------------
   template<typename T>
   size_t SparseVolume<T>::memoryUsage() const
   {
-    return std::pow(s_blockSize, 3) * m_blocks.size();
+    size_t usage = 0;
+
+    for(auto it = m_blocks.cbegin(); it != m_blocks.cend(); ++it)
+    {
+      usage += it.value().memoryUsage();
+    }
+
+    return usage;
   }
 
   //-----------------------------------------------------------------------------
@@ -284,7 +348,11 @@ namespace ESPINA
 
       for(auto &block : m_blocks)
       {
-        changeSpacing<T>(block, itkSpacing, spacingRatio);
+        // encoded blocks have no geometry, it's computed from the volume one.
+        if(block.image())
+        {
+          changeSpacing<T>(block.image(), itkSpacing, spacingRatio);
+        }
       }
 
       BoundsList regions;
@@ -343,12 +411,13 @@ namespace ESPINA
 
     for(auto index: affectedIndexes)
     {
-      if(!m_blocks.contains(index)) continue;
+      auto it = m_blocks.find(index);
+      if(it == m_blocks.cend()) continue;
 
-      auto block        = m_blocks[index];
-      auto commonBounds = blockIntersection(block, expectedBounds);
+      auto commonBounds = blockIntersection(index, expectedBounds);
+      if(!commonBounds.areValid()) continue;
 
-      copy_image<itkVolumeType>(block, image, commonBounds);
+      it.value().copyTo(image, commonBounds);
     }
 
     m_blockMutex.unlock();
@@ -372,17 +441,20 @@ namespace ESPINA
 
     for(auto index: affectedIndexes)
     {
-      if(!m_blocks.contains(index))
+      // nothing changes if the block already has only the drawn value.
+      if(isUniform(index, value)) continue;
+
+      auto block = editableBlock(index);
+      if(!block)
       {
         if(value == this->backgroundValue())
         {
           continue;
         }
 
-        createBlock(index);
+        block = createBlock(index);
       }
 
-      auto block       = m_blocks[index];
       auto blockBounds = blockIntersection(block, editedBounds);
 
       auto bit = itkImageIteratorWithIndex<T>(block, blockBounds);
@@ -401,11 +473,8 @@ namespace ESPINA
         ++bit;
       }
 
-      if(value == this->backgroundValue() && isEmpty(index))
-      {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
-      }
+      block = nullptr;
+      compactBlock(index);
     }
   }
 
@@ -424,17 +493,20 @@ namespace ESPINA
 
     for(auto index: affectedIndexes)
     {
-      if(!m_blocks.contains(index))
+      // nothing changes if the block already has only the drawn value.
+      if(isUniform(index, value)) continue;
+
+      auto block = editableBlock(index);
+      if(!block)
       {
         if(value == this->backgroundValue())
         {
           continue;
         }
 
-        createBlock(index);
+        block = createBlock(index);
       }
 
-      auto block       = m_blocks[index];
       auto blockBounds = blockIntersection(block, editedBounds);
 
       auto bit = itkImageIterator<T>(block, blockBounds);
@@ -452,11 +524,8 @@ namespace ESPINA
         ++bit;
       }
 
-      if(value == this->backgroundValue() && isEmpty(index))
-      {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
-      }
+      block = nullptr;
+      compactBlock(index);
     }
 
     this->updateModificationTime();
@@ -478,21 +547,18 @@ namespace ESPINA
 
     for(auto index: affectedIndexes)
     {
-      if(!m_blocks.contains(index))
+      auto block = editableBlock(index);
+      if(!block)
       {
-        createBlock(index);
+        block = createBlock(index);
       }
 
-      auto block        = m_blocks[index];
       auto commonBounds = blockIntersection(block, editedBounds);
 
       copy_image<itkVolumeType>(image, block, commonBounds);
 
-      if(isEmpty(index))
-      {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
-      }
+      block = nullptr;
+      compactBlock(index);
     }
 
     this->updateModificationTime();
@@ -513,21 +579,18 @@ namespace ESPINA
 
     for(auto index: affectedIndexes)
     {
-      if(!m_blocks.contains(index))
+      auto block = editableBlock(index);
+      if(!block)
       {
-        createBlock(index);
+        block = createBlock(index);
       }
 
-      auto block        = m_blocks[index];
       auto commonBounds = blockIntersection(block, editedBounds);
 
       copy_image<itkVolumeType>(image, block, commonBounds);
 
-      if(isEmpty(index))
-      {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
-      }
+      block = nullptr;
+      compactBlock(index);
     }
 
     this->updateModificationTime();
@@ -562,17 +625,20 @@ namespace ESPINA
 
     for (auto index : affectedIndexes)
     {
-      if (!m_blocks.contains(index))
+      // nothing changes if the block already has only the drawn value.
+      if (isUniform(index, value)) continue;
+
+      auto block = editableBlock(index);
+      if (!block)
       {
         if(value == this->backgroundValue())
         {
           continue;
         }
 
-        createBlock(index);
+        block = createBlock(index);
       }
 
-      auto block       = m_blocks[index];
       auto blockBounds = blockIntersection(block, editedBounds);
 
       auto bit = itkImageIterator<T>(block, blockBounds);
@@ -584,11 +650,8 @@ namespace ESPINA
         ++bit;
       }
 
-      if (value == this->backgroundValue() && isEmpty(index))
-      {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
-      }
+      block = nullptr;
+      compactBlock(index);
     }
 
     this->updateModificationTime();
@@ -611,19 +674,19 @@ namespace ESPINA
     {
       if(!affectedIndexes.contains(index))
       {
-        m_blocks[index] = nullptr;
-        m_blocks.remove(index);
+        releaseBlock(index);
       }
       else
       {
-         auto block = m_blocks[index];
-         auto blockRegion = block->GetLargestPossibleRegion();
-         auto blockBounds = equivalentBounds<T>(block, blockRegion);
+         auto blockRegion = this->blockRegion(index);
+         auto blockBounds = equivalentBounds<T>(origin, spacing, blockRegion);
          auto blockIntersection = intersection(bounds, blockBounds);
 
          // if the block is completely inside the new bounds there is no need to delete anything
          if(blockIntersection == blockBounds) continue;
 
+         auto block = editableBlock(index);
+
          // clear voxels outside the new bounds
          auto validRegion = equivalentRegion<T>(block, blockIntersection);
          Q_ASSERT(blockRegion.IsInside(validRegion));
@@ -635,6 +698,9 @@ namespace ESPINA
            iit.Set(SEG_BG_VALUE);
            ++iit;
          }
+
+         block = nullptr;
+         compactBlock(index);
       }
     }
 
@@ -720,7 +786,10 @@ namespace ESPINA
         && (index[1] % s_blockSize == 0)
         && (index[2] % s_blockSize == 0))
       {
-        m_blocks[key] = image;
+        m_blocks[key] = SparseVolumeBlock<T>(image);
+        image = nullptr;
+
+        compactBlock(key);
       }
       else
       {
@@ -748,7 +817,6 @@ namespace ESPINA
       auto spacing = bounds.spacing();
       for(auto index: this->m_blocks.keys())
       {
-        auto region = m_blocks[index]->GetLargestPossibleRegion();
         Bounds bBounds{index[0] * spacing[0] - spacing[0]/2, (index[0] + s_blockSize) * spacing[0]  - spacing[0]/2,
                        index[1] * spacing[1] - spacing[1]/2, (index[1] + s_blockSize) * spacing[1]  - spacing[1]/2,
                        index[2] * spacing[2] - spacing[2]/2, (index[2] + s_blockSize) * spacing[2]  - spacing[2]/2};
@@ -777,18 +845,35 @@ namespace ESPINA
   {
     Snapshot snapshot;
 
+    auto &pool   = SparseVolumeBlockPool<T>::instance();
+    auto origin  = this->m_bounds.origin();
+    auto spacing = this->m_bounds.spacing();
+
     int i = 0;
     for(auto it = m_blocks.cbegin(); it != m_blocks.cend(); ++it, ++i)
     {
       auto filename = multiBlockPath(id, i);
 
+      // encoded blocks are decoded into a temporary image.
+      auto image = it.value().image();
+      if(!image)
+      {
+        image = pool.acquire(origin, spacing, blockRegion(it.key()), this->backgroundValue());
+        it.value().copyTo(image, equivalentBounds<T>(image));
+      }
+
       if(std::is_same<T, itkVolumeType>::value)
       {
-        snapshot << blockSnapshotMemory(it.value(), storage, path, filename);
+        snapshot << blockSnapshotMemory(image, storage, path, filename);
       }
       else
       {
-        snapshot << createVolumeSnapshot<T>(it.value(), storage, path, filename);
+        snapshot << createVolumeSnapshot<T>(image, storage, path, filename);
+      }
+
+      if(!it.value().image())
+      {
+        pool.release(image);
       }
     }
 
@@ -1001,7 +1086,7 @@ namespace ESPINA
 
   //-----------------------------------------------------------------------------
   template<typename T>
-  void SparseVolume<T>::createBlock(const lliVector3 &index)
+  typename T::RegionType SparseVolume<T>::blockRegion(const lliVector3 &index) const
   {
     itk::ImageRegion<3> region;
     region.SetIndex(0, index[0] * this->s_blockSize);
@@ -1011,35 +1096,84 @@ namespace ESPINA
     region.SetSize(1, this->s_blockSize);
     region.SetSize(2, this->s_blockSize);
 
+    return region;
+  }
+
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  typename T::Pointer SparseVolume<T>::createBlock(const lliVector3 &index)
+  {
     auto origin  = this->m_bounds.origin();
     auto spacing = this->m_bounds.spacing();
 
-    auto bounds = equivalentBounds<T>(origin, spacing, region);
-    bounds.setLowerInclusion(true);
-    bounds.setUpperInclusion(false);
+    auto block = SparseVolumeBlockPool<T>::instance().acquire(origin, spacing, blockRegion(index), this->backgroundValue());
 
-    m_blocks[index] = create_itkImage<T>(bounds, this->backgroundValue(), spacing, origin);
+    m_blocks[index] = SparseVolumeBlock<T>(block);
+
+    return block;
   }
 
   //-----------------------------------------------------------------------------
   template<typename T>
-  bool SparseVolume<T>::isEmpty(const lliVector3 &index) const
+  typename T::Pointer SparseVolume<T>::editableBlock(const lliVector3 &index)
   {
-    auto block  = m_blocks[index];
-    auto region = block->GetLargestPossibleRegion();
-    auto it     = itk::ImageRegionConstIterator<T>(block, region);
+    auto it = m_blocks.find(index);
+    if(it == m_blocks.end()) return nullptr;
 
-    it.GoToBegin();
-    while(!it.IsAtEnd())
+    auto &block = it.value();
+    if(block.encoding() != SparseVolumeBlock<T>::Encoding::DENSE)
     {
-      if(it.Value() != SEG_BG_VALUE)
-      {
-        return false;
-      }
-      ++it;
+      auto origin  = this->m_bounds.origin();
+      auto spacing = this->m_bounds.spacing();
+
+      block.decompress(SparseVolumeBlockPool<T>::instance().acquire(origin, spacing, blockRegion(index), this->backgroundValue()));
     }
 
-    return true;
+    return block.image();
+  }
+
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  void SparseVolume<T>::compactBlock(const lliVector3 &index)
+  {
+    auto it = m_blocks.find(index);
+    if(it == m_blocks.end()) return;
+
+    auto image = it.value().compress(blockRegion(index));
+
+    if(it.value().isUniform(SEG_BG_VALUE))
+    {
+      m_blocks.remove(index);
+    }
+
+    SparseVolumeBlockPool<T>::instance().release(image);
+  }
+
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  void SparseVolume<T>::releaseBlock(const lliVector3 &index)
+  {
+    auto image = m_blocks.take(index).image();
+
+    SparseVolumeBlockPool<T>::instance().release(image);
+  }
+
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  bool SparseVolume<T>::isUniform(const lliVector3 &index, const typename T::ValueType value) const
+  {
+    auto it = m_blocks.find(index);
+
+    return it != m_blocks.cend() && it.value().isUniform(value);
+  }
+
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  bool SparseVolume<T>::isEmpty(const lliVector3 &index) const
+  {
+    auto it = m_blocks.find(index);
+
+    return it == m_blocks.cend() || it.value().hasOnly(SEG_BG_VALUE);
   }
 
   //-----------------------------------------------------------------------------
@@ -1050,6 +1184,17 @@ namespace ESPINA
     return intersection(blockBounds, bounds);
   }
 
+  //-----------------------------------------------------------------------------
+  template<typename T>
+  Bounds SparseVolume<T>::blockIntersection(const lliVector3 &index, const Bounds &bounds) const
+  {
+    auto origin  = this->m_bounds.origin();
+    auto spacing = this->m_bounds.spacing();
+
+    auto blockBounds = equivalentBounds<T>(origin, spacing, blockRegion(index));
+    return intersection(blockBounds, bounds);
+  }
+
   //-----------------------------------------------------------------------------
   template<typename T>
   const typename T::RegionType SparseVolume<T>::itkRegion() const
@@ -1063,7 +1208,7 @@ namespace ESPINA
   {
     if(!this->m_blocks.isEmpty())
     {
-      return m_blocks.first()->GetSpacing();
+      return ItkSpacing<T>(this->m_bounds.spacing());
     }
 
     typename T::SpacingType spacing;
@@ -0,0 +1,325 @@
+/*
+ File: SparseVolumeBlock.hxx
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCK_HXX_
+#define CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCK_HXX_
+
+// ESPINA
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Utils/Bounds.h>
+#include <Core/Utils/SpatialUtils.hxx>
+
+// ITK
+#include <itkImageRegionIterator.h>
+
+// C++
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ESPINA
+{
+  /** \class SparseVolumeBlock
+   * \brief Block of a sparse volume stored in the most compact of three encodings.
+   *
+   * - DENSE: the voxels are stored in an itk::Image. Used while the block is being edited and
+   *          for blocks with too much detail to be compressed.
+   * - UNIFORM: all the voxels of the block have the same value, only the value is stored.
+   * - RLE: each row (along the X axis) is stored as a list of runs of equal values.
+   *
+   * Uniform and RLE blocks don't keep any image, only the region of the block, so the memory of
+   * a segmentation depends on the amount of detail of its surface instead of its bounding volume.
+   *
+   */
+  template<typename T>
+  class SparseVolumeBlock
+  {
+    public:
+      using ValueType = typename T::ValueType;
+
+      enum class Encoding: std::int8_t { DENSE = 0, UNIFORM = 1, RLE = 2 };
+
+      static const unsigned int COMPRESSION_RATIO = 2; /** min ratio between dense and RLE sizes to use RLE encoding. */
+
+      /** \brief SparseVolumeBlock class constructor.
+       * \param[in] image dense block image.
+       *
+       */
+      explicit SparseVolumeBlock(typename T::Pointer image = nullptr)
+      : m_encoding{Encoding::DENSE}
+      , m_image   {image}
+      , m_value   {0}
+      {}
+
+      /** \brief Returns the encoding of the block.
+       *
+       */
+      Encoding encoding() const
+      { return m_encoding; }
+
+      /** \brief Returns the image of a dense block or nullptr for the other encodings.
+       *
+       */
+      typename T::Pointer image() const
+      { return m_image; }
+
+      /** \brief Returns true if all the voxels of the block have the given value. Only checks the
+       * encoding, dense blocks are never considered uniform.
+       * \param[in] value voxel value.
+       *
+       */
+      bool isUniform(const ValueType value) const
+      { return m_encoding == Encoding::UNIFORM && m_value == value; }
+
+      /** \brief Returns true if all the voxels of the block have the given value.
+       * \param[in] value voxel value.
+       *
+       */
+      bool hasOnly(const ValueType value) const
+      {
+        switch(m_encoding)
+        {
+          case Encoding::UNIFORM:
+            return m_value == value;
+          case Encoding::RLE:
+            // uniform blocks are never RLE encoded.
+            return false;
+          case Encoding::DENSE:
+          default:
+            {
+              const auto buffer = m_image->GetBufferPointer();
+              const auto size   = m_image->GetPixelContainer()->Size();
+
+              return std::all_of(buffer, buffer + size, [value](const ValueType voxel) { return voxel == value; });
+            }
+        }
+
+        return false;
+      }
+
+      /** \brief Returns the memory used by the voxels of the block in bytes.
+       *
+       */
+      size_t memoryUsage() const
+      {
+        switch(m_encoding)
+        {
+          case Encoding::UNIFORM:
+            return sizeof(ValueType);
+          case Encoding::RLE:
+            return m_rowOffsets.capacity() * sizeof(std::uint32_t) + m_runs.capacity() * sizeof(Run);
+          case Encoding::DENSE:
+          default:
+            return m_image ? m_image->GetPixelContainer()->Size() * sizeof(ValueType) : 0;
+        }
+
+        return 0;
+      }
+
+      /** \brief Encodes a dense block as uniform or RLE if that saves enough memory. Returns the
+       * image of the block if it has been encoded or nullptr if it remains dense.
+       * \param[in] region region of the block in the index space of the volume.
+       *
+       */
+      typename T::Pointer compress(const typename T::RegionType &region)
+      {
+        if(m_encoding != Encoding::DENSE || !m_image) return nullptr;
+
+        Q_ASSERT(region.GetNumberOfPixels() == m_image->GetPixelContainer()->Size());
+
+        const auto buffer = m_image->GetBufferPointer();
+        const auto width  = region.GetSize(0);
+        const auto rows   = region.GetSize(1) * region.GetSize(2);
+
+        const size_t denseSize  = region.GetNumberOfPixels() * sizeof(ValueType);
+        const size_t offsetSize = (rows + 1) * sizeof(std::uint32_t);
+        const size_t maxRuns    = denseSize / COMPRESSION_RATIO > offsetSize ? (denseSize / COMPRESSION_RATIO - offsetSize) / sizeof(Run) : 0;
+
+        std::vector<std::uint32_t> offsets;
+        std::vector<Run>           runs;
+        offsets.reserve(rows + 1);
+
+        bool uniform = true;
+        for(size_t row = 0; row < rows; ++row)
+        {
+          offsets.push_back(runs.size());
+
+          const auto line = buffer + row * width;
+
+          Run run{line[0], 1};
+          for(size_t x = 1; x < width; ++x)
+          {
+            if(line[x] == run.value)
+            {
+              ++run.length;
+            }
+            else
+            {
+              runs.push_back(run);
+              run = Run{line[x], 1};
+              uniform = false;
+            }
+          }
+          runs.push_back(run);
+
+          uniform &= (run.value == buffer[0]);
+
+          // uniform blocks have one run per row, check the limit only after knowing it's not uniform.
+          if(!uniform && runs.size() > maxRuns) return nullptr;
+        }
+        offsets.push_back(runs.size());
+
+        m_region = region;
+
+        if(uniform)
+        {
+          m_encoding = Encoding::UNIFORM;
+          m_value    = buffer[0];
+        }
+        else
+        {
+          m_encoding = Encoding::RLE;
+
+          runs.shrink_to_fit();
+          m_rowOffsets.swap(offsets);
+          m_runs.swap(runs);
+        }
+
+        auto image = m_image;
+        m_image = nullptr;
+
+        return image;
+      }
+
+      /** \brief Decodes an encoded block into the given image, that becomes the block image.
+       * \param[in] image image with the region of the block.
+       *
+       */
+      void decompress(typename T::Pointer image)
+      {
+        if(m_encoding == Encoding::DENSE) return;
+
+        Q_ASSERT(image->GetLargestPossibleRegion() == m_region);
+
+        auto buffer = image->GetBufferPointer();
+
+        if(m_encoding == Encoding::UNIFORM)
+        {
+          image->FillBuffer(m_value);
+        }
+        else
+        {
+          for(const auto &run: m_runs)
+          {
+            std::fill_n(buffer, run.length, run.value);
+            buffer += run.length;
+          }
+        }
+
+        image->Modified();
+
+        m_encoding = Encoding::DENSE;
+        m_image    = image;
+
+        std::vector<std::uint32_t>().swap(m_rowOffsets);
+        std::vector<Run>().swap(m_runs);
+      }
+
+      /** \brief Copies the voxels of the block inside the given bounds to the destination image.
+       * \param[in] destination image with the same origin and spacing of the block.
+       * \param[in] bounds bounds contained in both the block and the destination image.
+       *
+       */
+      void copyTo(typename T::Pointer destination, const Bounds &bounds) const
+      {
+        if(m_encoding == Encoding::DENSE)
+        {
+          copy_image<T>(m_image, destination, bounds);
+          return;
+        }
+
+        const auto region = equivalentRegion<T>(destination, bounds);
+
+        if(m_encoding == Encoding::UNIFORM)
+        {
+          itk::ImageRegionIterator<T> it(destination, region);
+          while(!it.IsAtEnd())
+          {
+            it.Set(m_value);
+            ++it;
+          }
+
+          return;
+        }
+
+        const long long xBegin = region.GetIndex(0) - m_region.GetIndex(0);
+        const long long xEnd   = xBegin + region.GetSize(0);
+
+        auto index = region.GetIndex();
+        for(unsigned int z = 0; z < region.GetSize(2); ++z)
+        {
+          index[2] = region.GetIndex(2) + z;
+
+          for(unsigned int y = 0; y < region.GetSize(1); ++y)
+          {
+            index[1] = region.GetIndex(1) + y;
+
+            const auto row  = (index[1] - m_region.GetIndex(1)) + (index[2] - m_region.GetIndex(2)) * m_region.GetSize(1);
+            auto       line = destination->GetBufferPointer() + destination->ComputeOffset(index);
+
+            long long position = 0;
+            for(auto i = m_rowOffsets[row]; i < m_rowOffsets[row + 1] && position < xEnd; ++i)
+            {
+              const auto &run  = m_runs[i];
+              const auto  from = std::max(position, xBegin);
+              const auto  to   = std::min(position + run.length, xEnd);
+
+              if(from < to)
+              {
+                std::fill(line + (from - xBegin), line + (to - xBegin), run.value);
+              }
+
+              position += run.length;
+            }
+          }
+        }
+      }
+
+    private:
+      /** \struct Run
+       * \brief Sequence of voxels with the same value in a row.
+       *
+       */
+      struct Run
+      {
+        ValueType     value;  /** value of the voxels.  */
+        std::uint16_t length; /** number of voxels.     */
+      };
+
+      Encoding                   m_encoding;   /** block encoding.                                         */
+      typename T::Pointer        m_image;      /** voxels of dense blocks.                                 */
+      ValueType                  m_value;      /** value of uniform blocks.                                */
+      typename T::RegionType     m_region;     /** region of the encoded blocks in the volume index space. */
+      std::vector<std::uint32_t> m_rowOffsets; /** index of the first run of each row in RLE blocks.       */
+      std::vector<Run>           m_runs;       /** runs of RLE blocks.                                     */
+  };
+}
+
+#endif // CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCK_HXX_
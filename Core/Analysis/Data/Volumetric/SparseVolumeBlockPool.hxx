@@ -0,0 +1,167 @@
+/*
+ File: SparseVolumeBlockPool.hxx
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCKPOOL_HXX_
+#define CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCKPOOL_HXX_
+
+// ESPINA
+#include <Core/Utils/SpatialUtils.hxx>
+#include <Core/Utils/Vector3.hxx>
+
+// Qt
+#include <QMutex>
+#include <QMutexLocker>
+
+// C++
+#include <vector>
+
+namespace ESPINA
+{
+  /** \class SparseVolumeBlockPool
+   * \brief Process wide pool of released sparse volume blocks of the same size.
+   *
+   * Sparse volumes create and discard blocks continuously while editing (a block is removed as
+   * soon as it becomes empty). Instead of allocating a new itk::Image for each block, blocks
+   * that are no longer referenced are kept in the pool and reused with their buffer, only their
+   * origin, spacing and region are updated.
+   *
+   */
+  template<typename T>
+  class SparseVolumeBlockPool
+  {
+    public:
+      static const unsigned int MAX_POOLED_BLOCKS = 1024; /** max number of blocks kept in the pool. */
+
+      /** \brief Returns the pool of blocks of the image type.
+       *
+       */
+      static SparseVolumeBlockPool<T> &instance()
+      {
+        static SparseVolumeBlockPool<T> pool;
+
+        return pool;
+      }
+
+      /** \brief Returns a block with the given geometry and all its voxels set to the given value.
+       * \param[in] origin origin of the block.
+       * \param[in] spacing spacing of the block.
+       * \param[in] region region of the block.
+       * \param[in] value initial voxel value.
+       *
+       */
+      typename T::Pointer acquire(const NmVector3 &origin, const NmVector3 &spacing, const typename T::RegionType &region, const typename T::ValueType value)
+      {
+        typename T::Pointer block = nullptr;
+
+        {
+          QMutexLocker lock(&m_mutex);
+
+          if(!m_blocks.empty())
+          {
+            block = m_blocks.back();
+            m_blocks.pop_back();
+          }
+        }
+
+        if(!block)
+        {
+          block = define_itkImage<T>(origin, spacing);
+          block->SetRegions(region);
+          block->Allocate();
+        }
+        else
+        {
+          typename T::PointType   itkOrigin;
+          typename T::SpacingType itkSpacing;
+
+          for(int i = 0; i < 3; ++i)
+          {
+            itkOrigin[i]  = origin[i];
+            itkSpacing[i] = spacing[i];
+          }
+
+          block->SetOrigin(itkOrigin);
+          block->SetSpacing(itkSpacing);
+          block->SetRegions(region);
+
+          if(block->GetPixelContainer()->Size() != region.GetNumberOfPixels())
+          {
+            block->Allocate();
+          }
+        }
+
+        block->FillBuffer(value);
+        block->Modified();
+
+        return block;
+      }
+
+      /** \brief Returns the block to the pool if nobody else references it and the pool is not
+       * full. The given pointer is always reset.
+       * \param[in] block block smart pointer.
+       *
+       */
+      void release(typename T::Pointer &block)
+      {
+        if(block && block->GetReferenceCount() == 1)
+        {
+          QMutexLocker lock(&m_mutex);
+
+          if(m_blocks.size() < MAX_POOLED_BLOCKS)
+          {
+            m_blocks.push_back(block);
+          }
+        }
+
+        block = nullptr;
+      }
+
+      /** \brief Returns the number of blocks available for reuse.
+       *
+       */
+      unsigned int size() const
+      {
+        QMutexLocker lock(&m_mutex);
+
+        return m_blocks.size();
+      }
+
+      /** \brief Frees all the pooled blocks.
+       *
+       */
+      void clear()
+      {
+        QMutexLocker lock(&m_mutex);
+
+        m_blocks.clear();
+      }
+
+    private:
+      /** \brief SparseVolumeBlockPool class private constructor.
+       *
+       */
+      SparseVolumeBlockPool()
+      {}
+
+      mutable QMutex                   m_mutex;  /** protects the pooled blocks. */
+      std::vector<typename T::Pointer> m_blocks; /** blocks available for reuse. */
+  };
+}
+
+#endif // CORE_ANALYSIS_DATA_VOLUMETRIC_SPARSEVOLUMEBLOCKPOOL_HXX_
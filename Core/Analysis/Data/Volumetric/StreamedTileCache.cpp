@@ -0,0 +1,220 @@
+/*
+ File: StreamedTileCache.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "StreamedTileCache.h"
+
+// Qt
+#include <QMutexLocker>
+
+using namespace ESPINA;
+using namespace ESPINA::Core;
+
+//-----------------------------------------------------------------------------
+StreamedTileCache::StreamedTileCache()
+: m_budget    {DEFAULT_MEMORY_BUDGET}
+, m_usage     {0}
+, m_readAhead {DEFAULT_READ_AHEAD}
+, m_statistics{0, 0, 0, 0}
+{
+}
+
+//-----------------------------------------------------------------------------
+StreamedTileCache& StreamedTileCache::instance()
+{
+  static StreamedTileCache cache;
+
+  return cache;
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::setMemoryBudget(unsigned long long bytes)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_budget = bytes;
+
+  evict();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long StreamedTileCache::memoryBudget() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_budget;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long StreamedTileCache::memoryUsage() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_usage;
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::setReadAhead(unsigned int slices)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_readAhead = slices;
+}
+
+//-----------------------------------------------------------------------------
+unsigned int StreamedTileCache::readAhead() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_readAhead;
+}
+
+//-----------------------------------------------------------------------------
+itk::DataObject::Pointer StreamedTileCache::tile(const Key &key)
+{
+  QMutexLocker lock(&m_mutex);
+
+  auto it = m_tiles.find(key);
+  if(it == m_tiles.end())
+  {
+    ++m_statistics.misses;
+
+    return nullptr;
+  }
+
+  ++m_statistics.hits;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->position);
+
+  return it->tile;
+}
+
+//-----------------------------------------------------------------------------
+bool StreamedTileCache::contains(const Key &key) const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_tiles.contains(key);
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::insert(const Key &key, itk::DataObject::Pointer tile, unsigned long long size, unsigned int generation)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_pending.remove(key);
+
+  if(!tile || generation != m_generations.value(key.first, 0)) return;
+
+  remove(key);
+
+  m_lru.push_front(key);
+
+  m_tiles.insert(key, Entry{tile, size, m_lru.begin()});
+  m_usage += size;
+
+  evict();
+}
+
+//-----------------------------------------------------------------------------
+bool StreamedTileCache::reserve(const Key &key, unsigned int &generation)
+{
+  QMutexLocker lock(&m_mutex);
+
+  if(m_tiles.contains(key) || m_pending.contains(key)) return false;
+
+  m_pending.insert(key);
+  ++m_statistics.readAheads;
+
+  generation = m_generations.value(key.first, 0);
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::cancel(const Key &key)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_pending.remove(key);
+}
+
+//-----------------------------------------------------------------------------
+unsigned int StreamedTileCache::generation(const QString &file) const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_generations.value(file, 0);
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::invalidate(const QString &file)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_generations[file] = m_generations.value(file, 0) + 1;
+
+  for(auto key: m_tiles.keys())
+  {
+    if(key.first == file)
+    {
+      remove(key);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::clear()
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_tiles.clear();
+  m_lru.clear();
+  m_usage = 0;
+}
+
+//-----------------------------------------------------------------------------
+StreamedTileCache::Statistics StreamedTileCache::statistics() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_statistics;
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::evict()
+{
+  while(m_usage > m_budget && !m_lru.empty())
+  {
+    remove(m_lru.back());
+
+    ++m_statistics.evictions;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void StreamedTileCache::remove(const Key &key)
+{
+  auto it = m_tiles.find(key);
+  if(it == m_tiles.end()) return;
+
+  m_usage -= it->size;
+  m_lru.erase(it->position);
+  m_tiles.erase(it);
+}
@@ -0,0 +1,210 @@
+/*
+ File: StreamedTileCache.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_ANALYSIS_DATA_VOLUMETRIC_STREAMEDTILECACHE_H_
+#define CORE_ANALYSIS_DATA_VOLUMETRIC_STREAMEDTILECACHE_H_
+
+#include "Core/EspinaCore_Export.h"
+
+// ITK
+#include <itkDataObject.h>
+
+// Qt
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QString>
+
+// C++
+#include <list>
+
+namespace ESPINA
+{
+  namespace Core
+  {
+    /** \class StreamedTileCache
+     * \brief Process wide LRU cache of the tiles read from streamed image files.
+     *
+     * Tiles are identified by the file they belong to and an identifier of the tile in that file
+     * (computed by the streamed volume). The cache is shared by all the streamed volumes (and
+     * therefore by all the views) and evicts the least recently used tiles when the memory used
+     * exceeds the configured budget.
+     *
+     * Each file has a generation number that is increased when the file is modified. Tiles read
+     * with a previous generation are discarded when inserted, so asynchronous reads can't store
+     * stale data.
+     *
+     */
+    class EspinaCore_EXPORT StreamedTileCache
+    {
+      public:
+        using Key = QPair<QString, quint64>;
+
+        static const unsigned long long DEFAULT_MEMORY_BUDGET = 512*1024*1024; /** default memory budget in bytes.          */
+        static const unsigned int       DEFAULT_READ_AHEAD    = 2;             /** default number of slices to read ahead. */
+
+        /** \struct Statistics
+         * \brief Cache usage counters.
+         *
+         */
+        struct Statistics
+        {
+          unsigned long long hits;       /** number of tiles found in the cache.           */
+          unsigned long long misses;     /** number of tiles not found in the cache.       */
+          unsigned long long evictions;  /** number of tiles removed to fit in the budget. */
+          unsigned long long readAheads; /** number of tiles requested in advance.         */
+        };
+
+        /** \brief Returns the tile cache instance.
+         *
+         */
+        static StreamedTileCache &instance();
+
+        /** \brief Sets the max memory used by the cached tiles, evicting tiles if necessary.
+         * \param[in] bytes memory budget in bytes.
+         *
+         */
+        void setMemoryBudget(unsigned long long bytes);
+
+        /** \brief Returns the max memory used by the cached tiles in bytes.
+         *
+         */
+        unsigned long long memoryBudget() const;
+
+        /** \brief Returns the memory used by the cached tiles in bytes.
+         *
+         */
+        unsigned long long memoryUsage() const;
+
+        /** \brief Sets the number of slices read in advance in the direction of the slice requests.
+         * \param[in] slices number of slices, 0 disables read-ahead.
+         *
+         */
+        void setReadAhead(unsigned int slices);
+
+        /** \brief Returns the number of slices read in advance in the direction of the slice requests.
+         *
+         */
+        unsigned int readAhead() const;
+
+        /** \brief Returns the tile of the given key, marking it as the most recently used, or
+         * nullptr if not cached.
+         * \param[in] key tile key.
+         *
+         */
+        itk::DataObject::Pointer tile(const Key &key);
+
+        /** \brief Returns true if the tile of the given key is cached. Doesn't modify the tile
+         * position in the LRU list nor the statistics.
+         * \param[in] key tile key.
+         *
+         */
+        bool contains(const Key &key) const;
+
+        /** \brief Inserts a tile in the cache, evicting other tiles if the budget is exceeded.
+         * The tile is discarded if the file has been modified since the given generation.
+         * \param[in] key tile key.
+         * \param[in] tile tile image.
+         * \param[in] size tile memory size in bytes.
+         * \param[in] generation generation of the file when the read of the tile started.
+         *
+         */
+        void insert(const Key &key, itk::DataObject::Pointer tile, unsigned long long size, unsigned int generation);
+
+        /** \brief Marks a tile as being read in advance. Returns false if the tile is already
+         * cached or being read.
+         * \param[in] key tile key.
+         * \param[out] generation current generation of the tile file.
+         *
+         */
+        bool reserve(const Key &key, unsigned int &generation);
+
+        /** \brief Removes the read mark of a tile that couldn't be read.
+         * \param[in] key tile key.
+         *
+         */
+        void cancel(const Key &key);
+
+        /** \brief Returns the current generation of the given file.
+         * \param[in] file file absolute path.
+         *
+         */
+        unsigned int generation(const QString &file) const;
+
+        /** \brief Removes the tiles of the given file and increases its generation. Must be called
+         * every time the file is modified.
+         * \param[in] file file absolute path.
+         *
+         */
+        void invalidate(const QString &file);
+
+        /** \brief Removes all the tiles from the cache.
+         *
+         */
+        void clear();
+
+        /** \brief Returns the usage counters of the cache.
+         *
+         */
+        Statistics statistics() const;
+
+      private:
+        /** \brief StreamedTileCache class private constructor.
+         *
+         */
+        StreamedTileCache();
+
+        /** \brief Removes least recently used tiles until the memory used fits the budget.
+         * Must be called with the mutex locked.
+         *
+         */
+        void evict();
+
+        /** \brief Removes the tile of the given key. Must be called with the mutex locked.
+         * \param[in] key tile key.
+         *
+         */
+        void remove(const Key &key);
+
+        /** \struct Entry
+         * \brief Cached tile.
+         *
+         */
+        struct Entry
+        {
+          itk::DataObject::Pointer  tile;     /** tile image.                */
+          unsigned long long        size;     /** tile memory size in bytes. */
+          std::list<Key>::iterator  position; /** position in the LRU list.  */
+        };
+
+        mutable QMutex               m_mutex;       /** protects cache data.                               */
+        std::list<Key>               m_lru;         /** tile keys from most to least recently used.        */
+        QHash<Key, Entry>            m_tiles;       /** cached tiles.                                      */
+        QSet<Key>                    m_pending;     /** tiles being read in advance.                       */
+        QHash<QString, unsigned int> m_generations; /** generation of the modified files.                  */
+        unsigned long long           m_budget;      /** max memory used by the tiles in bytes.             */
+        unsigned long long           m_usage;       /** memory used by the tiles in bytes.                 */
+        unsigned int                 m_readAhead;   /** number of slices read in advance.                  */
+        Statistics                   m_statistics;  /** usage counters.                                    */
+    };
+  } // namespace Core
+} // namespace ESPINA
+
+#endif // CORE_ANALYSIS_DATA_VOLUMETRIC_STREAMEDTILECACHE_H_
@@ -32,6 +32,7 @@
 // ESPINA
 #include <Core/Analysis/Data/VolumetricData.hxx>
 #include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Analysis/Data/Volumetric/StreamedTileCache.h>
 #include <Core/Utils/BinaryMask.hxx>
 #include <Core/Utils/Bounds.h>
 #include <Core/Utils/EspinaException.h>
@@ -41,9 +42,17 @@
 
 // ITK
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 // Qt
 #include <QMutex>
+#include <QtConcurrent>
+
+// C++
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 
 namespace ESPINA
 {
@@ -52,6 +61,11 @@ namespace ESPINA
     /** \class StreamedVolume
      * \brief Wrapper class around itk::Image for read-only large data files.
      *
+     * The file is read in tiles stored in the shared StreamedTileCache, and the tiles of the next
+     * slices are read in the background in the direction of the slice requests. Regions spanning several
+     * slices that are much thinner than the tiles (XZ and YZ planes) are read directly from the file, as
+     * are all the regions of files whose format can't be streamed, as each tile would read the whole file.
+     *
      */
     template<typename T>
     class StreamedVolume
@@ -98,6 +112,20 @@ namespace ESPINA
 
         virtual const typename T::Pointer itkImage(const Bounds& bounds) const override;
 
+        virtual const typename T::Pointer itkImage(const Bounds& bounds, const Nm resolution) const override;
+
+        /** \brief Sets the lower resolution levels of the volume. Each level has half the size of the
+         * previous one in the X and Y axes and region index {0,0,0}.
+         * \param[in] levels lower resolution volumes, from higher to lower resolution.
+         *
+         */
+        void setLevels(const QList<std::shared_ptr<StreamedVolume<T>>> &levels);
+
+        /** \brief Returns the lower resolution levels of the volume.
+         *
+         */
+        QList<std::shared_ptr<StreamedVolume<T>>> levels() const;
+
         virtual void draw(vtkImplicitFunction*        brush,
                           const Bounds&               bounds,
                           const typename T::ValueType value) override;
@@ -161,6 +189,11 @@ namespace ESPINA
          */
         virtual void fill(const typename T::PixelType &value);
 
+        static const unsigned int TILE_SIZE = 256; /** size of the cached tiles in the first two dimensions, the rest have size 1. */
+
+        static constexpr double MAX_TILES_OVERREAD = 4.0; /** max ratio between the pixels of the tiles and the requested ones of regions
+                                                            * spanning several slices, thinner regions are read without the cache. */
+
       protected:
         virtual bool fetchDataImplementation(TemporalStorageSPtr storage, const QString &path, const QString &id, const VolumeBounds &bounds) override
         { return false; }
@@ -169,23 +202,64 @@ namespace ESPINA
         virtual QList<Data::Type> updateDependencies() const override
         { return QList<Data::Type>(); }
 
+      private:
+        /** \brief Returns the size of the tiles in the given dimension.
+         * \param[in] dimension image dimension.
+         *
+         */
+        static unsigned int tileSize(const unsigned int dimension);
+
+        /** \brief Returns the identifier of the tile with the given index in the tile grid.
+         * \param[in] tileIndex tile grid index.
+         *
+         */
+        quint64 tileId(const typename T::IndexType &tileIndex) const;
+
+        /** \brief Returns the region on disk of the tile with the given index in the tile grid.
+         * \param[in] tileIndex tile grid index.
+         *
+         */
+        typename T::RegionType tileRegion(const typename T::IndexType &tileIndex) const;
+
+        /** \brief Reads the given region of the file.
+         * \param[in] shortName file name.
+         * \param[in] region region on disk.
+         * \param[in] vectorLength number of components per pixel.
+         *
+         */
+        static typename T::Pointer loadTile(const std::string &shortName, const typename T::RegionType &region, const unsigned int vectorLength);
+
+        /** \brief Reads in the background the tiles of the next slices in the direction of the slice requests.
+         * \param[in] firstTile first tile grid index of the last request.
+         * \param[in] lastTile last tile grid index of the last request.
+         *
+         */
+        void readAhead(const typename T::IndexType &firstTile, const typename T::IndexType &lastTile) const;
+
       protected:
         StreamedVolume()
-        : m_vectorLength{0}
+        : m_vectorLength {0}
+        , m_canStreamRead{true}
+        , m_lastSlice    {-1}
         {};
 
-        typename T::PointType   m_origin;       /** origin of the image on disk file. Should be {0,0,0} for images created with EspINA. */
-        typename T::SpacingType m_spacing;      /** spacing of the image.                                                               */
-        typename T::RegionType  m_region;       /** region index and size. Index can be different from {0,0,0} in EspINA files.         */
-        unsigned int            m_vectorLength; /** length (or number of components per pixel) of the pixel value vector.               */
-        QFileInfo               m_fileName;     /** file name of the file on disk.                                                      */
-        mutable QReadWriteLock  m_lock;         /** lock for read/write ordered access.                                                 */
+        typename T::PointType                     m_origin;       /** origin of the image on disk file. Should be {0,0,0} for images created with EspINA. */
+        typename T::SpacingType                   m_spacing;      /** spacing of the image.                                                               */
+        typename T::RegionType                    m_region;       /** region index and size. Index can be different from {0,0,0} in EspINA files.         */
+        unsigned int                              m_vectorLength; /** length (or number of components per pixel) of the pixel value vector.               */
+        QFileInfo                                 m_fileName;     /** file name of the file on disk.                                                      */
+        bool                                      m_canStreamRead; /** true if the file format can read regions without reading the whole file.          */
+        mutable QReadWriteLock                    m_lock;         /** lock for read/write ordered access.                                                 */
+        mutable std::atomic<long long>            m_lastSlice;    /** last requested slice, used to compute the read-ahead direction.                     */
+        QList<std::shared_ptr<StreamedVolume<T>>> m_levels;       /** lower resolution levels of the volume.                                              */
     };
 
     //-----------------------------------------------------------------------------
     template<typename T>
     StreamedVolume<T>::StreamedVolume(const QFileInfo &fileName)
-    : m_fileName{fileName}
+    : m_fileName     {fileName}
+    , m_canStreamRead{true}
+    , m_lastSlice    {-1}
     {
       if(!fileName.exists())
       {
@@ -206,6 +280,8 @@ namespace ESPINA
 
       auto image = reader->GetOutput();
 
+      m_canStreamRead = reader->GetImageIO()->CanStreamRead();
+
       m_vectorLength = image->GetNumberOfComponentsPerPixel();
       if(m_vectorLength == 0)
       {
@@ -295,11 +371,6 @@ namespace ESPINA
     template<typename T>
     const typename T::Pointer StreamedVolume<T>::itkImage() const
     {
-      auto message = QObject::tr("Attemp to complete load an StreamedVolume. File: %1").arg(m_fileName.absoluteFilePath());
-      auto details = QObject::tr("StreamedVolume::itkImage() -> ") + message;
-
-      throw Core::Utils::EspinaException(message, details);
-
       if (!isValid())
       {
         auto message = QObject::tr("Uninitialized StreamedVolume. File: %1").arg(m_fileName.absoluteFilePath());
@@ -308,32 +379,23 @@ namespace ESPINA
         throw Core::Utils::EspinaException(message, details);
       }
 
-      const auto shortName = getShortFileName(m_fileName.absoluteFilePath());
-
-      QReadLocker lock(&this->m_lock);
-
-      auto reader = itk::ImageFileReader<T>::New();
-      reader->ReleaseDataFlagOn();
-      reader->SetFileName(shortName);
-      reader->SetUseStreaming(false);
-      reader->SetNumberOfThreads(1);
-      reader->Update();
+      typename T::RegionType region;
+      {
+        QReadLocker lock(&this->m_lock);
 
-      typename T::Pointer image = reader->GetOutput();
-      image->DisconnectPipeline();
-      image->SetNumberOfComponentsPerPixel(m_vectorLength);
-      image->SetSpacing(m_spacing);
+        region = m_region;
+      }
 
-      auto origin = image->GetOrigin();
-      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
+      const unsigned long long size = region.GetNumberOfPixels() * m_vectorLength * sizeof(typename T::InternalPixelType);
+      if(size > StreamedTileCache::instance().memoryBudget())
       {
-        origin.SetElement(i,0);
-      }
+        auto message = QObject::tr("Attemp to complete load an StreamedVolume bigger than the tile cache memory budget. File: %1").arg(m_fileName.absoluteFilePath());
+        auto details = QObject::tr("StreamedVolume::itkImage() -> ") + message;
 
-      image->SetOrigin(origin);
-      image->SetRegions(m_region);
+        throw Core::Utils::EspinaException(message, details);
+      }
 
-      return image;
+      return read(region);
     }
 
     //-----------------------------------------------------------------------------
@@ -354,6 +416,77 @@ namespace ESPINA
       return read(eqRegion);
     }
 
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    const typename T::Pointer StreamedVolume<T>::itkImage(const Bounds& bounds, const Nm resolution) const
+    {
+      const auto levels = this->levels();
+
+      if(T::GetImageDimension() != 3 || levels.isEmpty()) return itkImage(bounds);
+
+      const auto imageBounds = this->bounds();
+      const auto spacing     = imageBounds.spacing();
+      const auto requested   = equivalentRegion<T>(imageBounds.origin(), spacing, bounds);
+      const auto region      = itkRegion();
+
+      if(!region.IsInside(requested))
+      {
+        auto message = QObject::tr("Requested region is totally/partially outside the image region. File: %1").arg(m_fileName.absoluteFilePath());
+        auto details = QObject::tr("StreamedVolume::itkImage(bounds, resolution) -> ") + message;
+
+        throw Core::Utils::EspinaException(message, details);
+      }
+
+      int level = 0;
+      while(level < levels.size() && (2 << level) * std::min(spacing[0], spacing[1]) <= resolution) ++level;
+
+      if(level == 0) return itkImage(bounds);
+
+      auto volume      = levels.at(level - 1);
+      auto levelRegion = volume->itkRegion();
+
+      typename T::RegionType diskRegion;
+      typename T::SpacingType levelSpacing;
+      typename T::PointType   levelOrigin;
+      for(unsigned int i = 0; i < 3; ++i)
+      {
+        const long long factor = (i < 2) ? (1 << level) : 1;
+        const long long begin  = (requested.GetIndex(i) - region.GetIndex(i)) / factor;
+        const long long end    = (requested.GetIndex(i) - region.GetIndex(i) + requested.GetSize(i) + factor - 1) / factor;
+
+        diskRegion.SetIndex(i, begin);
+        diskRegion.SetSize(i, std::min<long long>(end, levelRegion.GetSize(i)) - begin);
+
+        // each voxel of the level covers factor voxels of the volume, place it at their center.
+        levelSpacing[i] = spacing[i] * factor;
+        levelOrigin[i]  = (region.GetIndex(i) + 0.5 * (factor - 1)) * spacing[i];
+      }
+
+      auto image = volume->read(diskRegion);
+      image->SetSpacing(levelSpacing);
+      image->SetOrigin(levelOrigin);
+
+      return image;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    void StreamedVolume<T>::setLevels(const QList<std::shared_ptr<StreamedVolume<T>>> &levels)
+    {
+      QWriteLocker lock(&this->m_lock);
+
+      m_levels = levels;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    QList<std::shared_ptr<StreamedVolume<T>>> StreamedVolume<T>::levels() const
+    {
+      QReadLocker lock(&this->m_lock);
+
+      return m_levels;
+    }
+
     //-----------------------------------------------------------------------------
     template<typename T>
     void StreamedVolume<T>::draw(vtkImplicitFunction*        brush,
@@ -442,15 +575,156 @@ namespace ESPINA
         throw Core::Utils::EspinaException(message, details);
       }
 
+      const auto dimension = T::GetImageDimension();
+      const auto fileName  = m_fileName.absoluteFilePath();
+      const auto shortName = getShortFileName(fileName);
+      auto &cache          = StreamedTileCache::instance();
+
       // need to correct the region with the equivalent one on disk, just a displacement of origin length.
       typename T::RegionType requestedRegion = region;
-      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
+      typename T::IndexType  firstTile, lastTile;
+      double tilesPixels = 1;
+      for(unsigned int i = 0; i < dimension; ++i)
       {
         requestedRegion.SetIndex(i, requestedRegion.GetIndex(i)-m_region.GetIndex(i));
+
+        firstTile[i] = requestedRegion.GetIndex(i) / tileSize(i);
+        lastTile[i]  = (requestedRegion.GetIndex(i) + requestedRegion.GetSize(i) - 1) / tileSize(i);
+
+        tilesPixels *= std::min<long long>((lastTile[i] + 1) * tileSize(i), m_region.GetSize(i)) - firstTile[i] * tileSize(i);
+      }
+
+      // regions spanning several slices but thin in the tiled dimensions (XZ and YZ planes) would read a
+      // whole tile for each of their rows and evict the cached slices, those are read directly from disk.
+      // Files that can't be streamed are read whole for each tile, so the cache is never used for them.
+      const auto readDirectly = !m_canStreamRead ||
+                                ((dimension > 2) && (requestedRegion.GetSize(dimension-1) > 1)
+                                 && (tilesPixels > MAX_TILES_OVERREAD * requestedRegion.GetNumberOfPixels()));
+
+      typename T::Pointer image = readDirectly ? loadTile(shortName, requestedRegion, m_vectorLength) : T::New();
+      image->SetNumberOfComponentsPerPixel(m_vectorLength);
+      image->SetRegions(region);
+      image->SetSpacing(m_spacing);
+
+      auto origin = image->GetOrigin();
+      for(unsigned int i = 0; i < dimension; ++i)
+      {
+        origin.SetElement(i,0);
+      }
+
+      image->SetOrigin(origin);
+
+      if(readDirectly) return image;
+
+      image->Allocate();
+
+      // pixels of itk::VectorImage are stored as consecutive components in the buffer.
+      const unsigned int components = std::is_same<typename T::PixelType, typename T::InternalPixelType>::value ? 1 : m_vectorLength;
+
+      auto tileIndex = firstTile;
+      while(tileIndex[dimension-1] <= lastTile[dimension-1])
+      {
+        const auto key = StreamedTileCache::Key{fileName, tileId(tileIndex)};
+
+        typename T::Pointer tile = dynamic_cast<T *>(cache.tile(key).GetPointer());
+        if(!tile)
+        {
+          const auto generation = cache.generation(fileName);
+          const auto diskRegion = tileRegion(tileIndex);
+
+          tile = loadTile(shortName, diskRegion, m_vectorLength);
+
+          cache.insert(key, tile.GetPointer(), diskRegion.GetNumberOfPixels() * m_vectorLength * sizeof(typename T::InternalPixelType), generation);
+        }
+
+        auto common = tile->GetLargestPossibleRegion();
+        common.Crop(requestedRegion);
+
+        const auto width = common.GetSize(0);
+
+        // iterate over the first voxel of each row of the common region.
+        auto rows = common;
+        rows.SetSize(0, 1);
+
+        itk::ImageRegionConstIteratorWithIndex<T> it(tile, rows);
+        while(!it.IsAtEnd())
+        {
+          auto index = it.GetIndex();
+          auto source = tile->GetBufferPointer() + tile->ComputeOffset(index) * components;
+
+          for(unsigned int i = 0; i < dimension; ++i)
+          {
+            index[i] += m_region.GetIndex(i);
+          }
+          auto destination = image->GetBufferPointer() + image->ComputeOffset(index) * components;
+
+          std::memcpy(destination, source, width * components * sizeof(typename T::InternalPixelType));
+
+          ++it;
+        }
+
+        // next tile index, first dimension changes faster.
+        for(unsigned int i = 0; i < dimension; ++i)
+        {
+          if(++tileIndex[i] <= lastTile[i] || i == dimension - 1) break;
+
+          tileIndex[i] = firstTile[i];
+        }
+      }
+
+      if(dimension > 2)
+      {
+        readAhead(firstTile, lastTile);
+      }
+
+      return image;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    inline unsigned int StreamedVolume<T>::tileSize(const unsigned int dimension)
+    {
+      return dimension < 2 ? TILE_SIZE : 1;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    quint64 StreamedVolume<T>::tileId(const typename T::IndexType &tileIndex) const
+    {
+      quint64 id     = 0;
+      quint64 stride = 1;
+
+      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
+      {
+        id     += tileIndex[i] * stride;
+        stride *= (m_region.GetSize(i) + tileSize(i) - 1) / tileSize(i);
       }
 
-      const auto shortName = getShortFileName(m_fileName.absoluteFilePath());
+      return id;
+    }
 
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    typename T::RegionType StreamedVolume<T>::tileRegion(const typename T::IndexType &tileIndex) const
+    {
+      typename T::RegionType region;
+
+      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
+      {
+        const long long begin = tileIndex[i] * tileSize(i);
+        const long long end   = std::min<long long>(begin + tileSize(i), m_region.GetSize(i));
+
+        region.SetIndex(i, begin);
+        region.SetSize(i, end - begin);
+      }
+
+      return region;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    typename T::Pointer StreamedVolume<T>::loadTile(const std::string &shortName, const typename T::RegionType &region, const unsigned int vectorLength)
+    {
       auto reader = itk::ImageFileReader<T>::New();
       reader->ReleaseDataFlagOn();
       reader->SetFileName(shortName);
@@ -459,27 +733,82 @@ namespace ESPINA
 
       auto extractor = itk::ExtractImageFilter<T,T>::New();
       extractor->SetInput(reader->GetOutput());
-      extractor->SetExtractionRegion(requestedRegion);
+      extractor->SetExtractionRegion(region);
       extractor->Update();
 
       typename T::Pointer image = extractor->GetOutput();
       image->DisconnectPipeline();
-      image->SetNumberOfComponentsPerPixel(m_vectorLength);
-      image->SetSpacing(m_spacing);
-
-      auto origin = image->GetOrigin();
-      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
-      {
-        origin.SetElement(i,0);
-      }
-
-      image->SetOrigin(origin);
+      image->SetNumberOfComponentsPerPixel(vectorLength);
       image->SetRegions(region);
-      image->UpdateOutputInformation();
 
       return image;
     }
 
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    void StreamedVolume<T>::readAhead(const typename T::IndexType &firstTile, const typename T::IndexType &lastTile) const
+    {
+      auto &cache = StreamedTileCache::instance();
+
+      const auto slices = cache.readAhead();
+      if(slices == 0) return;
+
+      const auto dimension = T::GetImageDimension();
+      const long long slice     = firstTile[dimension-1];
+      const long long previous  = m_lastSlice.exchange(slice);
+      const long long direction = (slice < previous) ? -1 : 1;
+      const long long maxSlice  = m_region.GetSize(dimension-1);
+
+      const auto fileName     = m_fileName.absoluteFilePath();
+      const auto shortName    = getShortFileName(fileName);
+      const auto vectorLength = m_vectorLength;
+
+      for(long long n = 1; n <= slices; ++n)
+      {
+        auto tileIndex = firstTile;
+        tileIndex[dimension-1] = (direction > 0 ? lastTile[dimension-1] : firstTile[dimension-1]) + n * direction;
+
+        if(tileIndex[dimension-1] < 0 || tileIndex[dimension-1] >= maxSlice) break;
+
+        while(true)
+        {
+          const auto key = StreamedTileCache::Key{fileName, tileId(tileIndex)};
+
+          unsigned int generation;
+          if(cache.reserve(key, generation))
+          {
+            const auto region    = tileRegion(tileIndex);
+            const auto tileBytes = region.GetNumberOfPixels() * vectorLength * sizeof(typename T::InternalPixelType);
+
+            QtConcurrent::run([key, shortName, region, vectorLength, tileBytes, generation]()
+            {
+              try
+              {
+                auto tile = loadTile(shortName, region, vectorLength);
+
+                StreamedTileCache::instance().insert(key, tile.GetPointer(), tileBytes, generation);
+              }
+              catch(...)
+              {
+                StreamedTileCache::instance().cancel(key);
+              }
+            });
+          }
+
+          // next tile of the slice.
+          unsigned int i = 0;
+          for(; i < dimension - 1; ++i)
+          {
+            if(++tileIndex[i] <= lastTile[i]) break;
+
+            tileIndex[i] = firstTile[i];
+          }
+
+          if(i == dimension - 1) break;
+        }
+      }
+    }
+
     //-----------------------------------------------------------------------------
     template<typename T>
     inline void StreamedVolume<T>::write(const typename T::Pointer &image)
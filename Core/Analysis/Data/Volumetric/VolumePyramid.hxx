@@ -0,0 +1,345 @@
+/*
+ File: VolumePyramid.hxx
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_ANALYSIS_DATA_VOLUMETRIC_VOLUMEPYRAMID_HXX_
+#define CORE_ANALYSIS_DATA_VOLUMETRIC_VOLUMEPYRAMID_HXX_
+
+// ESPINA
+#include <Core/Analysis/Data/Volumetric/MappedVolume.hxx>
+#include <Core/Analysis/Data/Volumetric/StreamedTileCache.h>
+#include <Core/Analysis/Data/Volumetric/WritableStreamedVolume.hxx>
+#include <Core/Utils/EspinaException.h>
+
+// Qt
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace ESPINA
+{
+  namespace Core
+  {
+    /** \class VolumePyramid
+     * \brief Builds and opens the lower resolution levels of a streamed volume.
+     *
+     * Each level halves the size of the previous one in the X and Y axes averaging blocks of 2x2
+     * voxels, the Z axis keeps its resolution so slices of the XY plane can be read from any level.
+     * Levels are stored as uncompressed MetaImage files named after the volume file and are reused
+     * while they are more recent than the level they were built from.
+     *
+     */
+    template<typename T>
+    class VolumePyramid
+    {
+      public:
+        static_assert(std::is_same<typename T::PixelType, typename T::InternalPixelType>::value, "VolumePyramid only supports scalar pixel types.");
+
+        using Levels   = QList<std::shared_ptr<StreamedVolume<T>>>;
+        using Reporter = std::function<void(int)>;
+
+        static const unsigned int MIN_LEVEL_SIZE = 256; /** levels are created until both X and Y sizes are smaller than this value. */
+        static const unsigned int MAX_LEVELS     = 10;  /** max number of lower resolution levels.                                   */
+        static const unsigned int BAND_ROWS      = 64;  /** number of rows of a level computed at once.                              */
+
+        /** \brief Returns the lower resolution levels of the given volume, building the missing or
+         * outdated ones in the given directory.
+         * \param[in] volume full resolution volume.
+         * \param[in] directory directory of the level files.
+         * \param[in] reporter progress reporter, receives values in [0,100].
+         *
+         */
+        static Levels create(const StreamedVolume<T> *volume, const QDir &directory, Reporter reporter = nullptr);
+
+        /** \brief Returns the number of lower resolution levels of a volume of the given region.
+         * \param[in] region volume region.
+         *
+         */
+        static unsigned int numberOfLevels(const typename T::RegionType &region);
+
+        /** \brief Returns the file name of the given level of a volume.
+         * \param[in] volumeFile file of the full resolution volume.
+         * \param[in] directory directory of the level files.
+         * \param[in] level level number, starting at 1.
+         *
+         */
+        static QString levelFileName(const QFileInfo &volumeFile, const QDir &directory, const unsigned int level);
+
+      private:
+        using PixelType = typename T::PixelType;
+
+        /** \brief Returns the region of the given level of a volume of the given region.
+         * \param[in] region volume region.
+         * \param[in] level level number, starting at 1.
+         *
+         */
+        static typename T::RegionType levelRegion(const typename T::RegionType &region, const unsigned int level);
+
+        /** \brief Opens the level file if it exists, has the given region and is more recent than the given time.
+         * Returns nullptr otherwise.
+         * \param[in] fileName level file name.
+         * \param[in] region level region.
+         * \param[in] sourceTime modification time of the level the file was built from.
+         *
+         */
+        static std::shared_ptr<StreamedVolume<T>> open(const QString &fileName, const typename T::RegionType &region, const QDateTime &sourceTime);
+
+        /** \brief Builds a level file from the previous level.
+         * \param[in] source previous level.
+         * \param[in] fileName level file name.
+         * \param[in] region level region.
+         * \param[in] spacing level spacing.
+         * \param[in] reporter progress reporter, receives the number of processed slices.
+         *
+         */
+        static void build(const StreamedVolume<T> *source, const QString &fileName, const typename T::RegionType &region, const typename T::SpacingType &spacing, Reporter reporter);
+    };
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    typename VolumePyramid<T>::Levels VolumePyramid<T>::create(const StreamedVolume<T> *volume, const QDir &directory, Reporter reporter)
+    {
+      Levels levels;
+
+      const auto region = volume->itkRegion();
+      const auto count  = numberOfLevels(region);
+      const auto slices = region.GetSize(2);
+
+      auto spacing    = volume->itkSpacing();
+      auto source     = volume;
+      auto sourceTime = volume->fileName().lastModified();
+
+      for(unsigned int level = 1; level <= count; ++level)
+      {
+        const auto fileName = levelFileName(volume->fileName(), directory, level);
+        const auto lRegion  = levelRegion(region, level);
+
+        spacing[0] *= 2;
+        spacing[1] *= 2;
+
+        auto levelVolume = open(fileName, lRegion, sourceTime);
+        if(!levelVolume)
+        {
+          auto levelReporter = [reporter, level, count, slices](int slice)
+          {
+            if(reporter) reporter((100 * (level - 1) + (100 * slice) / slices) / count);
+          };
+
+          build(source, fileName, lRegion, spacing, levelReporter);
+
+          levelVolume = open(fileName, lRegion, QDateTime());
+          if(!levelVolume)
+          {
+            auto message = QObject::tr("Couldn't open level file %1.").arg(fileName);
+            auto details = QObject::tr("VolumePyramid::create() -> ") + message;
+
+            throw Core::Utils::EspinaException(message, details);
+          }
+        }
+
+        levels << levelVolume;
+        source     = levelVolume.get();
+        sourceTime = QFileInfo{fileName}.lastModified();
+      }
+
+      if(reporter) reporter(100);
+
+      return levels;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    unsigned int VolumePyramid<T>::numberOfLevels(const typename T::RegionType &region)
+    {
+      if(T::GetImageDimension() != 3) return 0;
+
+      unsigned int levels = 0;
+      auto width  = region.GetSize(0);
+      auto height = region.GetSize(1);
+
+      while((width > MIN_LEVEL_SIZE || height > MIN_LEVEL_SIZE) && levels < MAX_LEVELS)
+      {
+        width  = (width + 1) / 2;
+        height = (height + 1) / 2;
+        ++levels;
+      }
+
+      return levels;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    QString VolumePyramid<T>::levelFileName(const QFileInfo &volumeFile, const QDir &directory, const unsigned int level)
+    {
+      return directory.absoluteFilePath(volumeFile.completeBaseName() + QString("_level%1.mhd").arg(level));
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    typename T::RegionType VolumePyramid<T>::levelRegion(const typename T::RegionType &region, const unsigned int level)
+    {
+      typename T::RegionType result;
+
+      for(unsigned int i = 0; i < T::GetImageDimension(); ++i)
+      {
+        const itk::SizeValueType factor = (i < 2) ? (1 << level) : 1;
+
+        result.SetIndex(i, 0);
+        result.SetSize(i, (region.GetSize(i) + factor - 1) / factor);
+      }
+
+      return result;
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    std::shared_ptr<StreamedVolume<T>> VolumePyramid<T>::open(const QString &fileName, const typename T::RegionType &region, const QDateTime &sourceTime)
+    {
+      QFileInfo info{fileName};
+
+      if(!info.exists() || (sourceTime.isValid() && info.lastModified() < sourceTime)) return nullptr;
+
+      try
+      {
+        auto volume = std::make_shared<MappedVolume<T>>(info);
+
+        if(volume->itkRegion().GetSize() != region.GetSize()) return nullptr;
+
+        return volume;
+      }
+      catch(const Core::Utils::EspinaException &e)
+      {
+        return nullptr;
+      }
+      catch(const itk::ExceptionObject &e)
+      {
+        return nullptr;
+      }
+    }
+
+    //-----------------------------------------------------------------------------
+    template<typename T>
+    void VolumePyramid<T>::build(const StreamedVolume<T> *source, const QString &fileName, const typename T::RegionType &region, const typename T::SpacingType &spacing, Reporter reporter)
+    {
+      QFileInfo info{fileName};
+      const auto dataFileName = info.absoluteDir().absoluteFilePath(info.completeBaseName() + ".raw");
+
+      // writable volumes open existing files instead of creating them.
+      QFile::remove(fileName);
+      QFile::remove(dataFileName);
+
+      // creates the header and an empty data file.
+      WritableStreamedVolume<T> level(info, region, spacing);
+
+      QFile file{dataFileName};
+      if(!file.open(QIODevice::ReadWrite))
+      {
+        auto message = QObject::tr("Couldn't open raw file '%1'. Reason: %2.").arg(dataFileName).arg(file.errorString());
+        auto details = QObject::tr("VolumePyramid::build() -> ") + message;
+
+        throw Core::Utils::EspinaException(message, details);
+      }
+
+      const auto sourceRegion = source->itkRegion();
+      const auto sourceWidth  = sourceRegion.GetSize(0);
+      const auto sourceHeight = sourceRegion.GetSize(1);
+      const auto width        = region.GetSize(0);
+      const auto height       = region.GetSize(1);
+
+      std::vector<PixelType> band(width * BAND_ROWS);
+
+      for(unsigned int z = 0; z < region.GetSize(2); ++z)
+      {
+        for(unsigned int y = 0; y < height; y += BAND_ROWS)
+        {
+          const auto rows = std::min<itk::SizeValueType>(BAND_ROWS, height - y);
+
+          typename T::RegionType sourceBand = sourceRegion;
+          sourceBand.SetIndex(1, sourceRegion.GetIndex(1) + 2 * y);
+          sourceBand.SetIndex(2, sourceRegion.GetIndex(2) + z);
+          sourceBand.SetSize(1, std::min<itk::SizeValueType>(2 * rows, sourceHeight - 2 * y));
+          sourceBand.SetSize(2, 1);
+
+          auto image  = source->read(sourceBand);
+          auto buffer = image->GetBufferPointer();
+
+          for(unsigned int row = 0; row < rows; ++row)
+          {
+            const auto sourceRows = std::min<itk::SizeValueType>(2, sourceBand.GetSize(1) - 2 * row);
+
+            for(unsigned int x = 0; x < width; ++x)
+            {
+              const auto sourceColumns = std::min<itk::SizeValueType>(2, sourceWidth - 2 * x);
+
+              double sum = 0;
+              for(unsigned int j = 0; j < sourceRows; ++j)
+              {
+                for(unsigned int i = 0; i < sourceColumns; ++i)
+                {
+                  sum += buffer[(2 * row + j) * sourceWidth + 2 * x + i];
+                }
+              }
+
+              const auto mean = sum / (sourceRows * sourceColumns);
+
+              band[row * width + x] = static_cast<PixelType>(std::numeric_limits<PixelType>::is_integer ? std::floor(mean + 0.5) : mean);
+            }
+          }
+
+          const qint64 position = (static_cast<qint64>(z) * height + y) * width * sizeof(PixelType);
+          const qint64 size     = rows * width * sizeof(PixelType);
+
+          if(!file.seek(position) || size != file.write(reinterpret_cast<const char *>(band.data()), size))
+          {
+            auto message = QObject::tr("Unable to write in pos %1, total file size is %2. File: %3").arg(position).arg(file.size()).arg(dataFileName);
+            auto details = QObject::tr("VolumePyramid::build() -> ") + message;
+
+            throw Core::Utils::EspinaException(message, details);
+          }
+        }
+
+        if(reporter) reporter(z + 1);
+      }
+
+      if(!file.flush() || (file.error() != QFile::NoError))
+      {
+        auto message = QObject::tr("Error finishing write operation in file: %1").arg(dataFileName);
+        auto details = QObject::tr("VolumePyramid::build() -> ") + message;
+
+        throw Core::Utils::EspinaException(message, details);
+      }
+      file.close();
+
+      // the data has been written outside the writable volume.
+      StreamedTileCache::instance().invalidate(info.absoluteFilePath());
+    }
+
+  } // namespace Core
+} // namespace ESPINA
+
+#endif // CORE_ANALYSIS_DATA_VOLUMETRIC_VOLUMEPYRAMID_HXX_
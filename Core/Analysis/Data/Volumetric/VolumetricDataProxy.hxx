@@ -98,6 +98,11 @@ namespace ESPINA
       return m_data->itkImage(bounds);
     }
 
+    virtual const typename T::Pointer itkImage(const Bounds& bounds, const Nm resolution) const override
+    {
+      return m_data->itkImage(bounds, resolution);
+    }
+
     virtual void setBackgroundValue(const typename T::ValueType value) override
     {
       m_data->setBackgroundValue(value);
@@ -254,6 +254,9 @@ namespace ESPINA
           throw Core::Utils::EspinaException(message, details);
         }
 
+        // a previous file with the same name could have been cached.
+        StreamedTileCache::instance().invalidate(this->m_fileName.absoluteFilePath());
+
         auto image = T::New();
 
         // Initial mhd file is just a voxel, we'll expand the data file later using Qt file interface.
@@ -644,6 +647,9 @@ namespace ESPINA
     {
       QWriteLocker lock(&this->m_lock);
 
+      // tiles read before the modification are no longer valid.
+      StreamedTileCache::instance().invalidate(this->m_fileName.absoluteFilePath());
+
       unsigned long dataSize = sizeof(typename T::InternalPixelType);
       const auto size        = this->m_region.GetNumberOfPixels();
 
@@ -692,6 +698,9 @@ namespace ESPINA
     {
       QWriteLocker lock(&this->m_lock);
 
+      // tiles read before the modification are no longer valid.
+      StreamedTileCache::instance().invalidate(this->m_fileName.absoluteFilePath());
+
       auto volumeRegion = image->GetLargestPossibleRegion();
       auto volumeOrigin = image->GetOrigin();
 
@@ -804,6 +813,9 @@ namespace ESPINA
     {
       QWriteLocker lock(&this->m_lock);
 
+      // tiles read before the modification are no longer valid.
+      StreamedTileCache::instance().invalidate(this->m_fileName.absoluteFilePath());
+
       unsigned long dataSize = sizeof(typename T::InternalPixelType) * this->m_vectorLength;
       auto size              = this->m_region.GetNumberOfPixels();
 
@@ -852,6 +864,9 @@ namespace ESPINA
     {
       QWriteLocker lock(&this->m_lock);
 
+      // tiles read before the modification are no longer valid.
+      StreamedTileCache::instance().invalidate(this->m_fileName.absoluteFilePath());
+
       auto volumeRegion = image->GetLargestPossibleRegion();
       auto volumeOrigin = image->GetOrigin();
 
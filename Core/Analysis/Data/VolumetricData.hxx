@@ -88,6 +88,17 @@ namespace ESPINA
      */
     virtual const typename T::Pointer itkImage(const Bounds& bounds) const = 0;
 
+    /** \brief Return a read only ItkImage of volume representation contained in bounds with the
+     * lowest resolution that has voxels not bigger than the given resolution in the X and Y axes.
+     * \param[in] bounds bounds of the resulting image.
+     * \param[in] resolution max size of the voxels of the resulting image in the X and Y axes.
+     *
+     * The spacing and origin of the resulting image can be different from the volume ones. Volumes
+     * without lower resolution levels return the full resolution image.
+     */
+    virtual const typename T::Pointer itkImage(const Bounds& bounds, const Nm resolution) const
+    { return itkImage(bounds); }
+
     /** \brief Set volume background value
      * \param[in] value background value.
      *
@@ -671,6 +671,22 @@ namespace ESPINA
     return vtkImage<T>(image, bounds);
   }
 
+  /** \brief Return the vtkImageData of the given bounds of the volumetric data at the lowest
+   * resolution whose voxels are not bigger than the given one.
+   * \param[in] volume VolumetricData smart pointer to transform.
+   * \param[in] bounds bounds of the image to transform.
+   * \param[in] resolution max voxel size in the X and Y axes.
+   *
+   */
+  template<typename T>
+  vtkSmartPointer<vtkImageData> vtkImage(const Output::ReadLockData<VolumetricData<T>> &volume, const Bounds &bounds, const Nm resolution)
+  {
+    typename T::Pointer image = volume->itkImage(bounds, resolution);
+
+    // lower resolution images don't have the same voxel boundaries as the requested bounds.
+    return vtkImage<T>(image, equivalentBounds<T>(image));
+  }
+
   /** \brief Copies a sub-image from the source image to the destination image.
    * \param[in] source source image.
    * \param[in] destination destination image.
@@ -20,26 +20,33 @@
 
 // ESPINA
 #include <Core/IO/ErrorHandler.h>
+#include <Core/Analysis/Data/Volumetric/MappedVolume.hxx>
 #include <Core/Analysis/Data/Volumetric/RawVolume.hxx>
 #include <Core/Analysis/Data/Volumetric/StreamedVolume.hxx>
+#include <Core/Analysis/Data/Volumetric/VolumePyramid.hxx>
 #include <Core/Analysis/Data/VolumetricDataUtils.hxx>
 #include <Core/Analysis/Filters/VolumetricStreamReader.h>
 #include <Core/Utils/EspinaException.h>
 #include <Core/Utils/StatePair.h>
 #include <Core/Utils/ITKProgressReporter.h>
 
+// Qt
+#include <QDebug>
+
 using namespace ESPINA;
 using namespace ESPINA::Core;
 using namespace ESPINA::Core::Utils;
 
 const QString STREAM_FILENAME = "streamingData.mhd";
 
-const QString VolumetricStreamReader::STREAMING_OPTION = QObject::tr("Streaming");
+const QString VolumetricStreamReader::STREAMING_OPTION       = QObject::tr("Streaming");
+const QString VolumetricStreamReader::MULTIRESOLUTION_OPTION = QObject::tr("MultiResolution");
 
 //----------------------------------------------------------------------------
 VolumetricStreamReader::VolumetricStreamReader(InputSList inputs, Type type, SchedulerSPtr scheduler)
 : Filter            {inputs, type, scheduler}
 , m_streaming       {false}
+, m_multiResolution {false}
 , m_streamingStorage{nullptr}
 , m_changedStreaming{false}
 {
@@ -70,6 +77,11 @@ void VolumetricStreamReader::restoreState(const State& state)
     {
       m_streaming = (tokens[1].simplified().compare("true", Qt::CaseInsensitive) == 0);
     }
+
+    if(tokens[0].simplified().compare("MultiResolution", Qt::CaseInsensitive) == 0)
+    {
+      m_multiResolution = (tokens[1].simplified().compare("true", Qt::CaseInsensitive) == 0);
+    }
   }
 }
 
@@ -88,6 +100,7 @@ State VolumetricStreamReader::state() const
 
   state += StatePair("File", m_fileName.absoluteFilePath());
   state += StatePair("Streaming", (m_streaming ? "true" : "false"));
+  state += StatePair("MultiResolution", (m_multiResolution ? "true" : "false"));
 
   return state;
 }
@@ -108,6 +121,16 @@ void VolumetricStreamReader::setStreaming(bool value)
   }
 }
 
+//----------------------------------------------------------------------------
+void VolumetricStreamReader::setMultiResolution(bool value)
+{
+  if(value != m_multiResolution)
+  {
+    m_multiResolution = value;
+    m_changedStreaming = m_streaming;
+  }
+}
+
 //----------------------------------------------------------------------------
 bool VolumetricStreamReader::needUpdate() const
 {
@@ -209,7 +232,25 @@ void VolumetricStreamReader::execute()
       m_streamingFile = m_fileName;
     }
 
-    volume = std::make_shared<StreamedVolume<itkVolumeType>>(m_streamingFile);
+    // uncompressed files are mapped in memory, the rest are read using the tile cache.
+    auto streamed = std::make_shared<MappedVolume<itkVolumeType>>(m_streamingFile);
+
+    if(m_multiResolution)
+    {
+      try
+      {
+        auto reporter = [this](int value) { reportProgress(value); };
+
+        streamed->setLevels(VolumePyramid<itkVolumeType>::create(streamed.get(), levelsDirectory(), reporter));
+      }
+      catch(const EspinaException &e)
+      {
+        // the stack is still usable at full resolution.
+        qWarning() << "VolumetricStreamReader::execute() -> Couldn't create lower resolution levels:" << e.details();
+      }
+    }
+
+    volume = streamed;
   }
   else
   {
@@ -251,3 +292,14 @@ void VolumetricStreamReader::execute()
 
   reportProgress(100);
 }
+
+//----------------------------------------------------------------------------
+QDir VolumetricStreamReader::levelsDirectory() const
+{
+  QFileInfo directory{m_streamingFile.absolutePath()};
+
+  // levels are kept next to the stack to reuse them between sessions.
+  if(directory.isWritable()) return QDir{directory.absoluteFilePath()};
+
+  return QDir{storage()->absoluteFilePath("")};
+}
@@ -40,7 +40,8 @@ namespace ESPINA
     : public Filter
     {
       public:
-        static const QString STREAMING_OPTION; /** load options key. */
+        static const QString STREAMING_OPTION;       /** load options key. */
+        static const QString MULTIRESOLUTION_OPTION; /** load options key. */
 
         /** \brief VolumetricStreamReader class constructor.
          * \param[in] inputs list of input smart pointers.
@@ -77,6 +78,20 @@ namespace ESPINA
         bool streamingEnabled() const
         { return m_streaming; }
 
+        /** \brief Enables or disables the lower resolution levels of streamed stacks.
+         * \param[in] value true to build or reuse the lower resolution levels of the stack and false otherwise.
+         *
+         * Lower resolution levels are only used when the stack is streamed.
+         *
+         */
+        void setMultiResolution(bool value);
+
+        /** \brief Returns the state of the multi-resolution parameter.
+         *
+         */
+        bool multiResolutionEnabled() const
+        { return m_multiResolution; }
+
       protected:
         virtual Snapshot saveFilterSnapshot() const override
         { return Snapshot(); }
@@ -89,8 +104,14 @@ namespace ESPINA
         { return false; }
 
       private:
+        /** \brief Returns the directory of the lower resolution levels of the streamed stack.
+         *
+         */
+        QDir levelsDirectory() const;
+
         QFileInfo           m_fileName;         /** image file filename.                                                         */
         bool                m_streaming;        /** true if the stack is streamed from file, false for read all stack to memory. */
+        bool                m_multiResolution;  /** true to use lower resolution levels of the streamed stack.                   */
         TemporalStorageSPtr m_streamingStorage; /** storage for streaming data.                                                  */
         QFileInfo           m_streamingFile;    /** streaming image file info. Need one different for the one used by analysis.  */
         bool                m_changedStreaming; /** true if the streaming mode has changed and needs update, false otherwise.    */
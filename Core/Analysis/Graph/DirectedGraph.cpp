@@ -68,6 +68,7 @@ void DirectedGraph::add(Vertex vertex)
   VertexDescriptor vd = add_vertex(m_graph);
 
   m_graph[vd] = vertex;
+  m_descriptors.insert(vertex.get(), vd);
 }
 
 //-----------------------------------------------------------------------------
@@ -87,6 +88,13 @@ void DirectedGraph::remove(Vertex vertex)
 
   clear_vertex (vd, m_graph);
   remove_vertex(vd, m_graph);
+
+  // NOTE: vertices are stored in a vector, the descriptors after the removed one are shifted.
+  m_descriptors.remove(vertex.get());
+  for(auto i = vd; i < num_vertices(m_graph); ++i)
+  {
+    m_descriptors[m_graph[i].get()] = i;
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -323,11 +331,9 @@ DirectedGraph::VertexDescriptor DirectedGraph::descriptor(Vertex vertex) const
 //-----------------------------------------------------------------------------
 DirectedGraph::VertexDescriptor DirectedGraph::descriptor(VertexPtr vertex) const
 {
-  VertexIterator vi, vi_end;
-  for(tie(vi, vi_end) = boost::vertices(m_graph); vi != vi_end; ++vi)
-  {
-    if (m_graph[*vi].get() == vertex) return *vi;
-  }
+  auto it = m_descriptors.constFind(vertex);
+
+  if (it != m_descriptors.constEnd()) return it.value();
 
   auto what    = QObject::tr("Descriptor not found, vertex: %1").arg(vertex->name());
   auto details = QObject::tr("DirectedGraph::descriptor() -> Descriptor not found, vertex: %1").arg(vertex->name());
@@ -387,14 +393,20 @@ DirectedGraph::OutEdgeIterator DirectedGraph::findRelation(const VertexDescripto
 //-----------------------------------------------------------------------------
 bool DirectedGraph::contains_implementation(Vertex vertex) const
 {
+  return vertex && m_descriptors.contains(vertex.get());
+}
+
+//-----------------------------------------------------------------------------
+void DirectedGraph::rebuildIndex()
+{
+  m_descriptors.clear();
+  m_descriptors.reserve(num_vertices(m_graph));
+
   VertexIterator vi, vi_end;
   for(tie(vi, vi_end) = boost::vertices(m_graph); vi != vi_end; ++vi)
   {
-    if (m_graph[*vi] == vertex) return true;
+    if (m_graph[*vi]) m_descriptors.insert(m_graph[*vi].get(), *vi);
   }
-
-  return false;
-
 }
 
 //-----------------------------------------------------------------------------
@@ -403,6 +415,7 @@ void DirectedGraph::clear()
   QMutexLocker lock(&m_mutex);
 
   m_graph.clear();
+  m_descriptors.clear();
 }
 
 //-----------------------------------------------------------------------------
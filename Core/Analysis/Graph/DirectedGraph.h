@@ -34,6 +34,7 @@
 // Qt
 #include <QTextStream>
 #include <QMutex>
+#include <QHash>
 
 namespace ESPINA
 {
@@ -307,10 +308,17 @@ namespace ESPINA
        */
       bool existsRelation(const VertexDescriptor source, const VertexDescriptor destination, const QString &relation) const;
 
+      /** \brief Rebuilds the vertex to descriptor index from the graph vertices.
+       *
+       */
+      void rebuildIndex();
+
     private:
       mutable Graph  m_graph;
       mutable QMutex m_mutex;
 
+      QHash<VertexPtr, VertexDescriptor> m_descriptors; /** vertex to descriptor index, kept coherent with m_graph. */
+
      friend void IO::Graph::read(std::istream& stream, DirectedGraphSPtr graph, IO::Graph::PrintFormat format);
      friend void IO::Graph::write(const DirectedGraphSPtr graph, std::ostream& stream, IO::Graph::PrintFormat format);
   };
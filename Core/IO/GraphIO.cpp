@@ -174,6 +174,8 @@ void Graph::read(std::istream& stream, DirectedGraphSPtr graph, PrintFormat form
   if (format == PrintFormat::BOOST)
   {
     stream >> boost::read(graph->m_graph);
+
+    graph->rebuildIndex();
   }
 }
 
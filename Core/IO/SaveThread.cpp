@@ -36,12 +36,13 @@ using namespace ESPINA::IO;
 using namespace ESPINA::IO::SegFile;
 
 //-----------------------------------------------------------------------------
-SaveThread::SaveThread(SchedulerSPtr scheduler, AnalysisPtr analysis, const QFileInfo& file, ProgressReporterSPtr reporter, ErrorHandlerSPtr handler)
+SaveThread::SaveThread(SchedulerSPtr scheduler, AnalysisPtr analysis, const QFileInfo& file, ProgressReporterSPtr reporter, ErrorHandlerSPtr handler, const SaveMode mode)
 : Task      {scheduler}
 , m_analysis{analysis}
 , m_file    {file}
 , m_reporter{reporter}
 , m_handler {handler}
+, m_mode    {mode}
 , m_success {false}
 {
   setDescription(tr("Save session to file %1.").arg(file.fileName()));
@@ -58,7 +59,7 @@ void SaveThread::run()
 {
   try
   {
-    save(m_analysis, m_file, m_reporter.get(), m_handler);
+    save(m_analysis, m_file, m_reporter.get(), m_handler, m_mode);
     m_success = true;
   }
   catch(EspinaException &e)
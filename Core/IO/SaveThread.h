@@ -28,6 +28,7 @@
 #include <Core/Analysis/Analysis.h>
 #include <Core/IO/ErrorHandler.h>
 #include <Core/IO/ProgressReporter.h>
+#include <Core/IO/SegFile.h>
 #include <Core/Types.h>
 #include <Core/MultiTasking/Task.h>
 
@@ -55,12 +56,14 @@ namespace ESPINA
            * \param[in] file QFileInfo object with the file info.
            * \param[in] reporter progress reporter object.
            * \param[in] handler error handler smart pointer.
+           * \param[in] mode save mode.
            */
           SaveThread(SchedulerSPtr        scheduler,
                      AnalysisPtr          analysis,
                      const QFileInfo&     file,
                      ProgressReporterSPtr reporter = nullptr,
-                     ErrorHandlerSPtr     handler = ErrorHandlerSPtr());
+                     ErrorHandlerSPtr     handler = ErrorHandlerSPtr(),
+                     const SaveMode       mode = SaveMode::FULL);
 
           /** \brief SaveThread class virtual destructor.
            *
@@ -94,6 +97,7 @@ namespace ESPINA
           const QFileInfo      m_file;     /** info of the file on disk.  */
           ProgressReporterSPtr m_reporter; /** progress reporter object.  */
           ErrorHandlerSPtr     m_handler;  /** application error handler. */
+          const SaveMode       m_mode;     /** save mode.                 */
 
           bool              m_success;      /** true if the process succeeded, false otherwise. */
           QString           m_errorMessage; /** description of the error or empty if succeeded. */
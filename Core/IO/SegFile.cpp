@@ -33,6 +33,20 @@
 #include <quazip/quazip.h>
 #include <quazip/quazipfile.h>
 
+// Qt
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QMutex>
+
+// C++
+#include <cstdio>
+#ifdef __WIN64__
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace ESPINA;
 using namespace ESPINA::Core::Utils;
 using namespace ESPINA::IO;
@@ -64,7 +78,7 @@ AnalysisSPtr SegFile::load(const QFileInfo  &file,
   }
 
   SegFileLoaderSPtr loader;
-  if (!zip.setCurrentFile(SegFile_V5::FORMAT_INFO_FILE))
+  if (!zip.setCurrentFile(SegFile_V5::FORMAT_INFO_FILE) && !zip.setCurrentFile(SegFile_V5::CODEC_FORMAT_INFO_FILE))
   {
     if (!zip.setCurrentFile(SegFile_V4::FORMAT_INFO_FILE))
     {
@@ -113,11 +127,173 @@ private:
   QDir m_tmpDir;
 };
 
+//-----------------------------------------------------------------------------
+QDir temporalDirectory()
+{
+  QDir tmpDir = QDir::tempPath();
+  tmpDir.mkpath("espina");
+  tmpDir.cd("espina");
+
+  return tmpDir;
+}
+
+//-----------------------------------------------------------------------------
+void replaceFile(QFile &source, const QFileInfo &file)
+{
+  if (file.exists())
+  {
+    file.absoluteDir().remove(file.fileName());
+  }
+
+  if (!source.copy(file.absoluteFilePath()))
+  {
+    auto what    = QObject::tr("Can't copy file to path, file: %1, path: %2").arg(source.fileName()).arg(file.absoluteFilePath());
+    auto details = QObject::tr("SegFile::save() -> Can't copy file to path, file: %1, path: %2").arg(source.fileName()).arg(file.absoluteFilePath());
+
+    throw EspinaException(what, details);
+  }
+}
+
+namespace
+{
+  struct SavedFile
+  {
+    QDateTime                modified; /** modification time of the file after the save. */
+    qint64                   size;     /** size of the file after the save.              */
+    SegFile_V5::SavedFilters filters;  /** filters written to the file.                  */
+  };
+
+  QMap<QString, SavedFile> s_savedFiles;      /** files saved in this session, indexed by absolute path. */
+  QMutex                   s_savedFilesMutex; /** protects the saved files map.                          */
+
+  QAtomicInt s_volumeCodec{static_cast<int>(VolumeCodec::Type::DEFLATE)}; /** codec of the saved volumes. */
+
+  /** \brief Keeps the filters written to the given file, valid while the file isn't modified by others.
+   * \param[in] file saved file.
+   * \param[in] filters filters written to the file.
+   *
+   */
+  void registerSave(const QFileInfo &file, const SegFile_V5::SavedFilters &filters)
+  {
+    QFileInfo info{file.absoluteFilePath()};
+    info.refresh();
+
+    QMutexLocker lock(&s_savedFilesMutex);
+    s_savedFiles[info.absoluteFilePath()] = SavedFile{info.lastModified(), info.size(), filters};
+  }
+
+  /** \brief Returns the filters written to the given file by the last save, or none if it has been modified since.
+   * \param[in] file saved file.
+   *
+   */
+  SegFile_V5::SavedFilters savedFilters(const QFileInfo &file)
+  {
+    QFileInfo info{file.absoluteFilePath()};
+    info.refresh();
+
+    QMutexLocker lock(&s_savedFilesMutex);
+    auto saved = s_savedFiles.value(info.absoluteFilePath());
+
+    if (saved.modified == info.lastModified() && saved.size == info.size()) return saved.filters;
+
+    return SegFile_V5::SavedFilters();
+  }
+
+  /** \brief Flushes the given file to disk and moves it over the destination file in a single step, the
+   * destination keeps its previous contents if the operation is interrupted.
+   * \param[in] source file to move, in the same file system as the destination.
+   * \param[in] file destination file.
+   *
+   */
+  void replaceFileAtomically(QFile &source, const QFileInfo &file)
+  {
+    bool replaced = source.open(QIODevice::ReadWrite);
+
+    if (replaced)
+    {
+#ifdef __WIN64__
+      replaced = (::_commit(source.handle()) == 0);
+#else
+      replaced = (::fsync(source.handle()) == 0);
+#endif
+      source.close();
+    }
+
+    if (replaced)
+    {
+      const auto from = QDir::toNativeSeparators(source.fileName());
+      const auto to   = QDir::toNativeSeparators(file.absoluteFilePath());
+
+#ifdef __WIN64__
+      replaced = ::MoveFileExW(reinterpret_cast<LPCWSTR>(from.utf16()), reinterpret_cast<LPCWSTR>(to.utf16()),
+                               MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH);
+#else
+      replaced = (std::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0);
+#endif
+    }
+
+    if (!replaced)
+    {
+      auto what    = QObject::tr("Can't move file to path, file: %1, path: %2").arg(source.fileName()).arg(file.absoluteFilePath());
+      auto details = QObject::tr("SegFile::save() -> ") + what;
+
+      throw EspinaException(what, details);
+    }
+  }
+
+  /** \brief Rewrites an existing SEG file compressing only the changed entries of the analysis, the rest
+   * are copied as they are from the existing file. Returns false if the file can't be updated and must be
+   * completely rewritten.
+   * \param[in] analysis analysis to save.
+   * \param[in] file existing SEG file.
+   * \param[in] reporter progress reporter object.
+   * \param[in] handler error handler smart pointer.
+   *
+   */
+  bool saveIncremental(AnalysisPtr analysis, const QFileInfo &file, ProgressReporter *reporter, ErrorHandlerSPtr handler)
+  {
+    if (!file.exists()) return false;
+
+    QuaZip source(file.absoluteFilePath());
+    if (!source.open(QuaZip::mdUnzip)) return false;
+
+    // written next to the file to replace it with a rename, an interrupted save leaves the file untouched.
+    auto fileDir = file.absoluteDir();
+    TmpSegFile tmpFile(fileDir);
+    QuaZip zip(&(tmpFile.File));
+
+    if (!zip.open(QuaZip::mdCreate)) return false;
+
+    SegFile_V5 segFile(volumeCodec());
+    auto saved = segFile.saveIncremental(analysis, zip, source, savedFilters(file), reporter, handler);
+
+    zip.close();
+    source.close();
+
+    if (!saved) return false;
+
+    if (zip.getZipError() != UNZ_OK)
+    {
+      auto what    = QObject::tr("Can't close file inside ZIP container, file: %1, error code: %2").arg(tmpFile.File.fileName()).arg(zip.getZipError());
+      auto details = QObject::tr("SegFile::save() -> ") + what;
+
+      throw EspinaException(what, details);
+    }
+
+    replaceFileAtomically(tmpFile.File, file);
+
+    registerSave(file, segFile.savedFilters());
+
+    return true;
+  }
+}
+
 //-----------------------------------------------------------------------------
 void SegFile::save(AnalysisPtr analysis,
                    const QFileInfo& file,
                    ProgressReporter *reporter,
-                   ErrorHandlerSPtr handler)
+                   ErrorHandlerSPtr handler,
+                   const SaveMode mode)
 {
   if (file.baseName().isEmpty())
   {
@@ -132,9 +308,15 @@ void SegFile::save(AnalysisPtr analysis,
     throw EspinaException(what, details);
   }
 
-  QDir tmpDir = QDir::tempPath();
-  tmpDir.mkpath("espina");
-  tmpDir.cd("espina");
+  // sessions loaded lazily from the file being modified still need its contents.
+  for (auto storage : TemporalStorage::s_Storages)
+  {
+    storage->extractDeferredSnapshots(file.absoluteFilePath());
+  }
+
+  if (mode == SaveMode::INCREMENTAL && saveIncremental(analysis, file, reporter, handler)) return;
+
+  auto tmpDir = temporalDirectory();
 
   TmpSegFile tmpFile(tmpDir);
   QuaZip zip(&(tmpFile.File));
@@ -147,7 +329,7 @@ void SegFile::save(AnalysisPtr analysis,
     throw EspinaException(what, details);
   }
 
-  SegFile_V5 segFile;
+  SegFile_V5 segFile(volumeCodec());
  
   segFile.save(analysis, zip, reporter, handler);
 
@@ -161,16 +343,27 @@ void SegFile::save(AnalysisPtr analysis,
     throw EspinaException(what, details);
   }
 
-  if (file.exists())
-  {
-    file.absoluteDir().remove(file.fileName());
-  }
+  replaceFile(tmpFile.File, file);
+
+  registerSave(file, segFile.savedFilters());
+}
 
-  if (!tmpFile.File.copy(file.absoluteFilePath()))
+//-----------------------------------------------------------------------------
+void SegFile::setVolumeCodec(const VolumeCodec::Type codec)
+{
+  if (!VolumeCodec::isAvailable(codec))
   {
-    auto what    = QObject::tr("Can't copy file to path, file: %1, path: %2").arg(tmpFile.File.fileName()).arg(file.absoluteFilePath());
-    auto details = QObject::tr("SegFile::save() -> Can't copy file to path, file: %1, path: %2").arg(tmpFile.File.fileName()).arg(file.absoluteFilePath());
+    auto what    = QObject::tr("Volume codec not available in this build: %1").arg(VolumeCodec::name(codec));
+    auto details = QObject::tr("SegFile::setVolumeCodec() -> ") + what;
 
     throw EspinaException(what, details);
   }
+
+  s_volumeCodec.store(static_cast<int>(codec));
+}
+
+//-----------------------------------------------------------------------------
+VolumeCodec::Type SegFile::volumeCodec()
+{
+  return static_cast<VolumeCodec::Type>(s_volumeCodec.load());
 }
@@ -28,6 +28,7 @@
 #include "ErrorHandler.h"
 #include <Core/Analysis/Analysis.h>
 #include <Core/Factory/AnalysisReader.h>
+#include <Core/IO/VolumeCodec.h>
 
 // Qt
 #include <QMap>
@@ -42,6 +43,8 @@ namespace ESPINA
 
     namespace SegFile
     {
+      enum class SaveMode: char { FULL = 1, INCREMENTAL = 2 };
+
       /** \brief Loads an analysis from a file in disk.
        * \param[in] file QFileInfo object with the file info.
        * \param[in] factory factory smart pointer.
@@ -60,12 +63,28 @@ namespace ESPINA
        * \param[in] file QFileInfo object with the file info.
        * \param[in] reporter progress reporter object.
        * \param[in] handler error handler smart pointer.
+       * \param[in] mode FULL to rewrite the file, INCREMENTAL to compress only the changed entries of an
+       *            existing file and copy the rest as they are. In both cases the file is replaced once the
+       *            save completes.
        *
        */
       void EspinaCore_EXPORT save(AnalysisPtr       analysis,
                                   const QFileInfo&  file,
                                   ProgressReporter *reporter = nullptr,
-                                  ErrorHandlerSPtr  handler  = ErrorHandlerSPtr());
+                                  ErrorHandlerSPtr  handler  = ErrorHandlerSPtr(),
+                                  const SaveMode    mode     = SaveMode::FULL);
+
+      /** \brief Sets the codec of the volumetric data of the saved SEG files. Throws an exception if the
+       * codec isn't available in this build.
+       * \param[in] codec codec type.
+       *
+       */
+      void EspinaCore_EXPORT setVolumeCodec(const VolumeCodec::Type codec);
+
+      /** \brief Returns the codec of the volumetric data of the saved SEG files.
+       *
+       */
+      VolumeCodec::Type EspinaCore_EXPORT volumeCodec();
     }
   }
 }
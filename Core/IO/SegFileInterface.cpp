@@ -41,11 +41,12 @@ using namespace ESPINA::IO::SegFile;
 void SegFileInterface::addFileToZip(const QString    &fileName,
                                     const QByteArray &content,
                                     QuaZip           &zip,
-                                    ErrorHandlerSPtr  handler)
+                                    ErrorHandlerSPtr  handler,
+                                    const bool        compress)
 {
   try
   {
-    ZipUtils::AddFileToZip(fileName, content, zip);
+    ZipUtils::AddFileToZip(fileName, content, zip, compress);
   }
   catch(EspinaException &e)
   {
@@ -82,12 +82,14 @@ namespace ESPINA
          * \param[in] content content of the file.
          * \param[in] zip QuaZip handler.
          * \param[in] handler error handler smart pointer.
+         * \param[in] compress true to deflate the content and false to store it as is.
          *
          */
         static void addFileToZip(const QString&    fileName,
                                  const QByteArray& content,
                                  QuaZip&           zip,
-                                 ErrorHandlerSPtr  handler = ErrorHandlerSPtr());
+                                 ErrorHandlerSPtr  handler  = ErrorHandlerSPtr(),
+                                 const bool        compress = true);
 
         /** \brief Reads a file from a QuaZip file.
          * \param[in] fileName file name to read.
@@ -277,6 +277,10 @@ ChannelSPtr SegFile_V4::Loader::createChannel(DirectedGraph::Vertex roVertex)
     {
       reader->setStreaming(m_options.value(VolumetricStreamReader::STREAMING_OPTION).toBool() == true);
     }
+    if(m_options.contains(VolumetricStreamReader::MULTIRESOLUTION_OPTION))
+    {
+      reader->setMultiResolution(m_options.value(VolumetricStreamReader::MULTIRESOLUTION_OPTION).toBool() == true);
+    }
   }
   filter->update(); // Existing outputs weren't stored in previous versions
 
@@ -40,12 +40,21 @@
 #include <Core/Analysis/Filters/SourceFilter.h>
 #include <Core/Factory/CoreFactory.h>
 #include <Core/IO/DataFactory/RawDataFactory.h>
+#include <Core/IO/VolumeCodec.h>
+#include <Core/IO/ZipUtils.h>
 #include <Core/Utils/TemporalStorage.h>
 #include <Core/Utils/EspinaException.h>
 #include <Core/Utils/QStringUtils.h>
 
+// QuaZip
+#include <quazip/quazipfilepos.h>
+#include <zlib.h>
+
 // Qt
 #include <QDataStream>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 using namespace ESPINA;
 using namespace ESPINA::Core;
@@ -54,15 +63,19 @@ using namespace ESPINA::IO;
 using namespace ESPINA::IO::SegFile;
 using namespace ESPINA::IO::Graph;
 
-const QString SegFile::SegFile_V5::FORMAT_INFO_FILE = "formatInfo.ini";
+const QString SegFile::SegFile_V5::FORMAT_INFO_FILE       = "formatInfo.ini";
+const QString SegFile::SegFile_V5::CODEC_FORMAT_INFO_FILE = "codecFormatInfo.ini";
+const QString SegFile::SegFile_V5::LAZY_LOADING_OPTION    = "Lazy loading";
 
 const QString CONTENT_FILE        = "content.dot";
 const QString RELATIONS_FILE      = "relations.dot";
 const QString CLASSIFICATION_FILE = "classification.xml";
 const QString CONNECTIONS_FILE    = ConnectionStorage::connectionsFileName();
 const QString CURRENT_SEG_FILE_VERSION = "6";
+const QString CODEC_SEG_FILE_VERSION   = "7";
 
 const int FIX_SOURCE_INPUTS_SEG_FILE_VERSION = 5;
+const int LAST_SEG_FILE_VERSION              = 7;
 
 const unsigned CLASSIFICATION_PROGRESS =  5;
 const unsigned SNAPSHOT_PROGRESS       = 20;
@@ -73,21 +86,40 @@ const float SNAPSHOT_PROGRESS_CHUNK  = SNAPSHOT_PROGRESS  - CLASSIFICATION_PROGR
 const float CONTENT_PROGRESS_CHUNK   = CONTENT_PROGRESS   - SNAPSHOT_PROGRESS;
 const float RELATIONS_PROGRESS_CHUNK = RELATIONS_PROGRESS - CONTENT_PROGRESS;
 
+const unsigned SAVE_ITEMS_PROGRESS   = 80;
+const unsigned SAVE_STORAGE_PROGRESS = 95;
+
 const QString SEG_FILE_VERSION = "SegFile Version";
 
 //-----------------------------------------------------------------------------
-QByteArray formatInfo()
+QByteArray formatInfo(const VolumeCodec::Type codec)
 {
   QByteArray info;
 
   QTextStream infoStream(&info);
 
-  infoStream << QString("%1=%2").arg(SEG_FILE_VERSION).arg(CURRENT_SEG_FILE_VERSION) << endl;
+  // files without codec are deflated by the zip container and can be opened by previous versions.
+  const bool encoded = (codec != VolumeCodec::Type::DEFLATE);
+
+  infoStream << QString("%1=%2").arg(SEG_FILE_VERSION).arg(encoded ? CODEC_SEG_FILE_VERSION : CURRENT_SEG_FILE_VERSION) << endl;
   infoStream << QString("ESPINA Version=%1").arg(ESPINA_VERSION) << endl;
 
+  if (encoded)
+  {
+    infoStream << QString("%1=%2").arg(VolumeCodec::FORMAT_INFO_KEY).arg(VolumeCodec::name(codec)) << endl;
+  }
+
   return info;
 }
 
+//-----------------------------------------------------------------------------
+QString formatInfoFile(const VolumeCodec::Type codec)
+{
+  // previous versions don't know the codec format info file and refuse to open the file instead of reading
+  // the encoded volumes as raw data.
+  return codec == VolumeCodec::Type::DEFLATE ? SegFile_V5::FORMAT_INFO_FILE : SegFile_V5::CODEC_FORMAT_INFO_FILE;
+}
+
 //-----------------------------------------------------------------------------
 int segFileVersion(const QString &info)
 {
@@ -100,6 +132,64 @@ int segFileVersion(const QString &info)
   return info.mid(start, n).toInt();
 }
 
+//-----------------------------------------------------------------------------
+VolumeCodec::Type volumeCodec(const QString &info)
+{
+  for (auto line : info.split('\n', QString::SkipEmptyParts))
+  {
+    auto separator = line.indexOf('=');
+
+    if (separator != -1 && line.left(separator).trimmed() == VolumeCodec::FORMAT_INFO_KEY)
+    {
+      return VolumeCodec::type(line.mid(separator + 1));
+    }
+  }
+
+  return VolumeCodec::Type::DEFLATE;
+}
+
+//-----------------------------------------------------------------------------
+QByteArray decodeEntry(const QString &fileName, const QByteArray &content, const VolumeCodec::Type codec)
+{
+  if (codec == VolumeCodec::Type::DEFLATE || !VolumeCodec::isVolumeData(fileName)) return content;
+
+  return VolumeCodec::decode(content, codec);
+}
+
+//-----------------------------------------------------------------------------
+bool isSameContent(const ZipUtils::Entry &entry, const QByteArray &content)
+{
+  if (entry.size != content.size()) return false;
+
+  auto crc = crc32(0L, Z_NULL, 0);
+  crc = crc32(crc, reinterpret_cast<const Bytef *>(content.constData()), content.size());
+
+  return entry.crc == crc;
+}
+
+//-----------------------------------------------------------------------------
+QString filterSignature(Filter *filter)
+{
+  QStringList signature;
+
+  for (auto output : filter->outputs())
+  {
+    signature << QString("%1:%2").arg(output->id()).arg(output->lastModified());
+  }
+
+  // outputs data is only saved for segmentation outputs.
+  auto analysis = filter->analysis();
+  if (analysis)
+  {
+    for (auto edge : analysis->content()->outEdges(filter))
+    {
+      signature << QString("%1>%2").arg(edge.relationship.c_str()).arg(edge.target->uuid().toString());
+    }
+  }
+
+  return signature.join(";");
+}
+
 //-----------------------------------------------------------------------------
 SegFile_V5::Loader::Loader(QuaZip           &zip,
                            CoreFactorySPtr  factory,
@@ -113,6 +203,7 @@ SegFile_V5::Loader::Loader(QuaZip           &zip,
 , m_options        {options}
 , m_analysis       {new Analysis()}
 , m_dataFactory    {new RawDataFactory()}
+, m_codec          {VolumeCodec::Type::DEFLATE}
 , m_fixSourceInputs{false}
 {
 }
@@ -124,7 +215,45 @@ AnalysisSPtr SegFile_V5::Loader::load()
 
   m_storage = m_factory->createTemporalStorage();
 
-  if (!m_zip.setCurrentFile(CLASSIFICATION_FILE))
+  // the central directory is read once, the entries are accessed by their position.
+  m_index = ZipUtils::indexZip(m_zip);
+
+  const auto infoFile = m_index.contains(CODEC_FORMAT_INFO_FILE) ? CODEC_FORMAT_INFO_FILE : FORMAT_INFO_FILE;
+
+  if (m_index.contains(infoFile))
+  {
+    const QString info = readFile(infoFile);
+    const auto version = segFileVersion(info);
+
+    if (version > LAST_SEG_FILE_VERSION)
+    {
+      if (m_handler)
+      {
+        m_handler->error(QObject::tr("The file was saved by a newer version of ESPINA"));
+      }
+
+      auto what    = QObject::tr("Unsupported SEG file version: %1").arg(version);
+      auto details = QObject::tr("SegFile_V5::load() -> ") + what;
+      throw EspinaException(what, details);
+    }
+
+    m_fixSourceInputs = version <= FIX_SOURCE_INPUTS_SEG_FILE_VERSION;
+    m_codec           = volumeCodec(info);
+
+    if (!VolumeCodec::isAvailable(m_codec))
+    {
+      if (m_handler)
+      {
+        m_handler->error(QObject::tr("The volumes of the file use the %1 codec, not supported by this ESPINA build").arg(VolumeCodec::name(m_codec)));
+      }
+
+      auto what    = QObject::tr("Volume codec not available in this build: %1").arg(VolumeCodec::name(m_codec));
+      auto details = QObject::tr("SegFile_V5::load() -> ") + what;
+      throw EspinaException(what, details);
+    }
+  }
+
+  if (!m_index.contains(CLASSIFICATION_FILE))
   {
     if (m_handler)
     {
@@ -138,7 +267,7 @@ AnalysisSPtr SegFile_V5::Loader::load()
 
   try
   {
-    auto currentFile    = SegFileInterface::readCurrentFileFromZip(m_zip, m_handler);
+    auto currentFile    = readFile(CLASSIFICATION_FILE);
     auto classification = ClassificationXML::parse(currentFile, m_handler);
     m_analysis->setClassification(classification);
   }
@@ -154,51 +283,193 @@ AnalysisSPtr SegFile_V5::Loader::load()
 
   reportProgress(CLASSIFICATION_PROGRESS);
 
+  if(m_options.value(LAZY_LOADING_OPTION, false).toBool() && !m_zip.getZipName().isEmpty())
+  {
+    loadSnapshotsInParallel();
+  }
+  else
+  {
+    loadSnapshots();
+  }
+
+  loadContent();
+
+  loadRelations();
+
+  m_analysis->setStorage(m_storage);
+
+  loadConnections();
+
+  reportProgress(100);
+
+  return m_analysis;
+}
+
+//-----------------------------------------------------------------------------
+void SegFile_V5::Loader::loadSnapshots()
+{
   unsigned long i = 0;
-  const unsigned long total = m_zip.getFileNameList().size();
+  const unsigned long total = m_index.size();
 
-  bool hasFile = m_zip.goToFirstFile();
-  while (hasFile)
+  for (auto entry : m_index)
   {
-    QString file = m_zip.getCurrentFileName();
-
-    if (file == FORMAT_INFO_FILE)
+    if (isSnapshot(entry.name))
     {
-      auto info = SegFileInterface::readCurrentFileFromZip(m_zip, m_handler);
-      if (segFileVersion(info) <= FIX_SOURCE_INPUTS_SEG_FILE_VERSION)
+      if (!m_zip.setCurrentFilePosition(entry.position))
       {
-        m_fixSourceInputs = true;
+        auto what    = QObject::tr("Couldn't find a file inside a ZIP container, file: %1, error code: %2").arg(entry.name).arg(m_zip.getZipError());
+        auto details = QObject::tr("SegFile_V5::Loader::loadSnapshots() -> ") + what;
+        throw EspinaException(what, details);
       }
+
+      auto currentFile = decodeEntry(entry.name, SegFileInterface::readCurrentFileFromZip(m_zip, m_handler), m_codec);
+
+      // FIX: Windows doesn't allow some characters in filenames that Linux does and were used in previous versions.
+      auto file = QString{entry.name}.replace(">", "_"); // TabularReport save key information file.
+
+      m_storage->saveSnapshot(SnapshotData(file, currentFile));
     }
-    else
+
+    reportProgress(CLASSIFICATION_PROGRESS + (SNAPSHOT_PROGRESS_CHUNK*(++i)/total));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void SegFile_V5::Loader::loadSnapshotsInParallel()
+{
+  struct Chunk
+  {
+    QList<ZipUtils::Entry> entries; /** entries to decompress.            */
+    QString                error;   /** error message, empty on success. */
+  };
+
+  const auto zipName = QFileInfo{m_zip.getZipName()}.absoluteFilePath();
+  const auto codec   = m_codec;
+
+  QList<ZipUtils::Entry> entries;
+
+  for (auto entry : m_index)
+  {
+    if (!isSnapshot(entry.name)) continue;
+
+    // FIX: Windows doesn't allow some characters in filenames that Linux does and were used in previous versions.
+    entry.name = entry.name.replace(">", "_"); // TabularReport save key information file.
+
+    if (isDeferrable(entry.name))
     {
-      if (file != CLASSIFICATION_FILE && file != CONTENT_FILE && file != RELATIONS_FILE)
+      auto position = entry.position;
+      auto name     = entry.name;
+
+      m_storage->deferSnapshot(entry.name, zipName, [zipName, position, name, codec]()
       {
-        auto currentFile = SegFileInterface::readCurrentFileFromZip(m_zip, m_handler);
+        QByteArray contents;
 
-        // FIX: Windows doesn't allow some characters in filenames that Linux does and were used in previous versions.
-        file = file.replace(">", "_"); // TabularReport save key information file.
+        QuaZip zip(zipName);
+        if (zip.open(QuaZip::mdUnzip) && zip.setCurrentFilePosition(position))
+        {
+          contents = decodeEntry(name, ZipUtils::readCurrentFileFromZip(zip), codec);
+        }
 
-        m_storage->saveSnapshot(SnapshotData(file, currentFile));
+        return contents;
+      });
+    }
+    else
+    {
+      entries << entry;
+    }
+  }
+
+  // entries are distributed in turns to balance the work, each chunk uses its own zip handler.
+  QVector<Chunk> chunks(std::max(1, std::min(QThread::idealThreadCount(), entries.size())));
+  for (int i = 0; i < entries.size(); ++i)
+  {
+    chunks[i % chunks.size()].entries << entries.at(i);
+  }
+
+  auto storage = m_storage;
+  auto decompress = [&zipName, codec, storage](Chunk &chunk)
+  {
+    if (chunk.entries.isEmpty()) return;
+
+    QuaZip zip(zipName);
+    if (!zip.open(QuaZip::mdUnzip))
+    {
+      chunk.error = QObject::tr("Can't open ZIP container, file: %1, error code: %2").arg(zipName).arg(zip.getZipError());
+      return;
+    }
+
+    for (auto &entry: chunk.entries)
+    {
+      if (!zip.setCurrentFilePosition(entry.position))
+      {
+        chunk.error = QObject::tr("Couldn't find a file inside a ZIP container, file: %1, error code: %2").arg(entry.name).arg(zip.getZipError());
+        return;
+      }
+
+      try
+      {
+        storage->saveSnapshot(SnapshotData(entry.name, decodeEntry(entry.name, ZipUtils::readCurrentFileFromZip(zip), codec)));
+      }
+      catch (const EspinaException &e)
+      {
+        chunk.error = QString(e.what());
+        return;
       }
     }
+  };
 
-    hasFile = m_zip.goToNextFile();
+  QtConcurrent::blockingMap(chunks, decompress);
 
-    reportProgress(CLASSIFICATION_PROGRESS + (SNAPSHOT_PROGRESS_CHUNK*(++i)/total));
+  for (auto &chunk: chunks)
+  {
+    if (!chunk.error.isEmpty())
+    {
+      if (m_handler)
+      {
+        m_handler->error(QObject::tr("Couldn't extract the contents of the seg file"));
+      }
+
+      auto what    = QObject::tr("Couldn't extract the contents of the seg file: %1").arg(chunk.error);
+      auto details = QObject::tr("SegFile_V5::Loader::loadSnapshotsInParallel() -> ") + what;
+
+      throw EspinaException(what, details);
+    }
   }
 
-  loadContent();
+  reportProgress(SNAPSHOT_PROGRESS);
+}
 
-  loadRelations();
+//-----------------------------------------------------------------------------
+bool SegFile_V5::Loader::isSnapshot(const QString &fileName) const
+{
+  return fileName != FORMAT_INFO_FILE && fileName != CODEC_FORMAT_INFO_FILE &&
+         fileName != CLASSIFICATION_FILE && fileName != CONTENT_FILE &&
+         fileName != RELATIONS_FILE;
+}
 
-  m_analysis->setStorage(m_storage);
+//-----------------------------------------------------------------------------
+QByteArray SegFile_V5::Loader::readFile(const QString &fileName)
+{
+  if (!m_index.contains(fileName) || !m_zip.setCurrentFilePosition(m_index[fileName].position))
+  {
+    if (m_handler)
+    {
+      m_handler->error(QObject::tr("Could not find %1 in seg file").arg(fileName));
+    }
 
-  loadConnections();
+    auto what    = QObject::tr("Couldn't find a file inside a ZIP container, file: %1").arg(fileName);
+    auto details = QObject::tr("SegFile_V5::Loader::readFile() -> ") + what;
+    throw EspinaException(what, details);
+  }
 
-  reportProgress(100);
+  return SegFileInterface::readCurrentFileFromZip(m_zip, m_handler);
+}
 
-  return m_analysis;
+//-----------------------------------------------------------------------------
+bool SegFile_V5::Loader::isDeferrable(const QString &fileName)
+{
+  // filter outputs descriptions are small and read on filter restoration, only their data is deferred.
+  return fileName.startsWith("Filters/") && !fileName.endsWith(".xml", Qt::CaseInsensitive);
 }
 
 //-----------------------------------------------------------------------------
@@ -303,6 +574,10 @@ FilterSPtr SegFile_V5::Loader::createFilter(DirectedGraph::Vertex roVertex)
     {
       reader->setStreaming(m_options.value(VolumetricStreamReader::STREAMING_OPTION).toBool() == true);
     }
+    if(m_options.contains(VolumetricStreamReader::MULTIRESOLUTION_OPTION))
+    {
+      reader->setMultiResolution(m_options.value(VolumetricStreamReader::MULTIRESOLUTION_OPTION).toBool() == true);
+    }
   }
   filter->setStorage(m_storage);
   filter->restorePreviousOutputs();
@@ -499,7 +774,7 @@ void SegFile_V5::Loader::loadContent()
 {
   m_content = std::make_shared<DirectedGraph>();
 
-  QTextStream textStream(readFileFromZip(CONTENT_FILE, m_zip, m_handler));
+  QTextStream textStream(readFile(CONTENT_FILE));
 
   std::istringstream stream(textStream.readAll().toStdString().c_str());
   read(stream, m_content);
@@ -543,7 +818,7 @@ void SegFile_V5::Loader::loadRelations()
 {
   auto relations = std::make_shared<DirectedGraph>();
 
-  QTextStream textStream(readFileFromZip(RELATIONS_FILE, m_zip, m_handler));
+  QTextStream textStream(readFile(RELATIONS_FILE));
 
   std::istringstream stream(textStream.readAll().toStdString().c_str());
   read(stream, relations);
@@ -765,7 +1040,8 @@ void SegFile_V5::Loader::reportProgress(unsigned int currentProgress)
 }
 
 //-----------------------------------------------------------------------------
-SegFile_V5::SegFile_V5()
+SegFile_V5::SegFile_V5(const VolumeCodec::Type codec)
+: m_codec{codec}
 {
 }
 
@@ -787,132 +1063,139 @@ void SegFile_V5::save(AnalysisPtr analysis,
                       ProgressReporter *reporter,
                       ErrorHandlerSPtr handler)
 {
-  if (reporter)
-  {
-    reporter->setProgress(0);
-  }
-
-  try
-  {
-    addFileToZip(FORMAT_INFO_FILE, formatInfo(), zip, handler);
-  }
-  catch (const EspinaException &e)
-  {
-    if (handler)
-    {
-      handler->error("Error while saving Analysis Format Information.");
-    }
+  saveEntries(analysis, zip, nullptr, ZipUtils::Index(), SavedFilters(), reporter, handler);
+}
 
-    throw (e);
-  }
+//-----------------------------------------------------------------------------
+bool SegFile_V5::saveIncremental(AnalysisPtr         analysis,
+                                 QuaZip&             zip,
+                                 QuaZip&             source,
+                                 const SavedFilters &previous,
+                                 ProgressReporter   *reporter,
+                                 ErrorHandlerSPtr    handler)
+{
+  ZipUtils::Index index;
 
-  QByteArray classification;
   try
   {
-    classification = ClassificationXML::dump(analysis->classification(), handler);
+    index = ZipUtils::indexZip(source);
   }
-  catch (const EspinaException &e)
+  catch (const EspinaException &)
   {
-    if (handler)
-    {
-      handler->error("Error while dumping Analysis classification to byte array.");
-    }
-
-    throw(e);
+    return false;
   }
 
-  try
-  {
-    addFileToZip(CLASSIFICATION_FILE, classification, zip, handler);
-  }
-  catch (const EspinaException &e)
-  {
-    if (handler)
-    {
-      handler->error("Error while saving Analysis classification.");
-    }
+  // only files written by the same format, codec and ESPINA version can be updated.
+  auto info     = formatInfo(m_codec);
+  auto infoFile = formatInfoFile(m_codec);
+  if (!index.contains(infoFile) || !isSameContent(index[infoFile], info)) return false;
 
-    throw(e);
-  }
+  saveEntries(analysis, zip, &source, index, previous, reporter, handler);
 
-  if (reporter)
-  {
-    reporter->setProgress(CLASSIFICATION_PROGRESS);
-  }
+  return true;
+}
 
-  auto storage = analysis->storage();
+//-----------------------------------------------------------------------------
+void SegFile_V5::saveEntries(AnalysisPtr             analysis,
+                             QuaZip&                 zip,
+                             QuaZip                 *source,
+                             const ZipUtils::Index  &index,
+                             const SavedFilters     &previous,
+                             ProgressReporter       *reporter,
+                             ErrorHandlerSPtr        handler)
+{
+  m_savedFilters.clear();
 
-  if(analysis->saveConnections())
+  const auto codec = m_codec;
+
+  auto addFile = [&zip, &handler, source, &index, codec](const QString &fileName, const QByteArray &content)
   {
-    try
-    {
-      addFileToZip(CONNECTIONS_FILE, storage->snapshot(CONNECTIONS_FILE), zip, handler);
-    }
-    catch(const EspinaException &e)
-    {
-      if (handler)
-      {
-        handler->error("Error while saving connections data.");
-      }
+    // encoded volumes are stored as is, deflating them again only costs time.
+    const bool encode = (codec != VolumeCodec::Type::DEFLATE) && VolumeCodec::isVolumeData(fileName);
+    const auto data   = encode ? VolumeCodec::encode(content, codec) : content;
 
-      throw (e);
+    if (source && index.contains(fileName) && isSameContent(index[fileName], data))
+    {
+      ZipUtils::copyRawFileToZip(index[fileName], *source, zip);
     }
-  }
-
-  std::ostringstream content;
-  write(analysis->content(), content);
-  try
-  {
-    addFileToZip(CONTENT_FILE, content.str().c_str(), zip, handler);
-  }
-  catch (const EspinaException &e)
-  {
-    if (handler)
+    else
     {
-      handler->error("Error while saving analysis content graph.");
+      addFileToZip(fileName, data, zip, handler, !encode);
     }
-
-    throw (e);
-  }
+  };
 
   if (reporter)
   {
-    reporter->setProgress(40);
+    reporter->setProgress(0);
   }
 
-  std::ostringstream relations;
-  write(analysis->relationships(), relations);
   try
   {
-    addFileToZip(RELATIONS_FILE, relations.str().c_str(), zip, handler);
+    addFile(formatInfoFile(m_codec), formatInfo(m_codec));
   }
   catch (const EspinaException &e)
   {
     if (handler)
     {
-      handler->error("Error while saving analysis relationships graph.");
+      handler->error("Error while saving Analysis Format Information.");
     }
 
     throw (e);
   }
 
-  if (reporter)
-  {
-    reporter->setProgress(60);
-  }
-
   int i = 0;
   int total = analysis->content()->vertices().size();
 
   for(auto v : analysis->content()->vertices())
   {
     PersistentPtr item = dynamic_cast<PersistentPtr>(v.get());
+    auto filter = dynamic_cast<Filter *>(item);
 
     try
     {
-      for(auto data : item->snapshot())
+      if (filter)
       {
-        addFileToZip(data.first, data.second, zip, handler);
+        auto uuid      = filter->uuid().toString();
+        auto signature = filterSignature(filter);
+
+        SavedFilter saved;
+        saved.signature = signature;
+
+        auto unchanged = source && previous.contains(uuid) && previous[uuid].signature == signature;
+        if (unchanged)
+        {
+          for (auto entry : previous[uuid].entries)
+          {
+            unchanged &= index.contains(entry);
+          }
+        }
+
+        if (unchanged)
+        {
+          saved.entries = previous[uuid].entries;
+
+          for (auto entry : saved.entries)
+          {
+            ZipUtils::copyRawFileToZip(index[entry], *source, zip);
+          }
+        }
+        else
+        {
+          for(auto data : item->snapshot())
+          {
+            addFile(data.first, data.second);
+            saved.entries << data.first;
+          }
+        }
+
+        m_savedFilters.insert(uuid, saved);
+      }
+      else
+      {
+        for(auto data : item->snapshot())
+        {
+          addFile(data.first, data.second);
+        }
       }
     }
     catch (const EspinaException &e)
@@ -927,13 +1210,14 @@ void SegFile_V5::save(AnalysisPtr analysis,
 
     if (reporter)
     {
-      reporter->setProgress(60 + 20*(++i)/total);
+      reporter->setProgress(SAVE_ITEMS_PROGRESS*(++i)/total);
     }
   }
 
+  auto storage = analysis->storage();
+
   if(storage != nullptr)
   {
-
     Snapshot files;
     files << storage->snapshots(QString("Extra"), TemporalStorage::Mode::RECURSIVE);
     files << storage->snapshots(QString("Settings"), TemporalStorage::Mode::RECURSIVE);
@@ -945,7 +1229,7 @@ void SegFile_V5::save(AnalysisPtr analysis,
     {
       try
       {
-        addFileToZip(data.first, data.second, zip, handler);
+        addFile(data.first, data.second);
       }
       catch (const EspinaException &e)
       {
@@ -959,11 +1243,89 @@ void SegFile_V5::save(AnalysisPtr analysis,
 
       if (reporter)
       {
-        reporter->setProgress(80 + 20*(++i)/total);
+        reporter->setProgress(SAVE_ITEMS_PROGRESS + (SAVE_STORAGE_PROGRESS - SAVE_ITEMS_PROGRESS)*(++i)/total);
       }
     }
   }
 
+  if(analysis->saveConnections())
+  {
+    try
+    {
+      addFile(CONNECTIONS_FILE, storage->snapshot(CONNECTIONS_FILE));
+    }
+    catch(const EspinaException &e)
+    {
+      if (handler)
+      {
+        handler->error("Error while saving connections data.");
+      }
+
+      throw (e);
+    }
+  }
+
+  QByteArray classification;
+  try
+  {
+    classification = ClassificationXML::dump(analysis->classification(), handler);
+  }
+  catch (const EspinaException &e)
+  {
+    if (handler)
+    {
+      handler->error("Error while dumping Analysis classification to byte array.");
+    }
+
+    throw(e);
+  }
+
+  try
+  {
+    addFile(CLASSIFICATION_FILE, classification);
+  }
+  catch (const EspinaException &e)
+  {
+    if (handler)
+    {
+      handler->error("Error while saving Analysis classification.");
+    }
+
+    throw(e);
+  }
+
+  std::ostringstream content;
+  write(analysis->content(), content);
+  try
+  {
+    addFile(CONTENT_FILE, content.str().c_str());
+  }
+  catch (const EspinaException &e)
+  {
+    if (handler)
+    {
+      handler->error("Error while saving analysis content graph.");
+    }
+
+    throw (e);
+  }
+
+  std::ostringstream relations;
+  write(analysis->relationships(), relations);
+  try
+  {
+    addFile(RELATIONS_FILE, relations.str().c_str());
+  }
+  catch (const EspinaException &e)
+  {
+    if (handler)
+    {
+      handler->error("Error while saving analysis relationships graph.");
+    }
+
+    throw (e);
+  }
+
   if (reporter)
   {
     reporter->setProgress(100);
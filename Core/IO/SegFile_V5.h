@@ -26,11 +26,16 @@
 
 // ESPINA
 #include <Core/IO/SegFileInterface.h>
+#include <Core/IO/VolumeCodec.h>
+#include <Core/IO/ZipUtils.h>
 #include <Core/Utils/TemporalStorage.h>
 #include <Core/Analysis/Output.h>
 #include <Core/Analysis/DataFactory.h>
 #include <Core/Analysis/Extensions.h>
 
+// Qt
+#include <QSet>
+
 namespace ESPINA
 {
   namespace IO
@@ -70,6 +75,35 @@ namespace ESPINA
             AnalysisSPtr load();
 
           private:
+            /** \brief Decompresses the SEG file entries into the temporal storage one by one.
+             *
+             */
+            void loadSnapshots();
+
+            /** \brief Reads the SEG file central directory once, decompresses the entries into the temporal
+             * storage in parallel and defers the decompression of the filters data until it's first fetched.
+             *
+             */
+            void loadSnapshotsInParallel();
+
+            /** \brief Returns true if the decompression of the given SEG file entry can be deferred.
+             * \param[in] fileName name of the entry.
+             *
+             */
+            static bool isDeferrable(const QString &fileName);
+
+            /** \brief Returns true if the given SEG file entry must be extracted to the temporal storage.
+             * \param[in] fileName name of the entry.
+             *
+             */
+            bool isSnapshot(const QString &fileName) const;
+
+            /** \brief Returns the contents of the last SEG file entry with the given name.
+             * \param[in] fileName name of the entry.
+             *
+             */
+            QByteArray readFile(const QString &fileName);
+
             /** \brief Finds and returns the vertex that match the uuid.
              * \param[in] vertices, directed graph vertices group.
              * \param[in] uuid, unique id.
@@ -191,6 +225,8 @@ namespace ESPINA
             DataFactorySPtr         m_dataFactory;    /** data factory.                       */
             DirectedGraphSPtr       m_content;        /** content graph.                      */
             DirectedGraph::Vertices m_loadedVertices; /** loaded vertices from content graph. */
+            ZipUtils::Index         m_index;          /** entries of the SEG file.            */
+            VolumeCodec::Type       m_codec;          /** codec of the volumetric data.       */
 
             bool m_fixSourceInputs;
             ChannelSPtr m_sourceInput;
@@ -198,12 +234,23 @@ namespace ESPINA
 
       public:
         static const QString FORMAT_INFO_FILE;
+        static const QString CODEC_FORMAT_INFO_FILE; /** format info of the files with encoded volumes, unknown to previous versions. */
+        static const QString LAZY_LOADING_OPTION;    /** load options key.                                                          */
+
+        struct SavedFilter
+        {
+          QString     signature; /** modification signature of the filter outputs. */
+          QStringList entries;   /** SEG file entries written by the filter.        */
+        };
+
+        using SavedFilters = QMap<QString, SavedFilter>; /** saved filters indexed by uuid. */
 
       public:
         /** \brief SegFile_V5 class constructor.
+         * \param[in] codec codec of the volumetric data of saved files, loaded files use the one in their format info.
          *
          */
-        SegFile_V5();
+        explicit SegFile_V5(const VolumeCodec::Type codec = VolumeCodec::Type::DEFLATE);
 
         virtual AnalysisSPtr load(QuaZip&           zip,
                                   CoreFactorySPtr   factory  = CoreFactorySPtr(),
@@ -215,6 +262,54 @@ namespace ESPINA
                           QuaZip&          zip,
                           ProgressReporter *reporter = nullptr,
                           ErrorHandlerSPtr handler = ErrorHandlerSPtr());
+
+        /** \brief Writes the analysis to a SEG file compressing only the entries that differ from the ones of
+         * a previous version of the file, the rest are copied from it without decompressing them. Returns
+         * false if the previous file was written by a different format, codec or ESPINA version.
+         * \param[in] analysis analysis to save.
+         * \param[in] zip SEG file opened for writing.
+         * \param[in] source previous version of the SEG file opened for reading.
+         * \param[in] previous filters written by the last save of the previous file, the ones with the same
+         *            signature aren't snapshotted again.
+         * \param[in] reporter progress reporter object.
+         * \param[in] handler error handler smart pointer.
+         *
+         */
+        bool saveIncremental(AnalysisPtr                analysis,
+                             QuaZip&                    zip,
+                             QuaZip&                    source,
+                             const SavedFilters        &previous,
+                             ProgressReporter          *reporter = nullptr,
+                             ErrorHandlerSPtr           handler  = ErrorHandlerSPtr());
+
+        /** \brief Returns the filters written by the last save operation.
+         *
+         */
+        const SavedFilters &savedFilters() const
+        { return m_savedFilters; }
+
+      private:
+        /** \brief Writes the analysis to the SEG file. If a source file is given the entries that are equal
+         * to the indexed ones are copied from it instead of compressed again.
+         * \param[in] analysis analysis to save.
+         * \param[in] zip SEG file opened for writing.
+         * \param[in] source previous version of the SEG file or nullptr to compress all the entries.
+         * \param[in] index entries of the source file.
+         * \param[in] previous filters written by the last save of the source file.
+         * \param[in] reporter progress reporter object.
+         * \param[in] handler error handler smart pointer.
+         *
+         */
+        void saveEntries(AnalysisPtr             analysis,
+                         QuaZip&                 zip,
+                         QuaZip                 *source,
+                         const ZipUtils::Index  &index,
+                         const SavedFilters     &previous,
+                         ProgressReporter       *reporter,
+                         ErrorHandlerSPtr        handler);
+
+        const VolumeCodec::Type m_codec;        /** codec of the volumetric data of saved files. */
+        SavedFilters            m_savedFilters; /** filters written by the last save.            */
       };
     }
   }
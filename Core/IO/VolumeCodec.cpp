@@ -0,0 +1,184 @@
+/*
+ File: VolumeCodec.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "VolumeCodec.h"
+#include <EspinaConfig.h>
+#include <Core/Utils/EspinaException.h>
+
+// Qt
+#include <QObject>
+#include <QThread>
+
+#if USE_ZSTD
+// Zstandard
+#include <zstd.h>
+#endif
+
+using namespace ESPINA;
+using namespace ESPINA::IO;
+using namespace ESPINA::Core::Utils;
+
+const QString VolumeCodec::FORMAT_INFO_KEY = "Volume Codec";
+
+const QString DEFLATE_NAME = "deflate";
+const QString ZSTD_NAME    = "zstd";
+
+#if USE_ZSTD
+const int ZSTD_LEVEL = 3;
+#endif
+
+//-----------------------------------------------------------------------------
+bool VolumeCodec::isAvailable(const Type codec)
+{
+  switch(codec)
+  {
+    case Type::DEFLATE:
+      return true;
+    case Type::ZSTD:
+      return USE_ZSTD;
+    default:
+      break;
+  }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+QString VolumeCodec::name(const Type codec)
+{
+  switch(codec)
+  {
+    case Type::ZSTD:
+      return ZSTD_NAME;
+    case Type::DEFLATE:
+    default:
+      break;
+  }
+
+  return DEFLATE_NAME;
+}
+
+//-----------------------------------------------------------------------------
+VolumeCodec::Type VolumeCodec::type(const QString &name)
+{
+  const auto codecName = name.trimmed().toLower();
+
+  if(codecName == DEFLATE_NAME) return Type::DEFLATE;
+  if(codecName == ZSTD_NAME)    return Type::ZSTD;
+
+  auto what    = QObject::tr("Unknown volume codec: %1").arg(name);
+  auto details = QObject::tr("VolumeCodec::type() -> ") + what;
+
+  throw EspinaException(what, details);
+}
+
+//-----------------------------------------------------------------------------
+bool VolumeCodec::isVolumeData(const QString &fileName)
+{
+  return fileName.endsWith(".raw", Qt::CaseInsensitive);
+}
+
+//-----------------------------------------------------------------------------
+QByteArray VolumeCodec::encode(const QByteArray &data, const Type codec, const int threads)
+{
+  if(codec == Type::DEFLATE) return data;
+
+  if(!isAvailable(codec))
+  {
+    auto what    = QObject::tr("Volume codec not available in this build: %1").arg(name(codec));
+    auto details = QObject::tr("VolumeCodec::encode() -> ") + what;
+
+    throw EspinaException(what, details);
+  }
+
+  QByteArray result;
+
+#if USE_ZSTD
+  auto context = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, ZSTD_LEVEL);
+
+  // fails silently if the library was built without multithreading support.
+  const auto workers = (threads > 0) ? threads : QThread::idealThreadCount();
+  if(workers > 1)
+  {
+    ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, workers);
+  }
+
+  result.resize(static_cast<int>(ZSTD_compressBound(data.size())));
+
+  const auto size = ZSTD_compress2(context, result.data(), result.size(), data.constData(), data.size());
+
+  ZSTD_freeCCtx(context);
+
+  if(ZSTD_isError(size))
+  {
+    auto what    = QObject::tr("Couldn't compress volume data, cause: %1").arg(ZSTD_getErrorName(size));
+    auto details = QObject::tr("VolumeCodec::encode() -> ") + what;
+
+    throw EspinaException(what, details);
+  }
+
+  result.resize(static_cast<int>(size));
+#endif
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+QByteArray VolumeCodec::decode(const QByteArray &data, const Type codec)
+{
+  if(codec == Type::DEFLATE) return data;
+
+  if(!isAvailable(codec))
+  {
+    auto what    = QObject::tr("Volume codec not available in this build: %1").arg(name(codec));
+    auto details = QObject::tr("VolumeCodec::decode() -> ") + what;
+
+    throw EspinaException(what, details);
+  }
+
+  QByteArray result;
+
+#if USE_ZSTD
+  const auto contentSize = ZSTD_getFrameContentSize(data.constData(), data.size());
+
+  if(contentSize == ZSTD_CONTENTSIZE_ERROR || contentSize == ZSTD_CONTENTSIZE_UNKNOWN)
+  {
+    auto what    = QObject::tr("Invalid compressed volume data.");
+    auto details = QObject::tr("VolumeCodec::decode() -> ") + what;
+
+    throw EspinaException(what, details);
+  }
+
+  result.resize(static_cast<int>(contentSize));
+
+  const auto size = ZSTD_decompress(result.data(), result.size(), data.constData(), data.size());
+
+  if(ZSTD_isError(size) || size != contentSize)
+  {
+    auto what    = QObject::tr("Couldn't decompress volume data, cause: %1").arg(ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch");
+    auto details = QObject::tr("VolumeCodec::decode() -> ") + what;
+
+    throw EspinaException(what, details);
+  }
+#endif
+
+  return result;
+}
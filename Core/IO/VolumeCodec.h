@@ -0,0 +1,90 @@
+/*
+ File: VolumeCodec.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPINA_IO_VOLUME_CODEC_H
+#define ESPINA_IO_VOLUME_CODEC_H
+
+#include "Core/EspinaCore_Export.h"
+
+// Qt
+#include <QByteArray>
+#include <QString>
+
+namespace ESPINA
+{
+  namespace IO
+  {
+    /** \class VolumeCodec
+     * \brief Compression of the volumetric data entries of SEG files.
+     *
+     * DEFLATE leaves the data untouched for the zip container to compress it. Other codecs compress the
+     * data themselves and the entries are stored in the container without compression.
+     *
+     */
+    class EspinaCore_EXPORT VolumeCodec
+    {
+      public:
+        enum class Type: char { DEFLATE = 0, ZSTD = 1 };
+
+        static const QString FORMAT_INFO_KEY; /** key of the codec in the SEG file format info. */
+
+        /** \brief Returns true if the given codec can be used in this build.
+         * \param[in] codec codec type.
+         *
+         */
+        static bool isAvailable(const Type codec);
+
+        /** \brief Returns the name of the given codec.
+         * \param[in] codec codec type.
+         *
+         */
+        static QString name(const Type codec);
+
+        /** \brief Returns the codec with the given name. Throws an exception if the name is unknown.
+         * \param[in] name codec name.
+         *
+         */
+        static Type type(const QString &name);
+
+        /** \brief Returns true if the given SEG file entry contains volumetric data.
+         * \param[in] fileName entry name.
+         *
+         */
+        static bool isVolumeData(const QString &fileName);
+
+        /** \brief Returns the data compressed with the given codec. Throws an exception on error.
+         * \param[in] data uncompressed data.
+         * \param[in] codec codec type.
+         * \param[in] threads number of compression threads, 0 to use all the available cores.
+         *
+         */
+        static QByteArray encode(const QByteArray &data, const Type codec, const int threads = 0);
+
+        /** \brief Returns the data decompressed with the given codec. Throws an exception on error.
+         * \param[in] data compressed data.
+         * \param[in] codec codec type.
+         *
+         */
+        static QByteArray decode(const QByteArray &data, const Type codec);
+    };
+
+  } // namespace IO
+} // namespace ESPINA
+
+#endif // ESPINA_IO_VOLUME_CODEC_H
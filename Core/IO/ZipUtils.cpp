@@ -25,6 +25,8 @@
 
 // QuaZip
 #include <quazip/quazipfile.h>
+#include <quazip/quazipfileinfo.h>
+#include <quazip/quazipnewinfo.h>
 
 // Qt
 #include <QDebug>
@@ -36,13 +38,17 @@ using namespace ESPINA::Core::Utils;
 //-----------------------------------------------------------------------------
 void ZipUtils::AddFileToZip(const QString&    fileName,
                             const QByteArray& content,
-                            QuaZip&           zip)
+                            QuaZip&           zip,
+                            const bool        compress)
 {
   QuaZipFile zFile(&zip);
   QuaZipNewInfo zFileInfo = QuaZipNewInfo(fileName, fileName);
 
+  const int method = compress ? Z_DEFLATED : 0;
+  const int level  = compress ? Z_DEFAULT_COMPRESSION : 0;
+
   zFileInfo.externalAttr = 0x01A40000; // Permissions of the files 644
-  if (!zFile.open(QIODevice::WriteOnly, zFileInfo))
+  if (!zFile.open(QIODevice::WriteOnly, zFileInfo, nullptr, 0, method, level))
   {
     auto what    = QObject::tr("Couldn't create a file inside ZIP container, file: %1, cause: %2").arg(fileName).arg(zFile.errorString());
     auto details = QObject::tr("ZipUtils::AddFileToZip() -> Can't create file inside ZIP container, file: %1, cause: %2").arg(fileName).arg(zFile.errorString());
@@ -92,3 +98,85 @@ QByteArray ZipUtils::readCurrentFileFromZip(QuaZip& zip)
 
   return zFile.readAll();
 }
+
+//-----------------------------------------------------------------------------
+ZipUtils::Index ZipUtils::indexZip(QuaZip& zip)
+{
+  Index index;
+
+  bool hasFile = zip.goToFirstFile();
+  while(hasFile)
+  {
+    QuaZipFileInfo64 info;
+    if(!zip.getCurrentFileInfo(&info))
+    {
+      auto what    = QObject::tr("Couldn't read the central directory of a ZIP container, error code: %1").arg(zip.getZipError());
+      auto details = QObject::tr("ZipUtils::indexZip() -> ") + what;
+      throw EspinaException(what, details);
+    }
+
+    Entry entry;
+    entry.name           = info.name;
+    entry.crc            = info.crc;
+    entry.compressedSize = static_cast<qint64>(info.compressedSize);
+    entry.size           = static_cast<qint64>(info.uncompressedSize);
+    zip.getCurrentFilePosition(entry.position);
+
+    index.insert(entry.name, entry);
+
+    hasFile = zip.goToNextFile();
+  }
+
+  return index;
+}
+
+//-----------------------------------------------------------------------------
+void ZipUtils::copyRawFileToZip(const Entry& entry, QuaZip& source, QuaZip& destination)
+{
+  if(!source.setCurrentFilePosition(entry.position))
+  {
+    auto what    = QObject::tr("Couldn't find a file inside a ZIP container, file: %1, error code: %2").arg(entry.name).arg(source.getZipError());
+    auto details = QObject::tr("ZipUtils::copyRawFileToZip() -> ") + what;
+    throw EspinaException(what, details);
+  }
+
+  QuaZipFileInfo64 info;
+  source.getCurrentFileInfo(&info);
+
+  int method = 0;
+  int level  = 0;
+
+  QuaZipFile sFile(&source);
+  if(!sFile.open(QIODevice::ReadOnly, &method, &level, true))
+  {
+    auto what    = QObject::tr("Couldn't open a file inside ZIP container, file: %1, cause: %2").arg(entry.name).arg(sFile.errorString());
+    auto details = QObject::tr("ZipUtils::copyRawFileToZip() -> ") + what;
+    throw EspinaException(what, details);
+  }
+
+  auto content = sFile.readAll();
+  sFile.close();
+
+  QuaZipNewInfo dInfo(entry.name);
+  dInfo.dateTime         = info.dateTime;
+  dInfo.externalAttr     = info.externalAttr;
+  dInfo.uncompressedSize = info.uncompressedSize;
+
+  QuaZipFile dFile(&destination);
+  if(!dFile.open(QIODevice::WriteOnly, dInfo, nullptr, info.crc, method, level, true))
+  {
+    auto what    = QObject::tr("Couldn't create a file inside ZIP container, file: %1, cause: %2").arg(entry.name).arg(dFile.errorString());
+    auto details = QObject::tr("ZipUtils::copyRawFileToZip() -> ") + what;
+    throw EspinaException(what, details);
+  }
+
+  dFile.write(content);
+  dFile.close();
+
+  if(dFile.getZipError() != UNZ_OK)
+  {
+    auto what    = QObject::tr("Couldn't write a file inside ZIP container, file: %1, cause: %2").arg(entry.name).arg(dFile.errorString());
+    auto details = QObject::tr("ZipUtils::copyRawFileToZip() -> ") + what;
+    throw EspinaException(what, details);
+  }
+}
@@ -26,6 +26,10 @@
 
 // QuaZip
 #include <quazip/quazip.h>
+#include <quazip/quazipfilepos.h>
+
+// Qt
+#include <QMap>
 
 namespace ESPINA
 {
@@ -38,15 +42,28 @@ namespace ESPINA
     class EspinaCore_EXPORT ZipUtils
     {
       public:
+        struct Entry
+        {
+          QString       name;           /** file name.                          */
+          QuaZipFilePos position;       /** position in the central directory.  */
+          quint32       crc;            /** CRC-32 of the uncompressed content. */
+          qint64        compressedSize; /** size of the compressed content.     */
+          qint64        size;           /** size of the uncompressed content.   */
+        };
+
+        using Index = QMap<QString, Entry>;
+
         /** \brief Adds a file to a QuaZip file.
          * \param[in] fileName, file name.
          * \param[in] content, file content as a byte array.
          * \param[in] zip, QuaZip handler.
+         * \param[in] compress, true to deflate the content and false to store it as is.
          *
          */
         static void AddFileToZip(const QString&    fileName,
                                  const QByteArray& content,
-                                 QuaZip&           zip);
+                                 QuaZip&           zip,
+                                 const bool        compress = true);
 
         /** \brief Reads a file from a QuaZip file and returns its content as a byte array.
          * \param[in] fileName, file name.
@@ -61,6 +78,22 @@ namespace ESPINA
          *
          */
         static QByteArray readCurrentFileFromZip(QuaZip& zip);
+
+        /** \brief Reads the central directory of a QuaZip file and returns its entries indexed by file name.
+         * \param[in] zip, QuaZip handler.
+         *
+         */
+        static Index indexZip(QuaZip& zip);
+
+        /** \brief Copies an entry between QuaZip files without decompressing it.
+         * \param[in] entry, entry to copy.
+         * \param[in] source, QuaZip handler of the file containing the entry.
+         * \param[in] destination, QuaZip handler of the file where the entry will be added.
+         *
+         */
+        static void copyRawFileToZip(const Entry& entry,
+                                     QuaZip&      source,
+                                     QuaZip&      destination);
     };
 
   } // namespace IO
@@ -0,0 +1,56 @@
+/*
+ File: ContinuationTask.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "ContinuationTask.h"
+
+using namespace ESPINA;
+
+//-----------------------------------------------------------------------------
+ContinuationTask::ContinuationTask(Function function, SchedulerSPtr scheduler)
+: Task      {scheduler}
+, m_function{function}
+{
+}
+
+//-----------------------------------------------------------------------------
+TaskSPtr ContinuationTask::join(const TaskSList &tasks, Function function, SchedulerSPtr scheduler)
+{
+  auto continuation = std::make_shared<ContinuationTask>(function, scheduler);
+  continuation->setDescription(QObject::tr("Continuation"));
+  continuation->setHidden(true);
+
+  for(auto task: tasks)
+  {
+    addDependency(continuation, task);
+  }
+
+  submit(continuation);
+
+  return continuation;
+}
+
+//-----------------------------------------------------------------------------
+void ContinuationTask::run()
+{
+  if(m_function && canExecute())
+  {
+    m_function();
+  }
+}
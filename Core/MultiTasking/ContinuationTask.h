@@ -0,0 +1,76 @@
+/*
+ File: ContinuationTask.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_MULTITASKING_CONTINUATIONTASK_H_
+#define CORE_MULTITASKING_CONTINUATIONTASK_H_
+
+#include "Core/EspinaCore_Export.h"
+
+// ESPINA
+#include "Task.h"
+
+// C++
+#include <functional>
+
+namespace ESPINA
+{
+  /** \class ContinuationTask
+   * \brief Task that executes a function once all its predecessors have finished.
+   *
+   */
+  class EspinaCore_EXPORT ContinuationTask
+  : public Task
+  {
+    public:
+      using Function = std::function<void()>;
+
+      /** \brief ContinuationTask class constructor.
+       * \param[in] function function to execute.
+       * \param[in] scheduler application task scheduler.
+       *
+       */
+      explicit ContinuationTask(Function function, SchedulerSPtr scheduler);
+
+      /** \brief ContinuationTask class virtual destructor.
+       *
+       */
+      virtual ~ContinuationTask()
+      {}
+
+      /** \brief Creates and submits a hidden task that executes the given function after all the given
+       * tasks have finished. Returns the continuation task, that can be used as predecessor of other tasks.
+       * If any of the tasks is aborted the continuation is aborted and the function is not executed.
+       * \param[in] tasks predecessor tasks.
+       * \param[in] function function to execute.
+       * \param[in] scheduler application task scheduler.
+       *
+       */
+      static TaskSPtr join(const TaskSList &tasks, Function function, SchedulerSPtr scheduler);
+
+    private:
+      virtual void run() override;
+
+      Function m_function; /** function to execute. */
+  };
+
+  using ContinuationTaskSPtr = std::shared_ptr<ContinuationTask>;
+
+} // namespace ESPINA
+
+#endif // CORE_MULTITASKING_CONTINUATIONTASK_H_
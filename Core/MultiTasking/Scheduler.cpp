@@ -29,15 +29,15 @@
 // ESPINA
 #include "Scheduler.h"
 #include "Task.h"
+#include "WorkStealingPool.h"
 
 // C++
+#include <algorithm>
 #include <iostream>
-#include <unistd.h>
 #include <chrono>
 
 // Qt
 #include <QThread>
-#include <QApplication>
 #include <QDebug>
 
 using namespace ESPINA;
@@ -66,19 +66,33 @@ void Scheduler::TaskQueue::orderedInsert(TaskSPtr worker)
 }
 
 //-----------------------------------------------------------------------------
-Scheduler::Scheduler(int period, QObject* parent)
+Scheduler::Scheduler(int period, ExecutionMode mode, QObject* parent)
 : QObject             {parent}
 , m_period            {period}
 , m_lastId            {0}
 , m_maxNumRunningTasks{maxRunningTasks()}
 , m_abort             {false}
+, m_mode              {mode}
+, m_pool              {nullptr}
+, m_wakeupPending     {false}
+, m_wakeupRequestTime {0}
+, m_wakeupStatistics  {0, 0, 0, 0}
 {
   auto thread = new QThread();
 
   moveToThread(thread);
 
-  connect(thread, SIGNAL(started()),
-          this,   SLOT(scheduleTasks()));
+  if(m_mode == ExecutionMode::THREAD_POOL)
+  {
+    // scheduler thread only runs its event loop, tasks are dispatched by the pool.
+    m_pool = new WorkStealingPool(this);
+  }
+  else
+  {
+    // first pass, the next ones are triggered by wakeUp().
+    connect(thread, SIGNAL(started()),
+            this,   SLOT(scheduleTasks()));
+  }
 
   connect(this,   SIGNAL(destroyed(QObject *)),
           thread, SLOT(quit()));
@@ -100,6 +114,12 @@ Scheduler::Scheduler(int period, QObject* parent)
 Scheduler::~Scheduler()
 {
   abort();
+
+  if(m_pool)
+  {
+    delete m_pool;
+    m_pool = nullptr;
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -107,6 +127,35 @@ void Scheduler::addTask(TaskSPtr task)
 {
   if(m_abort) return;
 
+  if(m_mode == ExecutionMode::THREAD_POOL)
+  {
+    bool waitsDependencies = false;
+    {
+      QMutexLocker lock(&m_mutex);
+
+      task->setId(m_lastId++);
+      task->m_pooled = true;
+
+      m_poolTasks << task;
+
+      // released by onTaskReleased() when its predecessors finish.
+      waitsDependencies = task->hasPendingDependencies() && !task->isAborted();
+      if(waitsDependencies) m_dependentTasks << task;
+    }
+
+    if (!task->isHidden())
+    {
+      emit taskAdded(task);
+    }
+
+    if(!waitsDependencies)
+    {
+      m_pool->push(task, schedulingPriority(task));
+    }
+
+    return;
+  }
+
   QMutexLocker lock(&m_insertionMutex);
 
   task->setId(m_lastId++);
@@ -117,6 +166,8 @@ void Scheduler::addTask(TaskSPtr task)
   {
     emit taskAdded(task);
   }
+
+  wakeUp();
 }
 
 //-----------------------------------------------------------------------------
@@ -124,10 +175,45 @@ void Scheduler::abort()
 {
   m_abort = true;
 
-  // wait for the scheduler thread to end scheduleTask() method. Period is microsec so its converted to millisec.
-  m_waitMutex.lock();
-  m_wait.wait(&m_waitMutex, 3 * m_period/1000);
-  m_waitMutex.unlock();
+  if(m_mode == ExecutionMode::THREAD_POOL)
+  {
+    auto unstarted = m_pool->stop();
+    {
+      QMutexLocker lock(&m_mutex);
+      unstarted << m_dependentTasks;
+      m_dependentTasks.clear();
+    }
+
+    for(auto task: unstarted)
+    {
+      task->abort();
+
+      QMutexLocker lock(&m_mutex);
+      removeTask(task->priority(), task);
+    }
+
+    QList<TaskSPtr> runningTasks;
+    {
+      QMutexLocker lock(&m_mutex);
+      runningTasks = m_poolTasks;
+    }
+
+    for(auto task: runningTasks)
+    {
+      task->abort();
+      task->resume();
+
+      QMutexLocker lock(&task->m_mutex);
+      task->dispatcherResume();
+    }
+
+    m_pool->wait(1000);
+
+    QMutexLocker lock(&m_mutex);
+    m_poolTasks.clear();
+
+    return;
+  }
 
   {
     QMutexLocker priorityLock(&m_priorityMutex);
@@ -163,11 +249,25 @@ void Scheduler::abort()
 //-----------------------------------------------------------------------------
 void Scheduler::changePriority(TaskPtr task, Priority prevPriority)
 {
-  QMutexLocker lock(&m_priorityMutex);
-  if (!m_priorityBuffer.contains(task))
+  if(m_mode == ExecutionMode::THREAD_POOL)
   {
-    m_priorityBuffer[task] = prevPriority;
+    if(!task->isCritical())
+    {
+      m_pool->changePriority(task, prevPriority, task->priority());
+    }
+
+    return;
   }
+
+  {
+    QMutexLocker lock(&m_priorityMutex);
+    if (!m_priorityBuffer.contains(task))
+    {
+      m_priorityBuffer[task] = prevPriority;
+    }
+  }
+
+  wakeUp();
 }
 
 //-----------------------------------------------------------------------------
@@ -188,149 +288,141 @@ unsigned int Scheduler::maxRunningTasks()
 //-----------------------------------------------------------------------------
 void Scheduler::scheduleTasks()
 {
-  disconnect(this->thread(), SIGNAL(started()),
-             this,           SLOT(scheduleTasks()));
+  if (m_abort) return;
 
-  high_resolution_clock::time_point start;
-  high_resolution_clock::time_point last;
-  high_resolution_clock::time_point end;
-
-  while (!m_abort)
   {
-    QApplication::processEvents();
+    const auto wakeupTime = high_resolution_clock::now();
+
+    // read the request time before clearing the flag, so the next request can't overwrite it.
+    const auto requestTime = m_wakeupRequestTime.load();
+    if (m_wakeupPending.exchange(false))
+    {
+      const auto latency = duration_cast<microseconds>(wakeupTime.time_since_epoch()).count() - requestTime;
 
-    proccessTaskInsertion();
+      QMutexLocker lock(&m_mutex);
+      m_wakeupStatistics.lastLatency = std::max<long long>(0, latency);
+      m_wakeupStatistics.maxLatency  = std::max(m_wakeupStatistics.maxLatency, m_wakeupStatistics.lastLatency);
+      m_wakeupStatistics.meanLatency = (m_wakeupStatistics.meanLatency * m_wakeupStatistics.wakeups + m_wakeupStatistics.lastLatency) / (m_wakeupStatistics.wakeups + 1);
+      ++m_wakeupStatistics.wakeups;
+    }
+  }
+
+  proccessTaskInsertion();
 
 //     std::cout << "Start Scheduling" << std::endl;
 
-    reschedule();
+  reschedule();
 
-    {
-      QMutexLocker lock(&m_mutex);
+  {
+    QMutexLocker lock(&m_mutex);
 
-      start = high_resolution_clock::now();
+//     std::cout << "\t Scheduler thread " << thread() << std::endl;
+//     int numTasks = 0;
+//     for (auto priority: {Priority::VERY_HIGH, Priority::HIGH, Priority::NORMAL, Priority::LOW, Priority::VERY_LOW})
+//     {
+//       int size = m_scheduledTasks[priority].size();
+//       numTasks += size;
+//       std::cout << "Priority " << (int)priority << " has " << size << " tasks." << std::endl;
+//     }
+//     std::cout << "Scheduler has " << numTasks << " tasks:" << std::endl;
 
-  //     std::cout << "\t Scheduler thread " << thread() << std::endl;
-  //     int numTasks = 0;
-  //     for (auto priority: {Priority::VERY_HIGH, Priority::HIGH, Priority::NORMAL, Priority::LOW, Priority::VERY_LOW})
-  //     {
-  //       int size = m_scheduledTasks[priority].size();
-  //       numTasks += size;
-  //       std::cout << "Priority " << (int)priority << " has " << size << " tasks." << std::endl;
-  //     }
-  //     std::cout << "Scheduler has " << numTasks << " tasks:" << std::endl;
+    unsigned int num_running_threads = 0;
 
-      unsigned int num_running_threads = 0;
+    for (auto priority: {Priority::VERY_HIGH, Priority::HIGH, Priority::NORMAL, Priority::LOW, Priority::VERY_LOW})
+    {
+//       std::cout << "Updating Priority " << priority << std::endl;
+      QList<TaskSPtr> deferredDeletionTaskList;
 
-      for (auto priority: {Priority::VERY_HIGH, Priority::HIGH, Priority::NORMAL, Priority::LOW, Priority::VERY_LOW})
+      for(auto task: m_scheduledTasks[priority])
       {
-  //       std::cout << "Updating Priority " << priority << std::endl;
-        QList<TaskSPtr> deferredDeletionTaskList;
-
-        for(auto task: m_scheduledTasks[priority])
-        {
 //        for (auto scheduledTask : m_scheduledTasks[priority])
 //        {
 //          auto task = scheduledTask.Task;
-          const auto isEdgesTask = (priority == Priority::VERY_HIGH) && task->description().contains("Edges", Qt::CaseInsensitive);
-          const auto is_thread_attached = task->isExecutingOnThread();
+        const auto isCriticalTask = task->isCritical();
+        const auto is_thread_attached = task->isExecutingOnThread();
 
-          if (((num_running_threads < m_maxNumRunningTasks) || isEdgesTask) && canExecute(task))
+        if (((num_running_threads < m_maxNumRunningTasks) || isCriticalTask) && canExecute(task))
+        {
+          //printTask(task, "should be running");
+          if (is_thread_attached)
           {
-            //printTask(task, "should be running");
-            if (is_thread_attached)
+            if (task->isDispatcherPaused())
             {
-              if (task->isDispatcherPaused())
-              {
-                task->dispatcherResume();
-                //printTask(task, "resumed by scheduler");
-              }
-              else
-              {
-  //               printTask(task, "already running");
-              }
+              task->dispatcherResume();
+              //printTask(task, "resumed by scheduler");
             }
             else
             {
-              task->startThreadExecution();
-              //printTask(task, "started");
+//               printTask(task, "already running");
             }
-            num_running_threads++;
           }
           else
           {
-  //           std::cout << "- " << task->id() << ": " << task->description().toStdString() << " is " << (!task->isRunning()?"not ":"") << "running" << std::endl;
-            bool hasBeenAbortedWithoutRunning = task->isAborted() && !is_thread_attached;
-            if (task->hasFinished() || hasBeenAbortedWithoutRunning)
+            task->startThreadExecution();
+            //printTask(task, "started");
+          }
+          num_running_threads++;
+        }
+        else
+        {
+//           std::cout << "- " << task->id() << ": " << task->description().toStdString() << " is " << (!task->isRunning()?"not ":"") << "running" << std::endl;
+          bool hasBeenAbortedWithoutRunning = task->isAborted() && !is_thread_attached;
+          if (task->hasFinished() || hasBeenAbortedWithoutRunning)
+          {
+//             { // DEBUG
+//               if (task->hasFinished())
+//               {
+//                 std::cout << "- " << task->id() << ": " << task->description().toStdString() << " has finished" << (task->isAborted()?" and was aborted":"") << std::endl;
+//               }
+//               else
+//               {
+//                 std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was aborted without running" << std::endl;
+//               }
+//             }
+            deferredDeletionTaskList << task;
+          }
+          else
+          {
+            // Waiting tasks also fulfill these conditions so they must be paused by dispatcher
+            if (!task->isPendingPause() && is_thread_attached && !task->isDispatcherPaused())
             {
-  //             { // DEBUG
-  //               if (task->hasFinished())
-  //               {
-  //                 std::cout << "- " << task->id() << ": " << task->description().toStdString() << " has finished" << (task->isAborted()?" and was aborted":"") << std::endl;
-  //               }
-  //               else
-  //               {
-  //                 std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was aborted without running" << std::endl;
-  //               }
-  //             }
-              deferredDeletionTaskList << task;
+              task->dispatcherPause();
+              //printTask(task, " was paused by Scheduler");
             }
-            else
+            else if (task->isAborted() && task->isDispatcherPaused())
             {
-              // Waiting tasks also fulfill these conditions so they must be paused by dispatcher
-              if (!task->isPendingPause() && is_thread_attached && !task->isDispatcherPaused())
-              {
-                task->dispatcherPause();
-                //printTask(task, " was paused by Scheduler");
-              }
-              else if (task->isAborted() && task->isDispatcherPaused())
-              {
-                task->dispatcherResume();
-              }
+              task->dispatcherResume();
             }
           }
-
-  //         { // DEBUG
-  //           if (task->isPaused())
-  //           {
-  //             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was paused by the user" << std::endl;
-  //           }
-  //           else if (task->isAborted())
-  //           {
-  //             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was aborted but hasn't finished yet" << std::endl;
-  //           }
-  //           else
-  //           {
-  //             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " is ready to start" << std::endl;
-  //           }
-  //         }
         }
 
-        for (auto task : deferredDeletionTaskList)
-        {
-          removeTask(priority, task);
-        }
-
-  //      for (auto task : m_runningTasks[priority])
-  //      {
-  //         printState(task);
-  //      }
+//         { // DEBUG
+//           if (task->isPaused())
+//           {
+//             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was paused by the user" << std::endl;
+//           }
+//           else if (task->isAborted())
+//           {
+//             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " was aborted but hasn't finished yet" << std::endl;
+//           }
+//           else
+//           {
+//             std::cout << "- " << task->id() << ": " << task->description().toStdString() << " is ready to start" << std::endl;
+//           }
+//         }
       }
-    }
 
-    end  = high_resolution_clock::now();
-
-    int lastSchedulingTime = duration_cast<microseconds>(end - start).count();
-
-//     std::cout << "Inter Schedule time" << duration_cast<microseconds>(start - last).count() << std::endl;
-//     std::cout << "Scheduling End after " << lastSchedulingTime << std::endl;
-//
-//     last = start;
+      for (auto task : deferredDeletionTaskList)
+      {
+        removeTask(priority, task);
+      }
 
-    usleep(std::max(0, m_period - lastSchedulingTime));
+//      for (auto task : m_runningTasks[priority])
+//      {
+//         printState(task);
+//      }
+    }
   }
-
-  m_wait.wakeAll();
 }
 
 //-----------------------------------------------------------------------------
@@ -343,14 +435,7 @@ void Scheduler::proccessTaskInsertion()
 
   for (auto task : m_insertionBuffer)
   {
-    if(task->description().contains("Edges:"))
-    {
-      m_scheduledTasks[Priority::VERY_HIGH].orderedInsert(task);
-    }
-    else
-    {
-      m_scheduledTasks[task->priority()].orderedInsert(task);
-    }
+    m_scheduledTasks[schedulingPriority(task)].orderedInsert(task);
     m_priorityBuffer.remove(task.get());
   }
 
@@ -433,6 +518,7 @@ void Scheduler::removeTask(Priority priority, TaskSPtr task)
   {
     m_scheduledTasks[priority].removeOne(task);
     m_insertionBuffer.removeOne(task);
+    m_poolTasks.removeOne(task);
 
     task->m_submitted = false;
 
@@ -453,14 +539,23 @@ unsigned int Scheduler::numberOfTasks() const
   std::for_each(priorities.begin(), priorities.end(), [&result, this] (const Priority priority) { result += m_scheduledTasks[priority].size(); });
 
   result += m_insertionBuffer.size();
+  result += m_poolTasks.size();
 
   return result;
 }
 
+//-----------------------------------------------------------------------------
+unsigned int Scheduler::concurrency() const
+{
+  if(m_pool) return m_pool->size();
+
+  return m_maxNumRunningTasks;
+}
+
 //-----------------------------------------------------------------------------
 bool Scheduler::canExecute(TaskSPtr task) const
 {
-  return !(task->isPendingPause() || task->isAborted() || task->hasFinished());
+  return !(task->isPendingPause() || task->isAborted() || task->hasFinished() || task->hasPendingDependencies());
 }
 
 //-----------------------------------------------------------------------------
@@ -478,3 +573,125 @@ void Scheduler::printState(TaskSPtr task) const
   std::cout << (task->isHidden() ? "hidden " : "");
   std::cout << std::endl;
 }
+
+//-----------------------------------------------------------------------------
+Priority Scheduler::schedulingPriority(TaskSPtr task) const
+{
+  if(task->isCritical()) return Priority::VERY_HIGH;
+
+  return task->priority();
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::finishPoolTask(TaskSPtr task)
+{
+  {
+    QMutexLocker submissionLock(&task->m_submissionMutex);
+
+    // submitted again while finishing.
+    if(task->m_needsRestart && !task->isAborted() && !m_abort)
+    {
+      task->prepareToRun();
+      m_pool->push(task, schedulingPriority(task));
+
+      return;
+    }
+  }
+
+  QMutexLocker lock(&m_mutex);
+  removeTask(task->priority(), task);
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::onTaskStateChanged(TaskPtr task)
+{
+  if(m_abort) return;
+
+  if(!m_pool)
+  {
+    wakeUp();
+    return;
+  }
+
+  if(task->isAborted() || !task->isPendingPause())
+  {
+    // an aborted task must not stay blocked by a user pause.
+    task->m_pendingUserPause = false;
+
+    if(task->isAborted())
+    {
+      QMutexLocker lock(&m_mutex);
+      auto it = std::find_if(m_dependentTasks.begin(), m_dependentTasks.end(), [task](const TaskSPtr &dependent) { return dependent.get() == task; });
+      if(it != m_dependentTasks.end())
+      {
+        // executed as aborted to be removed by the pool.
+        auto dependent = *it;
+        m_dependentTasks.erase(it);
+        m_pool->push(dependent, schedulingPriority(dependent));
+        return;
+      }
+    }
+
+    if(!m_pool->unpark(task))
+    {
+      // locked to avoid waking the task before it waits in the pause condition.
+      QMutexLocker lock(&task->m_mutex);
+      task->dispatcherResume();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::onTaskFinished()
+{
+  if(!m_abort && !m_pool) wakeUp();
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::onTaskReleased(TaskSPtr task)
+{
+  if(m_abort) return;
+
+  if(!m_pool)
+  {
+    wakeUp();
+    return;
+  }
+
+  QMutexLocker lock(&m_mutex);
+  if(m_dependentTasks.removeOne(task))
+  {
+    m_pool->push(task, schedulingPriority(task));
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::wakeUp()
+{
+  if(!m_wakeupPending.exchange(true))
+  {
+    m_wakeupRequestTime = duration_cast<microseconds>(high_resolution_clock::now().time_since_epoch()).count();
+
+    QMetaObject::invokeMethod(this, "scheduleTasks", Qt::QueuedConnection);
+  }
+}
+
+//-----------------------------------------------------------------------------
+Scheduler::WakeupStatistics Scheduler::wakeupStatistics() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_wakeupStatistics;
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::beginBlockingWait()
+{
+  if(m_pool) m_pool->taskBlocked();
+}
+
+//-----------------------------------------------------------------------------
+void Scheduler::endBlockingWait()
+{
+  if(m_pool) m_pool->taskUnblocked();
+}
@@ -42,6 +42,8 @@
 
 namespace ESPINA
 {
+  class WorkStealingPool;
+
   /** \class Scheduler
    * \brief Task scheduler.
    *
@@ -96,12 +98,35 @@ namespace ESPINA
   public:
     static const unsigned int MAX_TASKS = 15; /** max number of tasks. */
 
+    /** \brief Task execution modes.
+     *
+     *  - DISPATCHER: each task runs on its own thread, the scheduler pauses and resumes them
+     *                periodically to keep at most MAX_TASKS running, ordered by priority.
+     *  - THREAD_POOL: tasks run on a work-stealing pool with as many workers as hardware threads.
+     *                 Priority determines the order tasks are taken from the pool queues, running
+     *                 tasks are never preempted. Opt-in, the application context still uses DISPATCHER.
+     */
+    enum class ExecutionMode: std::int8_t { DISPATCHER = 0, THREAD_POOL = 1 };
+
+    /** \struct WakeupStatistics
+     * \brief Latency between the request of a scheduling pass and its execution, in microseconds.
+     *
+     */
+    struct WakeupStatistics
+    {
+      unsigned long long wakeups;     /** number of scheduling passes triggered by a wakeup. */
+      double             lastLatency; /** latency of the last wakeup.                        */
+      double             meanLatency; /** mean latency of all the wakeups.                   */
+      double             maxLatency;  /** maximum latency of all the wakeups.                */
+    };
+
     /** \brief Scheduler class constructor.
-     * \param[in] period interval for scheduling tasks.
+     * \param[in] period legacy interval for scheduling tasks, unused as scheduling passes are triggered by task events.
+     * \param[in] mode task execution mode.
      * \param[in] parent raw pointer of the parent of this object.
      *
      */
-    explicit Scheduler(int period/*ns*/, QObject* parent = 0);
+    explicit Scheduler(int period/*ns*/, ExecutionMode mode = ExecutionMode::DISPATCHER, QObject* parent = 0);
 
     /** \brief Scheduler class destructor.
      *
@@ -141,8 +166,43 @@ namespace ESPINA
      */
     unsigned int numberOfTasks() const;
 
+    /** \brief Returns the task execution mode of the scheduler.
+     *
+     */
+    ExecutionMode executionMode() const
+    { return m_mode; }
+
+    /** \brief Returns the number of threads that execute tasks concurrently. In THREAD_POOL mode that's the
+     *  number of pool workers, not counting compensation workers.
+     *
+     */
+    unsigned int concurrency() const;
+
+    /** \brief Returns the wakeup latency statistics of the DISPATCHER mode scheduling passes.
+     *
+     */
+    WakeupStatistics wakeupStatistics() const;
+
+    /** \brief Notifies the scheduler that the calling thread is going to block until a paused state
+     *  ends or other tasks finish. If the thread is a worker of the THREAD_POOL mode pool a compensation
+     *  worker executes the queued tasks meanwhile, so waiting tasks can't take up all the workers.
+     *
+     *  Must be paired with a call to endBlockingWait() from the same thread.
+     *
+     */
+    void beginBlockingWait();
+
+    /** \brief Notifies the scheduler that the calling thread is no longer blocked.
+     *
+     */
+    void endBlockingWait();
+
   public slots:
-    /** \brief Starts the scheduler.
+    /** \brief Executes a scheduling pass: inserts the new tasks, applies priority changes and
+     * starts, pauses, resumes or removes tasks.
+     *
+     * The scheduler thread blocks in its event loop between passes. A pass is requested by
+     * wakeUp() on task insertion, priority change, pause, resume, abort or completion.
      *
      */
     void scheduleTasks();
@@ -190,6 +250,40 @@ namespace ESPINA
      */
     void printState(TaskSPtr task) const;
 
+    /** \brief Returns the priority of the queue the task must be scheduled in.
+     * \param[in] task task smart pointer.
+     *
+     */
+    Priority schedulingPriority(TaskSPtr task) const;
+
+    /** \brief Removes the task executed by the pool or enqueues it again if it needs to be restarted.
+     * \param[in] task task smart pointer.
+     *
+     */
+    void finishPoolTask(TaskSPtr task);
+
+    /** \brief Notifies the scheduler the task has been paused, resumed or aborted.
+     * \param[in] task task raw pointer.
+     *
+     */
+    void onTaskStateChanged(TaskPtr task);
+
+    /** \brief Notifies the scheduler a task has finished its execution.
+     *
+     */
+    void onTaskFinished();
+
+    /** \brief Notifies the scheduler that all the predecessors of the task have finished.
+     * \param[in] task task smart pointer.
+     *
+     */
+    void onTaskReleased(TaskSPtr task);
+
+    /** \brief Requests a scheduling pass in the scheduler thread. Requests are merged until the pass is executed.
+     *
+     */
+    void wakeUp();
+
   private:
     int                       m_period;             /** schduler executing period.                                 */
     QMutex                    m_insertionMutex;     /** mutex to protect insetion list.                            */
@@ -201,8 +295,16 @@ namespace ESPINA
     unsigned int              m_maxNumRunningTasks; /** maximum number of running tasks.                           */
     mutable QMutex            m_mutex;              /** scheduler data mutex.                                      */
     std::atomic<bool>         m_abort;              /** true to abort the schduler and finish, false otherwise.    */
-    QMutex                    m_waitMutex;          /** wait condition mutex.                                      */
-    QWaitCondition            m_wait;               /** wait condition to correctly finish and free all resources. */
+    const ExecutionMode       m_mode;               /** task execution mode.                                       */
+    WorkStealingPool         *m_pool;               /** thread pool for THREAD_POOL mode, nullptr otherwise.       */
+    QList<TaskSPtr>           m_poolTasks;          /** tasks submitted to the pool and not finished yet.          */
+    QList<TaskSPtr>           m_dependentTasks;     /** pool tasks waiting for their predecessors to finish.       */
+    std::atomic<bool>         m_wakeupPending;      /** true if a scheduling pass has been requested.              */
+    std::atomic<long long>    m_wakeupRequestTime;  /** time of the pending request in microseconds since epoch.   */
+    WakeupStatistics          m_wakeupStatistics;   /** wakeup latency statistics.                                 */
+
+    friend class Task;
+    friend class WorkStealingPool;
   };
 }
 
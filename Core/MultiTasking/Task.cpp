@@ -47,6 +47,7 @@ Task::Task(SchedulerSPtr scheduler)
 , m_thread          {nullptr}
 , m_executingThread {nullptr}
 , m_submitted       {false}
+, m_pooled          {false}
 , m_priority        {Priority::NORMAL}
 , m_isRunning       {false}
 , m_pendingPause    {false}
@@ -57,7 +58,10 @@ Task::Task(SchedulerSPtr scheduler)
 , m_needsRestart    {false}
 , m_id              {0}
 , m_hidden          {false}
+, m_critical        {false}
 , m_progress        {0}
+, m_pendingDependencies{0}
+, m_predecessorAborted {false}
 {
   prepareToRun();
 
@@ -115,12 +119,22 @@ void Task::pause()
   m_pendingUserPause = true;
 
   dispatcherPause();
+
+  if (m_scheduler)
+  {
+    m_scheduler->onTaskStateChanged(this);
+  }
 }
 
 //-----------------------------------------------------------------------------
 void Task::resume()
 {
   m_pendingUserPause = false;
+
+  if (m_scheduler)
+  {
+    m_scheduler->onTaskStateChanged(this);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -163,6 +177,10 @@ void Task::submit(TaskSPtr task)
     if (!task->m_submitted)
     {
       task->prepareToRun();
+
+      // the scheduler will discard it without executing it.
+      if (task->m_predecessorAborted) task->m_isAborted = true;
+
       task->m_scheduler->addTask(task);
       task->m_submitted = true;
     }
@@ -174,6 +192,8 @@ void Task::submit(TaskSPtr task)
   }
   else
   {
+    if (task->m_predecessorAborted) task->m_isAborted = true;
+
     task->runWrapper();
   }
 }
@@ -188,6 +208,13 @@ void Task::abort()
     onAbort();
 
     emit aborted();
+
+    abortSuccessors();
+
+    if (m_scheduler)
+    {
+      m_scheduler->onTaskStateChanged(this);
+    }
   }
 }
 
@@ -209,7 +236,14 @@ bool Task::canExecute()
 
     m_isRunning    = false;
     m_isPaused     = true;
+
+    // a paused task occupies a pool worker, let the pool compensate it.
+    if (m_pooled) m_scheduler->beginBlockingWait();
+
     m_pauseCondition.wait(&m_mutex);
+
+    if (m_pooled) m_scheduler->endBlockingWait();
+
     m_isRunning    = true;
     m_isPaused     = false;
     m_pendingPause = false;
@@ -230,6 +264,11 @@ void Task::setFinished(bool value)
 
   emit finished();
 
+  if (m_scheduler)
+  {
+    m_scheduler->onTaskFinished();
+  }
+
   if (isExecutingOnThread())
   {
     QCoreApplication::sendPostedEvents();
@@ -259,6 +298,15 @@ void Task::runWrapper()
   m_pendingUserPause = false;
 
   setFinished(true);
+
+  if (isAborted())
+  {
+    abortSuccessors();
+  }
+  else
+  {
+    releaseSuccessors();
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -337,7 +385,8 @@ void Task::startThreadExecution()
 //-----------------------------------------------------------------------------
 void Task::onTaskFinished()
 {
-  if (m_needsRestart)
+  // pooled tasks are restarted by the pool worker.
+  if (m_needsRestart && !m_pooled)
   {
     runWrapper();
   }
@@ -366,3 +415,65 @@ bool Task::isExecutingOnThread() const
 {
   return m_executingThread != nullptr;
 }
+
+//-----------------------------------------------------------------------------
+void Task::addDependency(TaskSPtr task, TaskSPtr predecessor)
+{
+  Q_ASSERT(task && predecessor && task != predecessor);
+
+  QMutexLocker lock(&predecessor->m_dependenciesMutex);
+
+  if (predecessor->hasFinished()) return;
+
+  if (predecessor->isAborted())
+  {
+    lock.unlock();
+    task->m_predecessorAborted = true;
+    task->abort();
+    return;
+  }
+
+  ++task->m_pendingDependencies;
+  predecessor->m_successors << task;
+}
+
+//-----------------------------------------------------------------------------
+void Task::releaseSuccessors()
+{
+  QList<std::weak_ptr<Task>> successors;
+  {
+    QMutexLocker lock(&m_dependenciesMutex);
+    successors.swap(m_successors);
+  }
+
+  for (auto weakSuccessor : successors)
+  {
+    auto successor = weakSuccessor.lock();
+
+    if (successor && --successor->m_pendingDependencies == 0 && successor->m_scheduler)
+    {
+      successor->m_scheduler->onTaskReleased(successor);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void Task::abortSuccessors()
+{
+  QList<std::weak_ptr<Task>> successors;
+  {
+    QMutexLocker lock(&m_dependenciesMutex);
+    successors.swap(m_successors);
+  }
+
+  for (auto weakSuccessor : successors)
+  {
+    auto successor = weakSuccessor.lock();
+
+    if (successor)
+    {
+      successor->m_predecessorAborted = true;
+      successor->abort();
+    }
+  }
+}
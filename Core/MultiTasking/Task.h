@@ -44,14 +44,16 @@
 // C++
 #include <cstdint>
 #include <atomic>
+#include <memory>
 
 namespace ESPINA
 {
   enum class Priority: std::int8_t { VERY_LOW = 0, LOW = 1, NORMAL = 2, HIGH = 3, VERY_HIGH = 4 };
 
   class Task;
-  using TaskPtr  = Task *;
-  using TaskSPtr = std::shared_ptr<Task>;
+  using TaskPtr   = Task *;
+  using TaskSPtr  = std::shared_ptr<Task>;
+  using TaskSList = QList<TaskSPtr>;
 
   /** \class Task
    * \brief Espina threaded task base class.
@@ -177,6 +179,23 @@ namespace ESPINA
     bool isHidden() const
     { return m_hidden; }
 
+    /** \brief Sets the task as critical.
+     * \param[in] critical true to set as critical, false otherwise.
+     *
+     * Critical tasks compute data other tasks block waiting for. The scheduler executes them before
+     * any other task regardless of their priority and without limiting the number of running tasks.
+     * Must be set before submitting the task.
+     *
+     */
+    void setCritical(bool critical)
+    { m_critical = critical; }
+
+    /** \brief Returns true if the task is a critical task.
+     *
+     */
+    bool isCritical() const
+    { return m_critical; }
+
     /** \brief Returns true if the task is paused.
      *
      */
@@ -186,6 +205,23 @@ namespace ESPINA
     int progress() const
     { return m_progress; }
 
+    /** \brief Makes the execution of the task depend on the completion of another task.
+     * \param[in] task task that must wait.
+     * \param[in] predecessor task that must finish before the given task can be executed.
+     *
+     * The scheduler won't execute the task until all its predecessors have finished. If a
+     * predecessor is aborted its successors are aborted too. Predecessors that have already
+     * finished are ignored. Both tasks must be submitted to be executed.
+     *
+     */
+    static void addDependency(TaskSPtr task, TaskSPtr predecessor);
+
+    /** \brief Returns true if the task is waiting for any of its predecessors to finish.
+     *
+     */
+    bool hasPendingDependencies() const
+    { return m_pendingDependencies > 0; }
+
   public slots:
     /** \brief Emits progress signal.
      *
@@ -288,6 +324,17 @@ namespace ESPINA
      */
     bool isExecutingOnThread() const;
 
+    /** \brief Notifies the successors of the task that it has finished and can be executed if
+     *  they have no more pending dependencies.
+     *
+     */
+    void releaseSuccessors();
+
+    /** \brief Aborts the successors of the task.
+     *
+     */
+    void abortSuccessors();
+
   signals:
     void progress(int);
     void resumed();
@@ -303,6 +350,7 @@ namespace ESPINA
     QThread *m_executingThread; /** thread where the task is executed.                              */
     bool     m_submitted;       /** true if task has been submitted to the scheduler for execution. */
     QMutex   m_submissionMutex; /** submission data protection mutex.                               */
+    bool     m_pooled;          /** true if the task is executed by the scheduler's thread pool.    */
 
     Priority m_priority;
 
@@ -316,6 +364,7 @@ namespace ESPINA
 
     Id                m_id;               /** task identifier.                                                                    */
     bool              m_hidden;           /** true to hide the task to the user interface, false to make it public.               */
+    bool              m_critical;         /** true if other tasks wait for the results of the task, false otherwise.              */
     QMutex            m_mutex;            /** data protection mutex.                                                              */
     QWaitCondition    m_pauseCondition;   /** wait condition for the paused state.                                                */
 
@@ -324,7 +373,13 @@ namespace ESPINA
 
     mutable QReadWriteLock m_descriptionLock; /** lock for accessing the description data. */
 
+    QMutex                     m_dependenciesMutex;   /** protects successors list.                        */
+    QList<std::weak_ptr<Task>> m_successors;          /** tasks waiting for this one to finish.            */
+    std::atomic<int>           m_pendingDependencies; /** number of predecessors that haven't finished yet. */
+    std::atomic<bool>          m_predecessorAborted;  /** true if any of the predecessors has been aborted. */
+
     friend class Scheduler;
+    friend class WorkStealingPool;
   };
 }
 
@@ -0,0 +1,412 @@
+/*
+ File: WorkStealingPool.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "WorkStealingPool.h"
+#include "Scheduler.h"
+
+// Qt
+#include <QThread>
+
+// C++
+#include <algorithm>
+
+using namespace ESPINA;
+
+namespace
+{
+  thread_local const WorkStealingPool *s_workerPool  = nullptr; /** pool of the worker running in the current thread. */
+  thread_local int                     s_workerQueue = -1;      /** queue index of the worker running in the current thread. */
+}
+
+/** \class WorkStealingPool::Worker
+ * \brief Pool thread.
+ *
+ */
+class WorkStealingPool::Worker
+: public QThread
+{
+  public:
+    /** \brief Worker class constructor.
+     * \param[in] pool pool of the worker.
+     * \param[in] index index of the worker queue or -1 if the worker doesn't own a queue.
+     *
+     */
+    explicit Worker(WorkStealingPool *pool, int index)
+    : m_pool {pool}
+    , m_index{index}
+    {}
+
+    /** \brief Returns the index of the worker queue.
+     *
+     */
+    int index() const
+    { return m_index; }
+
+  protected:
+    virtual void run() override
+    {
+      s_workerPool  = m_pool;
+      s_workerQueue = m_index;
+
+      while(m_pool->waitForTasks(this))
+      {
+        auto task = m_pool->take(m_index);
+
+        if(task)
+        {
+          m_pool->execute(task);
+        }
+        else
+        {
+          // other worker got it first.
+          yieldCurrentThread();
+        }
+      }
+
+      s_workerPool  = nullptr;
+      s_workerQueue = -1;
+    }
+
+  private:
+    WorkStealingPool *m_pool;  /** pool of the worker.        */
+    const int         m_index; /** index of the worker queue. */
+};
+
+//-----------------------------------------------------------------------------
+WorkStealingPool::WorkStealingPool(Scheduler *scheduler, unsigned int numWorkers)
+: m_scheduler{scheduler}
+, m_pending  {0}
+, m_blocked  {0}
+, m_nextQueue{0}
+, m_stop     {false}
+{
+  if(numWorkers == 0)
+  {
+    numWorkers = static_cast<unsigned int>(std::max(1, QThread::idealThreadCount()));
+  }
+
+  for(unsigned int i = 0; i < numWorkers; ++i)
+  {
+    m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+  }
+
+  QMutexLocker lock(&m_workersMutex);
+  for(unsigned int i = 0; i < numWorkers; ++i)
+  {
+    addWorker(static_cast<int>(i));
+  }
+}
+
+//-----------------------------------------------------------------------------
+WorkStealingPool::~WorkStealingPool()
+{
+  stop();
+  wait(1000);
+
+  QMutexLocker lock(&m_workersMutex);
+  for(auto worker: m_workers)
+  {
+    delete worker;
+  }
+
+  for(auto worker: m_retired)
+  {
+    delete worker;
+  }
+
+  m_workers.clear();
+  m_retired.clear();
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::push(TaskSPtr task, Priority priority)
+{
+  const auto level = static_cast<int>(priority);
+
+  int index = -1;
+  if(s_workerPool == this)
+  {
+    index = s_workerQueue;
+  }
+
+  if(index < 0)
+  {
+    index = m_nextQueue++ % m_queues.size();
+  }
+
+  {
+    QMutexLocker lock(&m_idleMutex);
+    ++m_pending;
+  }
+
+  {
+    auto &queue = *m_queues.at(index);
+
+    QMutexLocker lock(&queue.mutex);
+    queue.tasks[level].push_back(task);
+  }
+
+  m_idle.wakeOne();
+}
+
+//-----------------------------------------------------------------------------
+bool WorkStealingPool::changePriority(TaskPtr task, Priority previous, Priority current)
+{
+  const auto from = static_cast<int>(previous);
+  const auto to   = static_cast<int>(current);
+
+  if(from == to) return false;
+
+  for(auto &queue: m_queues)
+  {
+    QMutexLocker lock(&queue->mutex);
+
+    auto &tasks = queue->tasks[from];
+    auto it = std::find_if(tasks.begin(), tasks.end(), [task](const TaskSPtr &queued) { return queued.get() == task; });
+
+    if(it != tasks.end())
+    {
+      queue->tasks[to].push_back(*it);
+      tasks.erase(it);
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool WorkStealingPool::unpark(TaskPtr task)
+{
+  TaskSPtr parked = nullptr;
+
+  {
+    QMutexLocker lock(&m_parkedMutex);
+
+    auto it = std::find_if(m_parked.begin(), m_parked.end(), [task](const TaskSPtr &other) { return other.get() == task; });
+    if(it == m_parked.end()) return false;
+
+    parked = *it;
+    m_parked.erase(it);
+  }
+
+  push(parked, parked->priority());
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+QList<TaskSPtr> WorkStealingPool::stop()
+{
+  QList<TaskSPtr> tasks;
+
+  {
+    QMutexLocker lock(&m_idleMutex);
+    m_stop = true;
+  }
+
+  m_idle.wakeAll();
+
+  for(auto &queue: m_queues)
+  {
+    QMutexLocker lock(&queue->mutex);
+
+    for(auto &levelTasks: queue->tasks)
+    {
+      for(auto &task: levelTasks)
+      {
+        tasks << task;
+      }
+
+      levelTasks.clear();
+    }
+  }
+
+  m_pending = 0;
+
+  {
+    QMutexLocker lock(&m_parkedMutex);
+    tasks << m_parked;
+    m_parked.clear();
+  }
+
+  return tasks;
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::wait(unsigned long msecs)
+{
+  std::vector<Worker *> workers;
+
+  {
+    QMutexLocker lock(&m_workersMutex);
+    workers = m_workers;
+    workers.insert(workers.end(), m_retired.begin(), m_retired.end());
+  }
+
+  for(auto worker: workers)
+  {
+    if(worker == QThread::currentThread()) continue;
+
+    if(!worker->wait(msecs))
+    {
+      worker->terminate();
+      worker->wait();
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+unsigned int WorkStealingPool::numberOfWorkers() const
+{
+  QMutexLocker lock(&m_workersMutex);
+
+  return m_workers.size();
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::taskBlocked()
+{
+  // only the workers of the pool need to be compensated.
+  if(s_workerPool != this) return;
+
+  ++m_blocked;
+
+  QMutexLocker lock(&m_workersMutex);
+
+  const auto limit = std::min(size() + m_blocked, MAX_WORKERS_FACTOR * size());
+  if(!m_stop && m_workers.size() < limit)
+  {
+    addWorker(-1);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::taskUnblocked()
+{
+  if(s_workerPool != this) return;
+
+  --m_blocked;
+
+  // let surplus compensation workers retire.
+  m_idle.wakeAll();
+}
+
+//-----------------------------------------------------------------------------
+TaskSPtr WorkStealingPool::take(int index)
+{
+  const int numQueues = m_queues.size();
+
+  for(int level = NUM_PRIORITIES - 1; level >= 0; --level)
+  {
+    if(index >= 0)
+    {
+      auto &queue = *m_queues.at(index);
+
+      QMutexLocker lock(&queue.mutex);
+      auto &tasks = queue.tasks[level];
+      if(!tasks.empty())
+      {
+        auto task = tasks.back();
+        tasks.pop_back();
+        --m_pending;
+
+        return task;
+      }
+    }
+
+    for(int i = 1; i <= numQueues; ++i)
+    {
+      const auto victim = (std::max(index, 0) + i) % numQueues;
+      if(victim == index) continue;
+
+      auto &queue = *m_queues.at(victim);
+
+      QMutexLocker lock(&queue.mutex);
+      auto &tasks = queue.tasks[level];
+      if(!tasks.empty())
+      {
+        auto task = tasks.front();
+        tasks.pop_front();
+        --m_pending;
+
+        return task;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::execute(TaskSPtr task)
+{
+  {
+    // paused by the user before being started, wait until resumed.
+    QMutexLocker lock(&m_parkedMutex);
+    if(task->isPendingPause() && !task->isAborted())
+    {
+      m_parked << task;
+      return;
+    }
+  }
+
+  if(!task->isAborted())
+  {
+    task->runWrapper();
+  }
+
+  m_scheduler->finishPoolTask(task);
+}
+
+//-----------------------------------------------------------------------------
+bool WorkStealingPool::waitForTasks(Worker *worker)
+{
+  QMutexLocker lock(&m_idleMutex);
+
+  while(!m_stop && m_pending == 0)
+  {
+    if(worker->index() < 0)
+    {
+      QMutexLocker workersLock(&m_workersMutex);
+      if(m_workers.size() > size() + m_blocked)
+      {
+        m_workers.erase(std::find(m_workers.begin(), m_workers.end(), worker));
+        m_retired.push_back(worker);
+
+        return false;
+      }
+    }
+
+    m_idle.wait(&m_idleMutex);
+  }
+
+  return !m_stop;
+}
+
+//-----------------------------------------------------------------------------
+void WorkStealingPool::addWorker(int index)
+{
+  auto worker = new Worker(this, index);
+  m_workers.push_back(worker);
+
+  worker->start();
+}
@@ -0,0 +1,189 @@
+/*
+ File: WorkStealingPool.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_MULTITASKING_WORKSTEALINGPOOL_H_
+#define CORE_MULTITASKING_WORKSTEALINGPOOL_H_
+
+#include "Core/EspinaCore_Export.h"
+
+// ESPINA
+#include "Task.h"
+
+// Qt
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+
+// C++
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace ESPINA
+{
+  /** \class WorkStealingPool
+   * \brief Fixed set of worker threads with one double ended queue per worker and priority level.
+   *
+   * Each worker takes work from its own queues in LIFO order and steals from the other workers
+   * queues in FIFO order when it has none. Queues are visited from the highest to the lowest
+   * priority, so a worker never executes a task while a task with higher priority is waiting in
+   * any of the pool queues. When a task blocks (paused or waiting for other tasks) the pool spawns a
+   * compensation worker to keep the number of executing workers equal to the number of hardware threads.
+   *
+   */
+  class EspinaCore_EXPORT WorkStealingPool
+  {
+    public:
+      static const unsigned int NUM_PRIORITIES = 5;      /** number of priority levels, one queue per level and worker. */
+      static const unsigned int MAX_WORKERS_FACTOR = 4;  /** max number of workers (including compensation ones) as factor of the pool size. */
+
+      /** \brief WorkStealingPool class constructor.
+       * \param[in] scheduler scheduler that owns the pool and receives the finished tasks.
+       * \param[in] numWorkers number of workers or 0 to use the number of hardware threads.
+       *
+       */
+      explicit WorkStealingPool(Scheduler *scheduler, unsigned int numWorkers = 0);
+
+      /** \brief WorkStealingPool class destructor. Stops and waits for all the workers.
+       *
+       */
+      ~WorkStealingPool();
+
+      /** \brief Enqueues the task for execution with the given priority.
+       * \param[in] task task smart pointer.
+       * \param[in] priority queue priority.
+       *
+       * If called from a worker of this pool the task is added to the queue of that worker.
+       *
+       */
+      void push(TaskSPtr task, Priority priority);
+
+      /** \brief Moves a queued task to the queue of its new priority. Returns true if the task
+       * was waiting in the pool and false if it's already executing (or unknown).
+       * \param[in] task task raw pointer.
+       * \param[in] previous priority of the queue the task is in.
+       * \param[in] current new priority of the task.
+       *
+       */
+      bool changePriority(TaskPtr task, Priority previous, Priority current);
+
+      /** \brief Re-enqueues a task that has been parked because it was paused before being started.
+       * Returns true if the task was parked.
+       * \param[in] task task raw pointer.
+       *
+       */
+      bool unpark(TaskPtr task);
+
+      /** \brief Stops the workers from taking more tasks and returns the tasks that have not been
+       * started (queued and parked ones).
+       *
+       */
+      QList<TaskSPtr> stop();
+
+      /** \brief Waits for the workers to finish, terminating the ones that exceed the given time.
+       * \param[in] msecs milliseconds to wait for each worker.
+       *
+       */
+      void wait(unsigned long msecs);
+
+      /** \brief Returns the number of workers of the pool, not counting compensation workers.
+       *
+       */
+      unsigned int size() const
+      { return m_queues.size(); }
+
+      /** \brief Returns the number of live workers, including compensation workers.
+       *
+       */
+      unsigned int numberOfWorkers() const;
+
+      /** \brief Returns the number of tasks waiting to be executed.
+       *
+       */
+      unsigned int numberOfQueuedTasks() const
+      { return m_pending; }
+
+      /** \brief Notifies the pool that the task running in the calling worker is going to block.
+       * Calls from threads that aren't workers of the pool are ignored.
+       *
+       */
+      void taskBlocked();
+
+      /** \brief Notifies the pool that the task running in the calling worker is no longer blocked.
+       *
+       */
+      void taskUnblocked();
+
+    private:
+      class Worker;
+
+      /** \struct WorkQueue
+       * \brief Worker's queues, one for each priority level.
+       *
+       */
+      struct WorkQueue
+      {
+        QMutex                mutex;                 /** queues protection mutex.   */
+        std::deque<TaskSPtr>  tasks[NUM_PRIORITIES]; /** task queue for each level. */
+      };
+
+      /** \brief Returns the next task to execute by the given worker or nullptr if none is available.
+       * \param[in] index queue index of the worker or -1 if the worker doesn't own a queue.
+       *
+       */
+      TaskSPtr take(int index);
+
+      /** \brief Executes the task in the calling worker and notifies the scheduler when finished.
+       * \param[in] task task smart pointer.
+       *
+       */
+      void execute(TaskSPtr task);
+
+      /** \brief Blocks the calling worker until there are tasks available or the pool stops. Returns
+       * false if the worker must exit.
+       * \param[in] worker calling worker.
+       *
+       */
+      bool waitForTasks(Worker *worker);
+
+      /** \brief Creates and starts a new worker. Must be called with the workers mutex locked.
+       * \param[in] index index of the queue of the worker or -1 for compensation workers.
+       *
+       */
+      void addWorker(int index);
+
+      Scheduler                              *m_scheduler;     /** scheduler that owns the pool.                                   */
+      std::vector<std::unique_ptr<WorkQueue>> m_queues;        /** workers queues.                                                 */
+      mutable QMutex                          m_workersMutex;  /** protects workers lists.                                         */
+      std::vector<Worker *>                   m_workers;       /** live workers.                                                   */
+      std::vector<Worker *>                   m_retired;       /** finished compensation workers, deleted on destruction.          */
+      QMutex                                  m_parkedMutex;   /** protects parked tasks list.                                     */
+      QList<TaskSPtr>                         m_parked;        /** tasks paused before their execution started.                    */
+      QMutex                                  m_idleMutex;     /** idle condition mutex.                                           */
+      QWaitCondition                          m_idle;          /** wait condition for idle workers.                                */
+      std::atomic<unsigned int>               m_pending;       /** number of queued tasks.                                         */
+      std::atomic<unsigned int>               m_blocked;       /** number of workers blocked by their tasks.                       */
+      std::atomic<unsigned int>               m_nextQueue;     /** round-robin index for tasks pushed from outside the pool.       */
+      std::atomic<bool>                       m_stop;          /** true if the pool has been stopped, false otherwise.             */
+  };
+
+} // namespace ESPINA
+
+#endif // CORE_MULTITASKING_WORKSTEALINGPOOL_H_
@@ -176,6 +176,10 @@ AnalysisSPtr ChannelReader::read(const QFileInfo&      file,
   {
     filter->setStreaming(options.value(VolumetricStreamReader::STREAMING_OPTION) == true);
   }
+  if(options.contains(VolumetricStreamReader::MULTIRESOLUTION_OPTION))
+  {
+    filter->setMultiResolution(options.value(VolumetricStreamReader::MULTIRESOLUTION_OPTION) == true);
+  }
   filter->update();
 
   auto channel = factory->createChannel(filter, 0);
@@ -0,0 +1,473 @@
+/*
+ File: BlockHashMap.hxx
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_UTILS_BLOCKHASHMAP_HXX_
+#define CORE_UTILS_BLOCKHASHMAP_HXX_
+
+// ESPINA
+#include <Core/Utils/Vector3.hxx>
+
+// Qt
+#include <QList>
+#include <QtGlobal>
+
+// C++
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ESPINA
+{
+  namespace Core
+  {
+    namespace Utils
+    {
+      /** \class BlockHashMap
+       * \brief Open addressing hash map of block indexes to values.
+       *
+       * Keys are packed in a single 64 bit integer (21 bits per axis, so each block coordinate must
+       * be in the [-2^20, 2^20) range) and stored with linear probing in a power of two table that
+       * never exceeds a 70% load. Deletion shifts back the following entries of the probe sequence
+       * so there are no tombstones and lookups never degrade after many insertions/removals.
+       *
+       * The interface mimics the QMap subset used by the block based volumes. Iteration order is
+       * not the key order.
+       *
+       */
+      template<typename V>
+      class BlockHashMap
+      {
+        private:
+          using PackedKey = std::uint64_t;
+
+          static const PackedKey    EMPTY        = ~PackedKey(0);                    /** empty slot key marker.                 */
+          static const unsigned int AXIS_BITS    = 21;                               /** bits of each axis in the packed key.   */
+          static const long long    BIAS         = 1LL << 20;                        /** bias to make the coordinates positive. */
+          static const PackedKey    AXIS_MASK    = (PackedKey(1) << AXIS_BITS) - 1; /** mask of one axis in the packed key.    */
+          static const std::size_t  MIN_CAPACITY = 16;                               /** initial table size.                    */
+
+        public:
+          /** \class iterator_base
+           * \brief Iterates the occupied slots of the table.
+           *
+           */
+          template<typename Map, typename Value>
+          class iterator_base
+          {
+            public:
+              /** \brief iterator_base class constructor.
+               * \param[in] map iterated map.
+               * \param[in] slot initial slot, advanced to the first occupied one.
+               *
+               */
+              iterator_base(Map *map, std::size_t slot)
+              : m_map {map}
+              , m_slot{slot}
+              { skipEmpty(); }
+
+              /** \brief Returns the block index of the current entry.
+               *
+               */
+              lliVector3 key() const
+              { return unpack(m_map->m_keys[m_slot]); }
+
+              /** \brief Returns the value of the current entry.
+               *
+               */
+              Value &value() const
+              { return m_map->m_values[m_slot]; }
+
+              Value &operator*() const
+              { return value(); }
+
+              iterator_base &operator++()
+              { ++m_slot; skipEmpty(); return *this; }
+
+              bool operator==(const iterator_base &other) const
+              { return m_slot == other.m_slot; }
+
+              bool operator!=(const iterator_base &other) const
+              { return m_slot != other.m_slot; }
+
+            private:
+              /** \brief Advances the iterator to the next occupied slot.
+               *
+               */
+              void skipEmpty()
+              {
+                const auto capacity = m_map->m_keys.size();
+                while(m_slot < capacity && m_map->m_keys[m_slot] == EMPTY) ++m_slot;
+              }
+
+              Map         *m_map;  /** iterated map.      */
+              std::size_t  m_slot; /** current slot.      */
+          };
+
+          using iterator       = iterator_base<BlockHashMap<V>, V>;
+          using const_iterator = iterator_base<const BlockHashMap<V>, const V>;
+
+          /** \brief BlockHashMap class constructor.
+           *
+           */
+          BlockHashMap()
+          : m_size{0}
+          {}
+
+          /** \brief Returns true if the map has an entry for the given block index.
+           * \param[in] key block index.
+           *
+           */
+          bool contains(const lliVector3 &key) const
+          { return slotOf(pack(key)) != EMPTY_SLOT; }
+
+          /** \brief Returns an iterator to the entry of the given block index or end() if there is
+           * no entry for it. Iterators are invalidated by insertions and removals.
+           * \param[in] key block index.
+           *
+           */
+          iterator find(const lliVector3 &key)
+          {
+            const auto slot = slotOf(pack(key));
+
+            return slot == EMPTY_SLOT ? end() : iterator(this, slot);
+          }
+
+          /** \brief Returns an iterator to the entry of the given block index or cend() if there is
+           * no entry for it. Iterators are invalidated by insertions and removals.
+           * \param[in] key block index.
+           *
+           */
+          const_iterator find(const lliVector3 &key) const
+          {
+            const auto slot = slotOf(pack(key));
+
+            return slot == EMPTY_SLOT ? cend() : const_iterator(this, slot);
+          }
+
+          /** \brief Returns the value of the given block index or a default constructed value if
+           * there is no entry for it.
+           * \param[in] key block index.
+           *
+           */
+          V value(const lliVector3 &key) const
+          {
+            const auto slot = slotOf(pack(key));
+
+            return slot == EMPTY_SLOT ? V() : m_values[slot];
+          }
+
+          /** \brief Returns a reference to the value of the given block index, inserting a default
+           * constructed value if there is no entry for it.
+           * \param[in] key block index.
+           *
+           */
+          V &operator[](const lliVector3 &key)
+          {
+            const auto packed = pack(key);
+
+            auto slot = slotOf(packed);
+            if(slot == EMPTY_SLOT)
+            {
+              slot = insertSlot(packed);
+            }
+
+            return m_values[slot];
+          }
+
+          /** \brief Returns the value of the given block index or a default constructed value if
+           * there is no entry for it.
+           * \param[in] key block index.
+           *
+           */
+          const V operator[](const lliVector3 &key) const
+          { return value(key); }
+
+          /** \brief Inserts or replaces the value of the given block index.
+           * \param[in] key block index.
+           * \param[in] value entry value.
+           *
+           */
+          void insert(const lliVector3 &key, const V &value)
+          { (*this)[key] = value; }
+
+          /** \brief Removes the entry of the given block index and returns its value.
+           * \param[in] key block index.
+           *
+           */
+          V take(const lliVector3 &key)
+          {
+            V result = V();
+
+            const auto slot = slotOf(pack(key));
+            if(slot != EMPTY_SLOT)
+            {
+              result = std::move(m_values[slot]);
+              removeSlot(slot);
+            }
+
+            return result;
+          }
+
+          /** \brief Removes the entry of the given block index. Returns the number of removed
+           * entries (0 or 1).
+           * \param[in] key block index.
+           *
+           */
+          int remove(const lliVector3 &key)
+          {
+            const auto slot = slotOf(pack(key));
+            if(slot == EMPTY_SLOT) return 0;
+
+            removeSlot(slot);
+
+            return 1;
+          }
+
+          /** \brief Removes all the entries and releases the table memory.
+           *
+           */
+          void clear()
+          {
+            std::vector<PackedKey>().swap(m_keys);
+            std::vector<V>().swap(m_values);
+            m_size = 0;
+          }
+
+          /** \brief Returns the number of entries.
+           *
+           */
+          int size() const
+          { return static_cast<int>(m_size); }
+
+          /** \brief Returns true if the map has no entries.
+           *
+           */
+          bool isEmpty() const
+          { return m_size == 0; }
+
+          /** \brief Returns true if the map has no entries.
+           *
+           */
+          bool empty() const
+          { return isEmpty(); }
+
+          /** \brief Returns the block indexes of the entries.
+           *
+           */
+          QList<lliVector3> keys() const
+          {
+            QList<lliVector3> result;
+            result.reserve(size());
+
+            for(auto it = cbegin(); it != cend(); ++it)
+            {
+              result << it.key();
+            }
+
+            return result;
+          }
+
+          /** \brief Returns the value of an arbitrary entry. The map must not be empty.
+           *
+           */
+          const V &first() const
+          {
+            Q_ASSERT(!isEmpty());
+            return *cbegin();
+          }
+
+          iterator begin()
+          { return iterator(this, 0); }
+
+          iterator end()
+          { return iterator(this, m_keys.size()); }
+
+          const_iterator begin() const
+          { return cbegin(); }
+
+          const_iterator end() const
+          { return cend(); }
+
+          const_iterator cbegin() const
+          { return const_iterator(this, 0); }
+
+          const_iterator cend() const
+          { return const_iterator(this, m_keys.size()); }
+
+        private:
+          static const std::size_t EMPTY_SLOT = ~std::size_t(0); /** not found slot marker. */
+
+          /** \brief Returns the packed representation of the given block index.
+           * \param[in] key block index.
+           *
+           */
+          static PackedKey pack(const lliVector3 &key)
+          {
+            Q_ASSERT(-BIAS <= key[0] && key[0] < BIAS);
+            Q_ASSERT(-BIAS <= key[1] && key[1] < BIAS);
+            Q_ASSERT(-BIAS <= key[2] && key[2] < BIAS);
+
+            return (PackedKey(key[0] + BIAS) << (2*AXIS_BITS)) |
+                   (PackedKey(key[1] + BIAS) << AXIS_BITS)     |
+                    PackedKey(key[2] + BIAS);
+          }
+
+          /** \brief Returns the block index of the given packed key.
+           * \param[in] packed packed key.
+           *
+           */
+          static lliVector3 unpack(const PackedKey packed)
+          {
+            return lliVector3{static_cast<long long>((packed >> (2*AXIS_BITS)) & AXIS_MASK) - BIAS,
+                              static_cast<long long>((packed >> AXIS_BITS) & AXIS_MASK)     - BIAS,
+                              static_cast<long long>( packed & AXIS_MASK)                   - BIAS};
+          }
+
+          /** \brief Returns the preferred slot of the given packed key (splitmix64 finalizer).
+           * \param[in] packed packed key.
+           *
+           */
+          std::size_t idealSlot(PackedKey packed) const
+          {
+            packed ^= packed >> 30;
+            packed *= 0xbf58476d1ce4e5b9ULL;
+            packed ^= packed >> 27;
+            packed *= 0x94d049bb133111ebULL;
+            packed ^= packed >> 31;
+
+            return static_cast<std::size_t>(packed) & (m_keys.size() - 1);
+          }
+
+          /** \brief Returns the slot of the given packed key or EMPTY_SLOT if not present.
+           * \param[in] packed packed key.
+           *
+           */
+          std::size_t slotOf(const PackedKey packed) const
+          {
+            if(m_keys.empty()) return EMPTY_SLOT;
+
+            const auto mask = m_keys.size() - 1;
+
+            auto slot = idealSlot(packed);
+            while(m_keys[slot] != EMPTY)
+            {
+              if(m_keys[slot] == packed) return slot;
+
+              slot = (slot + 1) & mask;
+            }
+
+            return EMPTY_SLOT;
+          }
+
+          /** \brief Inserts the packed key (that must not be present) with a default constructed
+           * value and returns its slot.
+           * \param[in] packed packed key.
+           *
+           */
+          std::size_t insertSlot(const PackedKey packed)
+          {
+            if(10 * (m_size + 1) > 7 * m_keys.size())
+            {
+              rehash(m_keys.empty() ? MIN_CAPACITY : 2 * m_keys.size());
+            }
+
+            const auto mask = m_keys.size() - 1;
+
+            auto slot = idealSlot(packed);
+            while(m_keys[slot] != EMPTY)
+            {
+              slot = (slot + 1) & mask;
+            }
+
+            m_keys[slot]   = packed;
+            m_values[slot] = V();
+            ++m_size;
+
+            return slot;
+          }
+
+          /** \brief Empties the given slot, moving back the entries of its probe sequence.
+           * \param[in] slot occupied slot.
+           *
+           */
+          void removeSlot(std::size_t slot)
+          {
+            const auto mask = m_keys.size() - 1;
+
+            auto next = slot;
+            while(true)
+            {
+              next = (next + 1) & mask;
+              if(m_keys[next] == EMPTY) break;
+
+              const auto ideal = idealSlot(m_keys[next]);
+
+              // the entry can't be moved if its ideal slot lies cyclically in (slot, next]
+              const auto inRange = (slot <= next) ? (slot < ideal && ideal <= next)
+                                                  : (slot < ideal || ideal <= next);
+              if(!inRange)
+              {
+                m_keys[slot]   = m_keys[next];
+                m_values[slot] = std::move(m_values[next]);
+                slot = next;
+              }
+            }
+
+            m_keys[slot]   = EMPTY;
+            m_values[slot] = V();
+            --m_size;
+          }
+
+          /** \brief Resizes the table to the given capacity, reinserting all the entries.
+           * \param[in] capacity new capacity, must be a power of two.
+           *
+           */
+          void rehash(const std::size_t capacity)
+          {
+            std::vector<PackedKey> keys(capacity, PackedKey{EMPTY});
+            std::vector<V>         values(capacity);
+
+            keys.swap(m_keys);
+            values.swap(m_values);
+
+            const auto mask = capacity - 1;
+            for(std::size_t i = 0; i < keys.size(); ++i)
+            {
+              if(keys[i] == EMPTY) continue;
+
+              auto slot = idealSlot(keys[i]);
+              while(m_keys[slot] != EMPTY)
+              {
+                slot = (slot + 1) & mask;
+              }
+
+              m_keys[slot]   = keys[i];
+              m_values[slot] = std::move(values[i]);
+            }
+          }
+
+          std::vector<PackedKey> m_keys;   /** packed keys table, EMPTY for free slots. */
+          std::vector<V>         m_values; /** values table.                            */
+          std::size_t            m_size;   /** number of entries.                       */
+      };
+    }
+  }
+}
+
+#endif // CORE_UTILS_BLOCKHASHMAP_HXX_
@@ -171,6 +171,55 @@ bool removeRecursively(const QString &dirName)
   return result;
 }
 
+//----------------------------------------------------------------------------
+QString deferredKey(const QString &name)
+{
+  return QDir::cleanPath(QDir::fromNativeSeparators(name));
+}
+
+//----------------------------------------------------------------------------
+void writeSnapshot(const QDir &storageDir, const SnapshotData &data)
+{
+  QFileInfo fileName(storageDir.absoluteFilePath(data.first));
+
+  if(!storageDir.mkpath(fileName.absolutePath()))
+  {
+    auto message = QObject::tr("Can't create path: %1").arg(fileName.absolutePath());
+    auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+
+    throw EspinaException(message, details);
+  }
+
+  QFile file(fileName.absoluteFilePath());
+  if (!file.open(QIODevice::WriteOnly))
+  {
+    auto message = QObject::tr("Can't create file: %1").arg(fileName.absoluteFilePath()).arg(file.errorString());
+    auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+
+    throw EspinaException(message, details);
+  }
+  else
+  {
+    if(-1 == file.write(data.second))
+    {
+      auto message = QObject::tr("Can't write data to file: %1. Error: %2").arg(fileName.absoluteFilePath()).arg(file.errorString());
+      auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+
+      throw EspinaException(message, details);
+    }
+
+    if(!file.flush() || file.error() != QFileDevice::NoError)
+    {
+      auto message = QObject::tr("Error flushing or writing file: %1. Error: %2").arg(fileName.absoluteFilePath()).arg(file.errorString());
+      auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+
+      throw EspinaException(message, details);
+    }
+
+    file.close();
+  }
+}
+
 //----------------------------------------------------------------------------
 TemporalStorage::TemporalStorage(const QDir *parent)
 : m_uuid    {QUuid::createUuid()}
@@ -222,6 +271,22 @@ QString TemporalStorage::findFile(const QString &fileName) const
 {
   for (auto storage : s_Storages)
   {
+    QStringList deferred;
+
+    {
+      QMutexLocker lock(&storage->m_deferredMutex);
+
+      for(auto name: storage->m_deferred.keys())
+      {
+        if(name.split('/').last() == fileName) deferred << name;
+      }
+    }
+
+    for(auto name: deferred)
+    {
+      storage->extractDeferred(name);
+    }
+
     QStack<QString> stack;
     stack.push(storage->m_storageDir.absolutePath());
 
@@ -252,49 +317,187 @@ QString TemporalStorage::findFile(const QString &fileName) const
 //----------------------------------------------------------------------------
 void TemporalStorage::saveSnapshot(SnapshotData data)
 {
-  QFileInfo fileName(m_storageDir.absoluteFilePath(data.first));
+  // the saved contents replace the deferred ones.
+  discardDeferred(data.first);
+
+  writeSnapshot(m_storageDir, data);
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::deferSnapshot(const QString &descriptor, const QString &origin, SnapshotSource source)
+{
+  auto deferred = std::make_shared<DeferredSnapshot>();
+  deferred->origin    = origin;
+  deferred->source    = source;
+  deferred->extracted = false;
+
+  QMutexLocker lock(&m_deferredMutex);
+  m_deferred.insert(deferredKey(descriptor), deferred);
+}
+
+//----------------------------------------------------------------------------
+int TemporalStorage::deferredSnapshots() const
+{
+  QMutexLocker lock(&m_deferredMutex);
+
+  return m_deferred.size();
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::extractDeferredSnapshots(const QString &origin) const
+{
+  QList<QPair<QString, DeferredSnapshotSPtr>> pending;
 
-  if(!m_storageDir.mkpath(fileName.absolutePath()))
   {
-    auto message = QObject::tr("Can't create path: %1").arg(fileName.absolutePath());
-    auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+    QMutexLocker lock(&m_deferredMutex);
 
-    throw EspinaException(message, details);
+    for(auto it = m_deferred.constBegin(); it != m_deferred.constEnd(); ++it)
+    {
+      if(origin.isEmpty() || it.value()->origin == origin)
+      {
+        pending << qMakePair(it.key(), it.value());
+      }
+    }
   }
 
-  QFile file(fileName.absoluteFilePath());
-  if (!file.open(QIODevice::WriteOnly))
+  for(auto &deferred: pending)
   {
-    auto message = QObject::tr("Can't create file: %1").arg(fileName.absoluteFilePath()).arg(file.errorString());
-    auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
-
-    throw EspinaException(message, details);
+    extract(deferred.first, deferred.second);
   }
-  else
+}
+
+//----------------------------------------------------------------------------
+QString TemporalStorage::absoluteFilePath(const QString &filename) const
+{
+  extractDeferred(filename);
+
+  return m_storageDir.absoluteFilePath(filename);
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::extractDeferred(const QString &name) const
+{
+  QList<QPair<QString, DeferredSnapshotSPtr>> pending;
+
   {
-    if(-1 == file.write(data.second))
+    QMutexLocker lock(&m_deferredMutex);
+
+    if(m_deferred.isEmpty() || name.isEmpty()) return;
+
+    const auto key  = deferredKey(name);
+    const auto dot  = key.lastIndexOf('.');
+    const auto base = (dot > key.lastIndexOf('/')) ? key.left(dot) : key;
+
+    // companion files share the name without the extension and are consecutive in the map.
+    for(auto it = m_deferred.lowerBound(base); it != m_deferred.constEnd() && it.key().startsWith(base); ++it)
     {
-      auto message = QObject::tr("Can't write data to file: %1. Error: %2").arg(fileName.absoluteFilePath()).arg(file.errorString());
-      auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+      const auto extension = it.key().mid(base.length());
 
-      throw EspinaException(message, details);
+      if(it.key() == key || (extension.startsWith('.') && !extension.contains('/')))
+      {
+        pending << qMakePair(it.key(), it.value());
+      }
     }
+  }
 
-    if(!file.flush() || file.error() != QFileDevice::NoError)
+  for(auto &deferred: pending)
+  {
+    extract(deferred.first, deferred.second);
+  }
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::extractDeferredPath(const QString &path) const
+{
+  QList<QPair<QString, DeferredSnapshotSPtr>> pending;
+
+  {
+    QMutexLocker lock(&m_deferredMutex);
+
+    if(m_deferred.isEmpty()) return;
+
+    auto prefix = deferredKey(path);
+    if(prefix == ".") prefix.clear();
+    if(!prefix.isEmpty() && !prefix.endsWith('/')) prefix += '/';
+
+    for(auto it = m_deferred.lowerBound(prefix); it != m_deferred.constEnd() && it.key().startsWith(prefix); ++it)
     {
-      auto message = QObject::tr("Error flushing or writing file: %1. Error: %2").arg(fileName.absoluteFilePath()).arg(file.errorString());
-      auto details = QObject::tr("TemporalStorage::saveSnapshot() -> ") + message;
+      pending << qMakePair(it.key(), it.value());
+    }
+  }
 
-      throw EspinaException(message, details);
+  for(auto &deferred: pending)
+  {
+    extract(deferred.first, deferred.second);
+  }
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::extract(const QString &key, DeferredSnapshotSPtr deferred) const
+{
+  {
+    QMutexLocker lock(&deferred->mutex);
+
+    if(!deferred->extracted)
+    {
+      deferred->extracted = true;
+
+      try
+      {
+        auto data = deferred->source();
+
+        if(data.isEmpty())
+        {
+          qWarning() << "TemporalStorage::extract() -> Empty deferred file:" << key << "from" << deferred->origin;
+        }
+        else
+        {
+          writeSnapshot(m_storageDir, SnapshotData(key, data));
+        }
+      }
+      catch(const EspinaException &e)
+      {
+        qWarning() << "TemporalStorage::extract() -> Couldn't extract deferred file:" << key << "Cause:" << e.what();
+      }
     }
 
-    file.close();
+    deferred->source = nullptr;
+  }
+
+  QMutexLocker lock(&m_deferredMutex);
+  if(m_deferred.value(key) == deferred)
+  {
+    m_deferred.remove(key);
+  }
+}
+
+//----------------------------------------------------------------------------
+void TemporalStorage::discardDeferred(const QString &name) const
+{
+  DeferredSnapshotSPtr deferred;
+
+  {
+    QMutexLocker lock(&m_deferredMutex);
+
+    if(m_deferred.isEmpty()) return;
+
+    deferred = m_deferred.take(deferredKey(name));
+  }
+
+  if(deferred)
+  {
+    // waits for any running extraction to finish before the file is overwritten.
+    QMutexLocker lock(&deferred->mutex);
+    deferred->extracted = true;
+    deferred->source    = nullptr;
   }
 }
 
 //----------------------------------------------------------------------------
 QByteArray TemporalStorage::snapshot(const QString &descriptor) const
 {
+  extractDeferred(descriptor);
+
   QString fileName = QDir::fromNativeSeparators(m_storageDir.absoluteFilePath(descriptor));
 
   QByteArray data;
@@ -324,6 +527,8 @@ Snapshot TemporalStorage::snapshots(const QString &relativePath, TemporalStorage
 {
   Snapshot result;
 
+  extractDeferredPath(relativePath);
+
   QDir dir = QDir::fromNativeSeparators(m_storageDir.absoluteFilePath(relativePath));
 
   for (auto file : dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot))
@@ -348,6 +553,12 @@ Snapshot TemporalStorage::snapshots(const QString &relativePath, TemporalStorage
 //----------------------------------------------------------------------------
 bool TemporalStorage::exists(const QString &name) const
 {
+  {
+    QMutexLocker lock(&m_deferredMutex);
+
+    if(m_deferred.contains(deferredKey(name))) return true;
+  }
+
   QFileInfo file(m_storageDir.absoluteFilePath(QDir::fromNativeSeparators(name)));
   return file.exists();
 }
@@ -355,6 +566,9 @@ bool TemporalStorage::exists(const QString &name) const
 //----------------------------------------------------------------------------
 bool TemporalStorage::rename(const QString &oldName, const QString &newName) const
 {
+  extractDeferred(oldName);
+  extractDeferred(newName);
+
   QFileInfo oldFile(m_storageDir.absoluteFilePath(QDir::fromNativeSeparators(oldName)));
   QFileInfo newFile(m_storageDir.absoluteFilePath(QDir::fromNativeSeparators(newName)));
 
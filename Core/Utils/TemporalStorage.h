@@ -27,12 +27,15 @@
 // Qt
 #include <QPair>
 #include <QDir>
+#include <QMap>
+#include <QMutex>
 #include <QUuid>
 #include <QSettings>
 
 // C++
 #include <memory>
 #include <cstdint>
+#include <functional>
 
 namespace ESPINA
 {
@@ -44,6 +47,8 @@ namespace ESPINA
     public:
       enum class Mode: char { RECURSIVE = 1, NORECURSIVE = 2 };
 
+      using SnapshotSource = std::function<QByteArray()>;
+
     public:
       static QList<TemporalStorage *> s_Storages; /** temporal storage objects list for finding files in other storages. */
 
@@ -64,6 +69,26 @@ namespace ESPINA
        */
       void saveSnapshot(SnapshotData data);
 
+      /** \brief Registers a file whose contents will be written to the storage the first time it's accessed.
+       * \param[in] descriptor file name relative to the storage directory.
+       * \param[in] origin identifier of the place the contents are read from (i.e. the SEG file name).
+       * \param[in] source function returning the contents of the file, called at most once.
+       *
+       *  Files with the same name and different extension (i.e. mhd header and raw data) are written together.
+       */
+      void deferSnapshot(const QString &descriptor, const QString &origin, SnapshotSource source);
+
+      /** \brief Returns the number of deferred files that haven't been written to the storage yet.
+       *
+       */
+      int deferredSnapshots() const;
+
+      /** \brief Writes to the storage the deferred files of the given origin, or all of them if empty.
+       * \param[in] origin identifier of the place the contents are read from.
+       *
+       */
+      void extractDeferredSnapshots(const QString &origin = QString()) const;
+
       /** \brief Returns file absolute path if found in any storage created in the session.
        * \param[in] fileName File name to search for.
        */
@@ -89,12 +114,12 @@ namespace ESPINA
        */
       void makePath(const QString& path);
 
-      /** \brief Returns the absolute file path of the specified file in the storage.
+      /** \brief Returns the absolute file path of the specified file in the storage. If the file
+       * is deferred it's written to the storage before returning.
        * \param[in] filename file name relative to storage parent directory.
        *
        */
-      QString absoluteFilePath(const QString &filename) const
-      { return m_storageDir.absoluteFilePath(filename); }
+      QString absoluteFilePath(const QString &filename) const;
 
       /** \brief Returns true if final given as argument exists in this storage.
        *
@@ -132,10 +157,48 @@ namespace ESPINA
       { return m_baseStorageDir; }
 
     private:
+      struct DeferredSnapshot
+      {
+        QString        origin;    /** place the contents are read from.     */
+        SnapshotSource source;    /** function returning the contents.      */
+        QMutex         mutex;     /** serializes the extraction.            */
+        bool           extracted; /** true if already written or discarded. */
+      };
+
+      using DeferredSnapshotSPtr = std::shared_ptr<DeferredSnapshot>;
+
+      /** \brief Writes to the storage the deferred file with the given name and its companion files, if any.
+       * \param[in] name file name relative to the storage directory.
+       *
+       */
+      void extractDeferred(const QString &name) const;
+
+      /** \brief Writes to the storage the deferred files inside the given path.
+       * \param[in] path path relative to the storage directory.
+       *
+       */
+      void extractDeferredPath(const QString &path) const;
+
+      /** \brief Writes the given deferred file to the storage and removes it from the deferred files.
+       * \param[in] key normalized file name relative to the storage directory.
+       * \param[in] deferred deferred file information.
+       *
+       */
+      void extract(const QString &key, DeferredSnapshotSPtr deferred) const;
+
+      /** \brief Discards the deferred file with the given name, if any.
+       * \param[in] name file name relative to the storage directory.
+       *
+       */
+      void discardDeferred(const QString &name) const;
+
       QUuid        m_uuid;           /** unique id for persistent object. */
       QDir         m_storageDir;     /** writable directory.              */
       QDir         m_baseStorageDir; /** storage root dir. */
       QSettings   *m_settings;       /** session settings object.         */
+
+      mutable QMutex                              m_deferredMutex; /** protects the deferred files map.                  */
+      mutable QMap<QString, DeferredSnapshotSPtr> m_deferred;      /** files not written yet, indexed by normalized name. */
   };
 
   using TemporalStorageSPtr = std::shared_ptr<TemporalStorage>;
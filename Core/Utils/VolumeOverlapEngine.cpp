@@ -0,0 +1,307 @@
+/*
+ File: VolumeOverlapEngine.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "VolumeOverlapEngine.h"
+#include <Core/Analysis/Data/VolumetricData.hxx>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Utils/SpatialUtils.hxx>
+
+// Qt
+#include <QtConcurrent/QtConcurrent>
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+using namespace ESPINA;
+using namespace ESPINA::Core::Utils;
+
+namespace
+{
+  /** \brief Returns the integer division rounded towards minus infinity.
+   *
+   */
+  inline long long floorDivision(const long long value, const long long divisor)
+  {
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+  }
+
+  /** \brief Returns the key of the given pair of volumes.
+   *
+   */
+  inline quint64 pairKey(const int first, const int second)
+  {
+    return (static_cast<quint64>(first) << 32) | static_cast<quint32>(second);
+  }
+}
+
+//-----------------------------------------------------------------------------
+VolumeOverlapEngine::VolumeOverlapEngine(const int blockSize)
+: m_blockSize{std::max(1, blockSize)}
+{
+}
+
+//-----------------------------------------------------------------------------
+int VolumeOverlapEngine::add(OutputSPtr output)
+{
+  if(!output || !output->isValid() || !hasVolumetricData(output)) return -1;
+
+  const auto bounds = readLockVolume(output)->bounds();
+
+  if(!bounds.areValid()) return -1;
+
+  if(m_volumes.isEmpty())
+  {
+    m_reference = bounds;
+  }
+  else if(!isCompatible(m_reference, bounds))
+  {
+    return -1;
+  }
+
+  const auto region = equivalentRegion<itkVolumeType>(m_reference.origin(), m_reference.spacing(), bounds.bounds());
+
+  Volume volume;
+  volume.output = output;
+  for(int i = 0; i < 3; ++i)
+  {
+    volume.min[i] = region.GetIndex(i);
+    volume.max[i] = region.GetIndex(i) + static_cast<long long>(region.GetSize(i)) - 1;
+  }
+
+  const int index = m_volumes.size();
+  m_volumes << volume;
+
+  // blocks are extended one voxel in the positive directions to find the contacts on their faces.
+  long long first[3], last[3];
+  for(int i = 0; i < 3; ++i)
+  {
+    first[i] = floorDivision(volume.min[i] - 1, m_blockSize);
+    last[i]  = floorDivision(volume.max[i], m_blockSize);
+  }
+
+  for(auto z = first[2]; z <= last[2]; ++z)
+  {
+    for(auto y = first[1]; y <= last[1]; ++y)
+    {
+      for(auto x = first[0]; x <= last[0]; ++x)
+      {
+        auto &block = m_blocks[key(x, y, z)];
+
+        if(block.volumes.isEmpty())
+        {
+          block.index[0] = x;
+          block.index[1] = y;
+          block.index[2] = z;
+        }
+
+        block.volumes << index;
+      }
+    }
+  }
+
+  return index;
+}
+
+//-----------------------------------------------------------------------------
+VolumeOverlapEngine::OverlapList VolumeOverlapEngine::overlaps(std::function<bool()> canContinue) const
+{
+  QVector<Block> blocks;
+  for(auto &block: m_blocks)
+  {
+    if(block.volumes.size() > 1) blocks << block;
+  }
+
+  auto processBlock = [this, &canContinue](Block &block)
+  {
+    if(canContinue && !canContinue()) return;
+
+    process(block);
+  };
+
+  QtConcurrent::blockingMap(blocks, processBlock);
+
+  OverlapList result;
+
+  if(canContinue && !canContinue()) return result;
+
+  QHash<quint64, Overlap> merged;
+  for(auto &block: blocks)
+  {
+    for(auto &overlap: block.result)
+    {
+      auto pair = pairKey(overlap.first, overlap.second);
+
+      if(merged.contains(pair))
+      {
+        merged[pair].voxels   += overlap.voxels;
+        merged[pair].contacts += overlap.contacts;
+      }
+      else
+      {
+        merged.insert(pair, overlap);
+      }
+    }
+  }
+
+  result = merged.values();
+
+  std::sort(result.begin(), result.end(), [](const Overlap &lhs, const Overlap &rhs)
+  {
+    return (lhs.first < rhs.first) || (lhs.first == rhs.first && lhs.second < rhs.second);
+  });
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+void VolumeOverlapEngine::process(Block &block) const
+{
+  const int size[3]{m_blockSize + 1, m_blockSize + 1, m_blockSize + 1};
+  const long long min[3]{block.index[0] * m_blockSize, block.index[1] * m_blockSize, block.index[2] * m_blockSize};
+  const int strides[3]{1, size[0], size[0]*size[1]};
+
+  auto volumes = block.volumes;
+  std::sort(volumes.begin(), volumes.end());
+
+  QVector<QVector<unsigned char>> masks;
+  for(auto index: volumes)
+  {
+    masks << mask(m_volumes[index], min, size);
+  }
+
+  auto touch = [](const Volume &lhs, const Volume &rhs)
+  {
+    for(int i = 0; i < 3; ++i)
+    {
+      if(lhs.max[i] + 1 < rhs.min[i] || rhs.max[i] + 1 < lhs.min[i]) return false;
+    }
+
+    return true;
+  };
+
+  for(int i = 0; i < volumes.size(); ++i)
+  {
+    for(int j = i + 1; j < volumes.size(); ++j)
+    {
+      if(!touch(m_volumes[volumes[i]], m_volumes[volumes[j]])) continue;
+
+      const auto maskI = masks.at(i).constData();
+      const auto maskJ = masks.at(j).constData();
+
+      Overlap overlap{volumes[i], volumes[j], 0, 0};
+
+      // only the voxels of the block are visited, the halo voxels are visited by the next blocks.
+      for(int z = 0; z < m_blockSize; ++z)
+      {
+        for(int y = 0; y < m_blockSize; ++y)
+        {
+          auto p = z * strides[2] + y * strides[1];
+
+          for(int x = 0; x < m_blockSize; ++x, ++p)
+          {
+            const auto inI = maskI[p];
+            const auto inJ = maskJ[p];
+
+            if(!inI && !inJ) continue;
+
+            if(inI && inJ) ++overlap.voxels;
+
+            for(auto stride: strides)
+            {
+              overlap.contacts += (inI & maskJ[p + stride]) + (inJ & maskI[p + stride]);
+            }
+          }
+        }
+      }
+
+      if(overlap.voxels > 0 || overlap.contacts > 0)
+      {
+        block.result << overlap;
+      }
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+QVector<unsigned char> VolumeOverlapEngine::mask(const Volume &volume, const long long min[3], const int size[3]) const
+{
+  QVector<unsigned char> result(size[0] * size[1] * size[2], 0);
+
+  itkVolumeType::RegionType region;
+  for(int i = 0; i < 3; ++i)
+  {
+    auto first = std::max(min[i], volume.min[i]);
+    auto last  = std::min(min[i] + size[i] - 1, volume.max[i]);
+
+    if(first > last) return result;
+
+    region.SetIndex(i, first);
+    region.SetSize(i, last - first + 1);
+  }
+
+  const auto origin  = m_reference.origin();
+  const auto spacing = m_reference.spacing();
+  const auto bounds  = equivalentBounds<itkVolumeType>(origin, spacing, region);
+  const auto image   = readLockVolume(volume.output)->itkImage(bounds);
+
+  const auto imageRegion = image->GetLargestPossibleRegion();
+
+  // the image has its own origin, its first voxel is located in the engine grid.
+  itkVolumeType::PointType point;
+  image->TransformIndexToPhysicalPoint(imageRegion.GetIndex(), point);
+
+  long long offset[3];
+  for(int i = 0; i < 3; ++i)
+  {
+    offset[i] = std::llround((point[i] - origin[i]) / spacing[i]) - min[i];
+  }
+
+  auto buffer = image->GetBufferPointer();
+  for(unsigned int z = 0; z < imageRegion.GetSize(2); ++z)
+  {
+    const auto mz = offset[2] + z;
+
+    for(unsigned int y = 0; y < imageRegion.GetSize(1); ++y)
+    {
+      const auto my = offset[1] + y;
+
+      for(unsigned int x = 0; x < imageRegion.GetSize(0); ++x, ++buffer)
+      {
+        const auto mx = offset[0] + x;
+
+        if(*buffer != SEG_BG_VALUE && 0 <= mx && mx < size[0] && 0 <= my && my < size[1] && 0 <= mz && mz < size[2])
+        {
+          result[(mz * size[1] + my) * size[0] + mx] = 1;
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+quint64 VolumeOverlapEngine::key(const long long x, const long long y, const long long z)
+{
+  const quint64 mask = 0x1FFFFF;
+
+  return ((static_cast<quint64>(x) & mask) << 42) | ((static_cast<quint64>(y) & mask) << 21) | (static_cast<quint64>(z) & mask);
+}
@@ -0,0 +1,134 @@
+/*
+ File: VolumeOverlapEngine.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_UTILS_VOLUME_OVERLAP_ENGINE_H_
+#define CORE_UTILS_VOLUME_OVERLAP_ENGINE_H_
+
+#include <Core/EspinaCore_Export.h>
+
+// ESPINA
+#include <Core/Types.h>
+#include <Core/Utils/VolumeBounds.h>
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+// C++
+#include <functional>
+
+namespace ESPINA
+{
+  namespace Core
+  {
+    namespace Utils
+    {
+      /** \class VolumeOverlapEngine
+       * \brief Computes the overlapping and touching pairs of a set of volumes in a single sweep.
+       *
+       * The volumes are indexed in a sparse grid of blocks and each block is read once for every
+       * volume present in it, instead of extracting the common region of every pair of volumes.
+       * All the volumes must be compatible with the first one added (same spacing and aligned origins).
+       *
+       */
+      class EspinaCore_EXPORT VolumeOverlapEngine
+      {
+        public:
+          struct Overlap
+          {
+            int                first;    /** index of the first volume.                                                 */
+            int                second;   /** index of the second volume, greater than the first one.                    */
+            unsigned long long voxels;   /** number of voxels in both volumes.                                          */
+            unsigned long long contacts; /** number of voxel faces shared by a voxel of each volume (6-connectivity).  */
+          };
+
+          using OverlapList = QList<Overlap>;
+
+          static const int DEFAULT_BLOCK_SIZE = 32;
+
+          /** \brief VolumeOverlapEngine class constructor.
+           * \param[in] blockSize size of the index blocks in voxels.
+           *
+           */
+          explicit VolumeOverlapEngine(const int blockSize = DEFAULT_BLOCK_SIZE);
+
+          /** \brief Adds the volumetric data of the given output to the engine. Returns the index of the volume or
+           * -1 if the output doesn't have volumetric data or it's not compatible with the previous volumes.
+           * \param[in] output output with volumetric data.
+           *
+           */
+          int add(OutputSPtr output);
+
+          /** \brief Returns the number of volumes of the engine.
+           *
+           */
+          int size() const
+          { return m_volumes.size(); }
+
+          /** \brief Returns the pairs of volumes that overlap or touch each other. Blocks are processed in parallel.
+           * \param[in] canContinue function returning false to stop the computation, can be null.
+           *
+           */
+          OverlapList overlaps(std::function<bool()> canContinue = nullptr) const;
+
+        private:
+          struct Volume
+          {
+            OutputSPtr output;   /** output with the volumetric data.                */
+            long long  min[3];   /** first voxel index in the engine grid.           */
+            long long  max[3];   /** last voxel index in the engine grid.            */
+          };
+
+          struct Block
+          {
+            long long                  index[3]; /** block coordinates.                                 */
+            QVector<int>               volumes;  /** volumes with voxels in the block or its halo.      */
+            QVector<Overlap>           result;   /** overlaps found in the block.                       */
+          };
+
+          /** \brief Computes the overlaps between the volumes of the given block.
+           * \param[in,out] block block to process.
+           *
+           */
+          void process(Block &block) const;
+
+          /** \brief Returns the mask of the voxels of the volume in the given region of the engine grid.
+           * \param[in] volume volume to read.
+           * \param[in] min first voxel of the region.
+           * \param[in] size size of the region.
+           *
+           */
+          QVector<unsigned char> mask(const Volume &volume, const long long min[3], const int size[3]) const;
+
+          /** \brief Returns the key of the block with the given coordinates.
+           *
+           */
+          static quint64 key(const long long x, const long long y, const long long z);
+
+          const int               m_blockSize; /** size of the blocks in voxels.                     */
+          VolumeBounds            m_reference; /** bounds of the first volume, defines the grid.     */
+          QVector<Volume>         m_volumes;   /** indexed volumes.                                  */
+          QHash<quint64, Block>   m_blocks;    /** blocks with at least a volume.                    */
+      };
+    }
+  }
+}
+
+#endif // CORE_UTILS_VOLUME_OVERLAP_ENGINE_H_
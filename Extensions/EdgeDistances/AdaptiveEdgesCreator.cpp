@@ -20,6 +20,7 @@
 
 // ESPINA
 #include "AdaptiveEdgesCreator.h"
+#include "AdaptiveEdgesUtils.h"
 #include "ChannelEdges.h"
 #include <Core/Analysis/Data/VolumetricData.hxx>
 #include <Core/Analysis/Data/VolumetricDataUtils.hxx>
@@ -33,46 +34,20 @@
 #include <vtkImageData.h>
 #include <vtkSmartPointer.h>
 #include <vtkPoints.h>
-#include <vtkOBBTree.h>
 #include <itkImageToVTKImageFilter.h>
-#include <vtkMath.h>
+
+// Qt
+#include <QtConcurrent/QtConcurrent>
+
+// C++
+#include <algorithm>
 
 using namespace ESPINA;
 using namespace ESPINA::Extensions;
 
-//-----------------------------------------------------------------------------
-vtkSmartPointer<vtkPoints> plane(const double corner[3],
-                                 const double max[3],
-                                 const double mid[3],
-                                 const double min[3])
+namespace
 {
-  auto points = vtkSmartPointer<vtkPoints>::New();
-  points->SetDataTypeToDouble();
-  points->SetNumberOfPoints(4);
-
-  double x[3];
-  // {0,0,0} <- in a cube
-  x[0] = corner[0];
-  x[1] = corner[1];
-  x[2] = corner[2];
-  points->InsertPoint(0,x);
-  // {1,0,0} <- in a cube
-  x[0] = corner[0] + mid[0];
-  x[1] = corner[1] + mid[1];
-  x[2] = corner[2] + mid[2];
-  points->InsertPoint(1,x);
-  // {0,1,0} <- in a cube
-  x[0] = corner[0] + max[0];
-  x[1] = corner[1] + max[1];
-  x[2] = corner[2] + max[2];
-  points->InsertPoint(2,x);
-  // {1,1,0} <- in a cube
-  x[0] = corner[0] + max[0] + mid[0];
-  x[1] = corner[1] + max[1] + mid[1];
-  x[2] = corner[2] + max[2] + mid[2];
-  points->InsertPoint(3,x);
-
-  return points;
+  const int SLICES_PER_THREAD = 8; /** slices computed by each thread between progress reports. */
 }
 
 //------------------------------------------------------------------------
@@ -100,9 +75,8 @@ void AdaptiveEdgesCreator::computeEdges()
   auto borderVertices = vtkSmartPointer<vtkPoints>::New();
   borderVertices->SetDataTypeToDouble();
 
-  int dim[3], extent[6];
+  int extent[6];
   double spacing[3];
-  image->GetDimensions(dim);
   image->GetExtent(extent);
   image->GetSpacing(spacing);
 
@@ -111,10 +85,6 @@ void AdaptiveEdgesCreator::computeEdges()
 
   m_extension->m_computedVolume = 0;
 
-  auto xMin = extent[0];
-  auto xMax = extent[1];
-  auto yMin = extent[2];
-  auto yMax = extent[3];
   auto zMin = extent[4];
   auto zMax = extent[5];
 
@@ -122,128 +92,59 @@ void AdaptiveEdgesCreator::computeEdges()
   const int upperThreshold = (backgroundColor + threshold) > 255 ? 255 : backgroundColor + threshold;
   const int lowerThreshold = (backgroundColor - threshold) <   0 ?   0 : backgroundColor - threshold;
 
-  auto numComponents   = image->GetNumberOfScalarComponents();
+  // slices are independent, their borders are computed in parallel in batches to report progress
+  // and stop on cancellation. The edges are assembled afterwards in slice order.
+  QVector<AdaptiveEdgesUtils::SliceBorder> borders(zMax - zMin + 1);
+  auto bordersData = borders.data();
 
-  vtkIdType lastCell[4] = {-1, -1, -1, -1};
-  auto z = zMin;
-  while (canExecute() && z <= zMax)
+  auto computeSlice = [&](int &z)
   {
-    if (zMax - zMin != 0)
-    {
-      reportProgress((static_cast<double>(z - zMin) / static_cast<double>(zMax - zMin))*50.0);
-    }
-    else
-    {
-      reportProgress(0);
-    }
+    bordersData[z - zMin] = AdaptiveEdgesUtils::sliceBorder(image, z, bounds, lowerThreshold, upperThreshold);
+  };
 
-    // Look for images borders in z slice:
-    // We are going to take all bordering pixels (almost black) and then extract its oriented
-    // bounding box.
-    // We ignore pixels until we find the first non-black pixel
-    // Then, we keep last non-black pixel as the other side of the line
-    auto nonBlackPixels = vtkSmartPointer<vtkPoints>::New();
-    nonBlackPixels->SetDataTypeToDouble();
+  QVector<int> slices;
+  slices.reserve(borders.size());
+  for (auto z = zMin; z <= zMax; ++z)
+  {
+    slices << z;
+  }
 
-    for (auto y = yMin; y <= yMax; y++)
-    {
-      auto nonBlackPixelDetected = false;
-      double p1[3], p2[3];
-      auto singlePixel = true;
-      for (auto x = xMin; x <= xMax; x++)
-      {
-        auto nonBlackPixel = false;
-        auto pixelPtr = reinterpret_cast<unsigned char *>(image->GetScalarPointer(x,y,z));
-        for (int c = 0; c < numComponents; c++)
-        {
-          nonBlackPixel = nonBlackPixel || (pixelPtr[c] > upperThreshold) || (pixelPtr[c] < lowerThreshold);
-        }
+  const int batchSize = std::max(1, QThread::idealThreadCount()) * SLICES_PER_THREAD;
 
-        if (nonBlackPixel)
-        {
-          if (nonBlackPixelDetected)
-          {
-            // First border pixel
-            p2[0] = x * spacing[0];
-            p2[1] = y * spacing[1];
-            p2[2] = z * spacing[2];
-            singlePixel = false;
-          }
-          else
-          {
-            // Last border pixel
-            p1[0] = x * spacing[0];
-            p1[1] = y * spacing[1];
-            p1[2] = z * spacing[2];
-            nonBlackPixelDetected = true;
-            nonBlackPixels->InsertNextPoint(p1);
-          }
-        }
-      }
-      if (nonBlackPixelDetected && !singlePixel)
-      {
-        nonBlackPixels->InsertNextPoint(p2);
-      }
-    }
+  int computedSlices = 0;
+  while (canExecute() && computedSlices < slices.size())
+  {
+    auto batch = slices.mid(computedSlices, batchSize);
 
-    // Now we have to simplify the slice's borders to 4
-    double corner[3], max[3], mid[3], min[3], size[3];
-    auto obb_tree = vtkSmartPointer<vtkOBBTree>::New();
-    obb_tree->ComputeOBB(nonBlackPixels, corner, max, mid, min, size);
+    QtConcurrent::blockingMap(batch, computeSlice);
 
-    auto face = plane(corner,max,mid,min);
+    computedSlices += batch.size();
 
+    reportProgress((static_cast<double>(computedSlices) / static_cast<double>(slices.size()))*50.0);
+  }
+
+  const bool computed = (computedSlices == slices.size());
+
+  vtkIdType lastCell[4] = {-1, -1, -1, -1};
+  for (auto z = zMin; computed && z <= zMax; ++z)
+  {
     //NOTE: Espina's Counting Frame Definition is used here.
     // Front slice is the first of the stack and back the last one
     // Left Top Corner corresponds to pixel (0,0,0), Right Top to (N,0,0)
     // and so on
+    auto &border = borders.at(z - zMin);
+
     double LB[3], LT[3], RT[3], RB[3];
     vtkIdType cell[4];
 
-    face->GetPoint(0, LT);
-    face->GetPoint(1, LB);
-    face->GetPoint(2, RT);
-    face->GetPoint(3, RB);
-
-    // Correct rotation
-    auto correctedLeft  = std::min(LB[0], LT[0]);
-    correctedLeft = vtkMath::Round((correctedLeft - bounds[0]) / spacing[0]);
-    correctedLeft = bounds[0] + (correctedLeft)*spacing[0];
-
-    auto correctedRight = std::max(RB[0], RT[0]);
-    correctedRight = vtkMath::Round((correctedRight - bounds[0]) / spacing[0]);
-    correctedRight = bounds[0] + (correctedRight + 1)*spacing[0]; // the edge ends at the end of the voxel
-
-    auto correctedTop  = std::min(LT[1], RT[1]);
-    correctedTop = vtkMath::Round((correctedTop - bounds[2]) / spacing[1]);
-    correctedTop = bounds[2] + (correctedTop)*spacing[1];
-
-    auto correctedBottom  = std::max(LB[1], RB[1]);
-    correctedBottom = vtkMath::Round((correctedBottom - bounds[2]) / spacing[1]);
-    correctedBottom = bounds[2] + (correctedBottom + 1)*spacing[1]; // the edge ends at the end of the voxel
+    std::copy(border.LB, border.LB + 3, LB);
+    std::copy(border.LT, border.LT + 3, LT);
+    std::copy(border.RT, border.RT + 3, RT);
+    std::copy(border.RB, border.RB + 3, RB);
 
-    // Left Bottom Corner
-    LB[0]  = correctedLeft;
-    LB[1]  = correctedBottom;
-    LB[2] -= 0.5*spacing[2];
     cell[0] = borderVertices->InsertNextPoint(LB);
-
-    // Left Top Corner
-    LT[0]  = correctedLeft;
-    LT[1]  = correctedTop;
-    LT[2] -= 0.5*spacing[2];
     cell[1] = borderVertices->InsertNextPoint(LT);
-
-    // Right Top Corner
-    RT[0]  = correctedRight;
-    RT[1]  = correctedTop;
-    RT[2] -= 0.5*spacing[2];
     cell[2] = borderVertices->InsertNextPoint(RT);
-
-    // Right Bottom Corner
-    RB[0]  = correctedRight;
-    RB[1]  = correctedBottom;
-    RB[2] -= 0.5*spacing[2];
     cell[3] = borderVertices->InsertNextPoint(RB);
 
     if (z == zMin)
@@ -353,13 +254,11 @@ void AdaptiveEdgesCreator::computeEdges()
     {
       m_extension->m_computedVolume += ((RT[0] - LT[0] + 1)*(LB[1] - LT[1] + 1))*spacing[2];
     }
-
-    ++z;
   }
 
   QWriteLocker lock(&m_extension->m_dataMutex);
 
-  if (isAborted())
+  if (isAborted() || !computed)
   {
     m_extension->m_computedVolume = 0;
   }
@@ -485,6 +384,7 @@ void AdaptiveEdgesCreator::computeFaces()
       QWriteLocker lock(&m_extension->m_dataMutex);
 
       m_extension->m_faces[face] = poly;
+      m_extension->m_distanceIndex = nullptr;
     }
 
     reportProgress(50 + (static_cast<double>(face)/6.0)*50.0);
@@ -0,0 +1,246 @@
+/*
+
+    Copyright (C) 2026  Felix de las Pozas Alvarez <fpozas@cesvima.upm.es>
+
+    This file is part of ESPINA.
+
+    ESPINA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// ESPINA
+#include "AdaptiveEdgesUtils.h"
+
+// VTK
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkOBBTree.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace ESPINA;
+using namespace ESPINA::Extensions;
+
+namespace
+{
+  /** \brief Returns the corners of the face of the oriented bounding box defined by the given corner and axes.
+   * \param[in] corner corner of the bounding box.
+   * \param[in] max axis of maximum length.
+   * \param[in] mid axis of medium length.
+   * \param[in] min axis of minimum length.
+   *
+   */
+  vtkSmartPointer<vtkPoints> plane(const double corner[3],
+                                   const double max[3],
+                                   const double mid[3],
+                                   const double min[3])
+  {
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(4);
+
+    double x[3];
+    // {0,0,0} <- in a cube
+    x[0] = corner[0];
+    x[1] = corner[1];
+    x[2] = corner[2];
+    points->InsertPoint(0,x);
+    // {1,0,0} <- in a cube
+    x[0] = corner[0] + mid[0];
+    x[1] = corner[1] + mid[1];
+    x[2] = corner[2] + mid[2];
+    points->InsertPoint(1,x);
+    // {0,1,0} <- in a cube
+    x[0] = corner[0] + max[0];
+    x[1] = corner[1] + max[1];
+    x[2] = corner[2] + max[2];
+    points->InsertPoint(2,x);
+    // {1,1,0} <- in a cube
+    x[0] = corner[0] + max[0] + mid[0];
+    x[1] = corner[1] + max[1] + mid[1];
+    x[2] = corner[2] + max[2] + mid[2];
+    points->InsertPoint(3,x);
+
+    return points;
+  }
+
+  /** \brief Returns true if the given value is outside the background range.
+   * \param[in] value pixel component value.
+   * \param[in] lower lower limit of the background range.
+   * \param[in] upper upper limit of the background range.
+   *
+   */
+  inline bool isForeground(const unsigned char value, const unsigned char lower, const unsigned char upper)
+  {
+    return (value > upper) || (value < lower);
+  }
+
+#ifdef __SSE2__
+  /** \brief Returns a bit mask of the 16 values starting at the given position that are outside the background range.
+   * \param[in] values pointer to the values.
+   * \param[in] lower lower limit of the background range in every byte.
+   * \param[in] upper upper limit of the background range in every byte.
+   *
+   */
+  inline int foregroundMask(const unsigned char *values, const __m128i &lower, const __m128i &upper)
+  {
+    auto data  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+    auto above = _mm_subs_epu8(data, upper); // non zero where value > upper
+    auto below = _mm_subs_epu8(lower, data); // non zero where value < lower
+    auto background = _mm_cmpeq_epi8(_mm_or_si128(above, below), _mm_setzero_si128());
+
+    return ~_mm_movemask_epi8(background) & 0xFFFF;
+  }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+long long AdaptiveEdgesUtils::firstForeground(const unsigned char *row, const long long length, const unsigned char lower, const unsigned char upper)
+{
+  long long i = 0;
+
+#ifdef __SSE2__
+  const auto lowerValues = _mm_set1_epi8(static_cast<char>(lower));
+  const auto upperValues = _mm_set1_epi8(static_cast<char>(upper));
+
+  while ((i + 16 <= length) && (foregroundMask(row + i, lowerValues, upperValues) == 0)) i += 16;
+#endif
+
+  for (; i < length; ++i)
+  {
+    if (isForeground(row[i], lower, upper)) return i;
+  }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+long long AdaptiveEdgesUtils::lastForeground(const unsigned char *row, const long long length, const unsigned char lower, const unsigned char upper)
+{
+  long long i = length;
+
+#ifdef __SSE2__
+  const auto lowerValues = _mm_set1_epi8(static_cast<char>(lower));
+  const auto upperValues = _mm_set1_epi8(static_cast<char>(upper));
+
+  while ((i >= 16) && (foregroundMask(row + i - 16, lowerValues, upperValues) == 0)) i -= 16;
+#endif
+
+  while (i > 0)
+  {
+    if (isForeground(row[--i], lower, upper)) return i;
+  }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+AdaptiveEdgesUtils::SliceBorder AdaptiveEdgesUtils::sliceBorder(vtkImageData *image, const int z, const Bounds &bounds, const unsigned char lower, const unsigned char upper)
+{
+  int extent[6];
+  double spacing[3];
+  vtkIdType increments[3];
+  image->GetExtent(extent);
+  image->GetSpacing(spacing);
+  image->GetIncrements(increments);
+
+  const auto numComponents = image->GetNumberOfScalarComponents();
+  const long long rowLength = static_cast<long long>(extent[1] - extent[0] + 1) * numComponents;
+
+  auto slice = reinterpret_cast<const unsigned char *>(image->GetScalarPointer(extent[0], extent[2], z));
+
+  // Look for images borders in z slice:
+  // We are going to take all bordering pixels (almost black) and then extract its oriented
+  // bounding box.
+  // We ignore pixels until we find the first non-black pixel
+  // Then, we keep last non-black pixel as the other side of the line
+  auto nonBlackPixels = vtkSmartPointer<vtkPoints>::New();
+  nonBlackPixels->SetDataTypeToDouble();
+
+  for (auto y = extent[2]; y <= extent[3]; y++)
+  {
+    auto row = slice + (y - extent[2]) * increments[1];
+
+    auto first = firstForeground(row, rowLength, lower, upper);
+    if (first == -1) continue;
+
+    auto last = lastForeground(row, rowLength, lower, upper);
+
+    // pixel components are interleaved in the row.
+    auto firstX = extent[0] + first / numComponents;
+    auto lastX  = extent[0] + last / numComponents;
+
+    nonBlackPixels->InsertNextPoint(firstX * spacing[0], y * spacing[1], z * spacing[2]);
+
+    if (lastX != firstX)
+    {
+      nonBlackPixels->InsertNextPoint(lastX * spacing[0], y * spacing[1], z * spacing[2]);
+    }
+  }
+
+  // Now we have to simplify the slice's borders to 4
+  double corner[3], max[3], mid[3], min[3], size[3];
+  auto obb_tree = vtkSmartPointer<vtkOBBTree>::New();
+  obb_tree->ComputeOBB(nonBlackPixels, corner, max, mid, min, size);
+
+  auto face = plane(corner,max,mid,min);
+
+  SliceBorder border;
+  face->GetPoint(0, border.LT);
+  face->GetPoint(1, border.LB);
+  face->GetPoint(2, border.RT);
+  face->GetPoint(3, border.RB);
+
+  // Correct rotation
+  auto correctedLeft  = std::min(border.LB[0], border.LT[0]);
+  correctedLeft = vtkMath::Round((correctedLeft - bounds[0]) / spacing[0]);
+  correctedLeft = bounds[0] + (correctedLeft)*spacing[0];
+
+  auto correctedRight = std::max(border.RB[0], border.RT[0]);
+  correctedRight = vtkMath::Round((correctedRight - bounds[0]) / spacing[0]);
+  correctedRight = bounds[0] + (correctedRight + 1)*spacing[0]; // the edge ends at the end of the voxel
+
+  auto correctedTop  = std::min(border.LT[1], border.RT[1]);
+  correctedTop = vtkMath::Round((correctedTop - bounds[2]) / spacing[1]);
+  correctedTop = bounds[2] + (correctedTop)*spacing[1];
+
+  auto correctedBottom  = std::max(border.LB[1], border.RB[1]);
+  correctedBottom = vtkMath::Round((correctedBottom - bounds[2]) / spacing[1]);
+  correctedBottom = bounds[2] + (correctedBottom + 1)*spacing[1]; // the edge ends at the end of the voxel
+
+  // Left Bottom Corner
+  border.LB[0]  = correctedLeft;
+  border.LB[1]  = correctedBottom;
+  border.LB[2] -= 0.5*spacing[2];
+
+  // Left Top Corner
+  border.LT[0]  = correctedLeft;
+  border.LT[1]  = correctedTop;
+  border.LT[2] -= 0.5*spacing[2];
+
+  // Right Top Corner
+  border.RT[0]  = correctedRight;
+  border.RT[1]  = correctedTop;
+  border.RT[2] -= 0.5*spacing[2];
+
+  // Right Bottom Corner
+  border.RB[0]  = correctedRight;
+  border.RB[1]  = correctedBottom;
+  border.RB[2] -= 0.5*spacing[2];
+
+  return border;
+}
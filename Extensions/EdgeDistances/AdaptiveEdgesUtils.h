@@ -0,0 +1,83 @@
+/*
+
+    Copyright (C) 2026  Felix de las Pozas Alvarez <fpozas@cesvima.upm.es>
+
+    This file is part of ESPINA.
+
+    ESPINA is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ESPINA_ADAPTIVE_EDGES_UTILS_H
+#define ESPINA_ADAPTIVE_EDGES_UTILS_H
+
+#include "Extensions/EspinaExtensions_Export.h"
+
+// ESPINA
+#include <Core/Utils/Bounds.h>
+
+class vtkImageData;
+
+namespace ESPINA
+{
+  namespace Extensions
+  {
+    /** \brief Slice scanning methods of the adaptive edges computation.
+     *
+     */
+    namespace AdaptiveEdgesUtils
+    {
+      /** \struct SliceBorder
+       * \brief Corners of the edges of a slice.
+       *
+       */
+      struct SliceBorder
+      {
+        double LB[3]; /** left bottom corner.  */
+        double LT[3]; /** left top corner.     */
+        double RT[3]; /** right top corner.    */
+        double RB[3]; /** right bottom corner. */
+      };
+
+      /** \brief Returns the position of the first value of the row outside the background range or -1 if there is none.
+       * \param[in] row row values.
+       * \param[in] length number of values.
+       * \param[in] lower lower limit of the background range.
+       * \param[in] upper upper limit of the background range.
+       *
+       */
+      long long EspinaExtensions_EXPORT firstForeground(const unsigned char *row, const long long length, const unsigned char lower, const unsigned char upper);
+
+      /** \brief Returns the position of the last value of the row outside the background range or -1 if there is none.
+       * \param[in] row row values.
+       * \param[in] length number of values.
+       * \param[in] lower lower limit of the background range.
+       * \param[in] upper upper limit of the background range.
+       *
+       */
+      long long EspinaExtensions_EXPORT lastForeground(const unsigned char *row, const long long length, const unsigned char lower, const unsigned char upper);
+
+      /** \brief Returns the corners of the oriented bounding box of the non background pixels of the given slice.
+       * \param[in] image channel image.
+       * \param[in] z slice index.
+       * \param[in] bounds channel bounds.
+       * \param[in] lower lower limit of the background range.
+       * \param[in] upper upper limit of the background range.
+       *
+       */
+      SliceBorder EspinaExtensions_EXPORT sliceBorder(vtkImageData *image, const int z, const Bounds &bounds, const unsigned char lower, const unsigned char upper);
+    } // namespace AdaptiveEdgesUtils
+  } // namespace Extensions
+} // namespace ESPINA
+
+#endif // ESPINA_ADAPTIVE_EDGES_UTILS_H
@@ -34,7 +34,6 @@
 
 // VTK
 #include <vtkCellArray.h>
-#include <vtkDistancePolyDataFilter.h>
 #include <vtkLine.h>
 #include <vtkPoints.h>
 #include <vtkPointData.h>
@@ -46,7 +45,6 @@
 #include <vtkXMLPolyDataWriter.h>
 #include <vtkGenericDataObjectWriter.h>
 #include <vtkGenericDataObjectReader.h>
-#include <vtkImplicitPolyDataDistance.h>
 #include <vtkCellArray.h>
 
 // Qt
@@ -147,6 +145,7 @@ void ChannelEdges::analyzeChannel()
   if(m_edgesAnalyzer->isRunning() || m_edgesAnalyzer->hasFinished()) return;
 
   m_edgesAnalyzer->setDescription(QObject::tr("Analyzing Edges: %1").arg(m_extendedItem->name()));
+  m_edgesAnalyzer->setCritical(true);
 
   Task::submit(m_edgesAnalyzer);
 }
@@ -161,6 +160,7 @@ void ChannelEdges::computeAdaptiveEdges()
   if(m_edgesCreator->isRunning() || m_edgesCreator->hasFinished()) return;
 
   m_edgesCreator->setDescription(QObject::tr("Computing Edges: %1").arg(m_extendedItem->name()));
+  m_edgesCreator->setCritical(true);
 
   Task::submit(m_edgesCreator);
 }
@@ -309,32 +309,16 @@ void ChannelEdges::distanceToEdges(SegmentationPtr segmentation, Nm distances[6]
 
   bool computed = false;
   auto output = segmentation->output();
-
-  auto segmentationPolyData = vtkSmartPointer<vtkPolyData>::New();
+  auto index  = distanceIndex();
 
   if(hasMeshData(output))
   {
-    segmentationPolyData->DeepCopy(writeLockMesh(output)->mesh());
+    auto data = readLockMesh(output);
+    auto mesh = data->mesh();
 
-    if(segmentationPolyData->GetNumberOfPoints() != 0)
+    if(mesh && mesh->GetNumberOfPoints() != 0)
     {
-      for (int face = 0; face < 6; ++face)
-      {
-        const auto faceMesh = vtkSmartPointer<vtkPolyData>::New();
-
-        {
-          QMutexLocker lock(&m_distanceMutex);
-          faceMesh->DeepCopy(m_faces[face]);
-        }
-
-        auto distanceFilter = vtkSmartPointer<vtkDistancePolyDataFilter>::New();
-        distanceFilter->SignedDistanceOff();
-        distanceFilter->SetInputData(0, segmentationPolyData);
-        distanceFilter->SetInputData(1, faceMesh);
-        distanceFilter->Update();
-
-        distances[face] = distanceFilter->GetOutput()->GetPointData()->GetScalars()->GetRange()[0];
-      }
+      index->distances(mesh->GetPoints(), distances);
 
       computed = true;
     }
@@ -343,34 +327,13 @@ void ChannelEdges::distanceToEdges(SegmentationPtr segmentation, Nm distances[6]
   {
     if(hasSkeletonData(output))
     {
-      segmentationPolyData->DeepCopy(writeLockSkeleton(output)->skeleton());
+      auto data     = readLockSkeleton(output);
+      auto skeleton = data->skeleton();
 
-      // NOTE: Skeletons have no faces and vtkDistancePolyDataFilter returns an invalid result.
-      //       Need to evaluate distance at each point.
-      if(segmentationPolyData->GetNumberOfPoints() != 0)
+      // NOTE: skeletons have no faces, the distance is evaluated at each point like meshes.
+      if(skeleton && skeleton->GetNumberOfPoints() != 0)
       {
-        for (int face = 0; face < 6; ++face)
-        {
-          const auto faceMesh = vtkSmartPointer<vtkPolyData>::New();
-
-          {
-            QMutexLocker lock(&m_distanceMutex);
-            faceMesh->DeepCopy(m_faces[face]);
-          }
-
-          distances[face] = VTK_DOUBLE_MAX;
-
-          auto implicit = vtkSmartPointer<vtkImplicitPolyDataDistance>::New();
-          implicit->SetInput(faceMesh);
-
-          for(vtkIdType i = 0; i < segmentationPolyData->GetNumberOfPoints(); ++i)
-          {
-            double pt[3];
-            segmentationPolyData->GetPoint(i, pt);
-
-            distances[face] = std::min(distances[face], std::fabs(implicit->EvaluateFunction(pt)));
-          }
-        }
+        index->distances(skeleton->GetPoints(), distances);
 
         computed = true;
       }
@@ -387,6 +350,25 @@ void ChannelEdges::distanceToEdges(SegmentationPtr segmentation, Nm distances[6]
   }
 }
 
+//-----------------------------------------------------------------------------
+EdgesDistanceIndexSPtr ChannelEdges::distanceIndex()
+{
+  {
+    QReadLocker lock(&m_dataMutex);
+
+    if(m_distanceIndex) return m_distanceIndex;
+  }
+
+  QWriteLocker lock(&m_dataMutex);
+
+  if(!m_distanceIndex)
+  {
+    m_distanceIndex = std::make_shared<EdgesDistanceIndex>(m_faces);
+  }
+
+  return m_distanceIndex;
+}
+
 //-----------------------------------------------------------------------------
 vtkSmartPointer<vtkPolyData> ChannelEdges::channelEdges()
 {
@@ -468,6 +450,7 @@ void ChannelEdges::invalidateResults()
   {
     m_faces[i] = nullptr;
   }
+  m_distanceIndex = nullptr;
 
   m_computedVolume     = 0;
   m_hasAnalizedChannel = false;
@@ -539,9 +522,13 @@ void ChannelEdges::checkAnalysisData() const
   {
     const_cast<ChannelEdges *>(this)->analyzeChannel();
 
+    m_scheduler->beginBlockingWait();
+
     m_analysisResultMutex.lock();
     m_analisysWait.wait(&m_analysisResultMutex);
     m_analysisResultMutex.unlock();
+
+    m_scheduler->endBlockingWait();
   }
 }
 
@@ -554,9 +541,13 @@ void ChannelEdges::checkEdgesData()
     {
       const_cast<ChannelEdges *>(this)->computeAdaptiveEdges();
 
+      m_scheduler->beginBlockingWait();
+
       m_edgesResultMutex.lock();
       m_edgesTask.wait(&m_edgesResultMutex);
       m_edgesResultMutex.unlock();
+
+      m_scheduler->endBlockingWait();
     }
     else
     {
@@ -574,6 +565,8 @@ void ChannelEdges::createRectangularRegion(const Bounds &bounds)
 {
   QWriteLocker lock(&m_dataMutex);
 
+  m_distanceIndex = nullptr;
+
   m_edges       = vtkSmartPointer<vtkPolyData>::New();
   auto points   = vtkSmartPointer<vtkPoints>::New();
   auto cells    = vtkSmartPointer<vtkCellArray>::New();
@@ -26,6 +26,7 @@
 // ESPINA
 #include "AdaptiveEdgesCreator.h"
 #include "EdgesAnalyzer.h"
+#include "EdgesDistanceIndex.h"
 #include <Core/Utils/Spatial.h>
 #include <Core/Analysis/Extensions.h>
 
@@ -97,6 +98,9 @@ namespace ESPINA
        * \param[in] segmentation to measure distances
        * \param[out] distances in each direction.
        *
+       * NOTE: the faces are queried through a shared immutable index, so several segmentations
+       * can be measured concurrently.
+       *
        */
       void distanceToEdges(SegmentationPtr segmentation, Nm distances[6]);
 
@@ -196,6 +200,11 @@ namespace ESPINA
       void checkAnalysisData() const;
       void checkEdgesData();
 
+      /** \brief Returns the spatial index of the faces, building it if necessary.
+       *
+       */
+      EdgesDistanceIndexSPtr distanceIndex();
+
     private:
       /** \brief Helper method to create the rectangular edges vtkPolyData.
        * \param[in] bounds limits of the rectangular region.
@@ -211,7 +220,6 @@ namespace ESPINA
       mutable QWaitCondition m_edgesTask;           /** wait condition for AdaptiveEdges task.                                                    */
       mutable QMutex         m_edgesResultMutex;    /** barrier signaling end of edges computation.                                               */
       mutable QReadWriteLock m_dataMutex;           /** protects class internal data.                                                             */
-      QMutex                 m_distanceMutex;       /** protects edges polydata during distance to edges computation.                             */
 
       bool   m_useDistanceToBounds;                 /** true to use the distance to the stack bounds, false otherwise.                            */
       int    m_backgroundColor;                     /** background color intensity value.                                                         */
@@ -225,6 +233,7 @@ namespace ESPINA
 
       vtkSmartPointer<vtkPolyData> m_edges;         /** stack edges polydata.                                                                     */
       vtkSmartPointer<vtkPolyData> m_faces[6];      /** edges faces polydatas.                                                                    */
+      EdgesDistanceIndexSPtr       m_distanceIndex; /** spatial index of the faces, built on demand and reset when the faces change.              */
 
       SchedulerSPtr m_scheduler;                    /** application task scheduler.                                                               */
 
@@ -218,7 +218,15 @@ bool EdgeDistance::isOnEdge() const
       }
       else
       {
-        edgesExtension->distanceToEdges(m_extendedItem, distances);
+        if(channels.size() == 1)
+        {
+          // reuse the cached distances instead of measuring them again.
+          edgeDistance(distances);
+        }
+        else
+        {
+          edgesExtension->distanceToEdges(m_extendedItem, distances);
+        }
       }
 
       for(int i = 0; i < 3; ++i)
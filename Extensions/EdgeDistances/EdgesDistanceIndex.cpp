@@ -0,0 +1,363 @@
+/*
+ File: EdgesDistanceIndex.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include "EdgesDistanceIndex.h"
+
+// VTK
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+
+// Qt
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+
+// C++
+#include <algorithm>
+#include <cmath>
+
+using namespace ESPINA;
+using namespace ESPINA::Extensions;
+
+namespace
+{
+  const int       LEAF_SIZE  = 4;    /** maximum number of triangles of a leaf node.            */
+  const vtkIdType MIN_POINTS = 4096; /** minimum number of points of each parallel computation. */
+
+  struct PointsRange
+  {
+    vtkIdType begin;
+    vtkIdType end;
+    Nm        distances[6];
+  };
+
+  inline double dot(const double a[3], const double b[3])
+  {
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+  }
+
+  inline void subtract(const double a[3], const double b[3], double result[3])
+  {
+    result[0] = a[0] - b[0];
+    result[1] = a[1] - b[1];
+    result[2] = a[2] - b[2];
+  }
+}
+
+//-----------------------------------------------------------------------------
+EdgesDistanceIndex::EdgesDistanceIndex(const vtkSmartPointer<vtkPolyData> faces[6])
+{
+  for(int i = 0; i < 6; ++i)
+  {
+    auto &face = m_faces[i];
+
+    if(faces[i])
+    {
+      triangulate(faces[i], face);
+    }
+
+    if(!face.triangles.empty())
+    {
+      face.nodes.reserve(2 * (face.triangles.size() / LEAF_SIZE + 1));
+      face.nodes.resize(1);
+
+      build(face, 0, 0, face.triangles.size());
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EdgesDistanceIndex::triangulate(vtkPolyData *polyData, Face &face)
+{
+  auto points = polyData->GetPoints();
+  auto cells  = polyData->GetPolys();
+
+  if(!points || !cells) return;
+
+  face.triangles.reserve(2 * cells->GetNumberOfCells());
+
+  vtkIdType  npts = 0;
+  vtkIdType *indx = nullptr;
+
+  for(cells->InitTraversal(); cells->GetNextCell(npts, indx); )
+  {
+    for(vtkIdType i = 1; i + 1 < npts; ++i)
+    {
+      Triangle triangle;
+      points->GetPoint(indx[0],   triangle.a);
+      points->GetPoint(indx[i],   triangle.b);
+      points->GetPoint(indx[i+1], triangle.c);
+
+      face.triangles.push_back(triangle);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void EdgesDistanceIndex::build(Face &face, const int node, const int first, const int count)
+{
+  double bounds[6]{VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
+  double centers[6]{VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
+
+  for(int t = first; t < first + count; ++t)
+  {
+    auto &triangle = face.triangles[t];
+
+    for(int i = 0; i < 3; ++i)
+    {
+      bounds[2*i]   = std::min({bounds[2*i],   triangle.a[i], triangle.b[i], triangle.c[i]});
+      bounds[2*i+1] = std::max({bounds[2*i+1], triangle.a[i], triangle.b[i], triangle.c[i]});
+
+      auto center = triangle.a[i] + triangle.b[i] + triangle.c[i];
+      centers[2*i]   = std::min(centers[2*i],   center);
+      centers[2*i+1] = std::max(centers[2*i+1], center);
+    }
+  }
+
+  std::copy(bounds, bounds + 6, face.nodes[node].bounds);
+
+  if(count <= LEAF_SIZE)
+  {
+    face.nodes[node].first = first;
+    face.nodes[node].count = count;
+    return;
+  }
+
+  int axis = 0;
+  for(int i = 1; i < 3; ++i)
+  {
+    if(centers[2*i+1] - centers[2*i] > centers[2*axis+1] - centers[2*axis]) axis = i;
+  }
+
+  auto begin = face.triangles.begin() + first;
+  auto half  = count / 2;
+  std::nth_element(begin, begin + half, begin + count, [axis](const Triangle &lhs, const Triangle &rhs)
+  {
+    return lhs.a[axis] + lhs.b[axis] + lhs.c[axis] < rhs.a[axis] + rhs.b[axis] + rhs.c[axis];
+  });
+
+  const int children = face.nodes.size();
+  face.nodes.resize(children + 2);
+
+  face.nodes[node].first = children;
+  face.nodes[node].count = 0;
+
+  build(face, children,     first,        half);
+  build(face, children + 1, first + half, count - half);
+}
+
+//-----------------------------------------------------------------------------
+Nm EdgesDistanceIndex::distance(const int face, const double point[3], const Nm limit) const
+{
+  auto &indexed = m_faces[face];
+
+  if(indexed.nodes.empty()) return limit;
+
+  double best = limit * limit;
+
+  int stack[64];
+  int size = 0;
+  stack[size++] = 0;
+
+  while(size > 0)
+  {
+    auto &node = indexed.nodes[stack[--size]];
+
+    if(squaredDistance(point, node.bounds) >= best) continue;
+
+    if(node.count > 0)
+    {
+      for(int t = node.first; t < node.first + node.count; ++t)
+      {
+        best = std::min(best, squaredDistance(point, indexed.triangles[t]));
+      }
+    }
+    else
+    {
+      auto left  = node.first;
+      auto right = node.first + 1;
+
+      // nearest child is visited first to tighten the limit sooner.
+      if(squaredDistance(point, indexed.nodes[left].bounds) < squaredDistance(point, indexed.nodes[right].bounds))
+      {
+        std::swap(left, right);
+      }
+
+      stack[size++] = left;
+      stack[size++] = right;
+    }
+  }
+
+  return std::min(limit, std::sqrt(best));
+}
+
+//-----------------------------------------------------------------------------
+void EdgesDistanceIndex::distances(vtkPoints *points, Nm distances[6]) const
+{
+  const auto numPoints = points->GetNumberOfPoints();
+  const auto numRanges = std::max(1LL, std::min<long long>(QThread::idealThreadCount(), numPoints / MIN_POINTS));
+  const auto rangeSize = numPoints / numRanges + 1;
+
+  QVector<PointsRange> ranges;
+  for(vtkIdType begin = 0; begin < numPoints; begin += rangeSize)
+  {
+    PointsRange range;
+    range.begin = begin;
+    range.end   = std::min(numPoints, begin + rangeSize);
+
+    ranges << range;
+  }
+
+  auto computeRange = [this, points](PointsRange &range)
+  {
+    std::fill(range.distances, range.distances + 6, VTK_DOUBLE_MAX);
+
+    double point[3];
+    for(auto i = range.begin; i < range.end; ++i)
+    {
+      points->GetPoint(i, point);
+
+      for(int face = 0; face < 6; ++face)
+      {
+        range.distances[face] = distance(face, point, range.distances[face]);
+      }
+    }
+  };
+
+  if(ranges.size() == 1)
+  {
+    computeRange(ranges.first());
+  }
+  else
+  {
+    QtConcurrent::blockingMap(ranges, computeRange);
+  }
+
+  std::fill(distances, distances + 6, VTK_DOUBLE_MAX);
+  for(auto &range: ranges)
+  {
+    for(int face = 0; face < 6; ++face)
+    {
+      distances[face] = std::min(distances[face], range.distances[face]);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+double EdgesDistanceIndex::squaredDistance(const double point[3], const Triangle &triangle)
+{
+  // Closest point on triangle from "Real-Time Collision Detection", C. Ericson.
+  double ab[3], ac[3], ap[3], closest[3];
+  subtract(triangle.b, triangle.a, ab);
+  subtract(triangle.c, triangle.a, ac);
+  subtract(point,      triangle.a, ap);
+
+  auto d1 = dot(ab, ap);
+  auto d2 = dot(ac, ap);
+
+  auto closestTo = [&closest](const double origin[3], const double direction[3], const double t)
+  {
+    for(int i = 0; i < 3; ++i) closest[i] = origin[i] + t * direction[i];
+  };
+
+  if(d1 <= 0 && d2 <= 0)
+  {
+    closestTo(triangle.a, ab, 0);
+  }
+  else
+  {
+    double bp[3];
+    subtract(point, triangle.b, bp);
+    auto d3 = dot(ab, bp);
+    auto d4 = dot(ac, bp);
+
+    double cp[3];
+    subtract(point, triangle.c, cp);
+    auto d5 = dot(ab, cp);
+    auto d6 = dot(ac, cp);
+
+    auto vc = d1*d4 - d3*d2;
+    auto vb = d5*d2 - d1*d6;
+    auto va = d3*d6 - d5*d4;
+
+    if(d3 >= 0 && d4 <= d3)
+    {
+      closestTo(triangle.b, ab, 0);
+    }
+    else if(d6 >= 0 && d5 <= d6)
+    {
+      closestTo(triangle.c, ab, 0);
+    }
+    else if(vc <= 0 && d1 >= 0 && d3 <= 0)
+    {
+      closestTo(triangle.a, ab, d1 / (d1 - d3));
+    }
+    else if(vb <= 0 && d2 >= 0 && d6 <= 0)
+    {
+      closestTo(triangle.a, ac, d2 / (d2 - d6));
+    }
+    else if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+    {
+      double bc[3];
+      subtract(triangle.c, triangle.b, bc);
+      closestTo(triangle.b, bc, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+    else
+    {
+      auto denominator = va + vb + vc;
+
+      if(denominator == 0)
+      {
+        // degenerated triangle, all vertices are aligned.
+        closestTo(triangle.a, ab, 0);
+      }
+      else
+      {
+        auto v = vb / denominator;
+        auto w = vc / denominator;
+
+        for(int i = 0; i < 3; ++i) closest[i] = triangle.a[i] + ab[i] * v + ac[i] * w;
+      }
+    }
+  }
+
+  double delta[3];
+  subtract(point, closest, delta);
+
+  return dot(delta, delta);
+}
+
+//-----------------------------------------------------------------------------
+double EdgesDistanceIndex::squaredDistance(const double point[3], const double bounds[6])
+{
+  double result = 0;
+
+  for(int i = 0; i < 3; ++i)
+  {
+    double delta = 0;
+
+    if(point[i] < bounds[2*i])        delta = bounds[2*i] - point[i];
+    else if(point[i] > bounds[2*i+1]) delta = point[i] - bounds[2*i+1];
+
+    result += delta * delta;
+  }
+
+  return result;
+}
@@ -0,0 +1,139 @@
+/*
+ File: EdgesDistanceIndex.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPINA_EDGES_DISTANCE_INDEX_H
+#define ESPINA_EDGES_DISTANCE_INDEX_H
+
+#include "Extensions/EspinaExtensions_Export.h"
+
+// ESPINA
+#include <Core/Utils/Spatial.h>
+
+// VTK
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+
+// C++
+#include <memory>
+#include <vector>
+
+class vtkPoints;
+
+namespace ESPINA
+{
+  namespace Extensions
+  {
+    /** \class EdgesDistanceIndex
+     * \brief Immutable bounding volume hierarchy of the triangles of the six faces of the
+     *  channel edges. Once built it can be queried concurrently without locks or copies
+     *  of the faces polydatas.
+     *
+     */
+    class EspinaExtensions_EXPORT EdgesDistanceIndex
+    {
+      public:
+        /** \brief EdgesDistanceIndex class constructor.
+         * \param[in] faces edges faces polydatas in the ChannelEdges order (left, right, top, bottom, front, back).
+         *
+         */
+        explicit EdgesDistanceIndex(const vtkSmartPointer<vtkPolyData> faces[6]);
+
+        /** \brief Returns the unsigned distance from the point to the given face or the given limit
+         * if the face is farther than it.
+         * \param[in] face face index in [0,5].
+         * \param[in] point point coordinates.
+         * \param[in] limit maximum distance of interest.
+         *
+         */
+        Nm distance(const int face, const double point[3], const Nm limit = VTK_DOUBLE_MAX) const;
+
+        /** \brief Computes the minimum distance from the given points to each face. Points are
+         * evaluated in parallel.
+         * \param[in] points points to measure.
+         * \param[out] distances distances to each face.
+         *
+         */
+        void distances(vtkPoints *points, Nm distances[6]) const;
+
+        /** \brief Returns true if the given face has no triangles.
+         * \param[in] face face index in [0,5].
+         *
+         */
+        bool isEmpty(const int face) const
+        { return m_faces[face].triangles.empty(); }
+
+      private:
+        struct Triangle
+        {
+          double a[3];
+          double b[3];
+          double c[3];
+        };
+
+        struct Node
+        {
+          double bounds[6]; /** bounds of the triangles of the node.                 */
+          int    first;     /** first triangle index (leaves) or first child index.  */
+          int    count;     /** number of triangles for leaves, 0 for inner nodes.   */
+        };
+
+        struct Face
+        {
+          std::vector<Triangle> triangles;
+          std::vector<Node>     nodes;
+        };
+
+        /** \brief Fills the face triangles from the polygons of the given polydata.
+         * \param[in] polyData face polydata.
+         * \param[out] face face to fill.
+         *
+         */
+        static void triangulate(vtkPolyData *polyData, Face &face);
+
+        /** \brief Builds the hierarchy of the node triangles recursively.
+         * \param[in] face face being indexed.
+         * \param[in] node node index.
+         * \param[in] first first triangle of the node.
+         * \param[in] count number of triangles of the node.
+         *
+         */
+        static void build(Face &face, const int node, const int first, const int count);
+
+        /** \brief Returns the squared distance from the point to the given triangle.
+         * \param[in] point point coordinates.
+         * \param[in] triangle triangle.
+         *
+         */
+        static double squaredDistance(const double point[3], const Triangle &triangle);
+
+        /** \brief Returns the squared distance from the point to the given bounds.
+         * \param[in] point point coordinates.
+         * \param[in] bounds box bounds.
+         *
+         */
+        static double squaredDistance(const double point[3], const double bounds[6]);
+
+        Face m_faces[6]; /** indexed faces. */
+    };
+
+    using EdgesDistanceIndexSPtr = std::shared_ptr<const EdgesDistanceIndex>;
+  } // namespace Extensions
+} // namespace ESPINA
+
+#endif // ESPINA_EDGES_DISTANCE_INDEX_H
@@ -21,11 +21,12 @@
 // ESPINA
 #include "MorphologicalInformation.h"
 #include <Core/Analysis/Segmentation.h>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
 
 // ITK
-#include <itkShapeLabelObject.h>
-#include <vtkMeshQuality.h>
-#include <vtkSmartPointer.h>
+#include <vnl/vnl_math.h>
+#include <vnl/vnl_matrix.h>
+#include <vnl/algo/vnl_symmetric_eigensystem.h>
 
 // Qt
 #include <QApplication>
@@ -33,7 +34,14 @@
 // VTK
 #include <vtkSmartPointer.h>
 #include <vtkPolyData.h>
-#include <vtkMeshQuality.h>
+#include <vtkCellArray.h>
+#include <vtkTriangle.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
 
 using namespace ESPINA;
 using namespace ESPINA::Extensions;
@@ -67,15 +75,259 @@ const SegmentationExtension::Key MORPHOLOGICAL_EEDy  = "Equivalent Ellipsoid Dia
 const SegmentationExtension::Key MORPHOLOGICAL_EEDz  = "Equivalent Ellipsoid Diameter Z";
 const SegmentationExtension::Key MORPHOLOGICAL_AREA  = "Surface Area";
 
+namespace
+{
+  const long long SLAB_DEPTH = 25; /** depth in slices of the volume slabs, matches the sparse volume blocks size. */
+
+  /** \struct Moments
+   * \brief Zeroth, first and second order moments of the physical positions of the segmentation voxels.
+   *
+   * The sums are relative to a reference point to avoid losing precision with large coordinates.
+   */
+  struct Moments
+  {
+    unsigned long long count;    /** number of voxels.                                 */
+    double reference[3];         /** physical point the sums are relative to.          */
+    double sum[3];               /** sum of the voxel positions.                       */
+    double products[3][3];       /** sum of the products of the voxel positions.       */
+  };
+
+  /** \struct SlicePoint
+   * \brief Voxel position in a slice of a slab.
+   *
+   */
+  struct SlicePoint
+  {
+    long long x;
+    long long y;
+
+    bool operator<(const SlicePoint &other) const
+    { return (x < other.x) || (x == other.x && y < other.y); }
+  };
+
+  /** \brief Returns the cross product of the vectors ab and ac.
+   *
+   */
+  long long cross(const SlicePoint &a, const SlicePoint &b, const SlicePoint &c)
+  {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+  }
+
+  /** \brief Returns the vertices of the convex hull of the given points (Andrew's monotone chain).
+   * \param[in] points slice points.
+   *
+   */
+  std::vector<SlicePoint> convexHull(std::vector<SlicePoint> points)
+  {
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end(), [](const SlicePoint &a, const SlicePoint &b) { return a.x == b.x && a.y == b.y; }), points.end());
+
+    if(points.size() < 3) return points;
+
+    std::vector<SlicePoint> hull(2 * points.size());
+    size_t k = 0;
+
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+      while(k >= 2 && cross(hull[k-2], hull[k-1], points[i]) <= 0) --k;
+      hull[k++] = points[i];
+    }
+
+    for(size_t i = points.size() - 1, lower = k + 1; i > 0; --i)
+    {
+      while(k >= lower && cross(hull[k-2], hull[k-1], points[i-1]) <= 0) --k;
+      hull[k++] = points[i-1];
+    }
+
+    hull.resize(k - 1);
+
+    return hull;
+  }
+
+  /** \brief Accumulates the moments of the voxels of the given slab and, if requested, the candidate points for
+   * the Feret diameter. The candidates are the vertices of the convex hull of each slice, as the convex hull of
+   * the segmentation is a subset of them.
+   * \param[in] slab slab image.
+   * \param[inout] moments accumulated moments.
+   * \param[inout] candidates Feret diameter candidate points or nullptr to skip them.
+   *
+   */
+  void accumulateSlab(const itkVolumeType::Pointer slab, Moments &moments, std::vector<NmVector3> *candidates)
+  {
+    const auto region  = slab->GetLargestPossibleRegion();
+    const auto size    = region.GetSize();
+    const auto spacing = slab->GetSpacing();
+    const auto buffer  = slab->GetBufferPointer();
+
+    std::vector<SlicePoint> slicePoints;
+    itkVolumeType::IndexType index;
+    itkVolumeType::PointType point;
+
+    for(unsigned long long z = 0; z < size[2]; ++z)
+    {
+      slicePoints.clear();
+
+      for(unsigned long long y = 0; y < size[1]; ++y)
+      {
+        auto row = buffer + (z * size[1] + y) * size[0];
+
+        unsigned long long count = 0;
+        long long first = -1, last = -1;
+        double sum = 0, squares = 0;
+
+        for(unsigned long long x = 0; x < size[0]; ++x)
+        {
+          if(row[x] != SEG_VOXEL_VALUE) continue;
+
+          if(first < 0) first = x;
+          last     = x;
+          sum     += x;
+          squares += static_cast<double>(x) * x;
+          ++count;
+        }
+
+        if(count == 0) continue;
+
+        index[0] = region.GetIndex(0);
+        index[1] = region.GetIndex(1) + y;
+        index[2] = region.GetIndex(2) + z;
+        slab->TransformIndexToPhysicalPoint(index, point);
+
+        const double px = point[0] - moments.reference[0];
+        const double py = point[1] - moments.reference[1];
+        const double pz = point[2] - moments.reference[2];
+
+        // voxel positions in the row are px + x * spacing[0] for the counted x values.
+        const double rowSum     = count * px + spacing[0] * sum;
+        const double rowSquares = count * px * px + 2 * px * spacing[0] * sum + spacing[0] * spacing[0] * squares;
+
+        moments.count  += count;
+        moments.sum[0] += rowSum;
+        moments.sum[1] += count * py;
+        moments.sum[2] += count * pz;
+
+        moments.products[0][0] += rowSquares;
+        moments.products[0][1] += py * rowSum;
+        moments.products[0][2] += pz * rowSum;
+        moments.products[1][1] += count * py * py;
+        moments.products[1][2] += count * py * pz;
+        moments.products[2][2] += count * pz * pz;
+
+        if(candidates)
+        {
+          slicePoints.push_back(SlicePoint{first, static_cast<long long>(y)});
+          slicePoints.push_back(SlicePoint{last,  static_cast<long long>(y)});
+        }
+      }
+
+      if(candidates && !slicePoints.empty())
+      {
+        for(auto vertex: convexHull(slicePoints))
+        {
+          index[0] = region.GetIndex(0) + vertex.x;
+          index[1] = region.GetIndex(1) + vertex.y;
+          index[2] = region.GetIndex(2) + z;
+          slab->TransformIndexToPhysicalPoint(index, point);
+
+          candidates->push_back(NmVector3{point[0], point[1], point[2]});
+        }
+      }
+    }
+  }
+
+  /** \brief Returns the maximum distance between the given points. Pairs that can't improve the current
+   * maximum are discarded using the distances of the points to their centre.
+   * \param[in] points convex hull candidate points.
+   *
+   */
+  double feretDiameter(const std::vector<NmVector3> &points)
+  {
+    if(points.size() < 2) return 0;
+
+    NmVector3 centre{0, 0, 0};
+    for(auto &point: points)
+    {
+      for(auto i: {0, 1, 2}) centre[i] += point[i] / points.size();
+    }
+
+    std::vector<double> radius(points.size());
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+      double distance = 0;
+      for(auto j: {0, 1, 2}) distance += (points[i][j] - centre[j]) * (points[i][j] - centre[j]);
+
+      radius[i] = std::sqrt(distance);
+    }
+
+    std::vector<size_t> order(points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&radius](size_t a, size_t b) { return radius[a] > radius[b]; });
+
+    double maximum = 0;
+    for(size_t i = 0; i < order.size(); ++i)
+    {
+      const auto &a = points[order[i]];
+
+      if(radius[order[i]] + radius[order[0]] <= maximum) break;
+
+      for(size_t j = i + 1; j < order.size(); ++j)
+      {
+        if(radius[order[i]] + radius[order[j]] <= maximum) break;
+
+        const auto &b = points[order[j]];
+
+        double distance = 0;
+        for(auto k: {0, 1, 2}) distance += (a[k] - b[k]) * (a[k] - b[k]);
+
+        maximum = std::max(maximum, std::sqrt(distance));
+      }
+    }
+
+    return maximum;
+  }
+
+  /** \brief Returns the surface area of the given mesh computed from its polygons.
+   * \param[in] mesh mesh polydata.
+   *
+   */
+  double surfaceArea(vtkPolyData *mesh)
+  {
+    double area = 0.0;
+
+    auto points = mesh->GetPoints();
+    auto cells  = mesh->GetPolys();
+
+    if(!points || !cells) return area;
+
+    vtkIdType  npts = 0;
+    vtkIdType *indx = nullptr;
+    double a[3], b[3], c[3];
+
+    for(cells->InitTraversal(); cells->GetNextCell(npts, indx); )
+    {
+      if(npts < 3) continue;
+
+      points->GetPoint(indx[0], a);
+      for(vtkIdType i = 1; i + 1 < npts; ++i)
+      {
+        points->GetPoint(indx[i],   b);
+        points->GetPoint(indx[i+1], c);
+
+        area += vtkTriangle::TriangleArea(a, b, c);
+      }
+    }
+
+    return area;
+  }
+}
+
 //TODO: Review values to be used from new ITK version (Elongation & Flatness, Perimeter & Perimeter on border?)
 //------------------------------------------------------------------------
 MorphologicalInformation::MorphologicalInformation(const SegmentationExtension::InfoCache &cache,
                                                    const State &state)
-: SegmentationExtension{cache}
-, m_statistic          {nullptr}
+: SegmentationExtension  {cache}
+, m_computeFeretDiameter{false}
 {
-  m_labelMap = Image2LabelFilterType::New();
-  m_labelMap->SetComputeFeretDiameter(false);
 }
 
 //------------------------------------------------------------------------
@@ -128,7 +380,7 @@ QVariant MorphologicalInformation::cacheFail(const InformationKey& key) const
   if (key.value() == MORPHOLOGICAL_FD)
   {
     QWriteLocker lock(&m_mutex);
-    m_labelMap->SetComputeFeretDiameter(true);
+    m_computeFeretDiameter = true;
   }
 
   QVariant info;
@@ -152,62 +404,146 @@ void MorphologicalInformation::updateInformation() const
   QWriteLocker lock(&m_mutex);
   Q_ASSERT(hasVolumetricData(m_extendedItem->output()) && hasMeshData(m_extendedItem->output()));
 
-  itkVolumeType::Pointer segVolume = nullptr;
+  Moments moments{0, {0, 0, 0}, {0, 0, 0}, {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
+  NmVector3 spacing;
+
+  std::vector<NmVector3> candidates;
+  auto feretCandidates = m_computeFeretDiameter ? &candidates : nullptr;
 
   {
     auto data = readLockVolume(m_extendedItem->output());
-    segVolume = data->itkImage();
-  }
 
-  bool          validInfo = (segVolume != nullptr);
-  LabelMapType *labelMap  = nullptr;
+    const auto bounds = data->bounds();
+    const auto region = equivalentRegion<itkVolumeType>(bounds);
+    const auto first  = region.GetIndex(2);
+    const auto last   = first + static_cast<long long>(region.GetSize(2));
 
-  if (validInfo)
-  {
-    m_labelMap->SetInput(segVolume);
-    m_labelMap->Update();
-    m_labelMap->ReleaseDataFlagOn();
-    m_labelMap->Modified();
+    spacing = bounds.spacing();
+
+    itkVolumeType::IndexType referenceIndex = region.GetIndex();
+    itkVolumeType::PointType referencePoint;
+
+    // slabs are aligned with the blocks of the sparse volumes so each one touches only one layer of blocks.
+    for(long long z = first; z < last; )
+    {
+      const auto next = std::min(last, (z >= 0) ? (z / SLAB_DEPTH + 1) * SLAB_DEPTH : z + SLAB_DEPTH);
+
+      auto slabRegion = region;
+      slabRegion.SetIndex(2, z);
+      slabRegion.SetSize(2, next - z);
+
+      auto slab = data->itkImage(equivalentBounds<itkVolumeType>(bounds.origin(), spacing, slabRegion));
+
+      if(z == first)
+      {
+        slab->TransformIndexToPhysicalPoint(referenceIndex, referencePoint);
 
-    labelMap = m_labelMap->GetOutput();
-    labelMap->Update();
+        for(auto i: {0, 1, 2}) moments.reference[i] = referencePoint[i];
+      }
 
-    validInfo = labelMap->GetNumberOfLabelObjects() == 1;
+      accumulateSlab(slab, moments, feretCandidates);
+
+      z = next;
+    }
   }
 
-  if (validInfo)
+  if (moments.count > 0)
   {
-    m_statistic = labelMap->GetNthLabelObject(0);
+    const double count = moments.count;
+
+    double centroid[3];
+    vnl_matrix<double> centralMoments(3, 3);
+
+    for(int i = 0; i < 3; ++i)
+    {
+      centroid[i] = moments.sum[i] / count;
+    }
 
-    updateInfoCache(MORPHOLOGICAL_SIZE, static_cast<int>(m_statistic->GetNumberOfPixels()));
+    for(int i = 0; i < 3; ++i)
+    {
+      for(int j = i; j < 3; ++j)
+      {
+        centralMoments(i, j) = centralMoments(j, i) = moments.products[i][j] / count - centroid[i] * centroid[j];
+      }
+    }
+
+    // add the second order central moment of each voxel, as itk::ShapeLabelMapFilter does, so flat
+    // segmentations (one slice or one row thick) don't have null principal moments.
+    for(int i = 0; i < 3; ++i)
+    {
+      centralMoments(i, i) += spacing[i] * spacing[i] / 12.0;
+    }
+
+    // same conventions as itk::ShapeLabelMapFilter: ascending principal moments, principal axes as rows
+    // and a final reflection of the last axis if needed for a proper rotation.
+    vnl_symmetric_eigensystem<double> eigen(centralMoments);
+
+    double principalMoments[3];
+    double principalAxes[3][3];
+
+    for(int i = 0; i < 3; ++i)
+    {
+      principalMoments[i] = eigen.get_eigenvalue(i);
+
+      for(int j = 0; j < 3; ++j)
+      {
+        principalAxes[i][j] = eigen.V(j, i);
+      }
+    }
+
+    const double determinant = principalAxes[0][0] * (principalAxes[1][1] * principalAxes[2][2] - principalAxes[1][2] * principalAxes[2][1])
+                             - principalAxes[0][1] * (principalAxes[1][0] * principalAxes[2][2] - principalAxes[1][2] * principalAxes[2][0])
+                             + principalAxes[0][2] * (principalAxes[1][0] * principalAxes[2][1] - principalAxes[1][1] * principalAxes[2][0]);
+
+    if(determinant < 0)
+    {
+      for(int j = 0; j < 3; ++j) principalAxes[2][j] *= -1;
+    }
+
+    const double physicalSize = count * spacing[0] * spacing[1] * spacing[2];
+
+    // diameters of the ellipsoid with the same principal moments ratios and the same physical size.
+    const double equivalentRadius = std::pow(physicalSize / (4.0 * vnl_math::pi / 3.0), 1.0 / 3.0);
+    const double momentsRoot      = std::pow(principalMoments[0] * principalMoments[1] * principalMoments[2], 1.0 / 3.0);
+
+    double ellipsoidDiameter[3]{0, 0, 0};
+    if(momentsRoot != 0.0)
+    {
+      for(int i = 0; i < 3; ++i)
+      {
+        ellipsoidDiameter[i] = 2.0 * equivalentRadius * std::sqrt(principalMoments[i] / momentsRoot);
+      }
+    }
 
-    updateInfoCache(MORPHOLOGICAL_PS, m_statistic->GetPhysicalSize());
+    updateInfoCache(MORPHOLOGICAL_SIZE, static_cast<int>(moments.count));
 
-    updateInfoCache(MORPHOLOGICAL_Cx, m_statistic->GetCentroid()[0]);
-    updateInfoCache(MORPHOLOGICAL_Cy, m_statistic->GetCentroid()[1]);
-    updateInfoCache(MORPHOLOGICAL_Cz, m_statistic->GetCentroid()[2]);
+    updateInfoCache(MORPHOLOGICAL_PS, physicalSize);
 
-    updateInfoCache(MORPHOLOGICAL_BPMx, m_statistic->GetPrincipalMoments()[0]);
-    updateInfoCache(MORPHOLOGICAL_BPMy, m_statistic->GetPrincipalMoments()[1]);
-    updateInfoCache(MORPHOLOGICAL_BPMz, m_statistic->GetPrincipalMoments()[2]);
+    updateInfoCache(MORPHOLOGICAL_Cx, moments.reference[0] + centroid[0]);
+    updateInfoCache(MORPHOLOGICAL_Cy, moments.reference[1] + centroid[1]);
+    updateInfoCache(MORPHOLOGICAL_Cz, moments.reference[2] + centroid[2]);
 
-    updateInfoCache(MORPHOLOGICAL_BPA00, m_statistic->GetPrincipalAxes()[0][0]);
-    updateInfoCache(MORPHOLOGICAL_BPA01, m_statistic->GetPrincipalAxes()[0][1]);
-    updateInfoCache(MORPHOLOGICAL_BPA02, m_statistic->GetPrincipalAxes()[0][2]);
-    updateInfoCache(MORPHOLOGICAL_BPA10, m_statistic->GetPrincipalAxes()[1][0]);
-    updateInfoCache(MORPHOLOGICAL_BPA11, m_statistic->GetPrincipalAxes()[1][1]);
-    updateInfoCache(MORPHOLOGICAL_BPA12, m_statistic->GetPrincipalAxes()[1][2]);
-    updateInfoCache(MORPHOLOGICAL_BPA20, m_statistic->GetPrincipalAxes()[2][0]);
-    updateInfoCache(MORPHOLOGICAL_BPA21, m_statistic->GetPrincipalAxes()[2][1]);
-    updateInfoCache(MORPHOLOGICAL_BPA22, m_statistic->GetPrincipalAxes()[2][2]);
+    updateInfoCache(MORPHOLOGICAL_BPMx, principalMoments[0]);
+    updateInfoCache(MORPHOLOGICAL_BPMy, principalMoments[1]);
+    updateInfoCache(MORPHOLOGICAL_BPMz, principalMoments[2]);
 
-    updateInfoCache(MORPHOLOGICAL_EEDx, m_statistic->GetEquivalentEllipsoidDiameter()[0]);
-    updateInfoCache(MORPHOLOGICAL_EEDy, m_statistic->GetEquivalentEllipsoidDiameter()[1]);
-    updateInfoCache(MORPHOLOGICAL_EEDz, m_statistic->GetEquivalentEllipsoidDiameter()[2]);
+    updateInfoCache(MORPHOLOGICAL_BPA00, principalAxes[0][0]);
+    updateInfoCache(MORPHOLOGICAL_BPA01, principalAxes[0][1]);
+    updateInfoCache(MORPHOLOGICAL_BPA02, principalAxes[0][2]);
+    updateInfoCache(MORPHOLOGICAL_BPA10, principalAxes[1][0]);
+    updateInfoCache(MORPHOLOGICAL_BPA11, principalAxes[1][1]);
+    updateInfoCache(MORPHOLOGICAL_BPA12, principalAxes[1][2]);
+    updateInfoCache(MORPHOLOGICAL_BPA20, principalAxes[2][0]);
+    updateInfoCache(MORPHOLOGICAL_BPA21, principalAxes[2][1]);
+    updateInfoCache(MORPHOLOGICAL_BPA22, principalAxes[2][2]);
 
-    if (m_labelMap->GetComputeFeretDiameter())
+    updateInfoCache(MORPHOLOGICAL_EEDx, ellipsoidDiameter[0]);
+    updateInfoCache(MORPHOLOGICAL_EEDy, ellipsoidDiameter[1]);
+    updateInfoCache(MORPHOLOGICAL_EEDz, ellipsoidDiameter[2]);
+
+    if (m_computeFeretDiameter)
     {
-      updateInfoCache(MORPHOLOGICAL_FD, m_statistic->GetFeretDiameter());
+      updateInfoCache(MORPHOLOGICAL_FD, feretDiameter(candidates));
     }
   }
 
@@ -219,14 +555,6 @@ void MorphologicalInformation::updateInformation() const
 
   if(mesh != nullptr)
   {
-    double area = 0.0;
-
-    for(long long i = 0; i < mesh->GetNumberOfCells(); ++i)
-    {
-      auto cell = mesh->GetCell(i);
-      area += vtkMeshQuality::TriangleArea(cell);
-    }
-
-    updateInfoCache(MORPHOLOGICAL_AREA, area);
+    updateInfoCache(MORPHOLOGICAL_AREA, surfaceArea(mesh));
   }
 }
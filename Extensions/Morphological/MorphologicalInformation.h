@@ -28,10 +28,6 @@
 #include <Core/Analysis/Data/MeshData.h>
 #include <Core/Analysis/Data/VolumetricData.hxx>
 
-// ITK
-#include <itkLabelImageToShapeLabelMapFilter.h>
-#include <itkStatisticsLabelObject.h>
-
 namespace ESPINA
 {
   namespace Extensions
@@ -39,10 +35,6 @@ namespace ESPINA
     class EspinaExtensions_EXPORT MorphologicalInformation
     : public Core::SegmentationExtension
     {
-        using LabelObjectType       = itk::StatisticsLabelObject<unsigned int, 3>;
-        using LabelMapType          = itk::LabelMap<LabelObjectType>;
-        using Image2LabelFilterType = itk::LabelImageToShapeLabelMapFilter<itkVolumeType, LabelMapType>;
-
       public:
         static const Type TYPE;
 
@@ -79,7 +71,8 @@ namespace ESPINA
         virtual void onExtendedItemSet(Segmentation* item);
 
       private:
-        /** \brief Computes information values.
+        /** \brief Computes information values. The volumetric values are accumulated slab by slab from
+         * the volume data to avoid creating an image of the whole segmentation.
          *
          */
         void updateInformation() const;
@@ -94,8 +87,7 @@ namespace ESPINA
 
         mutable QReadWriteLock m_mutex;
 
-        Image2LabelFilterType::Pointer m_labelMap;
-        mutable LabelObjectType       *m_statistic;
+        mutable bool m_computeFeretDiameter; /** true to compute the Feret diameter, false otherwise. */
 
         friend class MorphologicalInformationFactory;
     };
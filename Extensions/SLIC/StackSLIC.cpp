@@ -20,6 +20,7 @@
 
 //ESPINA
 #include <Extensions/SLIC/StackSLIC.h>
+#include <Extensions/SLIC/StackSLICUtils.h>
 #include <Core/Analysis/Channel.h>
 #include <Core/Analysis/Data/VolumetricDataUtils.hxx>
 #include <Core/Factory/CoreFactory.h>
@@ -44,6 +45,7 @@
 #include <memory>
 #include <functional>
 #include <utility>
+#include <numeric>
 
 // Qt
 #include <QDataStream>
@@ -78,6 +80,8 @@ const QString StackSLIC::VOXELS_FILE = "voxels_%1.slic";
 const QString StackSLIC::LABELS_FILE = "labels.slic";
 const QString StackSLIC::DATA_FILE   = "data.slic";
 
+const unsigned long long StackSLIC::SLICE_CACHE_BUDGET = 64*1024*1024;
+
 const QStringList UNITS{ "bytes", "KB", "MB", "GB", "TB"};
 
 const QStringList VARIANTS_STRINGS{"SLIC", "SLIC0", "ASLIC", "SLIC Undefined!"};
@@ -88,6 +92,7 @@ StackSLIC::StackSLIC(SchedulerSPtr scheduler, CoreFactory* factory, const InfoCa
 , m_scheduler   {scheduler}
 , m_factory     {factory}
 , m_task        {nullptr}
+, m_cache       {SLICE_CACHE_BUDGET}
 {
 }
 
@@ -165,6 +170,8 @@ void StackSLIC::onComputeSLIC(unsigned char m_s, unsigned char m_c, Extensions::
 {
   if(m_task && m_task->isRunning()) return;
 
+  m_cache.clear();
+
   m_result.computed   = false;
   m_result.m_s        = m_s;
   m_result.m_c        = m_c;
@@ -192,6 +199,8 @@ void StackSLIC::onSLICComputed()
     disconnect(m_task.get(), SIGNAL(aborted()),     this, SLOT(onSLICComputed()));
     disconnect(m_task.get(), SIGNAL(progress(int)), this, SIGNAL(progress(int)));
 
+    m_cache.clear();
+
     if(!m_task->isAborted())
     {
       emit computeFinished();
@@ -222,6 +231,7 @@ void StackSLIC::onAbortSLIC()
   }
 
   // load old results if present
+  m_cache.clear();
   m_result.computed = false;
   loadFromSnapshot();
 }
@@ -290,59 +300,104 @@ void StackSLIC::SLICComputeTask::run()
   QList<Label> labels;
   if(!initLabels(image, labels, edgesExtension.get())) return;
 
-  // try to do it in memory, notify if there isn't enough memory.
-  double totalSize = result.region.GetNumberOfPixels() * sizeof(unsigned int);
-
-  try
+  const unsigned long SUPERVOXEL_SIZE = 2 * result.m_s;
+  if(SUPERVOXEL_SIZE > result.region.GetSize(0) || SUPERVOXEL_SIZE > result.region.GetSize(1) || SUPERVOXEL_SIZE > result.region.GetSize(2))
   {
-    voxels = std::unique_ptr<unsigned int[]>(new unsigned int[result.region.GetNumberOfPixels()]);
-    std::memset(voxels.get(), std::numeric_limits<unsigned int>::max(), totalSize);
+    m_errorMessage = tr("Region to compute is too small for given supervoxel spacing. Increase the region or reduce supervoxel distance.");
+    abort();
+    return;
   }
-  catch(...)
+
+  // the whole stack is saved slab by slab as slices, other regions are saved as an image.
+  const bool saveSlices = (image->GetLargestPossibleRegion() == result.region);
+
+  if(!saveSlices)
   {
-    int unit = 0;
-    while(totalSize > 1024)
+    // try to do it in memory, notify if there isn't enough memory.
+    double totalSize = result.region.GetNumberOfPixels() * sizeof(unsigned int);
+
+    try
     {
-      ++unit;
-      totalSize /= 1024.;
+      voxels = std::unique_ptr<unsigned int[]>(new unsigned int[result.region.GetNumberOfPixels()]);
+      std::memset(voxels.get(), std::numeric_limits<unsigned int>::max(), totalSize);
     }
+    catch(...)
+    {
+      int unit = 0;
+      while(totalSize > 1024)
+      {
+        ++unit;
+        totalSize /= 1024.;
+      }
 
-    m_errorMessage = tr("Not enough memory. Processing the stack '%1' requires a total of %2 %3 of memory.").arg(m_stack->name()).arg(QString::number(totalSize, 'f', 1)).arg(UNITS.at(unit));
-    abort();
-    return;
+      m_errorMessage = tr("Not enough memory. Processing the stack '%1' requires a total of %2 %3 of memory.").arg(m_stack->name()).arg(QString::number(totalSize, 'f', 1)).arg(UNITS.at(unit));
+      abort();
+      return;
+    }
   }
 
-  const unsigned long SUPERVOXEL_SIZE = 2 * result.m_s;
-  if(SUPERVOXEL_SIZE > result.region.GetSize(0) || SUPERVOXEL_SIZE > result.region.GetSize(1) || SUPERVOXEL_SIZE > result.region.GetSize(2))
+  m_centers = StackSLICUtils::Centers();
+  for(auto &label: labels)
   {
-    m_errorMessage = tr("Region to compute is too small for given supervoxel spacing. Increase the region or reduce supervoxel distance.");
-    voxels = nullptr;
-    abort();
-    return;
+    m_centers.x.push_back(label.center[0]);
+    m_centers.y.push_back(label.center[1]);
+    m_centers.z.push_back(label.center[2]);
+    m_centers.color.push_back(label.color);
+    m_centers.normQuotient.push_back(label.norm_quotient);
+    m_centers.valid.push_back(label.valid);
   }
+  labels.clear();
+
+  m_sliceRegions.clear();
+  for(auto z = result.region.GetIndex(2); z < result.region.GetIndex(2) + static_cast<long int>(result.region.GetSize(2)); ++z)
+  {
+    m_sliceRegions.push_back(edgesExtension->sliceRegion(z));
+  }
+
+  auto slabs = StackSLICUtils::createSlabs(result.region, result.m_s);
+
+  std::vector<unsigned int> layers(slabs.size());
+  std::iota(layers.begin(), layers.end(), 0);
 
   try
   {
-    for(unsigned int iteration = 0; iteration < result.iterations && !result.converged; ++iteration)
+    for(unsigned int iteration = 0; iteration <= result.iterations; ++iteration)
     {
       if(!canExecute()) break;
 
-      int newProgress = (100 * iteration) / result.iterations;
+      int newProgress = (100 * iteration) / (result.iterations + 1);
       if(newProgress != progress())
       {
         reportProgress(newProgress);
       }
 
-      watcher.setFuture(QtConcurrent::map(labels, std::bind(&SLICComputeTask::computeLabel, this, std::placeholders::_1, edgesExtension, image, labels)));
-      watcher.waitForFinished();
+      // the last pass assigns the voxels to the final centers and saves the labels.
+      const bool lastPass = (iteration == result.iterations) || result.converged;
 
-      if(!canExecute()) break;
+      StackSLICUtils::updateLayers(m_centers, slabs, result.region, result.m_s);
+
+      if(lastPass)
+      {
+        QWriteLocker lock(&result.dataMutex);
 
-      watcher.setFuture(QtConcurrent::map(labels, std::bind(&SLICComputeTask::recalculateCenter, this, std::placeholders::_1, image, TOLERANCE)));
+        result.supervoxels.clear();
+        for(unsigned int i = 0; i < m_centers.size(); ++i)
+        {
+          result.supervoxels.append({IndexType{m_centers.x[i], m_centers.y[i], m_centers.z[i]}, m_centers.color[i], m_centers.valid[i] != 0});
+        }
+      }
+
+      watcher.setFuture(QtConcurrent::map(slabs, [this, &image, lastPass](StackSLICUtils::Slab &slab) { if(canExecute()) computeSlab(slab, image, lastPass); }));
       watcher.waitForFinished();
 
-      if(!canExecute()) break;
+      if(!canExecute() || lastPass) break;
+
+      QAtomicInt moved{0};
+      const StackSLICUtils::NormalizationFunction normalization = [this](const StackSLICUtils::CenterSums &total, const float quotient) { return normalizationQuotient(total, quotient); };
+      watcher.setFuture(QtConcurrent::map(layers, [this, &slabs, &moved, &normalization, TOLERANCE](const unsigned int layer) { if(!StackSLICUtils::updateCenters(m_centers, layer, slabs, TOLERANCE, normalization)) moved.storeRelease(1); }));
+      watcher.waitForFinished();
 
+      result.converged = (TOLERANCE > 0) && (moved.loadAcquire() == 0);
     } //iteration
   }
   catch(const EspinaException &e)
@@ -358,12 +413,8 @@ void StackSLIC::SLICComputeTask::run()
 
   if(canExecute())
   {
-    // add supervoxels as valid. Invalid labels (empty) will be marked as such when computing connectivity.
-    std::for_each(labels.constBegin(), labels.constEnd(), [this](const Label &label) { result.supervoxels.append({label.center, label.color, label.valid});});
-
-    if(image->GetLargestPossibleRegion() == result.region)
+    if(saveSlices)
     {
-      saveResults();
       result.computed = true;
       result.modified = true;
     }
@@ -373,6 +424,7 @@ void StackSLIC::SLICComputeTask::run()
     }
   }
 
+  m_centers = StackSLICUtils::Centers();
   voxels = nullptr;
 }
 
@@ -387,8 +439,8 @@ const unsigned int StackSLIC::getSupervoxel(const itkVolumeType::IndexType &posi
 {
   if(!m_result.computed || !m_result.region.IsInside(position)) return 0;
 
-  auto slice = getUncompressedLabeledSlice(position.GetElement(2));
-  return slice->GetPixel(position);
+  auto slice = getRLESlice(position.GetElement(2));
+  return slice->label(position.GetElement(0), position.GetElement(1));
 }
 
 //-----------------------------------------------------------------------------
@@ -486,6 +538,7 @@ itk::Image<unsigned int, 3>::Pointer StackSLIC::getLabeledImageFromBounds(const
   }
 
   const auto spacing = m_extendedItem->output()->spacing();
+  const auto origin  = m_extendedItem->position();
   auto image = create_itkImage<ImageType>(bounds, SEG_BG_VALUE, spacing);
   auto region = image->GetLargestPossibleRegion();
 
@@ -499,15 +552,20 @@ itk::Image<unsigned int, 3>::Pointer StackSLIC::getLabeledImageFromBounds(const
     requestedSliceRegion.SetSize(2, 1);
     requestedSliceRegion.Crop(edgesExtension->sliceRegion(z));
 
-    auto sliceImage = getUncompressedLabeledSlice(z);
+    auto slice = getRLESlice(z);
     auto requestedBounds = equivalentBounds<ImageType>(image, requestedSliceRegion);
-    auto sliceImageBounds = equivalentBounds<ImageType>(sliceImage, sliceImage->GetLargestPossibleRegion());
+    auto sliceBounds     = equivalentBounds<ImageType>(origin, spacing, slice->region);
+
+    if(!intersect(requestedBounds, sliceBounds)) continue;
 
-    if(!intersect(requestedBounds, sliceImageBounds)) continue;
+    auto intersectionBounds = intersection(requestedBounds, sliceBounds);
+    auto sliceRegion        = equivalentRegion<ImageType>(origin, spacing, intersectionBounds);
+    auto imageRegion        = equivalentRegion<ImageType>(image, intersectionBounds);
 
-    auto intersectionBounds = intersection(requestedBounds, sliceImageBounds);
+    if(!sliceRegion.Crop(slice->region)) continue;
 
-    copy_image<ImageType>(sliceImage, image, intersectionBounds);
+    // only the rows of the requested region are decoded.
+    slice->decode(sliceRegion, image.GetPointer(), imageRegion.GetIndex(), [](const unsigned int label) { return label; });
   }
 
   image->Modified();
@@ -680,12 +738,11 @@ QDataStream &operator<<(QDataStream &out, const StackSLIC::SuperVoxel &label)
 }
 
 //-----------------------------------------------------------------------------
-void StackSLIC::SLICComputeTask::saveResults()
+void StackSLIC::SLICComputeTask::saveSlab(const StackSLICUtils::Slab &slab, const std::vector<unsigned int> &labels)
 {
-  QWriteLocker lock(&result.dataMutex);
-  auto edgesExtension = retrieveOrCreateStackExtension<ChannelEdges>(m_stack, m_factory);
+  const auto sliceSize = result.region.GetSize(0) * result.region.GetSize(1);
 
-  for (auto z = result.region.GetIndex(2); z < result.region.GetIndex(2) + static_cast<long int>(result.region.GetSize(2)); ++z)
+  for (auto z = slab.region.GetIndex(2); z < slab.region.GetIndex(2) + static_cast<long int>(slab.region.GetSize(2)); ++z)
   {
     QByteArray data;
     QDataStream stream(&data, QIODevice::WriteOnly);
@@ -694,9 +751,9 @@ void StackSLIC::SLICComputeTask::saveResults()
     auto region = result.region;
     region.SetIndex(2, z);
     region.SetSize(2,1);
-    region.Crop(edgesExtension->sliceRegion(z));
+    region.Crop(m_sliceRegions[z - result.region.GetIndex(2)]);
 
-    compressSliceRLE(stream, z, region);
+    StackSLICUtils::encodeSlice(stream, region, result.region, labels.data() + (z - slab.region.GetIndex(2)) * sliceSize, result.supervoxels.size());
 
     auto fileName =  m_factory->defaultStorage()->absoluteFilePath(QString(VOXELS_FILE).arg(z));
 
@@ -721,95 +778,6 @@ void StackSLIC::SLICComputeTask::saveResults()
   }
 }
 
-//-----------------------------------------------------------------------------
-void StackSLIC::SLICComputeTask::compressSliceRLE(QDataStream &stream, const long int z, const ImageRegion &region)
-{
-  unsigned int current_label;
-  unsigned char same_label_count = 0;
-  const unsigned int voxelLimit = result.supervoxels.size();
-
-  stream << static_cast<long long>(region.GetIndex(0));
-  stream << static_cast<long long>(region.GetIndex(1));
-  stream << static_cast<unsigned long long>(region.GetSize(0));
-  stream << static_cast<unsigned long long>(region.GetSize(1));
-
-  for(auto y = region.GetIndex(1); y < region.GetIndex(1) + static_cast<long int>(region.GetSize(1)); ++y)
-  {
-    for(auto x = region.GetIndex(0); x < region.GetIndex(0) + static_cast<long int>(region.GetSize(0)); ++x)
-    {
-      auto voxel_index = offsetOfIndex(IndexType{x,y,z});
-      auto voxelValue = voxels[voxel_index];
-
-      if(voxelValue >= voxelLimit) voxelValue = 0;
-
-      if (x != region.GetIndex(0))
-      {
-        if (voxelValue != current_label)
-        {
-          stream << current_label;
-          stream << same_label_count;
-          current_label = voxelValue;
-          same_label_count = 1;
-        }
-        else
-        {
-          if(same_label_count == std::numeric_limits<unsigned char>::max())
-          {
-            stream << current_label;
-            stream << same_label_count;
-
-            same_label_count = 0;
-          }
-
-          ++same_label_count;
-        }
-      }
-      else
-      {
-        current_label = voxelValue;
-        same_label_count = 1;
-      }
-      ++voxel_index;
-    }
-    //Write last supervoxel in row
-    stream << current_label;
-    stream << same_label_count;
-  }
-}
-
-//-----------------------------------------------------------------------------
-void StackSLIC::SLICComputeTask::findCandidateRegion(itkVolumeType::IndexType &center, double scan_size, ImageRegion &region) const
-{
-  union vec4f
-  {
-    __m128 vec;
-    float f[4];
-  };
-
-  region.SetSize(0, scan_size);
-  region.SetSize(1, scan_size);
-  region.SetSize(2, scan_size);
-
-  //Vector divide by 2
-  vec4f srca, srcb;
-  srca.vec = _mm_set_ps1(scan_size);
-  srcb.vec = _mm_set_ps1(2);
-  srcb.vec = _mm_div_ps(srca.vec, srcb.vec);
-
-  //Substract center - previous result
-  srca.f[0] = center[0];
-  srca.f[1] = center[1];
-  srca.f[2] = center[2];
-  srcb.vec = _mm_sub_ps(srca.vec, srcb.vec);
-  _mm_store_ps(srcb.f, srcb.vec);
-
-  region.SetIndex(0, srcb.f[0]);
-  region.SetIndex(1, srcb.f[1]);
-  region.SetIndex(2, srcb.f[2]);
-
-  region.Crop(result.region);
-}
-
 //-----------------------------------------------------------------------------
 bool StackSLIC::SLICComputeTask::initLabels(itkVolumeType *image, QList<Label> &labels, ChannelEdges *edgesExtension)
 {
@@ -888,316 +856,67 @@ bool StackSLIC::SLICComputeTask::initLabels(itkVolumeType *image, QList<Label> &
 }
 
 //-----------------------------------------------------------------------------
-float StackSLIC::SLICComputeTask::calculateDistance(const IndexType &voxel_index, const IndexType &center_index,
-                                                   const unsigned char voxel_color, const unsigned char center_color,
-                                                   const float norm_quotient, float *color_distance,
-                                                   float *spatial_distance, bool only_spatial)
-{
-  union vec4f
-  {
-    __m128 vec;
-    float f[4];
-  };
-
-  //Vector subtraction of cur_index - label->center
-  vec4f srca, srcb;
-  srca.f[1] = voxel_index[0];
-  srca.f[2] = voxel_index[1];
-  srca.f[3] = voxel_index[2];
-  srca.f[0] = voxel_color;
-  srcb.f[1] = center_index[0];
-  srcb.f[2] = center_index[1];
-  srcb.f[3] = center_index[2];
-  srcb.f[0] = center_color;
-  srca.vec = _mm_load_ps(srca.f);
-  srcb.vec = _mm_load_ps(srcb.f);
-  srca.vec = _mm_sub_ps(srca.vec, srcb.vec);
-
-  //Vector multiply of previous result * axis spacing
-  srcb.f[1] = 1;
-  srcb.f[2] = 1;
-  srcb.f[3] = 1;
-  srcb.f[0] = color_normalization_constant;
-  srcb.vec = _mm_load_ps(srcb.f);
-  srca.vec = _mm_mul_ps(srca.vec, srcb.vec);
-
-  //Calculate powers of 2 of results
-  srcb.vec = _mm_mul_ps(srca.vec, srca.vec);
-  _mm_store_ps(srcb.f, srcb.vec);
-
-  double spatial = srcb.f[1] + srcb.f[2] + srcb.f[3];
-  if(only_spatial)
-    //Return spatial distance squared
-    return spatial;
-  //Return normalized distance squared
-  if(color_distance != nullptr)
-    *color_distance = srcb.f[0];
-  if(spatial_distance != nullptr)
-    *spatial_distance = spatial;
-
-  return srcb.f[0] + norm_quotient * spatial;
-}
-
-//-----------------------------------------------------------------------------
-void StackSLIC::SLICComputeTask::computeLabel(Label &label, ChannelEdgesSPtr edgesExtension, itkVolumeType *image, QList<Label> &labels)
-{
-  ImageRegion subRegion;
-  ImageRegion region;
-  unsigned char voxel_color;
-  long int current_slice = 0;
-  unsigned long long voxel_index;
-  unsigned int label_old_index;
-  float spatial_distance, color_distance, distance, distance_old;
-  IndexType cur_index;
-
-  //Find the region of voxels that are in range of this supervoxel
-  findCandidateRegion(label.center, 2. * result.m_s, subRegion);
-
-  const auto center_color = label.color;
-
-  //Iterate over the slices
-  for(current_slice = subRegion.GetIndex(2); current_slice < subRegion.GetIndex(2) + static_cast<long int>(subRegion.GetSize(2)); ++current_slice)
-  {
-    //Get slice edges
-    auto sliceRegion = edgesExtension->sliceRegion(current_slice);
-    //Set region bounds around center for current slice
-    region.SetIndex(0, subRegion.GetIndex(0));
-    region.SetIndex(1, subRegion.GetIndex(1));
-    region.SetIndex(2, current_slice);
-    region.SetSize(0, subRegion.GetSize(0));
-    region.SetSize(1, subRegion.GetSize(1));
-    region.SetSize(2, 1);
-
-    //If the region was completely outside the edges, skip to next slice
-    //This mean either the stack was displaced too much or the z index
-    //was too high/low
-    if(!region.Crop(sliceRegion)) continue;
-
-    itk::ImageRegionIteratorWithIndex<itkVolumeType> it(image, region);
-    it.GoToBegin();
-
-    while(!it.IsAtEnd())
-    {
-      cur_index   = it.GetIndex();
-      voxel_color = it.Get();
-      voxel_index = offsetOfIndex(cur_index);
-      auto voxelLabel = voxels[voxel_index];
-
-      label_old_index = voxelLabel;
-      if(label_old_index == std::numeric_limits<unsigned int>::max() || label_old_index == label.index)
-      {
-        //If voxel is unassigned or assigned to the current label, assume it's an infinite distance away
-        distance_old = std::numeric_limits<double>::max();
-      }
-      else
-      {
-        Q_ASSERT(static_cast<int>(label_old_index) < labels.size());
-        const auto &label_old = labels.at(label_old_index);
-        distance_old = calculateDistance(cur_index, label_old.center, voxel_color, image->GetPixel(label_old.center), label_old.norm_quotient, nullptr, nullptr);
-      }
-
-      distance = calculateDistance(cur_index, label.center, voxel_color, center_color, label.norm_quotient, &color_distance, &spatial_distance);
-
-      if(distance < distance_old)
-      {
-        QMutexLocker locker(&labelListMutex);
-        if(label_old_index != voxelLabel)
-        {
-          Q_ASSERT(static_cast<int>(voxelLabel) < labels.size());
-          const auto &label_old = labels.at(voxelLabel);
-          distance_old = calculateDistance(cur_index, label_old.center, voxel_color, image->GetPixel(label_old.center), label_old.norm_quotient, nullptr, nullptr);
-        }
-
-        if(distance < distance_old)
-        {
-          voxels[voxel_index] = label.index;
-
-          //Update maximum distances
-          switch(result.variant)
-          {
-            case SLICVariant::ASLIC:
-              if(label.m_c < color_distance) label.m_c = color_distance;
-            //no break
-            case SLICVariant::SLICO:
-            case SLICVariant::SLIC:
-              if(label.m_s < spatial_distance) label.m_s = spatial_distance;
-              break;
-            default:
-              Q_ASSERT(false);
-              break;
-          }
-        }
-      }
-
-      ++it;
-    } //RegionIterator
-  }//current_slice
-
-  QMutexLocker locker(&labelListMutex);
-  switch(result.variant)
-  {
-    case SLICVariant::ASLIC:
-      //Update max. distances calculating their roots as we were
-      //using squared distances for the simplified equations
-      label.m_c = std::sqrt(label.m_c);
-    //no break
-    case SLICVariant::SLICO:
-    case SLICVariant::SLIC:
-      label.m_s = std::sqrt(label.m_s);
-      break;
-    default:
-      Q_ASSERT(false);
-      break;
-  }
-}
-
-//-----------------------------------------------------------------------------
-void StackSLIC::SLICComputeTask::recalculateCenter(Label& label, itkVolumeType *image, const double tolerance)
+void StackSLIC::SLICComputeTask::computeSlab(StackSLICUtils::Slab &slab, itkVolumeType *image, const bool save)
 {
-  // asumme all converge if we are going to check for convergence. Set to false later when recomputing supervoxel centers.
-  if(tolerance > 0) result.converged = true;
-
-  //Recalculate centers, check convergence
-  const auto SCAN_SIZE = 2. * result.m_s;
+  std::vector<unsigned int> labels;
 
-  ImageRegion subRegion;
-  findCandidateRegion(label.center, SCAN_SIZE, subRegion);
+  const bool adaptive = (result.variant != SLICVariant::SLIC);
 
-  unsigned long long sum_color = 0;
-  unsigned long long sum_voxels = 0;
-  long long int sum_x = 0;
-  long long int sum_y = 0;
-  long long int sum_z = 0;
+  if(!StackSLICUtils::computeSlab(slab, m_centers, image, result.region, m_sliceRegions, result.m_s, adaptive, labels, [this]() { return canExecute(); })) return;
 
-  auto it = itk::ImageRegionConstIterator<itkVolumeType>(image, subRegion);
-  it.GoToBegin();
-
-  while(!it.IsAtEnd())
+  if(save)
   {
-    const auto index = it.GetIndex();
-    const auto voxel_index = offsetOfIndex(index);
-    const auto voxelLabel = voxels[voxel_index];
-
-    Q_ASSERT(voxel_index < result.region.GetNumberOfPixels());
-
-    if (label.index == voxelLabel)
+    if(voxels)
     {
-      ++sum_voxels;
-      sum_x += index.GetElement(0); sum_y += index.GetElement(1); sum_z += index.GetElement(2);
-      sum_color += image->GetPixel(index);
+      const auto sliceSize = slab.region.GetSize(0) * slab.region.GetSize(1);
+      const auto offset    = (slab.region.GetIndex(2) - result.region.GetIndex(2)) * sliceSize;
+      std::memcpy(voxels.get() + offset, labels.data(), labels.size() * sizeof(unsigned int));
     }
-
-    ++it;
-  }
-
-  if(sum_voxels > 0)
-  {
-    //Calculate averaged coordinates
-    sum_x = std::round(sum_x/sum_voxels);
-    sum_y = std::round(sum_y/sum_voxels);
-    sum_z = std::round(sum_z/sum_voxels);
-
-    //Calculate displacement for the tolerance test
+    else
     {
-      QWriteLocker lock(&result.dataMutex);
-      if(tolerance > 0 && result.converged)
-      {
-        auto cur_index = IndexType{sum_x, sum_y, sum_z};
-        auto spatial_distance = calculateDistance(label.center, cur_index, 0, 0, 0, nullptr, nullptr, true);
-
-        if(spatial_distance > tolerance) result.converged = false;
-      }
+      saveSlab(slab, labels);
     }
-
-    QMutexLocker locker(&labelListMutex);
-    label.center = {sum_x, sum_y, sum_z};
-    label.color = sum_color/sum_voxels;
-  }
-
-  {
-    QMutexLocker locker(&labelListMutex);
-    label.valid = (sum_voxels != 0);
   }
+}
 
-  //Update weights with maximum observed results and reset them
+//-----------------------------------------------------------------------------
+float StackSLIC::SLICComputeTask::normalizationQuotient(const StackSLICUtils::CenterSums &total, const float quotient) const
+{
   switch(result.variant)
   {
     case SLICVariant::ASLIC:
-      {
-        QMutexLocker locker(&labelListMutex);
-        //Squared constants to prevent having to use expensive roots
-        label.norm_quotient = std::pow(label.m_c,2)/std::pow(label.m_s,2);
-        label.m_c = 1;
-        label.m_s = 1.0;
-      }
-      break;
+      return total.distance / total.spatial;
     case SLICVariant::SLICO:
-      {
-        QMutexLocker locker(&labelListMutex);
-        label.norm_quotient = std::pow(result.m_c,2)/std::pow(label.m_s,2);
-        label.m_s = 1.0;
-      }
-      break;
+      return std::pow(result.m_c, 2) / total.spatial;
     case SLICVariant::SLIC:
       break;
     default:
       Q_ASSERT(false);
       break;
   }
+
+  return quotient;
 }
 
 //-----------------------------------------------------------------------------
 itkVolumeType::Pointer StackSLIC::getUncompressedSlice(const int slice) const
 {
-  auto data = getSlice(slice);
-  auto RLEdata = qUncompress(data);
-  data.clear();
-
-  QDataStream stream(&RLEdata, QIODevice::ReadOnly);
-  stream.setVersion(QDataStream::Qt_4_0);
-
-  long long x, y;
-  unsigned long long length_x, length_y;
-
-  stream >> x;
-  stream >> y;
-  stream >> length_x;
-  stream >> length_y;
-
-  itkVolumeType::RegionType region;
-  region.SetIndex(0, x);
-  region.SetIndex(1, y);
-  region.SetIndex(2, slice);
-  region.SetSize(0, length_x);
-  region.SetSize(1, length_y);
-  region.SetSize(2, 1);
+  auto rleSlice = getRLESlice(slice);
 
   auto spacing = m_extendedItem->output()->spacing();
   auto origin  = m_extendedItem->position();
-  auto bounds  = equivalentBounds<itkVolumeType>(origin, spacing, region);
+  auto bounds  = equivalentBounds<itkVolumeType>(origin, spacing, rleSlice->region);
 
   auto sliceImage = create_itkImage<itkVolumeType>(bounds, SEG_BG_VALUE, spacing, origin);
-  auto buffer = sliceImage->GetBufferPointer();
 
-  unsigned int label;
-  unsigned char voxel_count;
-  const unsigned int voxelLimit = m_result.supervoxels.size();
-
-  unsigned long long int pixel = 0;
-
-  while(pixel < length_x*length_y)
+  const auto &supervoxels = m_result.supervoxels;
+  auto color = [&supervoxels](const unsigned int label)
   {
-    stream >> label;
-    stream >> voxel_count;
+    Q_ASSERT(label < static_cast<unsigned int>(supervoxels.size()));
+    return supervoxels[label].color;
+  };
 
-    Q_ASSERT(label < voxelLimit);
-
-    for(int i = 0; i < voxel_count; ++i)
-    {
-      *buffer++ = m_result.supervoxels[label].color;
-    }
-    pixel += voxel_count;
-  }
+  rleSlice->decode(rleSlice->region, sliceImage.GetPointer(), sliceImage->GetLargestPossibleRegion().GetIndex(), color);
 
   sliceImage->Modified();
 
@@ -1207,55 +926,32 @@ itkVolumeType::Pointer StackSLIC::getUncompressedSlice(const int slice) const
 //-----------------------------------------------------------------------------
 itk::Image<unsigned int, 3>::Pointer StackSLIC::getUncompressedLabeledSlice(const int slice) const
 {
-  auto data = getSlice(slice);
-  auto RLEdata = qUncompress(data);
-  data.clear();
-
-  QDataStream stream(&RLEdata, QIODevice::ReadOnly);
-  stream.setVersion(QDataStream::Qt_4_0);
-
-  long long x, y;
-  unsigned long long length_x, length_y;
-
-  stream >> x;
-  stream >> y;
-  stream >> length_x;
-  stream >> length_y;
-
-  itkVolumeType::RegionType region;
-  region.SetIndex(0, x);
-  region.SetIndex(1, y);
-  region.SetIndex(2, slice);
-  region.SetSize(0, length_x);
-  region.SetSize(1, length_y);
-  region.SetSize(2, 1);
+  auto rleSlice = getRLESlice(slice);
 
   auto spacing = m_extendedItem->output()->spacing();
   auto origin  = m_extendedItem->position();
-  auto bounds  = equivalentBounds<ImageType>(origin, spacing, region);
+  auto bounds  = equivalentBounds<ImageType>(origin, spacing, rleSlice->region);
 
   auto sliceImage = create_itkImage<ImageType>(bounds, SEG_BG_VALUE, spacing, origin);
-  auto buffer = sliceImage->GetBufferPointer();
 
-  unsigned int label;
-  unsigned char voxel_count;
+  rleSlice->decode(rleSlice->region, sliceImage.GetPointer(), sliceImage->GetLargestPossibleRegion().GetIndex(), [](const unsigned int label) { return label; });
+
+  sliceImage->Modified();
 
-  unsigned long long int pixel = 0;
+  return sliceImage;
+}
 
-  while(pixel < length_x*length_y)
+//-----------------------------------------------------------------------------
+StackSLICUtils::RLESliceSPtr StackSLIC::getRLESlice(const int slice) const
+{
+  auto rleSlice = m_cache.slice(slice);
+
+  if(!rleSlice)
   {
-    stream >> label;
-    stream >> voxel_count;
-    for(int i = 0; i < voxel_count; ++i)
-    {
-      *buffer++ = label;
-    }
-    pixel += voxel_count;
+    rleSlice = m_cache.insert(slice, StackSLICUtils::decodeSlice(qUncompress(getSlice(slice)), slice));
   }
 
-  sliceImage->Modified();
-
-  return sliceImage;
+  return rleSlice;
 }
 
 //-----------------------------------------------------------------------------
@@ -1348,14 +1044,6 @@ Snapshot ESPINA::Extensions::StackSLIC::snapshot() const
   return snapshot;
 }
 
-//--------------------------------------------------------------------
-inline const unsigned long long int StackSLIC::SLICComputeTask::offsetOfIndex(const IndexType &index)
-{
-  return  (index.GetElement(0) - result.region.GetIndex(0)) +
-         ((index.GetElement(1) - result.region.GetIndex(1)) * result.region.GetSize(0)) +
-         ((index.GetElement(2) - result.region.GetIndex(2)) * result.region.GetSize(0)*result.region.GetSize(1));
-}
-
 //--------------------------------------------------------------------
 const int StackSLIC::taskProgress() const
 {
@@ -27,10 +27,14 @@
 #include <Core/Analysis/Extensions.h>
 #include <Core/MultiTasking/Task.h>
 #include <Extensions/EdgeDistances/ChannelEdges.h>
+#include <Extensions/SLIC/StackSLICUtils.h>
 
 //Qt
 #include <QFutureWatcher>
 
+// C++
+#include <vector>
+
 class vtkUnsignedCharArray;
 class vtkPoints;
 
@@ -288,10 +292,13 @@ namespace ESPINA
             SLICResult(): tolerance{0}, iterations{10}, m_s{10}, m_c{20}, variant{SLICVariant::SLIC}, computed{false}, modified{false}, converged{false} {};
         };
 
-        SchedulerSPtr                    m_scheduler; /** application scheduler.                                   */
-        CoreFactory                     *m_factory;   /** core factory.                                            */
-        std::shared_ptr<SLICComputeTask> m_task;      /** Task instance that is currently running SLIC.            */
-        SLICResult                       m_result;    /** struct holding the results of the last SLIC computation. */
+        static const unsigned long long SLICE_CACHE_BUDGET; /** default max memory used by the cached slices in bytes. */
+
+        SchedulerSPtr                         m_scheduler; /** application scheduler.                                          */
+        CoreFactory                          *m_factory;   /** core factory.                                                   */
+        std::shared_ptr<SLICComputeTask>      m_task;      /** Task instance that is currently running SLIC.                   */
+        SLICResult                            m_result;    /** struct holding the results of the last SLIC computation.        */
+        mutable StackSLICUtils::RLESliceCache m_cache;     /** cached RLE slices, must be cleared when the results change.     */
 
         /** \brief Loads the results from disk.
          *
@@ -305,6 +312,13 @@ namespace ESPINA
          */
         const QByteArray getSlice(const int slice) const;
 
+        /** \brief Returns the RLE slice of the given slice number from the slice cache, loading and indexing
+         * it if not cached.
+         * \param[in] slice Slice number.
+         *
+         */
+        StackSLICUtils::RLESliceSPtr getRLESlice(const int slice) const;
+
         friend class SLICComputeTask;
         friend class StackSLICFactory;
     };
@@ -336,33 +350,18 @@ namespace ESPINA
         virtual void run();
         virtual void onAbort();
 
-        /** \brief Saves the computed results to the result struct to disk.
+        /** \brief Saves the labels of a slab to disk in the compressed RLE format, one file per slice.
+         * \param[in] slab slab to save.
+         * \param[in] labels labels of the slab voxels.
          *
          */
-        void saveResults();
+        void saveSlab(const StackSLICUtils::Slab &slab, const std::vector<unsigned int> &labels);
 
         /** \brief Saves the computed image to the temporal storage.
          *
          */
         void saveRegionImage();
 
-        /** \brief Compresses a slice and saves it to a QDataStream in RLE format prepending slice position and size.
-         * \param[out] QDataStream that will hold the compressed slice.
-         * \param[in] slice to compress.
-         * \param[in] region Image region to compress.
-         *
-         */
-        void compressSliceRLE(QDataStream &stream, const long int z, const ImageRegion &region);
-
-        /** \brief Returns the custom-defined region of voxels that are candidates to belong to the
-         * given supervoxel.
-         * \param[in] supervoxel position.
-         * \param[in] radius of influence assigned to the supervoxel.
-         * \param[out] region Computed region.
-         *
-         */
-        void findCandidateRegion(itkVolumeType::IndexType &center, double scan_size, ImageRegion &region) const;
-
         /** \brief Distributes evenly spaced empty supervoxels trying not to place them on edges.
          * \param[in] image to populate with supervoxels.
          * \param[out] list that will hold the created supervoxels.
@@ -371,45 +370,20 @@ namespace ESPINA
          */
         bool initLabels(itkVolumeType *image, QList<Label> &labels, ChannelEdges *edgesExtension);
 
-        /** \brief Returns the offset in memory or file of the given image index.
-         * \param[in] index Voxel index struct.
-         *
-         */
-        const unsigned long long int offsetOfIndex(const IndexType &index);
-
-        //TODO: Check color_distance for nullptr and remove only_spatial?
-        /** \brief Calculates the weighted distance between a voxel an a supervoxel.
-         * \param[in] coordinates of the voxel.
-         * \param[in] coordinates of the supervoxel.
-         * \param[in] voxel color.
-         * \param[in] mean color of the voxels contained in the supervoxel.
-         * \param[in] normalization quotient used to calculate the weighted distance.
-         * \param[out] weighted color distance.
-         * \param[out] weighted spatial distance.
-         * \param[in] wether color distance should be calculated.
+        /** \brief Assigns the voxels of the slab to the closest center of its halo and computes the sums of the centers.
+         * \param[in,out] slab slab to process.
+         * \param[in] image stack image.
+         * \param[in] save true to save the labels of the slab, false otherwise.
          *
          */
-        float calculateDistance(const IndexType &voxel_index, const IndexType &center_index,
-                                const unsigned char voxel_color, const unsigned char center_color,
-                                const float norm_quotient, float *color_distance, float *spatial_distance,
-                                bool only_spatial = false);
+        void computeSlab(StackSLICUtils::Slab &slab, itkVolumeType *image, const bool save);
 
-        /** \brief Finds the surrounding voxels that belong to the given supervoxel.
-         * \param[in,out] label Label to update.
-         * \param[in] edgesExtension pointer to the edges extension.
-         * \param[in] image pointer to the image.
-         * \param[in] labels List of all supervoxels.
+        /** \brief Returns the new normalization quotient of a center for the SLIC variant of the computation.
+         * \param[in] total merged sums of the center voxels.
+         * \param[in] quotient current normalization quotient.
          *
          */
-        void computeLabel(Label &label, ChannelEdgesSPtr edgesExtension, itkVolumeType *image, QList<Label> &labels);
-
-        /** \brief Recomputes the label center looking at the current label voxel positions.
-         * \param[in,out] label to update.
-         * \param[in] image Pointer to stack image.
-         * \param[in] tolerance Tolerance value for convergence test.
-         *
-         */
-        void recalculateCenter(Label &label, itkVolumeType *image, const double tolerance);
+        float normalizationQuotient(const StackSLICUtils::CenterSums &total, const float quotient) const;
 
         virtual bool hasErrors() const override
         { return !m_errorMessage.isEmpty(); };
@@ -419,12 +393,10 @@ namespace ESPINA
         ChannelPtr                       m_stack;        /** stack to process.                                                  */
         CoreFactory                     *m_factory;      /** core object factory needed to create edges extension if neccesary. */
         SLICResult                      &result;         /** Pointer to the result struct to write the computed results to.     */
-        std::unique_ptr<unsigned int[]>  voxels;         /** voxel volume storage.                                              */
+        std::unique_ptr<unsigned int[]>  voxels;         /** voxel volume storage for regions not saved as slices.              */
         QString                          m_errorMessage; /** error message or empty on success.                                 */
-
-        const double color_normalization_constant = 100.0/255.0; /** Used to avoid dividing when switching from grayscale space (0-255) to CIELab intensity (0-100) */
-
-        mutable QMutex labelListMutex;
+        StackSLICUtils::Centers          m_centers;      /** supervoxel centers.                                                */
+        std::vector<ImageRegion>         m_sliceRegions; /** region to compute of each slice, inside the stack edges.           */
 
         QFutureWatcher<void> watcher;
 
@@ -0,0 +1,501 @@
+/*
+ * Copyright (C) 2026, Felix de las Pozas Alvarez <fpozas@cesvima.upm.es>
+ *
+ * This file is part of ESPINA.
+ *
+ * ESPINA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// ESPINA
+#include <Extensions/SLIC/StackSLICUtils.h>
+#include <Core/Utils/EspinaException.h>
+
+// Qt
+#include <QDataStream>
+#include <QMutexLocker>
+#include <QObject>
+
+// C++
+#include <cmath>
+#include <limits>
+
+using namespace ESPINA;
+using namespace ESPINA::Core::Utils;
+using namespace ESPINA::Extensions;
+using namespace ESPINA::Extensions::StackSLICUtils;
+
+const int RLE_HEADER_SIZE = 2*sizeof(qint64) + 2*sizeof(quint64); /** slice position and size. */
+
+//-----------------------------------------------------------------------------
+unsigned int RLESlice::label(const long long x, const long long y) const
+{
+  const auto row    = y - region.GetIndex(1);
+  const auto column = x - region.GetIndex(0);
+
+  if(row < 0 || column < 0 || row >= static_cast<long long>(rows.size()) || column >= static_cast<long long>(region.GetSize(0))) return 0;
+
+  auto run = data.constData() + rows[row];
+
+  long long position = 0;
+  while(true)
+  {
+    position += static_cast<unsigned char>(run[sizeof(quint32)]);
+
+    if(column < position) break;
+
+    run += RLESlice::RUN_SIZE;
+  }
+
+  return qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(run));
+}
+
+//-----------------------------------------------------------------------------
+void StackSLICUtils::encodeSlice(QDataStream &stream, const ImageRegion &region, const ImageRegion &labelsRegion, const unsigned int *labels, const unsigned int labelLimit)
+{
+  unsigned int current_label;
+  unsigned char same_label_count = 0;
+  const auto width = labelsRegion.GetSize(0);
+
+  stream << static_cast<long long>(region.GetIndex(0));
+  stream << static_cast<long long>(region.GetIndex(1));
+  stream << static_cast<unsigned long long>(region.GetSize(0));
+  stream << static_cast<unsigned long long>(region.GetSize(1));
+
+  for(auto y = region.GetIndex(1); y < region.GetIndex(1) + static_cast<long int>(region.GetSize(1)); ++y)
+  {
+    for(auto x = region.GetIndex(0); x < region.GetIndex(0) + static_cast<long int>(region.GetSize(0)); ++x)
+    {
+      auto voxel_index = (x - labelsRegion.GetIndex(0)) + (y - labelsRegion.GetIndex(1)) * width;
+      auto voxelValue = labels[voxel_index];
+
+      if(voxelValue >= labelLimit) voxelValue = 0;
+
+      if (x != region.GetIndex(0))
+      {
+        if (voxelValue != current_label)
+        {
+          stream << current_label;
+          stream << same_label_count;
+          current_label = voxelValue;
+          same_label_count = 1;
+        }
+        else
+        {
+          if(same_label_count == std::numeric_limits<unsigned char>::max())
+          {
+            stream << current_label;
+            stream << same_label_count;
+
+            same_label_count = 0;
+          }
+
+          ++same_label_count;
+        }
+      }
+      else
+      {
+        current_label = voxelValue;
+        same_label_count = 1;
+      }
+    }
+    //Write last supervoxel in row
+    stream << current_label;
+    stream << same_label_count;
+  }
+}
+
+//-----------------------------------------------------------------------------
+RLESliceSPtr StackSLICUtils::decodeSlice(const QByteArray &data, const int slice)
+{
+  auto rleSlice = std::make_shared<RLESlice>();
+  rleSlice->data = data;
+
+  QDataStream stream(&rleSlice->data, QIODevice::ReadOnly);
+  stream.setVersion(QDataStream::Qt_4_0);
+
+  long long x, y;
+  unsigned long long length_x, length_y;
+
+  stream >> x;
+  stream >> y;
+  stream >> length_x;
+  stream >> length_y;
+
+  rleSlice->region.SetIndex(0, x);
+  rleSlice->region.SetIndex(1, y);
+  rleSlice->region.SetIndex(2, slice);
+  rleSlice->region.SetSize(0, length_x);
+  rleSlice->region.SetSize(1, length_y);
+  rleSlice->region.SetSize(2, 1);
+
+  // runs never span several rows, the index stores the offset of the run that starts each row.
+  rleSlice->rows.reserve(length_y);
+
+  const auto runs = rleSlice->data.constData();
+  const int  size = rleSlice->data.size();
+
+  int offset = RLE_HEADER_SIZE;
+  for(unsigned long long row = 0; row < length_y; ++row)
+  {
+    rleSlice->rows.push_back(offset);
+
+    unsigned long long pixel = 0;
+    while(pixel < length_x)
+    {
+      if(offset + RLESlice::RUN_SIZE > size)
+      {
+        auto message = QObject::tr("Invalid slice data");
+        auto details = QObject::tr("StackSLICUtils::decodeSlice() -> The data of slice %1 is truncated.").arg(slice);
+
+        throw EspinaException(message, details);
+      }
+
+      pixel  += static_cast<unsigned char>(runs[offset + sizeof(quint32)]);
+      offset += RLESlice::RUN_SIZE;
+    }
+  }
+
+  return rleSlice;
+}
+
+//-----------------------------------------------------------------------------
+RLESliceCache::RLESliceCache(const unsigned long long budget)
+: m_size  {0}
+, m_budget{budget}
+{
+}
+
+//-----------------------------------------------------------------------------
+RLESliceSPtr RLESliceCache::slice(const int slice)
+{
+  QMutexLocker lock(&m_mutex);
+
+  auto it = m_slices.find(slice);
+  if(it == m_slices.end()) return nullptr;
+
+  m_lru.splice(m_lru.begin(), m_lru, it.value().position);
+
+  return it.value().slice;
+}
+
+//-----------------------------------------------------------------------------
+RLESliceSPtr RLESliceCache::insert(const int slice, RLESliceSPtr rleSlice)
+{
+  QMutexLocker lock(&m_mutex);
+
+  auto it = m_slices.find(slice);
+  if(it != m_slices.end())
+  {
+    // inserted by other thread meanwhile.
+    m_lru.splice(m_lru.begin(), m_lru, it.value().position);
+
+    return it.value().slice;
+  }
+
+  m_lru.push_front(slice);
+  m_slices.insert(slice, Entry{rleSlice, m_lru.begin()});
+  m_size += rleSlice->size();
+
+  while(m_size > m_budget && m_lru.size() > 1)
+  {
+    auto evicted = m_slices.take(m_lru.back());
+    m_size -= evicted.slice->size();
+    m_lru.pop_back();
+  }
+
+  return rleSlice;
+}
+
+//-----------------------------------------------------------------------------
+void RLESliceCache::clear()
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_slices.clear();
+  m_lru.clear();
+  m_size = 0;
+}
+
+//-----------------------------------------------------------------------------
+void RLESliceCache::setBudget(const unsigned long long budget)
+{
+  QMutexLocker lock(&m_mutex);
+
+  m_budget = budget;
+}
+
+//-----------------------------------------------------------------------------
+std::list<int> RLESliceCache::slices() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_lru;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long RLESliceCache::size() const
+{
+  QMutexLocker lock(&m_mutex);
+
+  return m_size;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<Slab> StackSLICUtils::createSlabs(const ImageRegion &region, const unsigned int step)
+{
+  std::vector<Slab> slabs;
+
+  // the centers are one step apart and their search window is two steps wide, one step thick layer of centers
+  // at each side of a slab is enough.
+  const long int depth = step;
+  const long int first = region.GetIndex(2);
+  const long int last  = first + static_cast<long int>(region.GetSize(2));
+
+  for(auto z = first; z < last; z += depth)
+  {
+    Slab slab;
+    slab.region = region;
+    slab.region.SetIndex(2, z);
+    slab.region.SetSize(2, std::min(depth, last - z));
+    slab.first = 0;
+
+    slabs.push_back(slab);
+  }
+
+  return slabs;
+}
+
+//-----------------------------------------------------------------------------
+void StackSLICUtils::updateLayers(Centers &centers, std::vector<Slab> &slabs, const ImageRegion &region, const unsigned int step)
+{
+  const auto size   = centers.size();
+  const auto layers = static_cast<unsigned int>(slabs.size());
+
+  centers.layer.resize(size);
+  centers.position.resize(size);
+  centers.order.resize(size);
+  centers.layerStart.assign(layers + 1, 0);
+
+  // counting sort of the centers by layer.
+  for(unsigned int i = 0; i < size; ++i)
+  {
+    const auto layer = std::min<itk::IndexValueType>(layers - 1, std::max<itk::IndexValueType>(0, (centers.z[i] - region.GetIndex(2)) / static_cast<itk::IndexValueType>(step)));
+
+    centers.layer[i] = layer;
+    ++centers.layerStart[layer + 1];
+  }
+
+  for(unsigned int layer = 0; layer < layers; ++layer)
+  {
+    centers.layerStart[layer + 1] += centers.layerStart[layer];
+  }
+
+  auto next = centers.layerStart;
+  for(unsigned int i = 0; i < size; ++i)
+  {
+    const auto position = next[centers.layer[i]]++;
+
+    centers.order[position] = i;
+    centers.position[i]     = position;
+  }
+
+  // a voxel can only be assigned to centers closer than one step in z, so the halo of a slab are the centers of
+  // the adjacent layers.
+  for(unsigned int layer = 0; layer < layers; ++layer)
+  {
+    auto &slab = slabs[layer];
+
+    slab.first = centers.layerStart[(layer > 0) ? layer - 1 : 0];
+    slab.sums.clear();
+    slab.sums.resize(centers.layerStart[std::min(layer + 2, layers)] - slab.first, CenterSums{0, 0, 0, 0, 0, 0, 0});
+  }
+}
+
+//-----------------------------------------------------------------------------
+bool StackSLICUtils::computeSlab(Slab                           &slab,
+                                 const Centers                  &centers,
+                                 const itkVolumeType            *image,
+                                 const ImageRegion              &region,
+                                 const std::vector<ImageRegion> &sliceRegions,
+                                 const unsigned int              step,
+                                 const bool                      adaptive,
+                                 std::vector<unsigned int>      &labels,
+                                 std::function<bool()>           canExecute)
+{
+  const auto slabRegion = slab.region;
+  const itk::IndexValueType S = step;
+  const auto width     = slabRegion.GetSize(0);
+  const auto sliceSize = slabRegion.GetSize(0) * slabRegion.GetSize(1);
+  const auto end       = slab.first + static_cast<unsigned int>(slab.sums.size());
+  const auto buffer    = image->GetBufferPointer();
+
+  const itk::IndexValueType minimum[3]{slabRegion.GetIndex(0), slabRegion.GetIndex(1), slabRegion.GetIndex(2)};
+  const itk::IndexValueType maximum[3]{minimum[0] + static_cast<itk::IndexValueType>(slabRegion.GetSize(0)),
+                                       minimum[1] + static_cast<itk::IndexValueType>(slabRegion.GetSize(1)),
+                                       minimum[2] + static_cast<itk::IndexValueType>(slabRegion.GetSize(2))};
+
+  std::vector<float> distances(slabRegion.GetNumberOfPixels(), std::numeric_limits<float>::max());
+  labels.assign(slabRegion.GetNumberOfPixels(), std::numeric_limits<unsigned int>::max());
+
+  // assignment: every center of the halo updates the voxels of its 2S window inside the slab.
+  for(auto position = slab.first; position < end; ++position)
+  {
+    if(!canExecute()) return false;
+
+    const auto center  = centers.order[position];
+    const auto cx      = centers.x[center];
+    const auto cy      = centers.y[center];
+    const auto cz      = centers.z[center];
+    const float color  = centers.color[center];
+    const float factor = centers.normQuotient[center];
+
+    for(auto z = std::max(cz - S, minimum[2]); z < std::min(cz + S, maximum[2]); ++z)
+    {
+      const auto &edges = sliceRegions[z - region.GetIndex(2)];
+
+      const auto xBegin = std::max(std::max(cx - S, minimum[0]), edges.GetIndex(0));
+      const auto xEnd   = std::min(std::min(cx + S, maximum[0]), edges.GetIndex(0) + static_cast<itk::IndexValueType>(edges.GetSize(0)));
+      const auto yBegin = std::max(std::max(cy - S, minimum[1]), edges.GetIndex(1));
+      const auto yEnd   = std::min(std::min(cy + S, maximum[1]), edges.GetIndex(1) + static_cast<itk::IndexValueType>(edges.GetSize(1)));
+
+      if(xBegin >= xEnd || yBegin >= yEnd) continue;
+
+      const float dz2 = (z - cz) * (z - cz);
+
+      for(auto y = yBegin; y < yEnd; ++y)
+      {
+        const float dyz2 = dz2 + (y - cy) * (y - cy);
+
+        const auto offset = (z - minimum[2]) * sliceSize + (y - minimum[1]) * width - minimum[0];
+        const auto row    = buffer + image->ComputeOffset(itkVolumeType::IndexType{0, y, z});
+
+        for(auto x = xBegin; x < xEnd; ++x)
+        {
+          const float dc       = (row[x] - color) * COLOR_NORMALIZATION;
+          const float distance = dc * dc + factor * (dyz2 + (x - cx) * (x - cx));
+
+          if(distance < distances[offset + x])
+          {
+            distances[offset + x] = distance;
+            labels[offset + x]    = center;
+          }
+        }
+      }
+    }
+  }
+
+  distances.clear();
+  distances.shrink_to_fit();
+
+  // sums of the voxels assigned to each center of the halo.
+  for(auto z = minimum[2]; z < maximum[2]; ++z)
+  {
+    for(auto y = minimum[1]; y < maximum[1]; ++y)
+    {
+      const auto label = labels.data() + (z - minimum[2]) * sliceSize + (y - minimum[1]) * width;
+      const auto row   = buffer + image->ComputeOffset(itkVolumeType::IndexType{minimum[0], y, z});
+
+      for(unsigned long long x = 0; x < width; ++x)
+      {
+        const auto center = label[x];
+        if(center == std::numeric_limits<unsigned int>::max()) continue;
+
+        auto &sums = slab.sums[centers.position[center] - slab.first];
+        const auto voxelX = minimum[0] + static_cast<itk::IndexValueType>(x);
+
+        ++sums.voxels;
+        sums.x     += voxelX;
+        sums.y     += y;
+        sums.z     += z;
+        sums.color += row[x];
+
+        if(adaptive)
+        {
+          const float dx = voxelX - centers.x[center];
+          const float dy = y - centers.y[center];
+          const float dz = z - centers.z[center];
+          const float dc = (row[x] - static_cast<float>(centers.color[center])) * COLOR_NORMALIZATION;
+
+          sums.spatial  = std::max(sums.spatial, dx * dx + dy * dy + dz * dz);
+          sums.distance = std::max(sums.distance, dc * dc);
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool StackSLICUtils::updateCenters(Centers                     &centers,
+                                   const unsigned int           layer,
+                                   const std::vector<Slab>     &slabs,
+                                   const double                 tolerance,
+                                   const NormalizationFunction &normalization)
+{
+  bool converged = true;
+
+  const auto first = (layer > 0) ? layer - 1 : 0;
+  const auto last  = std::min(layer + 2, static_cast<unsigned int>(slabs.size()));
+
+  for(auto position = centers.layerStart[layer]; position < centers.layerStart[layer + 1]; ++position)
+  {
+    const auto center = centers.order[position];
+
+    // merge the sums of the slabs that have the center in their halo.
+    CenterSums total{0, 0, 0, 0, 0, 1, 1};
+    for(auto i = first; i < last; ++i)
+    {
+      const auto &sums = slabs[i].sums[position - slabs[i].first];
+
+      total.voxels  += sums.voxels;
+      total.x       += sums.x;
+      total.y       += sums.y;
+      total.z       += sums.z;
+      total.color   += sums.color;
+      total.spatial  = std::max(total.spatial, sums.spatial);
+      total.distance = std::max(total.distance, sums.distance);
+    }
+
+    centers.valid[center] = (total.voxels != 0);
+
+    if(total.voxels > 0)
+    {
+      itkVolumeType::IndexType newCenter;
+      newCenter[0] = std::llround(static_cast<double>(total.x)/total.voxels);
+      newCenter[1] = std::llround(static_cast<double>(total.y)/total.voxels);
+      newCenter[2] = std::llround(static_cast<double>(total.z)/total.voxels);
+
+      if(tolerance > 0)
+      {
+        const double dx = newCenter[0] - centers.x[center];
+        const double dy = newCenter[1] - centers.y[center];
+        const double dz = newCenter[2] - centers.z[center];
+
+        if(dx * dx + dy * dy + dz * dz > tolerance) converged = false;
+      }
+
+      centers.x[center]     = newCenter[0];
+      centers.y[center]     = newCenter[1];
+      centers.z[center]     = newCenter[2];
+      centers.color[center] = total.color / total.voxels;
+    }
+
+    //Update weights with maximum observed results
+    centers.normQuotient[center] = normalization(total, centers.normQuotient[center]);
+  }
+
+  return converged;
+}
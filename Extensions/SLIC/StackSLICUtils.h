@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2026, Felix de las Pozas Alvarez <fpozas@cesvima.upm.es>
+ *
+ * This file is part of ESPINA.
+ *
+ * ESPINA is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef EXTENSIONS_SLIC_STACKSLICUTILS_H_
+#define EXTENSIONS_SLIC_STACKSLICUTILS_H_
+
+#include <Extensions/EspinaExtensions_Export.h>
+
+// ESPINA
+#include <Core/Types.h>
+
+// ITK
+#include <itkImageRegion.h>
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QtEndian>
+
+// C++
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+class QDataStream;
+
+namespace ESPINA
+{
+  namespace Extensions
+  {
+    /** \brief Storage and computation helpers of the StackSLIC extension.
+     *
+     */
+    namespace StackSLICUtils
+    {
+      using ImageRegion = itk::ImageRegion<3>;
+
+      /** \struct RLESlice
+       * \brief Uncompressed RLE runs of a slice and the position of the first run of each row, to
+       * decode voxels and regions of the slice without decoding the whole slice.
+       *
+       */
+      struct EspinaExtensions_EXPORT RLESlice
+      {
+        static const int RUN_SIZE = sizeof(quint32) + sizeof(quint8); /** run label and voxel count. */
+
+        ImageRegion           region; /** region of the slice.                                */
+        QByteArray            data;   /** uncompressed slice data, the runs follow the header. */
+        std::vector<int>      rows;   /** offset in data of the first run of each row.         */
+
+        /** \brief Returns the label of the given voxel or 0 if outside the slice region.
+         * \param[in] x voxel x coordinate.
+         * \param[in] y voxel y coordinate.
+         *
+         */
+        unsigned int label(const long long x, const long long y) const;
+
+        /** \brief Decodes a region of the slice into the given image.
+         * \param[in] decodeRegion region of the slice to decode, must be inside the slice region.
+         * \param[in] image destination image.
+         * \param[in] index destination index of the region origin in the image.
+         * \param[in] value function that returns the value of the image voxels for a label.
+         *
+         */
+        template<typename T, typename F>
+        void decode(const ImageRegion &decodeRegion, T *image, const typename T::IndexType &index, F value) const
+        {
+          const long long first = decodeRegion.GetIndex(0) - region.GetIndex(0);
+          const long long last  = first + static_cast<long long>(decodeRegion.GetSize(0));
+
+          auto destination = index;
+
+          for(unsigned long long y = 0; y < decodeRegion.GetSize(1); ++y)
+          {
+            destination[1] = index[1] + y;
+
+            auto buffer = image->GetBufferPointer() + image->ComputeOffset(destination);
+            auto run    = data.constData() + rows[decodeRegion.GetIndex(1) - region.GetIndex(1) + y];
+
+            long long position = 0;
+            while(position < last)
+            {
+              const auto label = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(run));
+              const auto end   = position + static_cast<unsigned char>(run[sizeof(quint32)]);
+
+              if(end > first)
+              {
+                const auto voxelValue = value(label);
+
+                for(auto x = std::max(position, first); x < std::min(end, last); ++x)
+                {
+                  *buffer++ = voxelValue;
+                }
+              }
+
+              position = end;
+              run     += RUN_SIZE;
+            }
+          }
+        }
+
+        /** \brief Returns the memory used by the slice in bytes.
+         *
+         */
+        unsigned long long size() const
+        { return data.size() + rows.size() * sizeof(int); }
+      };
+
+      using RLESliceSPtr = std::shared_ptr<const RLESlice>;
+
+      /** \brief Compresses a slice and saves it to a QDataStream in RLE format prepending slice position and size.
+       * \param[out] stream QDataStream that will hold the compressed slice.
+       * \param[in] region region of the slice to compress.
+       * \param[in] labelsRegion region of the labels buffer.
+       * \param[in] labels labels of the voxels of the labels region slice.
+       * \param[in] labelLimit labels equal or greater are stored as 0.
+       *
+       */
+      void EspinaExtensions_EXPORT encodeSlice(QDataStream &stream, const ImageRegion &region, const ImageRegion &labelsRegion, const unsigned int *labels, const unsigned int labelLimit);
+
+      /** \brief Returns the RLE slice of the uncompressed data of a slice, with the index of its rows.
+       * \param[in] data uncompressed slice data.
+       * \param[in] slice slice number.
+       *
+       * Throws an EspinaException if the data is truncated.
+       *
+       */
+      RLESliceSPtr EspinaExtensions_EXPORT decodeSlice(const QByteArray &data, const int slice);
+
+      /** \class RLESliceCache
+       * \brief Thread-safe cache of RLE slices that evicts the least recently used ones when the memory used
+       * exceeds the budget. The last inserted slice is always kept.
+       *
+       */
+      class EspinaExtensions_EXPORT RLESliceCache
+      {
+        public:
+          /** \brief RLESliceCache class constructor.
+           * \param[in] budget max memory used by the cached slices in bytes.
+           *
+           */
+          explicit RLESliceCache(const unsigned long long budget);
+
+          /** \brief Returns the cached slice with the given number and marks it as the most recently used or
+           * nullptr if not cached.
+           * \param[in] slice slice number.
+           *
+           */
+          RLESliceSPtr slice(const int slice);
+
+          /** \brief Inserts the slice as the most recently used and returns it or, if other thread inserted
+           * the same slice meanwhile, the already cached one.
+           * \param[in] slice slice number.
+           * \param[in] rleSlice RLE slice.
+           *
+           */
+          RLESliceSPtr insert(const int slice, RLESliceSPtr rleSlice);
+
+          /** \brief Removes all the slices from the cache.
+           *
+           */
+          void clear();
+
+          /** \brief Sets the max memory used by the cached slices in bytes. Takes effect on the next insertion.
+           * \param[in] budget memory budget.
+           *
+           */
+          void setBudget(const unsigned long long budget);
+
+          /** \brief Returns the cached slices from the most to the least recently used.
+           *
+           */
+          std::list<int> slices() const;
+
+          /** \brief Returns the memory used by the cached slices in bytes.
+           *
+           */
+          unsigned long long size() const;
+
+        private:
+          /** \struct Entry
+           * \brief Cached RLE slice.
+           *
+           */
+          struct Entry
+          {
+            RLESliceSPtr             slice;    /** RLE slice.                 */
+            std::list<int>::iterator position; /** position in the LRU list.  */
+          };
+
+          mutable QMutex     m_mutex;  /** protects the cache.                              */
+          std::list<int>     m_lru;    /** cached slices from most to least recently used. */
+          QHash<int, Entry>  m_slices; /** cached RLE slices.                               */
+          unsigned long long m_size;   /** memory used by the cached slices in bytes.      */
+          unsigned long long m_budget; /** max memory used by the cached slices in bytes.  */
+      };
+      const float COLOR_NORMALIZATION = 100.0/255.0; /** Used to avoid dividing when switching from grayscale space (0-255) to CIELab intensity (0-100) */
+
+      /** \struct Centers
+       * \brief Supervoxel centers stored as contiguous arrays, one for each attribute.
+       *
+       */
+      struct Centers
+      {
+        std::vector<itk::IndexValueType> x;             /** center x coordinate.                                 */
+        std::vector<itk::IndexValueType> y;             /** center y coordinate.                                 */
+        std::vector<itk::IndexValueType> z;             /** center z coordinate.                                 */
+        std::vector<unsigned char>       color;         /** mean color of the supervoxel voxels.                 */
+        std::vector<float>               normQuotient;  /** normalization quotient of the spatial distance.      */
+        std::vector<char>                valid;         /** true if the supervoxel has voxels, false otherwise.  */
+        std::vector<unsigned int>        layer;         /** z layer of the center.                               */
+        std::vector<unsigned int>        position;      /** position of the center in the layers order.          */
+        std::vector<unsigned int>        order;         /** center indexes ordered by layer.                     */
+        std::vector<unsigned int>        layerStart;    /** first position of each layer and the end position.   */
+
+        /** \brief Returns the number of centers.
+         *
+         */
+        unsigned int size() const
+        { return static_cast<unsigned int>(x.size()); }
+      };
+
+      /** \struct CenterSums
+       * \brief Sums of the voxels assigned to a center in a slab.
+       *
+       */
+      struct CenterSums
+      {
+        unsigned long long voxels;   /** number of voxels.                         */
+        long long          x;        /** sum of the x coordinates.                 */
+        long long          y;        /** sum of the y coordinates.                 */
+        long long          z;        /** sum of the z coordinates.                 */
+        unsigned long long color;    /** sum of the colors.                        */
+        float              spatial;  /** max squared spatial distance to the center. */
+        float              distance; /** max squared color distance to the center.   */
+      };
+
+      /** \struct Slab
+       * \brief Z-slab of the region, one layer (the grid step) thick. The search window of the centers is one
+       * grid step at each side, so the voxels of the slab can only be assigned to centers of the same layer or
+       * the adjacent ones (the halo), which are contiguous in the layers order.
+       *
+       */
+      struct Slab
+      {
+        ImageRegion             region; /** region of the slab.                                              */
+        unsigned int            first;  /** position in the layers order of the first center of the halo.    */
+        std::vector<CenterSums> sums;   /** sums of the voxels assigned to the centers of the halo.          */
+      };
+
+      /** \brief Returns the new normalization quotient of a center from the merged sums of its voxels and
+       * its current quotient.
+       *
+       */
+      using NormalizationFunction = std::function<float(const CenterSums &, const float)>;
+
+      /** \brief Returns the slabs of the region, one grid step thick.
+       * \param[in] region region to compute.
+       * \param[in] step supervoxel grid step.
+       *
+       */
+      std::vector<Slab> EspinaExtensions_EXPORT createSlabs(const ImageRegion &region, const unsigned int step);
+
+      /** \brief Orders the centers by layer and sets the halo of every slab.
+       * \param[in,out] centers supervoxel centers.
+       * \param[in,out] slabs region slabs.
+       * \param[in] region region to compute.
+       * \param[in] step supervoxel grid step.
+       *
+       */
+      void EspinaExtensions_EXPORT updateLayers(Centers &centers, std::vector<Slab> &slabs, const ImageRegion &region, const unsigned int step);
+
+      /** \brief Assigns the voxels of the slab to the closest center of its halo and computes the sums of the centers.
+       * Returns false if the computation has been interrupted.
+       * \param[in,out] slab slab to process.
+       * \param[in] centers supervoxel centers ordered by layer.
+       * \param[in] image stack image.
+       * \param[in] region region to compute.
+       * \param[in] sliceRegions region to compute of each slice of the region, inside the stack edges.
+       * \param[in] step supervoxel grid step.
+       * \param[in] adaptive true to compute the max distances of the voxels to their centers, false otherwise.
+       * \param[out] labels center of each voxel of the slab or the max unsigned int value if not assigned.
+       * \param[in] canExecute function that returns false if the computation must be interrupted.
+       *
+       */
+      bool EspinaExtensions_EXPORT computeSlab(Slab                           &slab,
+                                               const Centers                  &centers,
+                                               const itkVolumeType            *image,
+                                               const ImageRegion              &region,
+                                               const std::vector<ImageRegion> &sliceRegions,
+                                               const unsigned int              step,
+                                               const bool                      adaptive,
+                                               std::vector<unsigned int>      &labels,
+                                               std::function<bool()>           canExecute);
+
+      /** \brief Recomputes the centers of the given layer from the sums of the slabs that contain them.
+       * Returns false if any of the centers has moved more than the tolerance.
+       * \param[in,out] centers supervoxel centers ordered by layer.
+       * \param[in] layer layer index.
+       * \param[in] slabs region slabs.
+       * \param[in] tolerance squared tolerance value for convergence test.
+       * \param[in] normalization function that returns the new normalization quotient of the centers.
+       *
+       */
+      bool EspinaExtensions_EXPORT updateCenters(Centers                     &centers,
+                                                 const unsigned int           layer,
+                                                 const std::vector<Slab>     &slabs,
+                                                 const double                 tolerance,
+                                                 const NormalizationFunction &normalization);
+    } // namespace StackSLICUtils
+  } // namespace Extensions
+} // namespace ESPINA
+
+#endif // EXTENSIONS_SLIC_STACKSLICUTILS_H_
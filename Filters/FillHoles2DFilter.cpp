@@ -23,15 +23,202 @@
 #include <Core/Analysis/Data/VolumetricData.hxx>
 #include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
 #include <Core/Analysis/Data/Mesh/MarchingCubesMesh.h>
-#include <Core/Utils/ITKProgressReporter.h>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
 
-// ITK
-#include <itkBinaryFillholeImageFilter.h>
-#include <itkPasteImageFilter.h>
+// Qt
+#include <QtConcurrent/QtConcurrent>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
+// C++
+#include <algorithm>
+#include <list>
+#include <vector>
 
 using namespace ESPINA;
 using namespace ESPINA::Core::Utils;
 
+namespace
+{
+  const int SLICES_PER_THREAD = 8;
+
+  const unsigned char BACKGROUND = 0; /** background voxel not reachable from the slice border (yet). */
+  const unsigned char FOREGROUND = 1; /** segmentation voxel.                                         */
+  const unsigned char REACHED    = 2; /** background voxel reachable from the slice border.           */
+
+  /** \struct SliceScratch
+   * \brief Buffers of the slice fill, reused between slices.
+   *
+   */
+  struct SliceScratch
+  {
+    std::vector<unsigned char> mask;  /** slice voxels state.         */
+    std::vector<unsigned int>  stack; /** flood fill pending voxels.  */
+  };
+
+  /** \class ScratchPool
+   * \brief Slice fill buffers of one filter execution. There are as many buffers as slices being filled
+   * at the same time and all of them are released when the pool is destroyed.
+   *
+   */
+  class ScratchPool
+  {
+    public:
+      /** \brief Returns a buffer not used by other thread, creating it if there isn't a free one.
+       *
+       */
+      SliceScratch &acquire()
+      {
+        QMutexLocker lock(&m_mutex);
+
+        if(m_free.empty())
+        {
+          m_scratches.emplace_back();
+          return m_scratches.back();
+        }
+
+        auto scratch = m_free.back();
+        m_free.pop_back();
+
+        return *scratch;
+      }
+
+      /** \brief Returns the buffer to the pool.
+       * \param[in] scratch buffer obtained with acquire().
+       *
+       */
+      void release(SliceScratch &scratch)
+      {
+        QMutexLocker lock(&m_mutex);
+
+        m_free.push_back(&scratch);
+      }
+
+    private:
+      QMutex                      m_mutex;     /** protects the pool buffers.              */
+      std::list<SliceScratch>     m_scratches; /** buffers, the list keeps their addresses. */
+      std::vector<SliceScratch *> m_free;      /** buffers not in use.                     */
+  };
+
+  /** \struct SliceGeometry
+   * \brief Position of the voxels of the slices in the image buffer.
+   *
+   */
+  struct SliceGeometry
+  {
+    unsigned long long width;       /** number of voxels of the first slice axis.  */
+    unsigned long long height;      /** number of voxels of the second slice axis. */
+    unsigned long long step[2];     /** buffer step of the slice axes.             */
+    unsigned long long sliceStep;   /** buffer step between slices.                */
+  };
+
+  /** \brief Returns a pointer to the voxel of the slice in the image buffer.
+   * \param[in] origin pointer to the first voxel of the slice.
+   * \param[in] geometry slices geometry.
+   * \param[in] u voxel position along the first slice axis.
+   * \param[in] v voxel position along the second slice axis.
+   *
+   */
+  inline const itkVolumeType::PixelType *sliceVoxel(const itkVolumeType::PixelType *origin, const SliceGeometry &geometry, const unsigned long long u, const unsigned long long v)
+  {
+    return origin + u * geometry.step[0] + v * geometry.step[1];
+  }
+
+  /** \brief Finds the holes of the slice, leaving them marked as BACKGROUND in the scratch mask. A hole
+   * is a 4-connected background area not connected to the slice border, like itk::BinaryFillholeImageFilter does
+   * for the middle slice of a three slices image with foreground top and bottom slices. Returns true if the slice
+   * has holes.
+   * \param[in] buffer image buffer.
+   * \param[in] geometry slices geometry.
+   * \param[in] slice slice number.
+   * \param[inout] scratch slice buffers.
+   *
+   */
+  bool findSliceHoles(const itkVolumeType::PixelType *buffer, const SliceGeometry &geometry, const unsigned long long slice, SliceScratch &scratch)
+  {
+    const auto width  = geometry.width;
+    const auto height = geometry.height;
+    const auto origin = buffer + slice * geometry.sliceStep;
+
+    auto &mask  = scratch.mask;
+    auto &stack = scratch.stack;
+
+    mask.resize(width * height);
+    stack.clear();
+
+    for(unsigned long long v = 0; v < height; ++v)
+    {
+      for(unsigned long long u = 0; u < width; ++u)
+      {
+        mask[v * width + u] = (*sliceVoxel(origin, geometry, u, v) == SEG_VOXEL_VALUE) ? FOREGROUND : BACKGROUND;
+      }
+    }
+
+    auto seed = [&mask, &stack](const unsigned int position)
+    {
+      if(mask[position] == BACKGROUND)
+      {
+        mask[position] = REACHED;
+        stack.push_back(position);
+      }
+    };
+
+    for(unsigned long long u = 0; u < width; ++u)
+    {
+      seed(u);
+      seed((height - 1) * width + u);
+    }
+
+    for(unsigned long long v = 0; v < height; ++v)
+    {
+      seed(v * width);
+      seed(v * width + width - 1);
+    }
+
+    while(!stack.empty())
+    {
+      const auto position = stack.back();
+      stack.pop_back();
+
+      const auto u = position % width;
+      const auto v = position / width;
+
+      if(u > 0)          seed(position - 1);
+      if(u + 1 < width)  seed(position + 1);
+      if(v > 0)          seed(position - width);
+      if(v + 1 < height) seed(position + width);
+    }
+
+    return std::find(mask.cbegin(), mask.cend(), BACKGROUND) != mask.cend();
+  }
+
+  /** \brief Copies the slice to the output buffer with the holes found by the last findSliceHoles() call with
+   * the same scratch buffers filled. The output buffer stores the slice with the first slice axis varying fastest.
+   * \param[in] buffer image buffer.
+   * \param[in] geometry slices geometry.
+   * \param[in] slice slice number.
+   * \param[in] scratch slice buffers.
+   * \param[out] output slice buffer.
+   *
+   */
+  void fillSliceHoles(const itkVolumeType::PixelType *buffer, const SliceGeometry &geometry, const unsigned long long slice, const SliceScratch &scratch, itkVolumeType::PixelType *output)
+  {
+    const auto origin = buffer + slice * geometry.sliceStep;
+    const auto &mask  = scratch.mask;
+
+    for(unsigned long long v = 0; v < geometry.height; ++v)
+    {
+      for(unsigned long long u = 0; u < geometry.width; ++u)
+      {
+        const auto position = v * geometry.width + u;
+
+        output[position] = (mask[position] == BACKGROUND) ? SEG_VOXEL_VALUE : *sliceVoxel(origin, geometry, u, v);
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 FillHoles2DFilter::FillHoles2DFilter(InputSList inputs, const Filter::Type &type, SchedulerSPtr scheduler)
 : Filter(inputs, type, scheduler), m_direction(Axis::Z)
@@ -68,95 +255,102 @@ void FillHoles2DFilter::execute()
 	reportProgress(0);
 	if (!canExecute()) return;
 
-	const auto bounds = inputVolume->bounds().bounds();
-	auto spacing      = inputVolume->bounds().spacing();
-	auto volume       = sparseCopy<itkVolumeType>(inputVolume->itkImage());
-	auto sliceBounds  = bounds;
+  auto spacing      = inputVolume->bounds().spacing();
+  auto image        = inputVolume->itkImage();
+  auto volume       = sparseCopy<itkVolumeType>(image);
   auto dir          = idx(m_direction);
 
-	// Create mask for the filter containing a 3 slices size image filled with SEG_VOXEL_VALUE (255)
-	auto maskRegion      = inputVolume->itkImage()->GetLargestPossibleRegion();
-	const auto numSlices = maskRegion.GetSize(dir);
-	maskRegion.SetSize(dir,3);
+  const auto region    = image->GetLargestPossibleRegion();
+  const auto numSlices = region.GetSize(dir);
 
   // Check other directions size
   for(auto i: {1,2})
   {
     auto otherDir = (dir + i) % 3;
-    if(maskRegion.GetSize(otherDir) < 3)
+    if(region.GetSize(otherDir) < 3)
     {
       // nothing to do, direction too thin.
       return;
     }
   }
 
-	auto maskImage = itkVolumeType::New();
-	maskImage->SetRegions(maskRegion);
-	maskImage->Allocate();
-	maskImage->FillBuffer(SEG_VOXEL_VALUE);
-	auto maskIndex = maskRegion.GetIndex();
-	maskIndex.SetElement(dir,maskIndex.GetElement(dir)+1);
+  const unsigned long long steps[3]{1, region.GetSize(0), region.GetSize(0) * region.GetSize(1)};
 
-	// Variables for progress reporter
-	const unsigned int numFilters = 3;
-	const auto progressPerFilter  = (double)100/(numFilters*numSlices);
-	double progress               = 0;
+  const auto uAxis = (dir == 0) ? 1 : 0;
+  const auto vAxis = (dir == 2) ? 1 : 2;
 
-	typedef itk::PasteImageFilter <itkVolumeType, itkVolumeType> PasteImageFilter;
-	PasteImageFilter::Pointer pasteFilter        = nullptr;
+  SliceGeometry geometry;
+  geometry.width     = region.GetSize(uAxis);
+  geometry.height    = region.GetSize(vAxis);
+  geometry.step[0]   = steps[uAxis];
+  geometry.step[1]   = steps[vAxis];
+  geometry.sliceStep = steps[dir];
 
-	typedef itk::BinaryFillholeImageFilter<itkVolumeType> BinaryFillholeFilter;
-	BinaryFillholeFilter::Pointer fillholeFilter = nullptr;
+  // the input image can be the input volume data, so the filled slices are created apart.
+  const auto buffer = image->GetBufferPointer();
 
-	for(auto i = bounds[2*dir]; !areEqual(i, bounds[(2*dir)+1], spacing[dir]) && canExecute(); i += spacing[dir])
-	{
-		sliceBounds[2*dir] = sliceBounds[(2*dir)+1] = i;
-
-		auto slice = volume->itkImage(sliceBounds);
-
-		// Copy the current slice over the mask middle slice (like a cheese sandwich)
-		pasteFilter = PasteImageFilter::New();
-		pasteFilter->SetInPlace(false);
-		pasteFilter->ReleaseDataFlagOn();
-		pasteFilter->SetNumberOfThreads(1);
-		pasteFilter->SetSourceImage(slice);
-		pasteFilter->SetSourceRegion(slice->GetLargestPossibleRegion());
-		pasteFilter->SetDestinationImage(maskImage);
-		pasteFilter->SetDestinationIndex(maskIndex);
-		ITKProgressReporter<PasteImageFilter> pfReporter(this, pasteFilter, progress, progress + progressPerFilter);
-		pasteFilter->Update();
-		progress += progressPerFilter;
-
-		// Fill the holes of the middle slice (like filling the cheese holes)
-		fillholeFilter = BinaryFillholeFilter::New();
-		fillholeFilter->SetInput(pasteFilter->GetOutput());
-		fillholeFilter->SetNumberOfThreads(1);
-		fillholeFilter->ReleaseDataFlagOn();
-		ITKProgressReporter<BinaryFillholeFilter> fhReporter(this, fillholeFilter, progress, progress + progressPerFilter);
-		fillholeFilter->Update();
-		progress += progressPerFilter;
-		auto fhfOutput = fillholeFilter->GetOutput();
-
-		// Copy back the middle slice to its original place (like taking the cheese out)
-		pasteFilter = PasteImageFilter::New();
-    pasteFilter->SetInPlace(false);
-    pasteFilter->ReleaseDataFlagOn();
-    pasteFilter->SetNumberOfThreads(1);
-		pasteFilter->SetSourceImage(fhfOutput);
-		auto secondSliceFhfOutputRegion = fhfOutput->GetLargestPossibleRegion();
-		secondSliceFhfOutputRegion.SetIndex(dir, secondSliceFhfOutputRegion.GetIndex(dir)+1); // Second slice from the mask
-		secondSliceFhfOutputRegion.SetSize(dir, 1); // 1 slice of the 3 contained by the mask
-		pasteFilter->SetSourceRegion(secondSliceFhfOutputRegion);
-		pasteFilter->SetDestinationImage(slice);
-		pasteFilter->SetDestinationIndex(slice->GetLargestPossibleRegion().GetIndex());
-		pasteFilter->SetNumberOfThreads(1);
-		pasteFilter->ReleaseDataFlagOn();
-		ITKProgressReporter<PasteImageFilter> pfReporter2(this, pasteFilter, progress, progress + progressPerFilter);
-		pasteFilter->Update();
-		progress += progressPerFilter;
-
-		volume->draw(pasteFilter->GetOutput());
-	}
+  QVector<unsigned long long> slices;
+  slices.reserve(numSlices);
+  for(unsigned long long i = 0; i < numSlices; ++i)
+  {
+    slices << i;
+  }
+
+  QVector<itkVolumeType::Pointer> filledSlices(numSlices);
+  auto filledData = filledSlices.data();
+
+  // the buffers are freed when the execution finishes.
+  ScratchPool scratchPool;
+
+  auto fillSlice = [buffer, &geometry, &region, &image, dir, filledData, &scratchPool](unsigned long long &slice)
+  {
+    auto &scratch = scratchPool.acquire();
+
+    if(!findSliceHoles(buffer, geometry, slice, scratch))
+    {
+      scratchPool.release(scratch);
+      return;
+    }
+
+    auto sliceRegion = region;
+    sliceRegion.SetIndex(dir, region.GetIndex(dir) + slice);
+    sliceRegion.SetSize(dir, 1);
+
+    auto sliceImage = itkVolumeType::New();
+    sliceImage->SetRegions(sliceRegion);
+    sliceImage->SetSpacing(image->GetSpacing());
+    sliceImage->SetOrigin(image->GetOrigin());
+    sliceImage->Allocate();
+
+    fillSliceHoles(buffer, geometry, slice, scratch, sliceImage->GetBufferPointer());
+    scratchPool.release(scratch);
+
+    filledData[slice] = sliceImage;
+  };
+
+  const int batchSize = std::max(1, QThread::idealThreadCount()) * SLICES_PER_THREAD;
+
+  int computedSlices = 0;
+  while (canExecute() && computedSlices < slices.size())
+  {
+    auto batch = slices.mid(computedSlices, batchSize);
+
+    QtConcurrent::blockingMap(batch, fillSlice);
+
+    // only the slices with holes are written to the output volume.
+    for(auto slice: batch)
+    {
+      auto &sliceImage = filledData[slice];
+      if(!sliceImage) continue;
+
+      volume->draw(sliceImage);
+      sliceImage = nullptr;
+    }
+
+    computedSlices += batch.size();
+
+    reportProgress((static_cast<double>(computedSlices) / static_cast<double>(slices.size()))*100.0);
+  }
 
 	if (!canExecute()) return;
 	reportProgress(100);
@@ -41,6 +41,7 @@ using namespace ESPINA::GUI::Model::Utils;
 //------------------------------------------------------------------------
 ModelAdapter::ModelAdapter()
 : m_analysis   {new Analysis()}
+, m_dirtyRows  {false}
 , m_isBatchMode{false}
 {
 }
@@ -80,6 +81,8 @@ void ModelAdapter::setAnalysis(AnalysisSPtr analysis, ModelFactorySPtr factory)
     auto adapted = factory->adaptSample(sample);
     m_samples << adapted;
     adapted->setModel(this);
+
+    addToIndices(adapted, m_samples.size() - 1);
   }
 
   // Adapt channels --> adapt non adapted filters
@@ -88,6 +91,8 @@ void ModelAdapter::setAnalysis(AnalysisSPtr analysis, ModelFactorySPtr factory)
     auto adapted = factory->adaptChannel(channel);
     m_channels << adapted;
     adapted->setModel(this);
+
+    addToIndices(adapted, m_channels.size() - 1);
   }
 
   ViewItemAdapterSList addedItems;
@@ -130,6 +135,8 @@ void ModelAdapter::setAnalysis(AnalysisSPtr analysis, ModelFactorySPtr factory)
       auto id = adapted->uuid();
       Q_ASSERT(!m_sptrLookup.contains(id));
       m_sptrLookup.insert(id, adapted);
+
+      addToIndices(adapted, m_segmentations.size() - 1);
     }
     endInsertRows();
 
@@ -208,7 +215,7 @@ void ModelAdapter::add(SampleAdapterSList samples)
 ModelAdapter::BatchCommandSPtr ModelAdapter::addChannelCommand(ChannelAdapterSPtr channel)
 {
   auto command = [this, channel]()
-  { if (m_channels.contains(channel))
+  { if (isAdapted(channel))
     {
       auto name = (channel ? channel->data().toString() : QString("Unknown stack"));
       auto what = QObject::tr("Item already in the model: %1").arg(name);
@@ -219,6 +226,8 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::addChannelCommand(ChannelAdapterSPt
     m_analysis->add(channel->m_channel);
     m_channels << channel;
 
+    addToIndices(channel, m_channels.size() - 1);
+
     channel->setModel(this);
   };
 
@@ -385,14 +394,11 @@ QModelIndex ModelAdapter::channelIndex(ChannelAdapterPtr channel) const
 {
   QModelIndex index;
 
-  for(int row = 0; row < m_channels.size(); ++row)
+  auto channelRow = row(channel);
+  if (channelRow != -1)
   {
-    auto item = m_channels.at(row);
-    if (item.get() == channel)
-    {
-      ItemAdapterPtr internalPtr = channel;
-      index = createIndex(row, 0, internalPtr);
-    }
+    ItemAdapterPtr internalPtr = channel;
+    index = createIndex(channelRow, 0, internalPtr);
   }
 
   return index;
@@ -907,15 +913,11 @@ QModelIndex ModelAdapter::sampleIndex(SampleAdapterPtr sample) const
 {
   QModelIndex index;
 
-  int row = 0;
-  for(auto ptr : m_samples)
+  auto sampleRow = row(sample);
+  if (sampleRow != -1)
   {
-    if (ptr.get() == sample)
-    {
-      auto internalPtr = sample;
-      index = createIndex(row, 0, internalPtr);
-    }
-    row++;
+    auto internalPtr = sample;
+    index = createIndex(sampleRow, 0, internalPtr);
   }
 
   return index;
@@ -938,15 +940,11 @@ QModelIndex ModelAdapter::segmentationIndex(SegmentationAdapterPtr segmentation)
 {
   QModelIndex index;
 
-  int row = 0;
-  for(auto ptr : m_segmentations)
+  auto segmentationRow = row(segmentation);
+  if (segmentationRow != -1)
   {
-    if (ptr.get() == segmentation)
-    {
-      auto internalPtr = segmentation;
-      index = createIndex(row, 0, internalPtr);
-    }
-    ++row;
+    auto internalPtr = segmentation;
+    index = createIndex(segmentationRow, 0, internalPtr);
   }
 
   return index;
@@ -1065,30 +1063,9 @@ void ModelAdapter::setSegmentationCategory(SegmentationAdapterSPtr segmentation,
 //------------------------------------------------------------------------
 ItemAdapterSPtr ModelAdapter::find(PersistentSPtr item)
 {
-  for(auto sample : m_samples)
-  {
-    auto base = std::dynamic_pointer_cast<Persistent>(sample->m_sample);
-    if(base == item) return sample;
-  }
+  auto it = m_adapters.constFind(item.get());
 
-  for(auto channel : m_channels)
-  {
-    auto base = std::dynamic_pointer_cast<Persistent>(channel->m_channel);
-    if(base == item) return channel;
-  }
-
-  if(m_sptrLookup.contains(item->uuid()))
-  {
-    auto candidate = m_sptrLookup[item->uuid()];
-    auto base = std::dynamic_pointer_cast<Persistent>(candidate->m_segmentation);
-    if(base == item) return candidate;
-  }
-
-  for(auto segmentation : m_segmentations)
-  {
-    auto base = std::dynamic_pointer_cast<Persistent>(segmentation->m_segmentation);
-    if(base == item) return segmentation;
-  }
+  if(it != m_adapters.constEnd()) return it.value();
 
   qWarning() << __FILE__ << __LINE__ << "Failed ModelAdapter::find(Persistent) on item" << item->name() << "uuid" << item->uuid();
 
@@ -1122,15 +1099,10 @@ SampleAdapterSPtr ModelAdapter::smartPointer(SampleAdapterPtr sample)
 {
   SampleAdapterSPtr pointer{nullptr};
 
-  int i=0;
-  while (!pointer && i < m_samples.size())
+  auto sampleRow = row(sample);
+  if (sampleRow != -1)
   {
-    if (m_samples[i].get() == sample)
-    {
-      pointer = m_samples[i];
-    }
-
-    i++;
+    pointer = m_samples[sampleRow];
   }
 
   return pointer;
@@ -1141,15 +1113,10 @@ ChannelAdapterSPtr ModelAdapter::smartPointer(ChannelAdapterPtr channel)
 {
   ChannelAdapterSPtr pointer;
 
-  int i=0;
-  while (!pointer && i < m_channels.size())
+  auto channelRow = row(channel);
+  if (channelRow != -1)
   {
-    if (m_channels[i].get() == channel)
-    {
-      pointer = m_channels[i];
-    }
-
-    i++;
+    pointer = m_channels[channelRow];
   }
 
   return pointer;
@@ -1179,10 +1146,58 @@ void ModelAdapter::resetInternalData()
   m_sptrLookup.clear();
   m_channels.clear();
   m_samples.clear();
+  m_adapters.clear();
+  m_rows.clear();
+  m_dirtyRows = false;
   m_classification.reset();
   m_dbvh.clear();
 }
 
+//------------------------------------------------------------------------
+int ModelAdapter::row(ItemAdapterPtr item) const
+{
+  if (m_dirtyRows)
+  {
+    m_rows.clear();
+    m_rows.reserve(m_samples.size() + m_channels.size() + m_segmentations.size());
+
+    for(int i = 0; i < m_samples.size(); ++i)       m_rows.insert(m_samples[i].get(), i);
+    for(int i = 0; i < m_channels.size(); ++i)      m_rows.insert(m_channels[i].get(), i);
+    for(int i = 0; i < m_segmentations.size(); ++i) m_rows.insert(m_segmentations[i].get(), i);
+
+    m_dirtyRows = false;
+  }
+
+  return m_rows.value(item, -1);
+}
+
+//------------------------------------------------------------------------
+bool ModelAdapter::isAdapted(ItemAdapterSPtr item) const
+{
+  return item && (m_adapters.value(item->m_analysisItem.get()) == item);
+}
+
+//------------------------------------------------------------------------
+void ModelAdapter::addToIndices(ItemAdapterSPtr item, int row)
+{
+  m_adapters.insert(item->m_analysisItem.get(), item);
+
+  if (!m_dirtyRows)
+  {
+    m_rows.insert(item.get(), row);
+  }
+}
+
+//------------------------------------------------------------------------
+void ModelAdapter::removeFromIndices(ItemAdapterSPtr item)
+{
+  m_adapters.remove(item->m_analysisItem.get());
+
+  // rows after the removed item are shifted, they will be computed on the next lookup.
+  m_rows.remove(item.get());
+  m_dirtyRows = true;
+}
+
 //------------------------------------------------------------------------
 bool ModelAdapter::contains(ItemAdapterSPtr &item, const ItemCommandsList &list) const
 {
@@ -1693,7 +1708,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::addSampleCommand(SampleAdapterSPtr
 {
   auto command = [this, sample]()
   {
-    if (m_samples.contains(sample))
+    if (isAdapted(sample))
     {
       auto name    = (sample ? sample->data().toString() : QString("Unknown sample"));
       auto what    = QObject::tr("Attempt to add an existing sample, sample: %1").arg(name);
@@ -1705,6 +1720,8 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::addSampleCommand(SampleAdapterSPtr
     m_analysis->add(sample->m_sample);
     m_samples << sample;
 
+    addToIndices(sample, m_samples.size() - 1);
+
     sample->setModel(this);
   };
 
@@ -1717,7 +1734,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::addSegmentationCommand(Segmentation
 {
   auto command = [this, segmentation]()
   {
-    if (m_segmentations.contains(segmentation))
+    if (isAdapted(segmentation))
     {
       auto name    = (segmentation ? segmentation->data().toString() : QString("Unknown segmentation"));
       auto what    = QObject::tr("Attempt to add an existing segmentation, segmentation: %1").arg(name);
@@ -1744,6 +1761,8 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::addSegmentationCommand(Segmentation
     m_sptrLookup.insert(id, segmentation);
     m_dbvh.insert(segmentation);
 
+    addToIndices(segmentation, m_segmentations.size() - 1);
+
     segmentation->setModel(this);
   };
 
@@ -1768,7 +1787,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeSampleCommand(SampleAdapterSP
 {
   auto command = [this, sample]()
   {
-    if (!m_samples.contains(sample))
+    if (!isAdapted(sample))
     {
       auto name    = (sample ? sample->data().toString() : QString("Unknown sample"));
       auto what    = QObject::tr("Attempt to remove an unknown sample, sample: %1").arg(name);
@@ -1779,6 +1798,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeSampleCommand(SampleAdapterSP
 
     m_analysis->remove(sample->m_sample);
     m_samples.removeOne(sample);
+    removeFromIndices(sample);
 
     sample->setModel(nullptr);
 
@@ -1793,7 +1813,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeChannelCommand(ChannelAdapter
 {
   auto command = [this, stack]()
   {
-    if (!m_channels.contains(stack))
+    if (!isAdapted(stack))
     {
       auto name    = (stack ? stack->data().toString() : QString("Unknown stack"));
       auto what    = QObject::tr("Attempt to remove an unknown stack, stack: %1").arg(name);
@@ -1804,6 +1824,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeChannelCommand(ChannelAdapter
 
     m_analysis->remove(stack->m_channel);
     m_channels.removeOne(stack);
+    removeFromIndices(stack);
 
     stack->setModel(nullptr);
 
@@ -1818,7 +1839,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeSegmentationCommand(Segmentat
 {
   auto command = [this, segmentation]()
   {
-    if (!m_segmentations.contains(segmentation))
+    if (!isAdapted(segmentation))
     {
       auto name    = (segmentation ? segmentation->data().toString() : QString("Unknown segmentation"));
       auto what    = QObject::tr("Attempt to remove an unknown segmentation, segmentation: %1").arg(name);
@@ -1830,6 +1851,7 @@ ModelAdapter::BatchCommandSPtr ModelAdapter::removeSegmentationCommand(Segmentat
     m_analysis->remove(segmentation->m_segmentation);
     m_segmentations.removeOne(segmentation);
     m_sptrLookup.remove(segmentation->uuid());
+    removeFromIndices(segmentation);
     m_dbvh.remove(segmentation);
 
     segmentation->setModel(nullptr);
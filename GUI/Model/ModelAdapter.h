@@ -670,6 +670,33 @@ namespace ESPINA
       void resetInternalData();
 
     private:
+      /** \brief Returns the row of the given sample, channel or segmentation adapter in its list, or -1
+       * if it's not in the model.
+       * \param[in] item item adapter raw pointer.
+       *
+       */
+      int row(ItemAdapterPtr item) const;
+
+      /** \brief Returns true if the given sample, channel or segmentation adapter is in the model.
+       * \param[in] item item adapter smart pointer.
+       *
+       */
+      bool isAdapted(ItemAdapterSPtr item) const;
+
+      /** \brief Registers the given item adapter, added at the end of its list, in the lookup indices.
+       * \param[in] item sample, channel or segmentation adapter.
+       * \param[in] row row of the item in its list.
+       *
+       */
+      void addToIndices(ItemAdapterSPtr item, int row);
+
+      /** \brief Removes the given item adapter from the lookup indices. The rows of the remaining
+       * items are recomputed on the next lookup.
+       * \param[in] item sample, channel or segmentation adapter.
+       *
+       */
+      void removeFromIndices(ItemAdapterSPtr item);
+
       bool contains(ItemAdapterSPtr &item, const ItemCommandsList &list) const;
 
       int find(ItemAdapterSPtr &item, const ItemCommandsList &list) const;
@@ -825,6 +852,9 @@ namespace ESPINA
       GUI::Model::Utils::DBVHNode m_dbvh;            /** spatial location tree.                         */
 
       QHash<const Persistent::Uuid, SegmentationAdapterSPtr> m_sptrLookup; /** relates pointers to smartpointers of segmentations for faster lookup based on common Uuid. */
+      QHash<PersistentPtr, ItemAdapterSPtr>                  m_adapters;   /** relates adapted items to their sample, channel or segmentation adapters.                 */
+      mutable QHash<ItemAdapterPtr, int>                     m_rows;       /** rows of the sample, channel and segmentation adapters in their lists.                    */
+      mutable bool                                           m_dirtyRows;  /** true if the rows must be recomputed after a removal, false otherwise.                     */
 
       bool m_isBatchMode;                 /** true if the model is currently in batch mode operation. */
       ItemCommandsList m_addCommands;     /** pending add commands to process.                        */
@@ -25,15 +25,144 @@
 // Qt
 #include <QThread>
 
+// C++
+#include <algorithm>
+
 using namespace ESPINA;
 using namespace ESPINA::Core;
 using namespace ESPINA::GUI::Model::Utils;
 
+const int BATCH_SIZE     = 256; /** segmentations computed by each task.                       */
+const int ROW_BATCH_SIZE = 16;  /** segmentations computed together and notified to the view. */
+
+//------------------------------------------------------------------------
+InformationProxy::InformationBatchFetcher::InformationBatchFetcher(const SegmentationAdapterList &segmentations,
+                                                                   const SegmentationExtension::InformationKeyList &keys,
+                                                                   SchedulerSPtr scheduler)
+: Task           {scheduler}
+, m_segmentations{segmentations}
+, m_removed      (segmentations.size(), false)
+, m_keys         {keys}
+, m_ready        {0}
+, m_notified     {0}
+, m_progress     {0}
+{
+  setDescription(tr("Information of %1 segmentations").arg(m_segmentations.size()));
+  setHidden(true);
+  setPriority(Priority::LOW);
+
+  m_keys.removeOne(NameKey());
+  m_keys.removeOne(CategoryKey());
+
+  for (int i = 0; i < m_segmentations.size(); ++i)
+  {
+    m_positions.insert(m_segmentations.at(i), i);
+  }
+
+  auto allKeysReady = [this](SegmentationAdapterPtr segmentation)
+  {
+    return std::all_of(m_keys.constBegin(), m_keys.constEnd(), [segmentation](const SegmentationExtension::InformationKey &key) { return segmentation->isReady(key); });
+  };
+
+  if (std::all_of(m_segmentations.constBegin(), m_segmentations.constEnd(), allKeysReady))
+  {
+    m_ready.store(m_segmentations.size());
+    m_progress = 100;
+
+    setFinished(true);
+  }
+}
+
+//------------------------------------------------------------------------
+bool InformationProxy::InformationBatchFetcher::isReady(SegmentationAdapterPtr segmentation) const
+{
+  return m_positions.value(segmentation, m_segmentations.size()) < readySegmentations();
+}
+
+//------------------------------------------------------------------------
+int InformationProxy::InformationBatchFetcher::readySegmentations() const
+{
+  return m_ready.load();
+}
+
+//------------------------------------------------------------------------
+SegmentationAdapterList InformationProxy::InformationBatchFetcher::takeReadySegmentations()
+{
+  auto ready = readySegmentations();
+
+  SegmentationAdapterList result;
+  for (int i = m_notified; i < ready; ++i)
+  {
+    if (!isRemoved(i))
+    {
+      result << m_segmentations.at(i);
+    }
+  }
+
+  m_notified = ready;
+
+  return result;
+}
+
+//------------------------------------------------------------------------
+void InformationProxy::InformationBatchFetcher::removeSegmentation(SegmentationAdapterPtr segmentation)
+{
+  if (m_positions.contains(segmentation))
+  {
+    QMutexLocker lock(&m_removedMutex);
+
+    m_removed[m_positions.take(segmentation)] = true;
+  }
+}
+
+//------------------------------------------------------------------------
+bool InformationProxy::InformationBatchFetcher::isRemoved(const int position) const
+{
+  QMutexLocker lock(&m_removedMutex);
+
+  return m_removed.at(position);
+}
+
+//------------------------------------------------------------------------
+void InformationProxy::InformationBatchFetcher::run()
+{
+  const int total = m_segmentations.size();
+
+  for (int first = 0; first < total; first += ROW_BATCH_SIZE)
+  {
+    const int last = std::min(total, first + ROW_BATCH_SIZE);
+
+    // each extension computes its keys for all the rows of the batch before the next one.
+    for (auto key : m_keys)
+    {
+      for (int i = first; i < last && canExecute(); ++i)
+      {
+        if (isRemoved(i)) continue;
+
+        auto segmentation = m_segmentations.at(i);
+
+        if (!segmentation->isReady(key))
+        {
+          segmentation->information(key);
+        }
+      }
+    }
+
+    if (!canExecute()) return;
+
+    m_ready.store(last);
+
+    m_progress = (100.0*last)/total;
+    reportProgress(m_progress);
+  }
+}
+
 //------------------------------------------------------------------------
 InformationProxy::InformationProxy(SchedulerSPtr scheduler)
 : QAbstractProxyModel{}
 , m_scheduler        {scheduler}
 , m_filter           {nullptr}
+, m_computed         {0}
 {
 }
 
@@ -66,6 +195,19 @@ void InformationProxy::setSourceModel(ModelAdapterSPtr sourceModel)
 
   m_pendingInformation.clear();
 
+  for (auto batch : m_batches)
+  {
+    disconnect(batch.get(), SIGNAL(progress(int)),
+               this,        SLOT(onBatchProgress()));
+    disconnect(batch.get(), SIGNAL(finished()),
+               this,        SLOT(onBatchProgress()));
+
+    batch->abort();
+  }
+
+  m_batches.clear();
+  m_pendingBatches.clear();
+
   if (m_model)
   {
     connect(m_model.get(), SIGNAL(rowsInserted(const QModelIndex&, int, int)),
@@ -200,11 +342,11 @@ QVariant InformationProxy::data(const QModelIndex& proxyIndex, int role) const
     const int HIDE_PROGRESS = -1;
     int progress = HIDE_PROGRESS;
 
-    if (m_pendingInformation.contains(segmentation))
+    if (m_pendingBatches.contains(segmentation))
     {
-      auto task = m_pendingInformation[segmentation];
+      auto task = m_pendingBatches[segmentation];
 
-      progress = task->hasFinished()?HIDE_PROGRESS:task->currentProgress();
+      progress = task->isReady(segmentation)?HIDE_PROGRESS:task->currentProgress();
     }
 
     return progress;
@@ -215,7 +357,7 @@ QVariant InformationProxy::data(const QModelIndex& proxyIndex, int role) const
     QVariant::fromValue(Qt::black);
     if(proxyIndex.column() == 0) return QAbstractProxyModel::data(proxyIndex, role);
 
-    if (!m_pendingInformation.contains(segmentation) || !m_pendingInformation[segmentation]->hasFinished())
+    if (!isInformationReady(segmentation))
     {
       return role == Qt::ForegroundRole ? QVariant::fromValue(Qt::black) : QVariant::fromValue(Qt::lightGray);
     }
@@ -247,25 +389,16 @@ QVariant InformationProxy::data(const QModelIndex& proxyIndex, int role) const
 
     if (extensions->hasInformation(key))
     {
-      if (!m_pendingInformation.contains(segmentation) || m_pendingInformation[segmentation]->isAborted())
+      if (!m_pendingBatches.contains(segmentation) || m_pendingBatches[segmentation]->isAborted())
       {
-        auto task = std::make_shared<InformationFetcher>(segmentation, m_keys, m_scheduler);
-        m_pendingInformation[segmentation] = task;
+        auto task = fetchInformation(segmentation);
 
-        if (!task->hasFinished()) // If all information is available on constructor, it is set as finished
-        {
-          connect(task.get(), SIGNAL(progress(int)),
-                  this,       SLOT(onProgressReported(int)));
-          connect(task.get(), SIGNAL(finished()),
-                  this,       SLOT(onTaskFininished()));
-          Task::submit(task);
-        }
-        else // we avoid overloading the scheduler
+        if (task->hasFinished()) // If all information is available on constructor, it is set as finished
         {
           return extensions->information(key);
         }
       }
-      else if (m_pendingInformation[segmentation]->hasFinished())
+      else if (m_pendingBatches[segmentation]->isReady(segmentation))
       {
         auto info = segmentation->information(key);
         if (!info.isValid())
@@ -326,9 +459,21 @@ int InformationProxy::progress() const
 
   double finishedTasks = std::count_if(tasks.constBegin(), tasks.constEnd(), [](const InformationFetcherSPtr &task){ return task->hasFinished(); });
 
+  const auto segmentations = m_pendingBatches.keys();
+
+  finishedTasks += std::count_if(segmentations.constBegin(), segmentations.constEnd(), [this](SegmentationAdapterPtr segmentation){ return isInformationReady(segmentation); });
+
   return finishedTasks / rowCount() * 100;
 }
 
+//------------------------------------------------------------------------
+double InformationProxy::throughput() const
+{
+  if (!m_throughputTimer.isValid() || m_computed == 0) return 0;
+
+  return m_computed / std::max(m_throughputTimer.elapsed() / 1000.0, 0.001);
+}
+
 //------------------------------------------------------------------------
 void InformationProxy::sourceRowsInserted(const QModelIndex& sourceParent, int start, int end)
 // Avoid population the view if no query is selected
@@ -392,6 +537,13 @@ void InformationProxy::sourceRowsAboutToBeRemoved(const QModelIndex& sourceParen
         // We use start instead of row to avoid access to removed indices
         auto removedItem = itemAdapter(index);
         m_elements.removeOne(removedItem);
+
+        // only the removed segmentation is dropped, the rest of the task is still computed.
+        auto task = m_pendingBatches.take(segmentationPtr(removedItem));
+        if (task)
+        {
+          task->removeSegmentation(segmentationPtr(removedItem));
+        }
       }
       if (!m_keys.isEmpty())
         endRemoveRows();
@@ -444,6 +596,52 @@ void InformationProxy::onTaskFininished()
   emit informationProgress();
 }
 
+//------------------------------------------------------------------------
+void InformationProxy::onBatchProgress()
+{
+  auto task = dynamic_cast<InformationBatchFetcher *>(sender());
+
+  if (task)
+  {
+    QList<int> rows;
+    for (auto segmentation : task->takeReadySegmentations())
+    {
+      auto row = m_elements.indexOf(segmentation);
+
+      if (row != -1 && m_pendingBatches.value(segmentation).get() == task)
+      {
+        rows << row;
+      }
+    }
+
+    std::sort(rows.begin(), rows.end());
+
+    // contiguous rows are notified together.
+    for (int i = 0; i < rows.size();)
+    {
+      int j = i;
+      while (j + 1 < rows.size() && rows.at(j + 1) == rows.at(j) + 1) ++j;
+
+      emit dataChanged(index(rows.at(i), 0), index(rows.at(j), columnCount() - 1));
+
+      i = j + 1;
+    }
+
+    if (task->hasFinished())
+    {
+      m_computed += task->readySegmentations();
+
+      auto it = std::find_if(m_batches.begin(), m_batches.end(), [task](const InformationBatchFetcherSPtr &batch) { return batch.get() == task; });
+      if (it != m_batches.end())
+      {
+        m_batches.erase(it);
+      }
+    }
+  }
+
+  emit informationProgress();
+}
+
 //------------------------------------------------------------------------
 void InformationProxy::sourceModelReset()
 {
@@ -492,4 +690,79 @@ void InformationProxy::abortTasks()
   }
 
   m_pendingInformation.clear();
+
+  for (auto task : m_batches)
+  {
+    disconnect(task.get(), SIGNAL(progress(int)),
+               this,       SLOT(onBatchProgress()));
+
+    disconnect(task.get(), SIGNAL(finished()),
+               this,       SLOT(onBatchProgress()));
+
+    if (!task->hasFinished())
+    {
+      task->abort();
+
+      if(!task->thread()->wait(100))
+      {
+        task->thread()->terminate();
+      }
+    }
+  }
+
+  m_batches.clear();
+  m_pendingBatches.clear();
+}
+
+//------------------------------------------------------------------------
+InformationProxy::InformationBatchFetcherSPtr InformationProxy::fetchInformation(SegmentationAdapterPtr segmentation) const
+{
+  // the task includes the following rows to compute them before the view requests them.
+  SegmentationAdapterList segmentations;
+  segmentations << segmentation;
+
+  for (int row = m_elements.indexOf(segmentation) + 1; row > 0 && row < m_elements.size() && segmentations.size() < BATCH_SIZE; ++row)
+  {
+    auto candidate = segmentationPtr(m_elements.at(row));
+
+    if (acceptSegmentation(candidate) && (!m_pendingBatches.contains(candidate) || m_pendingBatches[candidate]->isAborted()))
+    {
+      segmentations << candidate;
+    }
+  }
+
+  auto task = std::make_shared<InformationBatchFetcher>(segmentations, m_keys, m_scheduler);
+
+  for (auto fetched : segmentations)
+  {
+    m_pendingBatches[fetched] = task;
+  }
+
+  if (!task->hasFinished()) // we avoid overloading the scheduler
+  {
+    if (m_batches.isEmpty())
+    {
+      m_throughputTimer.start();
+      m_computed = 0;
+    }
+
+    m_batches << task;
+
+    connect(task.get(), SIGNAL(progress(int)),
+            this,       SLOT(onBatchProgress()));
+    connect(task.get(), SIGNAL(finished()),
+            this,       SLOT(onBatchProgress()));
+
+    Task::submit(task);
+  }
+
+  return task;
+}
+
+//------------------------------------------------------------------------
+bool InformationProxy::isInformationReady(SegmentationAdapterPtr segmentation) const
+{
+  auto task = m_pendingBatches.value(segmentation);
+
+  return task && task->isReady(segmentation);
 }
@@ -29,7 +29,11 @@
 
 // Qt
 #include <QAbstractProxyModel>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QStringList>
+#include <QVector>
 
 namespace ESPINA
 {
@@ -137,6 +141,86 @@ namespace ESPINA
 
       using InformationFetcherSPtr = std::shared_ptr<InformationFetcher>;
 
+      /** \class InformationBatchFetcher
+       * \brief Task to compute the information of a group of segmentations.
+       *
+       * The rows are computed in small batches, computing each key for all the segmentations of the
+       * batch before the next one, and the segmentations of a batch are ready as soon as it finishes.
+       *
+       */
+      class InformationBatchFetcher
+      : public Task
+      {
+        public:
+          /** \brief InformationBatchFetcher class constructor.
+           * \param[in] segmentations adapters of the segmentations to get information from.
+           * \param[in] keys information keys to fetch.
+           * \param[in] scheduler scheduler smart pointer.
+           *
+           */
+          explicit InformationBatchFetcher(const SegmentationAdapterList &segmentations,
+                                           const Core::SegmentationExtension::InformationKeyList &keys,
+                                           SchedulerSPtr scheduler);
+
+          /** \brief Returns the segmentations of the task, including the removed ones.
+           *
+           */
+          const SegmentationAdapterList &segmentations() const
+          { return m_segmentations; }
+
+          /** \brief Returns true if the information of the given segmentation has been computed.
+           * \param[in] segmentation segmentation adapter raw pointer.
+           *
+           */
+          bool isReady(SegmentationAdapterPtr segmentation) const;
+
+          /** \brief Returns the number of segmentations with their information computed.
+           *
+           */
+          int readySegmentations() const;
+
+          /** \brief Returns current progress.
+           *
+           */
+          int currentProgress() const
+          { return m_progress; }
+
+          /** \brief Returns the segmentations computed since the last call. Must be called from the
+           * thread that owns the task.
+           *
+           */
+          SegmentationAdapterList takeReadySegmentations();
+
+          /** \brief Removes the segmentation from the task, its information won't be computed but the rest
+           * of the segmentations are still computed. Must be called from the thread that owns the task.
+           * \param[in] segmentation segmentation adapter raw pointer.
+           *
+           */
+          void removeSegmentation(SegmentationAdapterPtr segmentation);
+
+        protected:
+          virtual void run();
+
+        private:
+          /** \brief Returns true if the segmentation in the given position has been removed from the task.
+           * \param[in] position position of the segmentation in the task.
+           *
+           */
+          bool isRemoved(const int position) const;
+
+        private:
+          SegmentationAdapterList                         m_segmentations; /** segmentations with the information.         */
+          QMap<SegmentationAdapterPtr, int>               m_positions;     /** position of each segmentation in the task.  */
+          QVector<bool>                                   m_removed;       /** true for the removed segmentations.          */
+          mutable QMutex                                  m_removedMutex;  /** protects the removed segmentations.          */
+          Core::SegmentationExtension::InformationKeyList m_keys;          /** information keys to obtain values.           */
+          QAtomicInt                                      m_ready;         /** number of computed segmentations.            */
+          int                                             m_notified;      /** number of segmentations already notified.    */
+          int                                             m_progress;      /** [0-100] % of computed segmentations.         */
+      };
+
+      using InformationBatchFetcherSPtr = std::shared_ptr<InformationBatchFetcher>;
+
     public:
       /** \brief InformationProxy class constructor.
        * \param[in] scheduler scheduler smart pointer.
@@ -211,6 +295,12 @@ namespace ESPINA
        */
       int progress() const;
 
+      /** \brief Returns the number of segmentations per second computed by the information tasks since the
+       * last time all of them had finished.
+       *
+       */
+      double throughput() const;
+
     signals:
       void informationProgress();
 
@@ -253,6 +343,11 @@ namespace ESPINA
        */
       void onTaskFininished();
 
+      /** \brief Notifies the rows computed by the batch task sending the signal.
+       *
+       */
+      void onBatchProgress();
+
     private:
       /** \brief Returns true if the segmentation should be in the proxy model.
        *
@@ -271,6 +366,19 @@ namespace ESPINA
        */
       void abortTasks();
 
+      /** \brief Creates and submits a task to compute the information of the given segmentation and the
+       * following rows without a task. Returns the task.
+       * \param[in] segmentation segmentation adapter raw pointer.
+       *
+       */
+      InformationBatchFetcherSPtr fetchInformation(SegmentationAdapterPtr segmentation) const;
+
+      /** \brief Returns true if the information of the given segmentation has been computed by a batch task.
+       * \param[in] segmentation segmentation adapter raw pointer.
+       *
+       */
+      bool isInformationReady(SegmentationAdapterPtr segmentation) const;
+
     protected:
       Core::SegmentationExtension::InformationKeyList m_keys;
       mutable QMap<SegmentationAdapterPtr, InformationFetcherSPtr> m_pendingInformation;
@@ -281,6 +389,11 @@ namespace ESPINA
       ModelAdapterSPtr m_model;
       QString          m_category;
 
+      mutable QMap<SegmentationAdapterPtr, InformationBatchFetcherSPtr> m_pendingBatches;  /** batch task of each segmentation.                  */
+      mutable QList<InformationBatchFetcherSPtr>                        m_batches;         /** running batch tasks.                              */
+      mutable QElapsedTimer                                             m_throughputTimer; /** time since the first batch of the current run.    */
+      mutable unsigned long long                                        m_computed;        /** segmentations computed in the current run.        */
+
 
       ItemAdapterList m_elements;
   };
@@ -24,21 +24,166 @@
 #include <GUI/Model/ChannelAdapter.h>
 #include <GUI/Representations/Pipelines/ChannelSlicePipeline.h>
 #include <GUI/Representations/Settings/PipelineStateUtils.h>
+#include <GUI/Utils/RepresentationUtils.h>
 
 // VTK
 #include <vtkSmartPointer.h>
-#include <vtkImageReslice.h>
-#include <vtkImageMapToColors.h>
-#include <vtkImageShiftScale.h>
 #include <vtkImageActor.h>
 #include <vtkImageMapper3D.h>
 #include <vtkImageData.h>
 #include <vtkLookupTable.h>
-#include <vtkAlgorithmOutput.h>
+#include <vtkFieldData.h>
+#include <vtkPointData.h>
+#include <vtkStringArray.h>
+#include <vtkUnsignedCharArray.h>
+
+// Qt
+#include <QMap>
+#include <QMutex>
+
+// C++
+#include <algorithm>
+#include <array>
+#include <memory>
 
 using namespace ESPINA;
 using namespace ESPINA::Core::Utils;
 
+namespace
+{
+  const char *INTENSITIES = "Intensities"; /** name of the array with the intensities of the slice. */
+  const char *COLORS      = "Colors";      /** name of the array with the colors of the slice.      */
+  const char *COLOR_KEY   = "ColorKey";    /** name of the array with the key of the slice colors.  */
+  const int   MAX_TABLES  = 64;            /** maximum number of cached color tables.               */
+
+  using ColorTable     = std::array<unsigned char, 3*256>;
+  using ColorTableSPtr = std::shared_ptr<const ColorTable>;
+
+  QMap<QString, ColorTableSPtr> s_tables; /** color tables cache.        */
+  QMutex                        s_mutex;  /** color tables cache mutex.  */
+
+  /** \brief Returns the key of the colors of the given state.
+   * \param[in] state representation state.
+   *
+   */
+  QString colorKey(const RepresentationState &state)
+  {
+    const auto shift = static_cast<int>(brightness(state)*255);
+
+    return QString("%1:%2:%3").arg(shift).arg(contrast(state), 0, 'g', 10).arg(stain(state).name());
+  }
+
+  /** \brief Returns the table that maps each intensity to the color of the given state. The table fuses
+   * the brightness and contrast correction and the stain lookup table in a single lookup.
+   * \param[in] state representation state.
+   *
+   */
+  ColorTableSPtr colorTable(const RepresentationState &state)
+  {
+    const auto shift = static_cast<int>(brightness(state)*255);
+    const auto scale = contrast(state);
+    const auto color = stain(state);
+
+    const auto key   = colorKey(state);
+
+    QMutexLocker lock(&s_mutex);
+
+    if(!s_tables.contains(key))
+    {
+      auto lut = vtkSmartPointer<vtkLookupTable>::New();
+      lut->Allocate();
+      lut->SetTableRange(0,255);
+      lut->SetValueRange(0.0, 1.0);
+      lut->SetAlphaRange(1.0,1.0);
+      lut->SetNumberOfColors(256);
+      lut->SetRampToLinear();
+      lut->SetHueRange(color.hueF(), color.hueF());
+      lut->SetSaturationRange(0.0, color.saturationF());
+      lut->Build();
+
+      auto table = std::make_shared<ColorTable>();
+      for(int i = 0; i < 256; ++i)
+      {
+        // same result as the previous vtkImageShiftScale with overflow clamping.
+        auto value = std::max(0.0, std::min(255.0, (i + shift) * scale));
+        auto rgba  = lut->MapValue(static_cast<unsigned char>(value));
+
+        std::copy(rgba, rgba + 3, table->begin() + 3*i);
+      }
+
+      if(s_tables.size() >= MAX_TABLES) s_tables.clear();
+
+      s_tables.insert(key, table);
+    }
+
+    return s_tables[key];
+  }
+
+  /** \brief Maps the intensities of the slice to the colors of the given table in a single pass.
+   * \param[in] intensities slice intensities.
+   * \param[in] colors slice colors.
+   * \param[in] table color table.
+   *
+   */
+  void mapColors(vtkUnsignedCharArray *intensities, vtkUnsignedCharArray *colors, const ColorTable &table)
+  {
+    const auto size   = intensities->GetNumberOfTuples();
+    auto       input  = intensities->GetPointer(0);
+    auto       output = colors->GetPointer(0);
+
+    for(vtkIdType i = 0; i < size; ++i, output += 3)
+    {
+      auto color = table.data() + 3*input[i];
+
+      output[0] = color[0];
+      output[1] = color[1];
+      output[2] = color[2];
+    }
+  }
+
+  /** \brief Returns a new actor for the slice image with the colors of the given state. The image must
+   * not be in use by other actors as its colors array is added here.
+   * \param[in] slice slice image with the intensities array.
+   * \param[in] state representation state.
+   *
+   */
+  vtkSmartPointer<vtkImageActor> sliceActor(vtkImageData *slice, const RepresentationState &state)
+  {
+    auto intensities = vtkUnsignedCharArray::SafeDownCast(slice->GetPointData()->GetArray(INTENSITIES));
+
+    auto colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    colors->SetName(COLORS);
+    colors->SetNumberOfComponents(3);
+    colors->SetNumberOfTuples(intensities->GetNumberOfTuples());
+
+    mapColors(intensities, colors, *colorTable(state));
+
+    slice->GetPointData()->AddArray(colors);
+    slice->GetPointData()->SetActiveScalars(COLORS);
+
+    auto key = vtkSmartPointer<vtkStringArray>::New();
+    key->SetName(COLOR_KEY);
+    key->InsertNextValue(colorKey(state).toStdString());
+
+    slice->GetFieldData()->AddArray(key);
+
+    int extent[6];
+    slice->GetExtent(extent);
+
+    auto actor = vtkSmartPointer<vtkImageActor>::New();
+    actor->SetInterpolate(false);
+    actor->GetMapper()->BorderOn();
+    actor->GetMapper()->SetInputData(slice);
+    actor->GetMapper()->SetNumberOfThreads(1);
+    actor->GetMapper()->UpdateWholeExtent();
+    actor->SetDisplayExtent(extent);
+    actor->SetOpacity(opacity(state));
+    actor->Update();
+
+    return actor;
+  }
+}
+
 //----------------------------------------------------------------------------
 ChannelSlicePipeline::ChannelSlicePipeline(const Plane plane)
 : RepresentationPipeline("ChannelSliceRepresentation")
@@ -64,67 +209,15 @@ RepresentationState ChannelSlicePipeline::representationState(ConstViewItemAdapt
 RepresentationPipeline::ActorList ChannelSlicePipeline::createActors(ConstViewItemAdapterPtr   item,
                                                                      const RepresentationState &state)
 {
-  auto channel    = channelPtr(item);
-  auto planeIndex = normalCoordinateIndex(m_plane);
-
   ActorList actors;
 
   // BlockTimer<> timer("Channel representation pipeline");
 
-  if (isVisible(state) && hasVolumetricData(channel->output()))
-  {
-    auto reslicePoint  = crosshairPosition(m_plane, state);
-    Bounds sliceBounds = item->bounds();
-
-    if (sliceBounds[2*planeIndex] <= reslicePoint && reslicePoint < sliceBounds[2*planeIndex+1])
-    {
-      sliceBounds.setUpperInclusion(toAxis(planeIndex), true);
-      sliceBounds[2*planeIndex] = sliceBounds[2*planeIndex+1] = reslicePoint;
-
-      // solid slice
-      auto slice = vtkImage(readLockVolume(channel->output(), DataUpdatePolicy::Ignore), sliceBounds);
-      int extent[6];
-      slice->GetExtent(extent);
-
-      auto shiftScaleFilter = vtkSmartPointer<vtkImageShiftScale>::New();
-      shiftScaleFilter->SetInputData(slice);
-      shiftScaleFilter->SetNumberOfThreads(1);
-      shiftScaleFilter->SetShift(static_cast<int>(brightness(state)*255));
-      shiftScaleFilter->SetScale(contrast(state));
-      shiftScaleFilter->SetClampOverflow(true);
-      shiftScaleFilter->SetOutputScalarType(slice->GetScalarType());
-      shiftScaleFilter->UpdateWholeExtent();
-
-      auto color = stain(state);
-      auto lut = vtkSmartPointer<vtkLookupTable>::New();
-      lut->Allocate();
-      lut->SetTableRange(0,255);
-      lut->SetValueRange(0.0, 1.0);
-      lut->SetAlphaRange(1.0,1.0);
-      lut->SetNumberOfColors(256);
-      lut->SetRampToLinear();
-      lut->SetHueRange(color.hueF(), color.hueF());
-      lut->SetSaturationRange(0.0, color.saturationF());
-      lut->Build();
+  auto slice = sliceImage(item, state);
 
-      auto mapToColors = vtkSmartPointer<vtkImageMapToColors>::New();
-      mapToColors->SetInputConnection(shiftScaleFilter->GetOutputPort());
-      mapToColors->SetLookupTable(lut);
-      mapToColors->SetNumberOfThreads(1);
-      mapToColors->UpdateWholeExtent();
-
-      auto actor = vtkSmartPointer<vtkImageActor>::New();
-      actor->SetInterpolate(false);
-      actor->GetMapper()->BorderOn();
-      actor->GetMapper()->SetInputConnection(mapToColors->GetOutputPort());
-      actor->GetMapper()->SetNumberOfThreads(1);
-      actor->GetMapper()->UpdateWholeExtent();
-      actor->SetDisplayExtent(extent);
-      actor->SetOpacity(opacity(state));
-      actor->Update();
-
-      actors << actor;
-    }
+  if (slice)
+  {
+    actors << sliceActor(slice, state);
   }
 
   return actors;
@@ -137,14 +230,23 @@ void ChannelSlicePipeline::updateColors(ActorList& actors,
 {
   if (actors.size() == 1)
   {
-    auto actor       = vtkImageActor::SafeDownCast(actors.first().Get());
-    auto mapToColors = vtkImageMapToColors::SafeDownCast(actor->GetMapper()->GetInputConnection(0,0)->GetProducer());
+    auto actor    = vtkImageActor::SafeDownCast(actors.first().Get());
+    auto previous = actor->GetMapper()->GetInput();
 
-    auto color = stain(state);
-    auto lut   = vtkLookupTable::SafeDownCast(mapToColors->GetLookupTable());
+    auto intensities = previous->GetPointData()->GetArray(INTENSITIES);
+    auto key         = vtkStringArray::SafeDownCast(previous->GetFieldData()->GetAbstractArray(COLOR_KEY));
 
-    lut->SetHueRange(color.hueF(), color.hueF());
-    lut->SetSaturationRange(0.0, color.saturationF());
+    // the actors created for the state already have its colors.
+    if(intensities && (!key || key->GetValue(0) != colorKey(state).toStdString()))
+    {
+      // the previous image can be still in use by the views, the new one only shares the intensities with it.
+      auto slice = vtkSmartPointer<vtkImageData>::New();
+      slice->CopyStructure(previous);
+      slice->GetPointData()->AddArray(intensities);
+
+      actors.clear();
+      actors << sliceActor(slice, state);
+    }
   }
 }
 
@@ -159,3 +261,33 @@ void ChannelSlicePipeline::setPlane(const Plane plane)
 {
   m_plane = plane;
 }
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> ChannelSlicePipeline::sliceImage(ConstViewItemAdapterPtr   item,
+                                                               const RepresentationState &state) const
+{
+  auto channel    = channelPtr(item);
+  auto planeIndex = normalCoordinateIndex(m_plane);
+
+  if (isVisible(state) && hasVolumetricData(channel->output()))
+  {
+    auto reslicePoint  = crosshairPosition(m_plane, state);
+    Bounds sliceBounds = item->bounds();
+
+    if (sliceBounds[2*planeIndex] <= reslicePoint && reslicePoint < sliceBounds[2*planeIndex+1])
+    {
+      sliceBounds.setUpperInclusion(toAxis(planeIndex), true);
+      sliceBounds[2*planeIndex] = sliceBounds[2*planeIndex+1] = reslicePoint;
+
+      auto resolution = GUI::RepresentationUtils::displayResolution(state);
+      auto slice      = vtkImage(readLockVolume(channel->output(), DataUpdatePolicy::Ignore), sliceBounds, resolution);
+
+      // the intensities are kept in the image to map them again when the colors change.
+      slice->GetPointData()->GetScalars()->SetName(INTENSITIES);
+
+      return slice;
+    }
+  }
+
+  return nullptr;
+}
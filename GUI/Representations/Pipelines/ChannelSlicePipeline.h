@@ -29,6 +29,11 @@
 #include <GUI/Representations/RepresentationPipeline.h>
 #include <GUI/Representations/RepresentationState.h>
 
+// VTK
+#include <vtkSmartPointer.h>
+
+class vtkImageData;
+
 namespace ESPINA
 {
   /** \class ChannelSlicePipeline
@@ -64,6 +69,16 @@ namespace ESPINA
        */
       void setPlane(const Plane plane);
 
+    private:
+      /** \brief Returns the slice of the channel at the crosshair position with its intensities array or
+       * nullptr if the channel isn't visible or the crosshair is outside its bounds.
+       * \param[in] item channel item.
+       * \param[in] state representation state.
+       *
+       */
+      vtkSmartPointer<vtkImageData> sliceImage(ConstViewItemAdapterPtr   item,
+                                               const RepresentationState &state) const;
+
     private:
       Plane m_plane; /** orthogonal plane. */
   };
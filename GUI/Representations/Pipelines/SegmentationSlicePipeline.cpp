@@ -33,6 +33,15 @@
 #include <vtkImageMapper3D.h>
 #include <vtkImageData.h>
 #include <vtkAlgorithmOutput.h>
+#include <vtkPointData.h>
+#include <vtkTypeUInt64Array.h>
+
+// Qt
+#include <QSet>
+
+// C++
+#include <algorithm>
+#include <cmath>
 
 using namespace ESPINA;
 using namespace ESPINA::Core::Utils;
@@ -43,11 +52,138 @@ using namespace ESPINA::GUI::View::Utils;
 
 IntensitySelectionHighlighter SegmentationSlicePipeline::s_highlighter;
 
+namespace
+{
+  const char *COMPOSITED_ITEMS = "CompositedItems"; /** name of the array with the item of each composited pixel. */
+
+  struct Layer
+  {
+    quintptr                      id;        /** identifier of the item.      */
+    vtkSmartPointer<vtkImageData> image;     /** item slice.                  */
+    int                           extent[6]; /** extent of the item slice.    */
+    unsigned char                 color[4];  /** RGBA color of the item.      */
+  };
+
+  /** \brief Returns true if the image has the given origin and spacing.
+   * \param[in] image image to check.
+   * \param[in] origin origin to compare.
+   * \param[in] spacing spacing to compare.
+   *
+   */
+  bool sameGrid(vtkImageData *image, const double origin[3], const double spacing[3])
+  {
+    double imageOrigin[3], imageSpacing[3];
+    image->GetOrigin(imageOrigin);
+    image->GetSpacing(imageSpacing);
+
+    for(auto i: {0,1,2})
+    {
+      auto tolerance = spacing[i] / 1000.;
+
+      if(std::abs(imageSpacing[i] - spacing[i]) > tolerance || std::abs(imageOrigin[i] - origin[i]) > tolerance) return false;
+    }
+
+    return true;
+  }
+
+  /** \brief Expands the extent to contain the other one.
+   * \param[in,out] extent extent to expand.
+   * \param[in] other extent to contain.
+   *
+   */
+  void merge(int extent[6], const int other[6])
+  {
+    for(auto i: {0,1,2})
+    {
+      extent[2*i]   = std::min(extent[2*i],   other[2*i]);
+      extent[2*i+1] = std::max(extent[2*i+1], other[2*i+1]);
+    }
+  }
+
+  /** \brief Returns true if the extents intersect.
+   * \param[in] extent1 extent.
+   * \param[in] extent2 extent.
+   * \param[out] result intersection of both extents.
+   *
+   */
+  bool intersection(const int extent1[6], const int extent2[6], int result[6])
+  {
+    for(auto i: {0,1,2})
+    {
+      result[2*i]   = std::max(extent1[2*i],   extent2[2*i]);
+      result[2*i+1] = std::min(extent1[2*i+1], extent2[2*i+1]);
+
+      if(result[2*i] > result[2*i+1]) return false;
+    }
+
+    return true;
+  }
+
+  /** \brief Makes transparent the given region of the composited image.
+   * \param[in] image composited image.
+   * \param[in] owners items of the composited pixels.
+   * \param[in] region region to clear.
+   *
+   */
+  void clear(vtkImageData *image, vtkTypeUInt64Array *owners, const int region[6])
+  {
+    const auto length = region[1] - region[0] + 1;
+
+    for(int z = region[4]; z <= region[5]; ++z)
+    {
+      for(int y = region[2]; y <= region[3]; ++y)
+      {
+        int ijk[3]{region[0], y, z};
+
+        auto pixels = reinterpret_cast<unsigned char *>(image->GetScalarPointer(ijk));
+        auto items  = owners->GetPointer(image->ComputePointId(ijk));
+
+        std::fill(pixels, pixels + 4 * length, 0);
+        std::fill(items,  items + length, 0);
+      }
+    }
+  }
+
+  /** \brief Paints the segmentation voxels of the layer in the given region of the composited image.
+   * \param[in] image composited image.
+   * \param[in] owners items of the composited pixels.
+   * \param[in] layer item to paint.
+   * \param[in] region region to paint, contained in the layer extent.
+   *
+   */
+  void paint(vtkImageData *image, vtkTypeUInt64Array *owners, const Layer &layer, const int region[6])
+  {
+    const auto length = region[1] - region[0] + 1;
+
+    for(int z = region[4]; z <= region[5]; ++z)
+    {
+      for(int y = region[2]; y <= region[3]; ++y)
+      {
+        int ijk[3]{region[0], y, z};
+
+        auto voxels = reinterpret_cast<unsigned char *>(layer.image->GetScalarPointer(ijk));
+        auto pixels = reinterpret_cast<unsigned char *>(image->GetScalarPointer(ijk));
+        auto items  = owners->GetPointer(image->ComputePointId(ijk));
+
+        for(int x = 0; x < length; ++x)
+        {
+          if(voxels[x] != SEG_BG_VALUE)
+          {
+            std::copy(layer.color, layer.color + 4, pixels + 4*x);
+            items[x] = layer.id;
+          }
+        }
+      }
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 SegmentationSlicePipeline::SegmentationSlicePipeline(const Plane plane, ColorEngineSPtr colorEngine)
 : RepresentationPipeline{"SegmentationSliceRepresentation"}
 , m_plane               {plane}
 , m_colorEngine         {colorEngine}
+, m_composited          {false}
 {
 }
 
@@ -81,35 +217,18 @@ RepresentationPipeline::ActorList SegmentationSlicePipeline::createActors(ConstV
 
   if (isVisible(state) && hasVolumetricData(segmentation->output()))
   {
-    Bounds sliceBounds = readLockVolume(segmentation->output(), DataUpdatePolicy::Ignore)->bounds();
-
-    Nm reslicePoint = crosshairPosition(m_plane, state);
+    auto image = slice(segmentation, state);
 
-    if (sliceBounds[2*planeIndex] <= reslicePoint && reslicePoint < sliceBounds[2*planeIndex+1])
+    if (image)
     {
-      sliceBounds.setUpperInclusion(toAxis(planeIndex), true);
-      sliceBounds[2*planeIndex] = sliceBounds[2*planeIndex+1] = reslicePoint;
-
-      auto slice = vtkImage(readLockVolume(segmentation->output(), DataUpdatePolicy::Ignore), sliceBounds);
-
-      addPadding(slice, planeIndex);
-
       int extent[6];
-      slice->GetExtent(extent);
+      image->GetExtent(extent);
 
-      QColor color;
-      if(segmentation->colorEngine())
-      {
-        color = segmentation->colorEngine()->color(segmentation);
-      }
-      else
-      {
-        color = m_colorEngine->color(segmentation);
-      }
+      auto segColor = color(segmentation);
 
       auto mapToColors = vtkSmartPointer<vtkImageMapToColors>::New();
-      mapToColors->SetInputData(slice);
-      mapToColors->SetLookupTable(s_highlighter.lut(color, item->isSelected()));
+      mapToColors->SetInputData(image);
+      mapToColors->SetLookupTable(s_highlighter.lut(segColor, item->isSelected()));
       mapToColors->SetNumberOfThreads(1);
       mapToColors->UpdateInformation();
       mapToColors->UpdateWholeExtent();
@@ -120,7 +239,7 @@ RepresentationPipeline::ActorList SegmentationSlicePipeline::createActors(ConstV
       actor->GetMapper()->SetNumberOfThreads(1);
       actor->GetMapper()->UpdateInformation();
       actor->GetMapper()->UpdateWholeExtent();
-      actor->SetOpacity(opacity(state) * color.alphaF());
+      actor->SetOpacity(opacity(state) * segColor.alphaF());
       actor->SetPickable(false);
       actor->SetInterpolate(false);
       actor->SetDisplayExtent(extent);
@@ -147,20 +266,12 @@ void SegmentationSlicePipeline::updateColors(ActorList                 &actors,
 
     auto actor = vtkImageActor::SafeDownCast(actors.first().Get());
 
-    QColor color;
-    if(segmentation->colorEngine())
-    {
-      color = segmentation->colorEngine()->color(segmentation);
-    }
-    else
-    {
-      color = m_colorEngine->color(segmentation);
-    }
+    auto segColor = color(segmentation);
 
-    actor->SetOpacity(opacity(state) * color.alphaF());
+    actor->SetOpacity(opacity(state) * segColor.alphaF());
 
     auto mapToColors = vtkImageMapToColors::SafeDownCast(actor->GetMapper()->GetInputConnection(0,0)->GetProducer());
-    mapToColors->SetLookupTable(s_highlighter.lut(color, item->isSelected()));
+    mapToColors->SetLookupTable(s_highlighter.lut(segColor, item->isSelected()));
   }
 }
 
@@ -181,3 +292,224 @@ void SegmentationSlicePipeline::setPlane(const Plane plane)
 {
   m_plane = plane;
 }
+
+//----------------------------------------------------------------------------
+void SegmentationSlicePipeline::setCompositing(const bool enabled)
+{
+  m_composited = enabled;
+}
+
+//----------------------------------------------------------------------------
+void SegmentationSlicePipeline::compositeActors(ActorList                            &actors,
+                                                const CompositedItems                &items,
+                                                const QList<ConstViewItemAdapterPtr> &modified)
+{
+  auto planeIndex = normalCoordinateIndex(m_plane);
+
+  QList<Layer> layers;
+  ActorList    uncomposited;
+  double       origin[3], spacing[3];
+  int          extent[6]{VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN};
+  Nm           depth = 0;
+
+  for(auto composited: items)
+  {
+    auto item         = composited.first;
+    auto state        = composited.second;
+    auto segmentation = segmentationPtr(item);
+
+    if(!segmentation || !isVisible(state) || !hasVolumetricData(segmentation->output())) continue;
+
+    auto image = slice(segmentation, state);
+
+    if(!image) continue;
+
+    if(layers.isEmpty())
+    {
+      image->GetOrigin(origin);
+      image->GetSpacing(spacing);
+      depth = segmentationDepth(state);
+    }
+    else if(!sameGrid(image, origin, spacing))
+    {
+      // slices not aligned with the composited image keep their own actors.
+      uncomposited << createActors(item, state);
+      continue;
+    }
+
+    auto segColor  = color(segmentation);
+    auto highlight = s_highlighter.color(segColor, item->isSelected());
+
+    Layer layer;
+    layer.id       = reinterpret_cast<quintptr>(item);
+    layer.image    = image;
+    layer.color[0] = highlight.red();
+    layer.color[1] = highlight.green();
+    layer.color[2] = highlight.blue();
+    layer.color[3] = static_cast<unsigned char>(255 * highlight.alphaF() * opacity(state) * segColor.alphaF());
+    image->GetExtent(layer.extent);
+
+    merge(extent, layer.extent);
+
+    layers << layer;
+  }
+
+  if(layers.isEmpty())
+  {
+    actors = uncomposited;
+    return;
+  }
+
+  // same padding as single segmentation slices, image actors need two voxels in the slice axes.
+  for(auto i: {0,1,2})
+  {
+    if(i != planeIndex && extent[2*i] == extent[2*i+1]) ++extent[2*i+1];
+  }
+
+  vtkSmartPointer<vtkImageData> previous;
+  if(!actors.isEmpty() && !modified.isEmpty())
+  {
+    auto actor = vtkImageActor::SafeDownCast(actors.first().Get());
+
+    if(actor && actor->GetMapper()->GetInput())
+    {
+      previous = actor->GetMapper()->GetInput();
+
+      int previousExtent[6];
+      previous->GetExtent(previousExtent);
+
+      if(!previous->GetPointData()->GetArray(COMPOSITED_ITEMS) || !sameGrid(previous, origin, spacing) || !std::equal(extent, extent + 6, previousExtent))
+      {
+        previous = nullptr;
+      }
+    }
+  }
+
+  auto image = vtkSmartPointer<vtkImageData>::New();
+  int  dirty[6]{VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN};
+
+  if(previous)
+  {
+    // the previous image can be still in use by the views.
+    image->DeepCopy(previous);
+
+    QSet<quintptr> modifiedIds;
+    for(auto item: modified)
+    {
+      modifiedIds << reinterpret_cast<quintptr>(item);
+    }
+
+    // pixels of the previous representation of the modified items.
+    auto owners = vtkTypeUInt64Array::SafeDownCast(image->GetPointData()->GetArray(COMPOSITED_ITEMS))->GetPointer(0);
+    for(int z = extent[4]; z <= extent[5]; ++z)
+    {
+      for(int y = extent[2]; y <= extent[3]; ++y)
+      {
+        for(int x = extent[0]; x <= extent[1]; ++x, ++owners)
+        {
+          if(*owners != 0 && modifiedIds.contains(*owners))
+          {
+            int voxel[6]{x, x, y, y, z, z};
+            merge(dirty, voxel);
+          }
+        }
+      }
+    }
+
+    // current representation of the modified items.
+    for(auto &layer: layers)
+    {
+      if(modifiedIds.contains(layer.id))
+      {
+        merge(dirty, layer.extent);
+      }
+    }
+
+    if(dirty[0] > dirty[1])
+    {
+      // nothing to repaint.
+      actors = ActorList{actors.first()} + uncomposited;
+      return;
+    }
+  }
+  else
+  {
+    image->SetOrigin(origin);
+    image->SetSpacing(spacing);
+    image->SetExtent(extent);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+
+    auto owners = vtkSmartPointer<vtkTypeUInt64Array>::New();
+    owners->SetName(COMPOSITED_ITEMS);
+    owners->SetNumberOfTuples(image->GetNumberOfPoints());
+    image->GetPointData()->AddArray(owners);
+
+    std::copy(extent, extent + 6, dirty);
+  }
+
+  auto owners = vtkTypeUInt64Array::SafeDownCast(image->GetPointData()->GetArray(COMPOSITED_ITEMS));
+
+  clear(image, owners, dirty);
+
+  // items are painted in order, the last one hides the previous ones.
+  for(auto &layer: layers)
+  {
+    int region[6];
+    if(intersection(layer.extent, dirty, region))
+    {
+      paint(image, owners, layer, region);
+    }
+  }
+
+  image->Modified();
+
+  auto actor = vtkSmartPointer<vtkImageActor>::New();
+  actor->GetMapper()->BorderOn();
+  actor->GetMapper()->SetInputData(image);
+  actor->GetMapper()->SetNumberOfThreads(1);
+  actor->GetMapper()->UpdateInformation();
+  actor->GetMapper()->UpdateWholeExtent();
+  actor->SetPickable(false);
+  actor->SetInterpolate(false);
+  actor->SetDisplayExtent(extent);
+  actor->Update();
+
+  repositionActor(actor, depth, planeIndex);
+
+  actors = ActorList{actor} + uncomposited;
+}
+
+//----------------------------------------------------------------------------
+QColor SegmentationSlicePipeline::color(ConstSegmentationAdapterPtr segmentation) const
+{
+  if(segmentation->colorEngine())
+  {
+    return segmentation->colorEngine()->color(segmentation);
+  }
+
+  return m_colorEngine->color(segmentation);
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> SegmentationSlicePipeline::slice(ConstSegmentationAdapterPtr segmentation, const RepresentationState &state) const
+{
+  auto planeIndex  = normalCoordinateIndex(m_plane);
+  auto volume      = readLockVolume(segmentation->output(), DataUpdatePolicy::Ignore);
+  auto sliceBounds = volume->bounds().bounds();
+
+  Nm reslicePoint = crosshairPosition(m_plane, state);
+
+  if (sliceBounds[2*planeIndex] <= reslicePoint && reslicePoint < sliceBounds[2*planeIndex+1])
+  {
+    sliceBounds.setUpperInclusion(toAxis(planeIndex), true);
+    sliceBounds[2*planeIndex] = sliceBounds[2*planeIndex+1] = reslicePoint;
+
+    auto image = vtkImage(volume, sliceBounds);
+
+    addPadding(image, planeIndex);
+
+    return image;
+  }
+
+  return nullptr;
+}
@@ -29,6 +29,11 @@
 #include <GUI/ColorEngines/IntensitySelectionHighlighter.h>
 #include <GUI/Representations/RepresentationPipeline.h>
 
+// VTK
+#include <vtkSmartPointer.h>
+
+class vtkImageData;
+
 namespace ESPINA
 {
   /** \class SegmentationSlicePipeline
@@ -58,15 +63,49 @@ namespace ESPINA
 
       virtual bool pick(ConstViewItemAdapterPtr item, const NmVector3 &point) const override;
 
+      virtual bool isComposited() const override
+      { return m_composited; }
+
+      /** \brief Rasterizes the slices of all the visible segmentations into a single RGBA image
+       * represented by one actor. Only the regions of the modified segmentations are repainted if
+       * the previous image covers the same slice.
+       *
+       */
+      virtual void compositeActors(ActorList                            &actors,
+                                   const CompositedItems                &items,
+                                   const QList<ConstViewItemAdapterPtr> &modified) override;
+
       /** \brief Sets the orthogonal plane of the representation.
        * \param[in] plane orthogonal plane.
        *
        */
       void setPlane(const Plane plane);
 
+      /** \brief Enables or disables the composition of all the segmentations in a single actor.
+       * \param[in] enabled true to composite the segmentations and false to create an actor for each one.
+       *
+       * NOTE: must be set before the pipeline is used to create actors.
+       */
+      void setCompositing(const bool enabled);
+
     private:
-      Plane                              m_plane;       /** orthogonal plane of the representation. */
-      GUI::ColorEngines::ColorEngineSPtr m_colorEngine; /** application's color engine.             */
+      /** \brief Returns the color of the given segmentation.
+       * \param[in] segmentation segmentation adapter.
+       *
+       */
+      QColor color(ConstSegmentationAdapterPtr segmentation) const;
+
+      /** \brief Returns the slice of the segmentation at the crosshair of the given state or nullptr
+       * if the segmentation doesn't intersect it.
+       * \param[in] segmentation segmentation adapter.
+       * \param[in] state representation state.
+       *
+       */
+      vtkSmartPointer<vtkImageData> slice(ConstSegmentationAdapterPtr segmentation, const RepresentationState &state) const;
+
+      Plane                              m_plane;       /** orthogonal plane of the representation.                  */
+      GUI::ColorEngines::ColorEngineSPtr m_colorEngine; /** application's color engine.                              */
+      bool                               m_composited;  /** true to composite all the segmentations in one actor.    */
 
       static GUI::ColorEngines::IntensitySelectionHighlighter s_highlighter; /** selection highlighter for this class. */
   };
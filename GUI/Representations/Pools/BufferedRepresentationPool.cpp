@@ -21,8 +21,24 @@
 #include <GUI/Representations/Pools/BufferedRepresentationPool.h>
 #include <GUI/Representations/Frame.h>
 
+// VTK
+#include <vtkImageActor.h>
+#include <vtkImageData.h>
+
+// C++
+#include <cmath>
+
 using namespace ESPINA;
 
+namespace
+{
+  const int    MIN_REACH = 1;    /** minimum number of slices computed at each side of the crosshair. */
+  const double LOOKAHEAD = 0.5;  /** seconds of scroll computed ahead of the crosshair.                */
+  const double MAX_AHEAD = 2.0;  /** seconds of scroll computed ahead when no slice is ready in time.  */
+  const double SMOOTHING = 0.5;  /** weight of the last observation in the scroll velocity.           */
+  const double IDLE_TIME = 1000; /** decay time of the scroll velocity in milliseconds.               */
+}
+
 //-----------------------------------------------------------------------------
 BufferedRepresentationPool::BufferedRepresentationPool(const ItemAdapter::Type   &type,
                                                        const Plane                plane,
@@ -36,6 +52,13 @@ BufferedRepresentationPool::BufferedRepresentationPool(const ItemAdapter::Type
 , m_normalRes       {0}
 , m_pipeline        {pipeline}
 , m_locator         {locator}
+, m_velocity        {0}
+, m_reachAhead      {MIN_REACH}
+, m_reachBehind     {MIN_REACH}
+, m_frameSize       {0}
+, m_memoryBudget    {0}
+, m_hits            {0}
+, m_misses          {0}
 {
   connect(&m_updateWindow, SIGNAL(actorsReady(GUI::Representations::FrameCSPtr,RepresentationPipeline::Actors)),
           this,            SLOT(onActorsReady(GUI::Representations::FrameCSPtr,RepresentationPipeline::Actors)), Qt::DirectConnection);
@@ -53,19 +76,18 @@ ViewItemAdapterList BufferedRepresentationPool::pick(const NmVector3 &point, vtk
     RepresentationPipeline::ActorsLocker actors(lastActors, true);
     if(actors.isLocked())
     {
+      auto items = representedItems(actors.get());
+
       // Test the fast method with the locator
       if(m_locator && (type() == ItemAdapter::Type::SEGMENTATION))
       {
         ViewItemAdapterSList candidates{m_locator->contains(point)};
 
-        if(!candidates.isEmpty())
+        for (auto item : candidates)
         {
-          for (auto item : candidates)
+          if (items.contains(item.get()) && m_pipeline->pick(item.get(), point))
           {
-            if (actors.get().keys().contains(item.get()) && m_pipeline->pick(item.get(), point))
-            {
-              result << item.get();
-            }
+            result << item.get();
           }
         }
 
@@ -73,36 +95,42 @@ ViewItemAdapterList BufferedRepresentationPool::pick(const NmVector3 &point, vtk
       }
 
       // If none found check with the old linear iteration method.
-      ViewItemAdapterPtr pickedItem = nullptr;
-
-      if(actors.isLocked())
+      if (actor)
       {
-        if (actor)
+        for (auto it = actors.get().constBegin(); it != actors.get().constEnd(); ++it)
         {
-          auto it = actors.get().begin();
-
-          while (it != actors.get().end() && !pickedItem)
+          for (auto itemActor : it.value())
           {
-            for (auto itemActor : it.value())
+            if (itemActor.GetPointer() == actor)
             {
-              if (itemActor.GetPointer() == actor)
+              if (it.key())
               {
                 result << it.key();
-                return result;
               }
-            }
+              else
+              {
+                // composited actors are shared by several items, the picked ones contain the point.
+                for (auto item : items)
+                {
+                  if (!actors.get().contains(item) && m_pipeline->pick(item, point))
+                  {
+                    result << item;
+                  }
+                }
+              }
 
-            ++it;
+              return result;
+            }
           }
         }
-        else
+      }
+      else
+      {
+        for (auto item : items)
         {
-          for (auto item : actors.get().keys())
+          if (m_pipeline->pick(item, point))
           {
-            if (m_pipeline->pick(item, point))
-            {
-              result << item;
-            }
+            result << item;
           }
         }
       }
@@ -112,6 +140,25 @@ ViewItemAdapterList BufferedRepresentationPool::pick(const NmVector3 &point, vtk
   return result;
 }
 
+//-----------------------------------------------------------------------------
+QSet<ViewItemAdapterPtr> BufferedRepresentationPool::representedItems(const RepresentationPipeline::ActorsMap &actors) const
+{
+  QSet<ViewItemAdapterPtr> items;
+
+  for (auto item : actors.keys())
+  {
+    if (item) items << item;
+  }
+
+  // composited actors are stored with a null key and represent the sources without their own actors.
+  if (m_pipeline->isComposited() && actors.contains(nullptr))
+  {
+    items.unite(sources().toSet());
+  }
+
+  return items;
+}
+
 //-----------------------------------------------------------------------------
 void BufferedRepresentationPool::updatePipelinesImplementation(const GUI::Representations::FrameCSPtr frame)
 {
@@ -125,10 +172,49 @@ void BufferedRepresentationPool::updatePipelinesImplementation(const GUI::Repres
     m_normalRes = res;
   }
 
-  auto shift       = invalidate ? invalidationShift() : distanceFromLastCrosshair(frame->crosshair);
+  auto shift = invalidate ? invalidationShift() : distanceFromLastCrosshair(frame->crosshair);
+
+  if (!invalidate && shift != 0)
+  {
+    updateVelocity(shift);
+  }
+
+  auto previous    = m_updateWindow.current();
   auto invalidated = updateBuffer(frame->crosshair, shift, frame);
+  auto current     = m_updateWindow.current();
+
+  if (shift != 0)
+  {
+    if (previous->hasFinished())
+    {
+      m_frameSize = actorsSize(previous);
+    }
 
-  if (!m_updateWindow.current()->isEmpty())
+    if (!invalidate && hasSources())
+    {
+      if (!invalidated.contains(current) && !m_pending.contains(current.get()) && current->hasFinished())
+      {
+        ++m_hits;
+      }
+      else
+      {
+        ++m_misses;
+      }
+    }
+
+    // stale actors of the slices that won't be computed until they get within reach.
+    updateReach();
+    auto reachable = reachableUpdaters();
+    for (auto updater : invalidated)
+    {
+      if (updater != previous && !reachable.contains(updater))
+      {
+        updater->releaseActors();
+      }
+    }
+  }
+
+  if (!current->isEmpty())
   {
     updatePipelines(invalidated);
   }
@@ -139,11 +225,21 @@ void BufferedRepresentationPool::updateRepresentationsAtImlementation(const GUI:
 {
   m_updateWindow.current()->setFrame(frame);
 
-  auto updaters = m_updateWindow.all();
+  updateReach();
+
+  auto updaters = reachableUpdaters();
 
-  for(auto updater: updaters)
+  for(auto updater: m_updateWindow.all())
   {
-    updater->updateRepresentations(modifiedItems);
+    if(updaters.contains(updater))
+    {
+      updater->updateRepresentations(modifiedItems);
+    }
+    else
+    {
+      // out of reach slices are fully computed once they get within reach.
+      m_pending << updater.get();
+    }
   }
 
   updatePipelines(updaters);
@@ -154,11 +250,21 @@ void BufferedRepresentationPool::updateRepresentationColorsAtImlementation(const
 {
   m_updateWindow.current()->setFrame(frame);
 
-  auto updaters = m_updateWindow.all();
+  updateReach();
+
+  auto updaters = reachableUpdaters();
 
-  for(auto updater: updaters)
+  for(auto updater: m_updateWindow.all())
   {
-    updater->updateRepresentationColors(modifiedItems);
+    if(updaters.contains(updater))
+    {
+      updater->updateRepresentationColors(modifiedItems);
+    }
+    else
+    {
+      // out of reach slices are fully computed once they get within reach.
+      m_pending << updater.get();
+    }
   }
 
   updatePipelines(updaters);
@@ -192,19 +298,39 @@ void BufferedRepresentationPool::applySettings(const RepresentationState &settin
   }
 }
 
+//-----------------------------------------------------------------------------
+void BufferedRepresentationPool::setMemoryBudget(const unsigned long long bytes)
+{
+  m_memoryBudget = bytes;
+}
+
+//-----------------------------------------------------------------------------
+void BufferedRepresentationPool::resetStatistics()
+{
+  m_hits   = 0;
+  m_misses = 0;
+}
+
 //-----------------------------------------------------------------------------
 void BufferedRepresentationPool::updatePriorities()
 {
   m_updateWindow.current()->setPriority(Priority::VERY_HIGH);
 
-  for (auto closest : m_updateWindow.closest())
+  auto ahead  = m_updateWindow.ahead();
+  auto behind = m_updateWindow.behind();
+
+  // slices in the scroll direction are needed sooner.
+  auto closestAhead  = (m_reachAhead  >= m_reachBehind) ? m_reachAhead  : MIN_REACH;
+  auto closestBehind = (m_reachBehind >= m_reachAhead)  ? m_reachBehind : MIN_REACH;
+
+  for (int i = 0; i < ahead.size(); ++i)
   {
-    closest->setPriority(Priority::HIGH);
+    ahead[i]->setPriority(i < closestAhead ? Priority::HIGH : Priority::LOW);
   }
 
-  for (auto further : m_updateWindow.farther())
+  for (int i = 0; i < behind.size(); ++i)
   {
-    further->setPriority(Priority::LOW);
+    behind[i]->setPriority(i < closestBehind ? Priority::HIGH : Priority::LOW);
   }
 }
 
@@ -258,13 +384,29 @@ RepresentationUpdaterSList BufferedRepresentationPool::updateBuffer(const NmVect
 //-----------------------------------------------------------------------------
 void BufferedRepresentationPool::updatePipelines(RepresentationUpdaterSList updaters)
 {
+  updateReach();
   updatePriorities();
 
   if(hasSources())
   {
+    auto reachable = reachableUpdaters();
+
     for (auto updater : updaters)
     {
-      Task::submit(updater);
+      if (!reachable.contains(updater))
+      {
+        m_pending << updater.get();
+      }
+    }
+
+    for (auto updater : reachable)
+    {
+      if (updaters.contains(updater) || m_pending.contains(updater.get()))
+      {
+        m_pending.remove(updater.get());
+
+        Task::submit(updater);
+      }
     }
 
     checkCurrentActors();
@@ -287,3 +429,105 @@ int BufferedRepresentationPool::invalidationShift() const
 {
   return m_updateWindow.size() + 1;
 }
+
+
+//-----------------------------------------------------------------------------
+void BufferedRepresentationPool::updateVelocity(int shift)
+{
+  auto elapsed = m_scrollTimer.isValid() ? std::max<qint64>(1, m_scrollTimer.restart()) : IDLE_TIME;
+
+  if (!m_scrollTimer.isValid())
+  {
+    m_scrollTimer.start();
+  }
+
+  // the statistics of a previous scroll don't apply to a new one.
+  if (elapsed >= IDLE_TIME)
+  {
+    resetStatistics();
+  }
+
+  auto velocity = shift * 1000.0 / elapsed;
+
+  m_velocity = SMOOTHING * velocity + (1 - SMOOTHING) * m_velocity * std::exp(-elapsed / IDLE_TIME);
+}
+
+//-----------------------------------------------------------------------------
+void BufferedRepresentationPool::updateReach()
+{
+  const int width = (m_updateWindow.size() - 1) / 2;
+
+  auto velocity = 0.0;
+  if (m_scrollTimer.isValid())
+  {
+    velocity = m_velocity * std::exp(-m_scrollTimer.elapsed() / IDLE_TIME);
+  }
+
+  // slices that weren't ready when the crosshair got there extend the lookahead of the scroll.
+  auto lookahead = LOOKAHEAD;
+  if (m_hits + m_misses > 0)
+  {
+    lookahead += (MAX_AHEAD - LOOKAHEAD) * m_misses / (m_hits + m_misses);
+  }
+
+  auto leading  = std::min(width, MIN_REACH + static_cast<int>(std::ceil(std::abs(velocity) * lookahead)));
+  auto trailing = std::min(width, MIN_REACH);
+
+  if (m_memoryBudget > 0 && m_frameSize > 0)
+  {
+    auto frames = static_cast<int>(std::min<unsigned long long>(m_memoryBudget / m_frameSize, 2 * width + 1));
+
+    // trailing slices are discarded first.
+    while (1 + leading + trailing > frames && trailing > 0) --trailing;
+    while (1 + leading + trailing > frames && leading  > 0) --leading;
+  }
+
+  m_reachAhead  = (velocity >= 0) ? leading  : trailing;
+  m_reachBehind = (velocity >= 0) ? trailing : leading;
+}
+
+//-----------------------------------------------------------------------------
+RepresentationUpdaterSList BufferedRepresentationPool::reachableUpdaters() const
+{
+  RepresentationUpdaterSList result;
+
+  auto ahead  = m_updateWindow.ahead();
+  auto behind = m_updateWindow.behind();
+
+  result << m_updateWindow.current();
+
+  for (int i = 0; i < std::max(m_reachAhead, m_reachBehind); ++i)
+  {
+    if (i < m_reachAhead)  result << ahead[i];
+    if (i < m_reachBehind) result << behind[i];
+  }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long long BufferedRepresentationPool::actorsSize(RepresentationUpdaterSPtr updater)
+{
+  unsigned long long size = 0;
+
+  RepresentationPipeline::ActorsLocker actors(updater->actors(), true);
+
+  if (actors.isLocked())
+  {
+    for (auto itemActors : actors.get())
+    {
+      for (auto actor : itemActors)
+      {
+        auto imageActor = vtkImageActor::SafeDownCast(actor.Get());
+
+        if (imageActor && imageActor->GetInput())
+        {
+          // GetActualMemorySize() returns kibibytes.
+          size += imageActor->GetInput()->GetActualMemorySize() * 1024;
+        }
+      }
+    }
+  }
+
+  return size;
+}
@@ -32,11 +32,20 @@
 #include <vtkMath.h>
 #include <vtkProp.h>
 
+// Qt
+#include <QElapsedTimer>
+#include <QSet>
+
 namespace ESPINA
 {
   /** \class BufferedRepresentationPool
    * \brief Buffered representation pool for 2D representations.
    *
+   * The window size is the maximum number of slices buffered at each side of the crosshair. Only
+   * the slices within the reach of the observed scroll velocity and the memory budget are computed,
+   * the rest are computed once they get within reach. The reach of a scroll grows with the ratio of
+   * buffer misses since the scroll started.
+   *
    */
   class EspinaGUI_EXPORT BufferedRepresentationPool
   : public RepresentationPool
@@ -60,6 +69,41 @@ namespace ESPINA
 
       virtual ViewItemAdapterList pick(const NmVector3 &point, vtkProp *actor) const override;
 
+      /** \brief Sets the maximum memory used by the buffered slices actors.
+       * \param[in] bytes memory budget in bytes, 0 for no limit.
+       *
+       */
+      void setMemoryBudget(const unsigned long long bytes);
+
+      /** \brief Returns the number of crosshair changes of the last scroll whose slice was already computed.
+       *
+       */
+      unsigned long long hits() const
+      { return m_hits; }
+
+      /** \brief Returns the number of crosshair changes of the last scroll whose slice wasn't computed yet.
+       *
+       */
+      unsigned long long misses() const
+      { return m_misses; }
+
+      /** \brief Resets the buffer hits and misses counters. They are also reset when a scroll starts.
+       *
+       */
+      void resetStatistics();
+
+      /** \brief Returns the number of slices computed ahead of the crosshair.
+       *
+       */
+      int reachAhead() const
+      { return m_reachAhead; }
+
+      /** \brief Returns the number of slices computed behind the crosshair.
+       *
+       */
+      int reachBehind() const
+      { return m_reachBehind; }
+
     private:
       virtual void updatePipelinesImplementation(const GUI::Representations::FrameCSPtr frame);
 
@@ -73,6 +117,12 @@ namespace ESPINA
 
       virtual void applySettings(const RepresentationState &settings) override;
 
+      /** \brief Returns the items represented by the given actors.
+       * \param[in] actors actors of the pool's items.
+       *
+       */
+      QSet<ViewItemAdapterPtr> representedItems(const RepresentationPipeline::ActorsMap &actors) const;
+
       /** \brief Updates the priorities of the task depending on the position.
        *
        */
@@ -114,6 +164,29 @@ namespace ESPINA
        */
       int invalidationShift() const;
 
+      /** \brief Updates the scroll velocity with the given crosshair shift.
+       * \param[in] shift crosshair shift in resolution steps.
+       *
+       */
+      void updateVelocity(int shift);
+
+      /** \brief Updates the number of slices to compute at each side of the crosshair from
+       * the scroll velocity and the memory budget.
+       *
+       */
+      void updateReach();
+
+      /** \brief Returns the updaters of the slices within reach, sorted by distance to the crosshair.
+       *
+       */
+      RepresentationUpdaterSList reachableUpdaters() const;
+
+      /** \brief Returns the size in bytes of the actors of the given updater.
+       * \param[in] updater representation updater.
+       *
+       */
+      static unsigned long long actorsSize(RepresentationUpdaterSPtr updater);
+
     private:
       const int                  m_normalIdx;    /** index of the plane normal. in [0,1,2]      */
       RepresentationWindow       m_updateWindow; /** the tasks window.                          */
@@ -121,6 +194,16 @@ namespace ESPINA
       NmVector3                  m_crosshair;    /** current position's crosshair.              */
       RepresentationPipelineSPtr m_pipeline;     /** actor creation pipeline and pick resolver. */
       SegmentationLocatorSPtr    m_locator;      /** segmentation locator object.               */
+
+      QSet<RepresentationUpdater *> m_pending;      /** updaters out of reach that need to be computed.         */
+      QElapsedTimer                 m_scrollTimer;  /** time since the last crosshair shift.                    */
+      double                        m_velocity;     /** scroll velocity in slices per second.                   */
+      int                           m_reachAhead;   /** number of slices computed ahead of the crosshair.       */
+      int                           m_reachBehind;  /** number of slices computed behind the crosshair.         */
+      unsigned long long            m_frameSize;    /** last measured size in bytes of the actors of a slice.   */
+      unsigned long long            m_memoryBudget; /** maximum memory of the buffered slices, 0 for no limit.  */
+      unsigned long long            m_hits;         /** number of crosshair changes with computed slice.        */
+      unsigned long long            m_misses;       /** number of crosshair changes without computed slice.     */
   };
 }
 
@@ -420,6 +420,13 @@ namespace ESPINA
          *
          */
         virtual void setRepresentationDepth(Nm depth) = 0;
+
+        /** \brief Sets the size in Nm of a display pixel, managers can use it to show lower resolution representations.
+         * \param[in] resolution size in Nm of a display pixel.
+         *
+         */
+        virtual void setDisplayResolution(Nm resolution)
+        {};
       };
 
       /** \brief Returns true if the frame invalidates the representations of the given item type.
@@ -187,9 +187,13 @@ void RepresentationParallelUpdater::run()
 
   if(canExecute())
   {
+    m_scheduler->beginBlockingWait();
+
     m_waitMutex.lock();
     m_condition.wait(&m_waitMutex);
     m_waitMutex.unlock();
+
+    m_scheduler->endBlockingWait();
   }
 
   if(!canExecute())
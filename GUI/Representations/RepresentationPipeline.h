@@ -32,6 +32,7 @@
 // Qt
 #include <QString>
 #include <QList>
+#include <QPair>
 #include <QMutex>
 
 // C++
@@ -58,6 +59,9 @@ namespace ESPINA
       using ActorsMap = QMap<ViewItemAdapter*, ActorList>;
       class ActorsLocker;
 
+      using CompositedItem  = QPair<ConstViewItemAdapterPtr, RepresentationState>;
+      using CompositedItems = QList<CompositedItem>;
+
       struct ActorsData
       {
         private:
@@ -142,6 +146,25 @@ namespace ESPINA
                                 ConstViewItemAdapterPtr           item,
                                 const RepresentationState         &state) = 0;
 
+      /** \brief Returns true if the pipeline represents all its items with a shared set of actors
+       * instead of creating the actors of each item.
+       *
+       */
+      virtual bool isComposited() const
+      { return false; }
+
+      /** \brief Creates the shared actors representing all the given items.
+       * \param[in,out] actors previous shared actors, replaced by the new ones.
+       * \param[in] items items in drawing order with their representation settings.
+       * \param[in] modified items modified since the previous actors were created, empty to create them from scratch.
+       *
+       *  NOTE: This function must be reentrant
+       */
+      virtual void compositeActors(RepresentationPipeline::ActorList    &actors,
+                                   const CompositedItems                &items,
+                                   const QList<ConstViewItemAdapterPtr> &modified)
+      {}
+
     protected:
       /** \brief RepresentationPipeline constructor.
        * \param[in] type type of the pipeline.
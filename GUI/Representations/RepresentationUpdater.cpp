@@ -60,6 +60,9 @@ void RepresentationUpdater::removeSource(ViewItemAdapterPtr item)
     {
       actors.get().remove(item);
     }
+
+    // shared actors are created from scratch in the next execution.
+    actors.get().remove(nullptr);
   }
 
   QWriteLocker lock(&m_dataLock);
@@ -81,6 +84,10 @@ void RepresentationUpdater::setCrosshair(const NmVector3 &point)
   QWriteLocker lock(&m_dataLock);
 
   setCrosshairPoint(point, m_settings);
+
+  // all the actors must be created for the new crosshair.
+  m_updateList = &m_sources;
+  m_requestedSources.clear();
 }
 
 //----------------------------------------------------------------------------
@@ -152,12 +159,25 @@ RepresentationPipeline::Actors RepresentationUpdater::actors() const
   return m_actors;
 }
 
+//----------------------------------------------------------------------------
+void RepresentationUpdater::releaseActors()
+{
+  RepresentationPipeline::ActorsLocker actors(m_actors, true);
+
+  if(actors.isLocked())
+  {
+    actors.get().clear();
+  }
+}
+
 //----------------------------------------------------------------------------
 void RepresentationUpdater::run()
 {
   auto frame = std::make_shared<Frame>();
   RepresentationState settings;
   UpdateRequestList updateList;
+  UpdateRequestList sources;
+  bool fullUpdate = false;
 
   {
     QReadLocker lock(&m_dataLock);
@@ -174,9 +194,16 @@ void RepresentationUpdater::run()
 
     // Local copy needed to prevent condition race on same frame
     // (usually due to invalidation view item representations)
+    fullUpdate = (m_updateList == &m_sources);
     updateList = *m_updateList;
     updateList.detach();
 
+    if(m_pipeline->isComposited())
+    {
+      sources = m_sources;
+      sources.detach();
+    }
+
     m_updateList    = &m_sources;
     m_requestedSources.clear();
   }
@@ -187,25 +214,32 @@ void RepresentationUpdater::run()
   {
     RepresentationPipeline::ActorsLocker actors(m_actors);
 
-    int i = 0;
-    while (canExecute() && it != updateList.end())
+    if(m_pipeline->isComposited())
     {
-      auto item     = it->first;
-      auto pipeline = sourcePipeline(item);
+      compositeActors(actors.get(), sources, updateList, settings, fullUpdate);
+    }
+    else
+    {
+      int i = 0;
+      while (canExecute() && it != updateList.end())
+      {
+        auto item     = it->first;
+        auto pipeline = sourcePipeline(item);
 
-      auto state = pipeline->representationState(item, settings);
+        auto state = pipeline->representationState(item, settings);
 
-      if (it->second)
-      {
-        actors.get()[item] = pipeline->createActors(item, state);
-      }
+        if (it->second)
+        {
+          actors.get()[item] = pipeline->createActors(item, state);
+        }
 
-      pipeline->updateColors(actors.get()[item], item, state);
+        pipeline->updateColors(actors.get()[item], item, state);
 
-      ++it;
-      ++i;
+        ++it;
+        ++i;
 
-      reportProgress((i/static_cast<double>(size))*100);
+        reportProgress((i/static_cast<double>(size))*100);
+      }
     }
   }
 
@@ -215,6 +249,66 @@ void RepresentationUpdater::run()
   }
 }
 
+//----------------------------------------------------------------------------
+void RepresentationUpdater::compositeActors(RepresentationPipeline::ActorsMap &actors,
+                                            const UpdateRequestList           &sources,
+                                            const UpdateRequestList           &updateList,
+                                            const RepresentationState         &settings,
+                                            const bool                         fullUpdate)
+{
+  QList<ConstViewItemAdapterPtr> modified;
+  for(auto request: updateList)
+  {
+    modified << request.first;
+  }
+
+  RepresentationPipeline::CompositedItems items;
+
+  for(auto source: sources)
+  {
+    if(!canExecute()) return;
+
+    auto item     = source.first;
+    auto pipeline = sourcePipeline(item);
+    auto state    = pipeline->representationState(item, settings);
+
+    if(pipeline == m_pipeline)
+    {
+      items << RepresentationPipeline::CompositedItem(item, state);
+
+      // previous temporal representation actors.
+      actors.remove(item);
+    }
+    else
+    {
+      auto createActors = fullUpdate;
+      for(auto request: updateList)
+      {
+        if(request.first == item)
+        {
+          createActors |= request.second;
+          break;
+        }
+      }
+
+      if(createActors || !actors.contains(item))
+      {
+        actors[item] = pipeline->createActors(item, state);
+      }
+
+      pipeline->updateColors(actors[item], item, state);
+    }
+  }
+
+  if(fullUpdate)
+  {
+    modified.clear();
+  }
+
+  // composited actors are stored with a null key as they don't belong to any item.
+  m_pipeline->compositeActors(actors[nullptr], items, modified);
+}
+
 //----------------------------------------------------------------------------
 RepresentationPipelineSPtr RepresentationUpdater::sourcePipeline(ViewItemAdapterPtr item) const
 {
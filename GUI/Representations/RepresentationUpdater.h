@@ -114,6 +114,11 @@ namespace ESPINA
        */
       RepresentationPipeline::Actors actors() const;
 
+      /** \brief Discards the actors computed by the task if they aren't being updated.
+       *
+       */
+      void releaseActors();
+
     signals:
       void actorsReady(const GUI::Representations::FrameCSPtr frame, RepresentationPipeline::Actors actors);
 
@@ -148,6 +153,21 @@ namespace ESPINA
        */
       static void removeUpdateRequest(UpdateRequestList &list, ViewItemAdapterPtr item);
 
+      /** \brief Updates the shared actors of the sources represented by a composited pipeline.
+       * Sources with a temporal representation keep their own actors.
+       * \param[in,out] actors actors of the sources.
+       * \param[in] sources all the sources of the updater.
+       * \param[in] updateList sources requested to update.
+       * \param[in] settings representation settings.
+       * \param[in] fullUpdate true if all the sources must be updated and false otherwise.
+       *
+       */
+      void compositeActors(RepresentationPipeline::ActorsMap &actors,
+                           const UpdateRequestList           &sources,
+                           const UpdateRequestList           &updateList,
+                           const RepresentationState         &settings,
+                           const bool                         fullUpdate);
+
     protected:
       GUI::Representations::FrameCSPtr m_frame;            /** frame of the actors.                                       */
       RepresentationPipelineSPtr       m_pipeline;         /** actor creation pipeline and pick resolver.                 */
@@ -27,6 +27,7 @@ using namespace ESPINA;
 
 const QString PLANE = "Plane";
 const QString DEPTH = "Depth";
+const QString RESOLUTION = "DisplayResolution";
 
 //--------------------------------------------------------------------
 Plane GUI::RepresentationUtils::plane(const RepresentationState &state)
@@ -63,3 +64,21 @@ void GUI::RepresentationUtils::setSegmentationDepth(RepresentationPoolSPtr pool,
 {
   pool->setSetting<Nm>(DEPTH, depth);
 }
+
+//--------------------------------------------------------------------
+Nm GUI::RepresentationUtils::displayResolution(const RepresentationState &state)
+{
+  return state.getValue<Nm>(RESOLUTION);
+}
+
+//--------------------------------------------------------------------
+void GUI::RepresentationUtils::setDisplayResolution(RepresentationState &state, const Nm resolution)
+{
+  state.setValue<Nm>(RESOLUTION, resolution);
+}
+
+//--------------------------------------------------------------------
+void GUI::RepresentationUtils::setDisplayResolution(RepresentationPoolSPtr pool, const Nm resolution)
+{
+  pool->setSetting<Nm>(RESOLUTION, resolution);
+}
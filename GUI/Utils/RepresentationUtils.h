@@ -74,6 +74,28 @@ namespace ESPINA
        *
        */
       void EspinaGUI_EXPORT setSegmentationDepth(RepresentationPoolSPtr pool, const Nm depth);
+
+      /** \brief Returns the display resolution defined in the given state.
+       * \param[in] state representation state object.
+       *
+       * A value of 0 means full resolution.
+       *
+       */
+      Nm EspinaGUI_EXPORT displayResolution(const RepresentationState &state);
+
+      /** \brief Sets the display resolution in the given state.
+       * \param[in] state representation state object.
+       * \param[in] resolution size in nm of a display pixel.
+       *
+       */
+      void EspinaGUI_EXPORT setDisplayResolution(RepresentationState &state, const Nm resolution);
+
+      /** \brief Sets the display resolution for the given pool.
+       * \param[inout] pool representation pool.
+       * \param[in] resolution size in nm of a display pixel.
+       *
+       */
+      void EspinaGUI_EXPORT setDisplayResolution(RepresentationPoolSPtr pool, const Nm resolution);
     } // namespace RepresentationUtils
   } // namespace GUI
 } // namespace ESPINA
@@ -83,6 +83,10 @@
 #include <vtkRendererCollection.h>
 #include <vtkPointPicker.h>
 
+// C++
+#include <cmath>
+#include <limits>
+
 using namespace ESPINA;
 using namespace ESPINA::GUI;
 using namespace ESPINA::GUI::Widgets;
@@ -94,25 +98,26 @@ using namespace ESPINA::GUI::Model::Utils;
 // SLICE VIEW
 //-----------------------------------------------------------------------------
 View2D::View2D(GUI::View::ViewState &state, Plane plane, QWidget *parent)
-: RenderView        {state, ViewType::VIEW_2D, parent}
-, m_mainLayout      {new QVBoxLayout()}
-, m_controlLayout   {new QHBoxLayout()}
-, m_fromLayout      {new QHBoxLayout()}
-, m_toLayout        {new QHBoxLayout()}
-, m_scrollBar       {new QScrollBar(Qt::Horizontal, this)}
-, m_spinBox         {new QDoubleSpinBox(this)}
-, m_cameraReset     {nullptr}
-, m_snapshot        {nullptr}
-, m_showThumbnail   {true}
-, m_inThumbnail     {false}
-, m_inThumbnailClick{true}
-, m_scaleValue      {1.0}
-, m_scaleVisibility {true}
-, m_scale           {vtkSmartPointer<vtkAxisActor2D>::New()}
-, m_plane           {plane}
-, m_normalCoord     {normalCoordinateIndex(plane)}
-, m_invertWheel     {false}
-, m_invertSliceOrder{false}
+: RenderView         {state, ViewType::VIEW_2D, parent}
+, m_mainLayout       {new QVBoxLayout()}
+, m_controlLayout    {new QHBoxLayout()}
+, m_fromLayout       {new QHBoxLayout()}
+, m_toLayout         {new QHBoxLayout()}
+, m_scrollBar        {new QScrollBar(Qt::Horizontal, this)}
+, m_spinBox          {new QDoubleSpinBox(this)}
+, m_cameraReset      {nullptr}
+, m_snapshot         {nullptr}
+, m_showThumbnail    {true}
+, m_inThumbnail      {false}
+, m_inThumbnailClick {true}
+, m_scaleValue       {1.0}
+, m_displayResolution{0}
+, m_scaleVisibility  {true}
+, m_scale            {vtkSmartPointer<vtkAxisActor2D>::New()}
+, m_plane            {plane}
+, m_normalCoord      {normalCoordinateIndex(plane)}
+, m_invertWheel      {false}
+, m_invertSliceOrder {false}
 {
   setupUI();
 
@@ -285,6 +290,8 @@ void View2D::updateScale()
   m_scale->SetRange(0, scale);
   m_scale->SetPosition2(0.1+rulerLength, 0.1);
   m_scale->SetVisibility(sceneBounds().areValid() && m_scaleVisibility && (0.02 < rulerLength) && (rulerLength < 0.8));
+
+  updateManagersResolution();
 }
 
 //-----------------------------------------------------------------------------
@@ -799,6 +806,7 @@ void View2D::configureManager(RepresentationManagerSPtr manager)
   {
     manager2D->setPlane(m_plane);
     manager2D->setRepresentationDepth(segmentationDepth());
+    manager2D->setDisplayResolution(m_displayResolution);
   }
 }
 
@@ -844,6 +852,42 @@ void View2D::updateManagersDepth(const NmVector3& resolution)
   }
 }
 
+//-----------------------------------------------------------------------------
+void View2D::updateManagersResolution()
+{
+  updateScaleValue();
+
+  auto resolution = sceneResolution();
+  auto voxelSize  = std::numeric_limits<Nm>::max();
+
+  for(auto i: {0, 1, 2})
+  {
+    if(i != m_normalCoord) voxelSize = std::min(voxelSize, resolution[i]);
+  }
+
+  // quantized to powers of two to avoid rebuilding the representations on every zoom step.
+  Nm displayResolution = 0;
+  if(std::isfinite(m_scaleValue) && (voxelSize > 0) && (m_scaleValue >= 2 * voxelSize))
+  {
+    displayResolution = voxelSize * std::pow(2, std::floor(std::log2(m_scaleValue / voxelSize)));
+  }
+
+  if(m_displayResolution != displayResolution)
+  {
+    m_displayResolution = displayResolution;
+
+    for(auto manager: m_managers)
+    {
+      auto manager2D = dynamic_cast<RepresentationManager2D *>(manager.get());
+
+      if (manager2D)
+      {
+        manager2D->setDisplayResolution(m_displayResolution);
+      }
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 const QString View2D::viewName() const
 {
@@ -250,6 +250,12 @@ namespace ESPINA
 
     void updateManagersDepth(const NmVector3 &resolution);
 
+    /** \brief Updates the display resolution of the managers if the size of a display
+     * pixel has crossed a power of two of the scene resolution.
+     *
+     */
+    void updateManagersResolution();
+
     void updateScrollBarLimits(int min, int max);
 
     inline bool fitToSlices() const;
@@ -324,6 +330,7 @@ namespace ESPINA
 
     // Ruler
     double                           m_scaleValue;
+    Nm                               m_displayResolution;
     bool                             m_scaleVisibility;
     vtkSmartPointer<vtkAxisActor2D>  m_scale;
 
@@ -27,6 +27,7 @@
 #include <Core/Analysis/Category.h>
 #include <Core/Analysis/Segmentation.h>
 #include <Core/MultiTasking/Scheduler.h>
+#include <Core/MultiTasking/ContinuationTask.h>
 #include <CountingFrames/CountingFrame.h>
 #include <Extensions/ExtensionUtils.h>
 #include <Extensions/StereologicalInclusion.h>
@@ -47,6 +48,8 @@ ApplyCountingFrame::ApplyCountingFrame(CountingFrame                         *co
 : Task           {scheduler}
 , m_countingFrame{countingFrame}
 , m_factory      {factory}
+, m_tasksFinished{false}
+, m_join         {nullptr}
 {
   setDescription(tr("Applying CF: %1").arg(m_countingFrame->id()));
 }
@@ -62,6 +65,11 @@ void ApplyCountingFrame::run()
 {
   bool validExecution = false;
 
+  {
+    QMutexLocker lock(&m_waitMutex);
+    m_tasksFinished = false;
+  }
+
   {
     auto stack         = m_countingFrame->channel();
     auto segmentations = m_countingFrame->channel()->analysis()->segmentations();
@@ -103,6 +111,7 @@ void ApplyCountingFrame::run()
         partitions[iteration++ % maxTasks] << segmentation;
       }
 
+      TaskSList tasks;
       for(unsigned int i = 0; i < maxTasks; ++i)
       {
         if (!canExecute()) break;
@@ -114,13 +123,16 @@ void ApplyCountingFrame::run()
         connect(data.Task.get(), SIGNAL(progress(int, ApplySegmentationCountingFrame *)),
                 this,            SLOT(onTaskProgress(int, ApplySegmentationCountingFrame *)), Qt::DirectConnection);
 
-        connect(data.Task.get(), SIGNAL(finished()),
-                this,            SLOT(onTaskFinished()), Qt::DirectConnection);
-
         m_tasks[data.Task.get()] = data;
+        tasks << data.Task;
 
         Task::submit(data.Task);
       }
+
+      m_join = ContinuationTask::join(tasks, [this]() { onTasksFinished(); }, m_scheduler);
+
+      connect(m_join.get(), SIGNAL(aborted()),
+              this,         SLOT(onJoinAborted()), Qt::DirectConnection);
     }
 
     validExecution = !validSegmentations.isEmpty();
@@ -128,9 +140,22 @@ void ApplyCountingFrame::run()
 
   if(validExecution && canExecute())
   {
-    m_waitMutex.lock();
-    m_condition.wait(&m_waitMutex);
-    m_waitMutex.unlock();
+    m_scheduler->beginBlockingWait();
+
+    QMutexLocker lock(&m_waitMutex);
+    while(!m_tasksFinished && !isAborted() && !m_join->isAborted())
+    {
+      m_condition.wait(&m_waitMutex);
+    }
+    lock.unlock();
+
+    m_scheduler->endBlockingWait();
+  }
+
+  // the continuation could have been aborted before connecting to it.
+  if(m_join && m_join->isAborted())
+  {
+    onJoinAborted();
   }
 
   if(isAborted())
@@ -149,9 +174,6 @@ void ApplyCountingFrame::abortTasks()
     disconnect(task, SIGNAL(progress(int, ApplySegmentationCountingFrame *)),
                this, SLOT(onTaskProgress(int, ApplySegmentationCountingFrame *)));
 
-    disconnect(task, SIGNAL(finished()),
-               this, SLOT(onTaskFinished()));
-
     if(!task->hasFinished())
     {
       task->abort();
@@ -164,6 +186,16 @@ void ApplyCountingFrame::abortTasks()
   }
 
   m_tasks.clear();
+
+  if(m_join)
+  {
+    disconnect(m_join.get(), SIGNAL(aborted()),
+               this,         SLOT(onJoinAborted()));
+
+    if(!m_join->hasFinished()) m_join->abort();
+
+    m_join = nullptr;
+  }
 }
 
 //--------------------------------------------------------------------
@@ -192,23 +224,18 @@ void ApplyCountingFrame::onTaskProgress(int value, ApplySegmentationCountingFram
 }
 
 //--------------------------------------------------------------------
-void ApplyCountingFrame::onTaskFinished()
+void ApplyCountingFrame::onJoinAborted()
 {
-  if(isAborted())
-  {
-    m_condition.wakeAll();
-    return;
-  }
-
-  bool finished = true;
-  const auto tasks = m_tasks.keys();
-  std::for_each(tasks.constBegin(), tasks.constEnd(), [&finished](const ApplySegmentationCountingFrame *task) { finished &= task->hasFinished(); });
+  // wakes up the thread through onAbort().
+  abort();
+}
 
-  if(finished)
-  {
-    m_tasks.clear();
-    m_condition.wakeAll();
-  }
+//--------------------------------------------------------------------
+void ApplyCountingFrame::onTasksFinished()
+{
+  QMutexLocker lock(&m_waitMutex);
+  m_tasksFinished = true;
+  m_condition.wakeAll();
 }
 
 //--------------------------------------------------------------------
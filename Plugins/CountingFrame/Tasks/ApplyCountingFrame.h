@@ -121,14 +121,23 @@ namespace ESPINA
          */
         void onTaskProgress(int value, ApplySegmentationCountingFrame *task);
 
-        /** \brief Wakes up the thread when all the sub tasks have finished computation.
+        /** \brief Aborts the operation when the sub tasks continuation has been aborted, as it won't be
+         * executed when any of the sub tasks is aborted.
          *
          */
-        void onTaskFinished();
+        void onJoinAborted();
 
       private:
         void onAbort() override
-        { m_condition.wakeAll(); }
+        {
+          QMutexLocker lock(&m_waitMutex);
+          m_condition.wakeAll();
+        }
+
+        /** \brief Wakes up the thread when all the sub tasks have finished computation.
+         *
+         */
+        void onTasksFinished();
 
         /** \brief Aborts the computation tasks.
          *
@@ -139,6 +148,8 @@ namespace ESPINA
         Core::SegmentationExtensionFactorySPtr m_factory;       /** stereological inclusion factory.   */
         QMutex                                 m_waitMutex;     /** wait condition mutex.              */
         QWaitCondition                         m_condition;     /** wait condition to stop the thread. */
+        bool                                   m_tasksFinished; /** true if all sub tasks finished.    */
+        TaskSPtr                               m_join;          /** sub tasks continuation.            */
 
         using TaskType = std::shared_ptr<ApplySegmentationCountingFrame>;
 
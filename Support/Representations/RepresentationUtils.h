@@ -26,6 +26,7 @@
 #include <GUI/Representations/RepresentationState.h>
 #include <GUI/Representations/RepresentationPool.h>
 #include <Support/Representations/RepresentationFactory.h>
+#include <Support/Settings/Settings.h>
 
 // C++
 #include <memory>
@@ -58,6 +59,12 @@ namespace ESPINA
         inline bool isSegmentationRepresentation(const Representation &representation)
         { return SEGMENTATIONS_GROUP == representation.Group; }
 
+        /** \brief Returns the memory budget in bytes of the precomputed slices of a view plane, 0 for no limit.
+         *
+         */
+        inline unsigned long long slicesMemoryBudget()
+        { return ApplicationSettings().slicesMemoryBudget() * 1024ULL * 1024ULL; }
+
         /** \brief Returns a list of settings of the templated type present in the given context.
          * \param[in] context Application context data.
          *
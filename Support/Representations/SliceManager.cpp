@@ -33,12 +33,13 @@ SliceManager::SliceManager(RepresentationPoolSPtr poolXY,
                            RepresentationPoolSPtr poolXZ,
                            RepresentationPoolSPtr poolYZ,
                            ManagerFlags           flags)
-: PoolManager{ViewType::VIEW_2D, flags}
-, m_plane    {Plane::UNDEFINED}
-, m_depth    {0}
-, m_XY       {poolXY}
-, m_XZ       {poolXZ}
-, m_YZ       {poolYZ}
+: PoolManager {ViewType::VIEW_2D, flags}
+, m_plane     {Plane::UNDEFINED}
+, m_depth     {0}
+, m_resolution{0}
+, m_XY        {poolXY}
+, m_XZ        {poolXZ}
+, m_YZ        {poolYZ}
 {
 }
 
@@ -79,6 +80,22 @@ void SliceManager::setRepresentationDepth(Nm depth)
   }
 }
 
+//----------------------------------------------------------------------------
+void SliceManager::setDisplayResolution(Nm resolution)
+{
+  if(m_resolution != resolution)
+  {
+    m_resolution = resolution;
+
+    if(supportsDisplayResolution())
+    {
+      auto pool = planePool();
+
+      GUI::RepresentationUtils::setDisplayResolution(pool, m_resolution);
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 bool SliceManager::acceptCrosshairChange(const NmVector3 &crosshair) const
 {
@@ -148,6 +165,11 @@ void SliceManager::onShow(const FrameCSPtr frame)
   GUI::RepresentationUtils::setPlane(pool, m_plane);
   GUI::RepresentationUtils::setSegmentationDepth(pool, m_depth);
 
+  if(supportsDisplayResolution())
+  {
+    GUI::RepresentationUtils::setDisplayResolution(pool, m_resolution);
+  }
+
   connectPools();
 }
 
@@ -192,7 +214,8 @@ RepresentationManagerSPtr SliceManager::cloneImplementation()
 {
   auto clone = std::make_shared<SliceManager>(m_XY, m_XZ, m_YZ, flags());
 
-  clone->m_plane = m_plane;
+  clone->m_plane      = m_plane;
+  clone->m_resolution = m_resolution;
 
   return clone;
 }
@@ -231,6 +254,13 @@ RepresentationPoolSList SliceManager::pools() const
   return result;
 }
 
+//----------------------------------------------------------------------------
+bool SliceManager::supportsDisplayResolution() const
+{
+  // channel pyramids only reduce the resolution of the axial plane.
+  return (Plane::XY == m_plane) && (planePool()->type() == ItemAdapter::Type::CHANNEL);
+}
+
 //----------------------------------------------------------------------------
 Nm SliceManager::normalCoordinate(const NmVector3 &point) const
 {
@@ -61,6 +61,8 @@ namespace ESPINA
 
       virtual void setRepresentationDepth(Nm depth) override;
 
+      virtual void setDisplayResolution(Nm resolution) override;
+
       virtual RepresentationPoolSList pools() const override;
 
     protected:
@@ -107,6 +109,11 @@ namespace ESPINA
        */
       bool validPlane() const;
 
+      /** \brief Returns true if the manager representations can be shown at lower resolutions.
+       *
+       */
+      bool supportsDisplayResolution() const;
+
       /** \brief Returns the normal coordinate for the given point according to the configured plane.
        * \param[in] point point coordinates.
        *
@@ -114,11 +121,12 @@ namespace ESPINA
       Nm normalCoordinate(const NmVector3 &point) const;
 
     private:
-      Plane                  m_plane; /** plane of the manager.                                         */
-      Nm                     m_depth; /** distance from the plane position to show the representations. */
-      RepresentationPoolSPtr m_XY;    /** Axial plane pool.                                             */
-      RepresentationPoolSPtr m_XZ;    /** Coronal plane pool.                                           */
-      RepresentationPoolSPtr m_YZ;    /** Sagittal plane pool.                                          */
+      Plane                  m_plane;      /** plane of the manager.                                         */
+      Nm                     m_depth;      /** distance from the plane position to show the representations. */
+      Nm                     m_resolution; /** size in Nm of a display pixel.                                */
+      RepresentationPoolSPtr m_XY;         /** Axial plane pool.                                             */
+      RepresentationPoolSPtr m_XZ;         /** Coronal plane pool.                                           */
+      RepresentationPoolSPtr m_YZ;         /** Sagittal plane pool.                                          */
   };
 }
 
@@ -20,6 +20,7 @@
  */
 
 #include <Core/Utils/EspinaException.h>
+#include <Core/IO/SegFile.h>
 #include <Support/Settings/Settings.h>
 #include <Support/Settings/Settings.h>
 
@@ -32,6 +33,8 @@ const QString ApplicationSettings::TEMPORAL_STORAGE_PATH_KEY = "Temporal Storage
 const QString ApplicationSettings::USER_NAME                 = "UserName";
 const QString ApplicationSettings::PERFORM_ANALYSIS_CHECK    = "Perform analysis check on load";
 const QString ApplicationSettings::CHECK_PERIODICITY_KEY     = "Last update check time";
+const QString ApplicationSettings::VOLUME_CODEC_KEY          = "SEG volume codec";
+const QString ApplicationSettings::SLICES_MEMORY_BUDGET_KEY  = "Slices memory budget";
 
 //-----------------------------------------------------------------------------
 ApplicationSettings::ApplicationSettings()
@@ -42,11 +45,22 @@ ApplicationSettings::ApplicationSettings()
   m_temporalStoragePath    = settings.value(TEMPORAL_STORAGE_PATH_KEY, QDir::tempPath()).toString();
   m_performAnalysisCheck   = settings.value(PERFORM_ANALYSIS_CHECK, true).toBool();
   m_updateCheckPeriodicity = static_cast<UpdateCheckPeriodicity>(settings.value(CHECK_PERIODICITY_KEY, 0).toInt());
+  m_slicesMemoryBudget     = settings.value(SLICES_MEMORY_BUDGET_KEY, 256).toUInt();
 
   if(!QDir{m_temporalStoragePath}.exists())
   {
     setTemporalPath(QDir::tempPath());
   }
+
+  m_volumeCodec = static_cast<IO::VolumeCodec::Type>(settings.value(VOLUME_CODEC_KEY, 0).toInt());
+
+  // the codec may have been set by a build with more codecs available.
+  if(!IO::VolumeCodec::isAvailable(m_volumeCodec))
+  {
+    m_volumeCodec = IO::VolumeCodec::Type::DEFLATE;
+  }
+
+  IO::SegFile::setVolumeCodec(m_volumeCodec);
 }
 
 //-----------------------------------------------------------------------------
@@ -111,3 +125,23 @@ void ESPINA::Support::ApplicationSettings::setUpdateCheckPeriodicity(const Updat
   ESPINA_SETTINGS(settings);
   settings.setValue(CHECK_PERIODICITY_KEY, static_cast<int>(m_updateCheckPeriodicity));
 }
+
+//-----------------------------------------------------------------------------
+void ApplicationSettings::setVolumeCodec(const IO::VolumeCodec::Type codec)
+{
+  IO::SegFile::setVolumeCodec(codec);
+
+  m_volumeCodec = codec;
+
+  ESPINA_SETTINGS(settings);
+  settings.setValue(VOLUME_CODEC_KEY, static_cast<int>(m_volumeCodec));
+}
+
+//-----------------------------------------------------------------------------
+void ApplicationSettings::setSlicesMemoryBudget(const unsigned int megabytes)
+{
+  m_slicesMemoryBudget = megabytes;
+
+  ESPINA_SETTINGS(settings);
+  settings.setValue(SLICES_MEMORY_BUDGET_KEY, m_slicesMemoryBudget);
+}
@@ -24,6 +24,9 @@
 
 #include <Support/EspinaSupport_Export.h>
 
+// ESPINA
+#include <Core/IO/VolumeCodec.h>
+
 // Qt
 #include <QSettings>
 #include <QString>
@@ -127,6 +130,33 @@ namespace ESPINA
         const UpdateCheckPeriodicity updateCheckPeriodicity() const
         { return m_updateCheckPeriodicity; }
 
+        /** \brief Sets the codec of the volumetric data of the saved SEG files. Throws exception if the
+         * codec isn't available in this build.
+         * \param[in] codec codec type.
+         *
+         */
+        void setVolumeCodec(const IO::VolumeCodec::Type codec);
+
+        /** \brief Returns the codec of the volumetric data of the saved SEG files.
+         *
+         */
+        const IO::VolumeCodec::Type volumeCodec() const
+        { return m_volumeCodec; }
+
+        /** \brief Sets the maximum memory used by the precomputed slices of each view plane.
+         * Applied to the views created after the change.
+         * \param[in] megabytes memory budget in megabytes, 0 for no limit.
+         *
+         */
+        void setSlicesMemoryBudget(const unsigned int megabytes);
+
+        /** \brief Returns the maximum memory in megabytes used by the precomputed slices of each view
+         * plane, 0 for no limit.
+         *
+         */
+        const unsigned int slicesMemoryBudget() const
+        { return m_slicesMemoryBudget; }
+
       private:
         static const QString LOAD_SEG_SETTINGS_KEY;
         static const QString TEMPORAL_STORAGE_PATH_KEY;
@@ -134,12 +164,16 @@ namespace ESPINA
         static const QString PERFORM_ANALYSIS_CHECK;
         static const QString PERFORM_UPDATE_CHECK;
         static const QString CHECK_PERIODICITY_KEY;
+        static const QString VOLUME_CODEC_KEY;
+        static const QString SLICES_MEMORY_BUDGET_KEY;
 
         QString                m_userName;               /** user name.                                                                        */
         bool                   m_loadSEGSettings;        /** true to load tool and representation settings from the SEG file, false otherwise. */
         QString                m_temporalStoragePath;    /** path for temporal storate.                                                        */
         bool                   m_performAnalysisCheck;   /** true to perform checks after loading a SEG file, false otherwise.                 */
         UpdateCheckPeriodicity m_updateCheckPeriodicity; /** frequency of update checks.                                                       */
+        IO::VolumeCodec::Type  m_volumeCodec;            /** codec of the volumetric data of saved SEG files.                                  */
+        unsigned int           m_slicesMemoryBudget;     /** memory budget of the precomputed slices of a view plane in megabytes.             */
     };
 
     using GeneralSettingsSPtr = std::shared_ptr<ApplicationSettings>;
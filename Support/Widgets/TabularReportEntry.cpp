@@ -338,6 +338,7 @@ void TabularReport::Entry::refreshGUIImplementation()
   progressLabel->setVisible(inProgress);
   progressBar->setVisible(inProgress);
   progressBar->setValue(progress);
+  progressBar->setToolTip(tr("%1 segmentations/s").arg(m_proxy->throughput(), 0, 'f', 1));
 
   if (exportInformation->isEnabled() == inProgress)
   {
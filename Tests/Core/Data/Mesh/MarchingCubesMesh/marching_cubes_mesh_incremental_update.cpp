@@ -0,0 +1,140 @@
+/*
+ File: marching_cubes_mesh_incremental_update.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Analysis/Data/Mesh/MarchingCubesMesh.h>
+#include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include "testing_support_dummy_filter.h"
+
+// VTK
+#include <vtkDiscreteMarchingCubes.h>
+#include <vtkImageConstantPad.h>
+
+using ESPINA::Testing::DummyFilter;
+
+using namespace ESPINA;
+using namespace std;
+
+namespace
+{
+  /** \brief Returns the surface of the whole volume computed at once.
+   *
+   */
+  vtkSmartPointer<vtkPolyData> referenceMesh(OutputSPtr output)
+  {
+    auto volume = readLockVolume(output, DataUpdatePolicy::Ignore);
+    auto image  = vtkImage(volume, volume->bounds());
+
+    int extent[6];
+    image->GetExtent(extent);
+
+    auto padding = vtkSmartPointer<vtkImageConstantPad>::New();
+    padding->SetInputData(image);
+    padding->SetOutputWholeExtent(extent[0]-1, extent[1]+1, extent[2]-1, extent[3]+1, extent[4]-1, extent[5]+1);
+    padding->SetConstant(0);
+    padding->UpdateWholeExtent();
+
+    auto marchingCubes = vtkSmartPointer<vtkDiscreteMarchingCubes>::New();
+    marchingCubes->GenerateValues(1, SEG_VOXEL_VALUE, SEG_VOXEL_VALUE);
+    marchingCubes->ComputeScalarsOff();
+    marchingCubes->ComputeNormalsOff();
+    marchingCubes->ComputeGradientsOff();
+    marchingCubes->SetInputData(padding->GetOutput());
+    marchingCubes->UpdateWholeExtent();
+
+    return marchingCubes->GetOutput();
+  }
+
+  bool checkMesh(const MarchingCubesMesh &mesh, OutputSPtr output, const QString &step)
+  {
+    auto polyData  = mesh.mesh();
+    auto reference = referenceMesh(output);
+
+    if(polyData->GetNumberOfCells() != reference->GetNumberOfCells() || polyData->GetNumberOfPoints() != reference->GetNumberOfPoints())
+    {
+      cerr << step.toStdString() << ": mesh has " << polyData->GetNumberOfCells() << " cells and " << polyData->GetNumberOfPoints()
+           << " points, expected " << reference->GetNumberOfCells() << " cells and " << reference->GetNumberOfPoints() << " points." << endl;
+      return false;
+    }
+
+    double bounds[6], referenceBounds[6];
+    polyData->GetBounds(bounds);
+    reference->GetBounds(referenceBounds);
+
+    for(auto i: {0, 1, 2, 3, 4, 5})
+    {
+      if(bounds[i] != referenceBounds[i])
+      {
+        cerr << step.toStdString() << ": unexpected mesh bounds." << endl;
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
+
+int marching_cubes_mesh_incremental_update(int argc, char** argv)
+{
+  bool error = false;
+
+  NmVector3 spacing{1, 1, 2};
+
+  DummyFilter filter;
+  auto output = std::make_shared<Output>(&filter, 0, spacing);
+  auto volume = std::make_shared<SparseVolume<itkVolumeType>>(Bounds{-0.5, 99.5, -0.5, 99.5, -1, 199}, spacing);
+
+  output->setData(volume);
+
+  MarchingCubesMesh mesh(output.get());
+
+  // initial surface, touching the volume limits.
+  volume->draw(Bounds{-0.5, 20.5, 9.5, 20.5, 9, 41}, SEG_VOXEL_VALUE);
+  error |= !checkMesh(mesh, output, "Initial surface");
+
+  // edition crossing several blocks.
+  volume->draw(Bounds{25.5, 70.5, 15.5, 40.5, 51, 81}, SEG_VOXEL_VALUE);
+  error |= !checkMesh(mesh, output, "Crossing blocks edition");
+
+  // edition on the limits of a block.
+  volume->draw(Bounds{MarchingCubesMesh::BLOCK_SIZE - 0.5, MarchingCubesMesh::BLOCK_SIZE + 0.5, 60.5, 61.5, 99, 101}, SEG_VOXEL_VALUE);
+  error |= !checkMesh(mesh, output, "Block limit edition");
+
+  // several editions between updates, erasing part of the previous ones.
+  volume->draw(Bounds{30.5, 50.5, 20.5, 30.5, 61, 71}, SEG_BG_VALUE);
+  volume->draw(Bounds{80.5, 99.5, 80.5, 99.5, 179, 199}, SEG_VOXEL_VALUE);
+  error |= !checkMesh(mesh, output, "Multiple editions");
+
+  // erasing everything.
+  volume->draw(volume->bounds().bounds(), SEG_BG_VALUE);
+  if(mesh.mesh()->GetNumberOfCells() != 0)
+  {
+    cerr << "Mesh of an empty volume has " << mesh.mesh()->GetNumberOfCells() << " cells." << endl;
+    error = true;
+  }
+
+  // changes without edited regions compute the whole surface.
+  volume->draw(Bounds{40.5, 60.5, 40.5, 60.5, 79, 121}, SEG_VOXEL_VALUE);
+  mesh.mesh();
+  volume->clearEditedRegions();
+  volume->draw(Bounds{10.5, 20.5, 10.5, 20.5, 19, 41}, SEG_VOXEL_VALUE);
+  error |= !checkMesh(mesh, output, "Cleared edited regions");
+
+  return error;
+}
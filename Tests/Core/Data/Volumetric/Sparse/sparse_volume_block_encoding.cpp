@@ -0,0 +1,134 @@
+/*
+ File: sparse_volume_block_encoding.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Data/Volumetric/SparseVolume.hxx"
+#include "Tests/Testing_Support.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Testing;
+
+typedef unsigned char VoxelType;
+typedef itk::Image<VoxelType, 3> ImageType;
+
+int sparse_volume_block_encoding(int argc, char** argv)
+{
+  bool pass = true;
+
+  const VoxelType bg = 0;
+  const VoxelType fg = 255;
+
+  const size_t denseBlockSize = 25*25*25*sizeof(VoxelType);
+
+  Bounds bounds{-0.5, 149.5, -0.5, 149.5, -0.5, 149.5};
+  SparseVolume<ImageType> canvas(bounds);
+
+  // a completely filled volume only stores one value per block.
+  canvas.draw(bounds, fg);
+
+  if (canvas.memoryUsage() != 216*sizeof(VoxelType))
+  {
+    cerr << "Uniform blocks should only store their value, memory usage: " << canvas.memoryUsage() << endl;
+    pass = false;
+  }
+
+  if (!Testing_Support<ImageType>::Test_Pixel_Values(canvas.itkImage(), fg))
+  {
+    cerr << "Pixel values of uniform blocks should be " << fg << endl;
+    pass = false;
+  }
+
+  canvas.draw(bounds, bg);
+
+  if (canvas.memoryUsage() != 0 || !canvas.isEmpty())
+  {
+    cerr << "Erased volume shouldn't have blocks" << endl;
+    pass = false;
+  }
+
+  // a sphere has uniform blocks inside and RLE blocks on its surface.
+  auto sphere = vtkSmartPointer<vtkSphere>::New();
+  sphere->SetCenter(75, 75, 75);
+  sphere->SetRadius(70);
+
+  canvas.draw(sphere, bounds, fg);
+
+  size_t numberOfBlocks = 0;
+  auto image = canvas.itkImage();
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  while(!it.IsAtEnd())
+  {
+    auto index = it.GetIndex();
+    // brushes are evaluated at the voxel centers.
+    auto inside = sphere->FunctionValue(index[0] + 0.5, index[1] + 0.5, index[2] + 0.5) <= 0;
+
+    if ((it.Value() == fg) != inside)
+    {
+      cerr << "Unexpected value " << static_cast<int>(it.Value()) << " at " << index << endl;
+      pass = false;
+      break;
+    }
+
+    ++it;
+  }
+
+  for (int i = 0; i < 6; ++i)
+  {
+    for (int j = 0; j < 6; ++j)
+    {
+      for (int k = 0; k < 6; ++k)
+      {
+        Bounds blockBounds{i*25 - 0.5, (i+1)*25 - 0.5, j*25 - 0.5, (j+1)*25 - 0.5, k*25 - 0.5, (k+1)*25 - 0.5};
+
+        if (!Testing_Support<ImageType>::Test_Pixel_Values(canvas.itkImage(blockBounds), bg, blockBounds))
+        {
+          ++numberOfBlocks;
+        }
+      }
+    }
+  }
+
+  if (canvas.memoryUsage() >= numberOfBlocks * denseBlockSize / 2)
+  {
+    cerr << "Sphere blocks haven't been compressed, memory usage: " << canvas.memoryUsage() << endl;
+    pass = false;
+  }
+
+  // reading a region inside a block must decode only that region.
+  Bounds center{69.5, 80.5, 69.5, 80.5, 69.5, 80.5};
+  if (!Testing_Support<ImageType>::Test_Pixel_Values(canvas.itkImage(center), fg, center))
+  {
+    cerr << "Pixel values inside " << center << " should be " << fg << endl;
+    pass = false;
+  }
+
+  canvas.draw(sphere, bounds, bg);
+
+  if (!canvas.isEmpty() || canvas.memoryUsage() != 0)
+  {
+    cerr << "Erased sphere shouldn't leave blocks" << endl;
+    pass = false;
+  }
+
+  return !pass;
+}
@@ -0,0 +1,238 @@
+/*
+ File: sparse_volume_block_index_benchmark.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Data/Volumetric/SparseVolume.hxx"
+#include "Tests/Testing_Support.h"
+
+// Qt
+#include <QMap>
+
+// C++
+#include <chrono>
+#include <random>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Testing;
+
+typedef unsigned char VoxelType;
+typedef itk::Image<VoxelType, 3> ImageType;
+
+namespace
+{
+  const VoxelType    BG         = 0;
+  const VoxelType    FG         = 255;
+  const unsigned int BLOCK_SIZE = 25;
+
+  /** \class OrderedMapBlocks
+   * \brief Block storage with the previous SparseVolume layout: an ordered map of block indexes
+   * and a new image allocated for every created block. Spacing 1 and origin 0.
+   *
+   */
+  class OrderedMapBlocks
+  {
+    public:
+      void draw(const Bounds &bounds, const VoxelType value)
+      {
+        for(auto index: blockIndexes(bounds))
+        {
+          if(!m_blocks.contains(index))
+          {
+            if(value == BG) continue;
+
+            m_blocks[index] = create_itkImage<ImageType>(blockBounds(index), BG);
+          }
+
+          auto block = m_blocks[index];
+          auto it    = itkImageIterator<ImageType>(block, intersection(equivalentBounds<ImageType>(block), bounds));
+          while(!it.IsAtEnd())
+          {
+            it.Set(value);
+            ++it;
+          }
+
+          if(value == BG && isEmpty(block))
+          {
+            m_blocks[index] = nullptr;
+            m_blocks.remove(index);
+          }
+        }
+      }
+
+      ImageType::Pointer read(const Bounds &bounds) const
+      {
+        auto image = create_itkImage<ImageType>(bounds, BG);
+
+        for(auto index: blockIndexes(bounds))
+        {
+          if(!m_blocks.contains(index)) continue;
+
+          auto block = m_blocks[index];
+          copy_image<ImageType>(block, image, intersection(equivalentBounds<ImageType>(block), bounds));
+        }
+
+        return image;
+      }
+
+    private:
+      static QList<lliVector3> blockIndexes(const Bounds &bounds)
+      {
+        QList<lliVector3> result;
+
+        auto region = equivalentRegion<ImageType>(NmVector3{0,0,0}, NmVector3{1,1,1}, bounds);
+
+        lliVector3 minimum, maximum;
+        for(int i = 0; i < 3; ++i)
+        {
+          minimum[i] = vtkMath::Floor(region.GetIndex(i)/static_cast<double>(BLOCK_SIZE));
+          maximum[i] = vtkMath::Ceil((region.GetIndex(i) + static_cast<int>(region.GetSize(i)))/static_cast<double>(BLOCK_SIZE));
+        }
+
+        for(auto i = minimum[0]; i < maximum[0]; ++i)
+          for(auto j = minimum[1]; j < maximum[1]; ++j)
+            for(auto k = minimum[2]; k < maximum[2]; ++k)
+              result << lliVector3{i,j,k};
+
+        return result;
+      }
+
+      static Bounds blockBounds(const lliVector3 &index)
+      {
+        return Bounds{index[0] * BLOCK_SIZE - 0.5, (index[0] + 1) * BLOCK_SIZE - 0.5,
+                      index[1] * BLOCK_SIZE - 0.5, (index[1] + 1) * BLOCK_SIZE - 0.5,
+                      index[2] * BLOCK_SIZE - 0.5, (index[2] + 1) * BLOCK_SIZE - 0.5};
+      }
+
+      static bool isEmpty(ImageType::Pointer block)
+      {
+        itk::ImageRegionConstIterator<ImageType> it(block, block->GetLargestPossibleRegion());
+        while(!it.IsAtEnd())
+        {
+          if(it.Value() != BG) return false;
+          ++it;
+        }
+
+        return true;
+      }
+
+      QMap<lliVector3, ImageType::Pointer> m_blocks;
+  };
+
+  Bounds randomBox(std::mt19937 &generator, const Bounds &volume)
+  {
+    std::uniform_int_distribution<int> size(5, 40);
+
+    Bounds box;
+    for(int i = 0; i < 3; ++i)
+    {
+      auto extent = size(generator);
+      std::uniform_int_distribution<int> start(0, static_cast<int>(volume[2*i+1] - volume[2*i]) - extent);
+
+      box[2*i]   = start(generator) - 0.5;
+      box[2*i+1] = box[2*i] + extent;
+    }
+
+    return box;
+  }
+
+  double throughput(unsigned int operations, const std::chrono::steady_clock::time_point &start)
+  {
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return operations/std::max(elapsed, 1e-9);
+  }
+}
+
+int sparse_volume_block_index_benchmark(int argc, char** argv)
+{
+  bool pass = true;
+
+  const unsigned int NUM_DRAWS  = 500;
+  const unsigned int NUM_ERASES = 250;
+  const unsigned int NUM_READS  = 500;
+
+  Bounds bounds{-0.5, 499.5, -0.5, 499.5, -0.5, 99.5};
+
+  SparseVolume<ImageType> sparse(bounds);
+  OrderedMapBlocks        reference;
+
+  std::mt19937 generator(25);
+
+  QList<Bounds> draws, erases, reads;
+  for(unsigned int i = 0; i < NUM_DRAWS;  ++i) draws  << randomBox(generator, bounds);
+  for(unsigned int i = 0; i < NUM_ERASES; ++i) erases << randomBox(generator, bounds);
+  for(unsigned int i = 0; i < NUM_READS;  ++i) reads  << randomBox(generator, bounds);
+
+  auto start = std::chrono::steady_clock::now();
+  for(auto box: draws)  reference.draw(box, FG);
+  for(auto box: erases) reference.draw(box, BG);
+  auto referenceDraw = throughput(NUM_DRAWS + NUM_ERASES, start);
+
+  start = std::chrono::steady_clock::now();
+  for(auto box: draws)  sparse.draw(box, FG);
+  for(auto box: erases) sparse.draw(box, BG);
+  auto sparseDraw = throughput(NUM_DRAWS + NUM_ERASES, start);
+
+  start = std::chrono::steady_clock::now();
+  for(auto box: reads) reference.read(box);
+  auto referenceRead = throughput(NUM_READS, start);
+
+  start = std::chrono::steady_clock::now();
+  for(auto box: reads) sparse.itkImage(box);
+  auto sparseRead = throughput(NUM_READS, start);
+
+  cout << "Draw throughput (boxes/s): ordered map " << referenceDraw << ", hash index " << sparseDraw << endl;
+  cout << "Read throughput (boxes/s): ordered map " << referenceRead << ", hash index " << sparseRead << endl;
+
+  auto expected = reference.read(bounds);
+  auto image    = sparse.itkImage(bounds);
+
+  itk::ImageRegionConstIterator<ImageType> eit(expected, expected->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> iit(image,    image->GetLargestPossibleRegion());
+  while(!eit.IsAtEnd() && pass)
+  {
+    if(eit.Value() != iit.Value())
+    {
+      cerr << "Sparse volume content differs from reference at " << eit.GetIndex() << endl;
+      pass = false;
+    }
+
+    ++eit;
+    ++iit;
+  }
+
+  // erasing a whole block must return it to the pool.
+  Bounds block{-0.5, 24.5, -0.5, 24.5, -0.5, 24.5};
+  sparse.draw(block, FG);
+  sparse.draw(block, BG);
+
+  if(SparseVolumeBlockPool<ImageType>::instance().size() == 0)
+  {
+    cerr << "Released blocks are not being recycled" << endl;
+    pass = false;
+  }
+
+  if (!Testing_Support<ImageType>::Test_Pixel_Values(sparse.itkImage(block), BG, block))
+  {
+    cerr << "Pixel values inside " << block << " should be " << BG << endl;
+    pass = false;
+  }
+
+  return !pass;
+}
@@ -0,0 +1,191 @@
+/*
+ File: mappedVolume_read.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Data/Volumetric/MappedVolume.hxx"
+
+// ITK
+#include <itkImageFileWriter.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+using namespace ESPINA;
+using namespace ESPINA::Core;
+using namespace ESPINA::Core::Utils;
+using namespace std;
+
+using ImageType = itk::Image<unsigned short, 3>;
+
+namespace
+{
+  unsigned short voxelValue(const ImageType::IndexType &index)
+  {
+    return index[0] + 2*index[1] + 3*index[2];
+  }
+
+  void writeImage(const QString &fileName, const bool compressed)
+  {
+    ImageType::RegionType region;
+    region.SetIndex(0, 0);
+    region.SetIndex(1, 0);
+    region.SetIndex(2, 0);
+    region.SetSize(0, 50);
+    region.SetSize(1, 40);
+    region.SetSize(2, 30);
+
+    auto image = ImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+    while(!it.IsAtEnd())
+    {
+      it.Set(voxelValue(it.GetIndex()));
+      ++it;
+    }
+
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetFileName(fileName.toStdString());
+    writer->SetInput(image);
+    writer->SetUseCompression(compressed);
+    writer->Update();
+  }
+
+  bool checkRegion(const MappedVolume<ImageType> &volume, const ImageType::RegionType &region)
+  {
+    auto image = volume.read(region);
+
+    if(image->GetLargestPossibleRegion() != region)
+    {
+      cerr << "Unexpected image region " << image->GetLargestPossibleRegion() << endl;
+      return false;
+    }
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, region);
+    while(!it.IsAtEnd())
+    {
+      if(it.Value() != voxelValue(it.GetIndex()))
+      {
+        cerr << "Invalid value " << it.Value() << " at " << it.GetIndex() << endl;
+        return false;
+      }
+
+      ++it;
+    }
+
+    return true;
+  }
+
+  ImageType::RegionType createRegion(long x, long y, long z, unsigned long w, unsigned long h, unsigned long d)
+  {
+    ImageType::RegionType region;
+    region.SetIndex(0, x);
+    region.SetIndex(1, y);
+    region.SetIndex(2, z);
+    region.SetSize(0, w);
+    region.SetSize(1, h);
+    region.SetSize(2, d);
+
+    return region;
+  }
+}
+
+int mappedVolume_read(int argc, char** argv)
+{
+  bool pass = true;
+
+  auto dir = QDir::current();
+
+  for(auto compressed: {false, true})
+  {
+    auto header = dir.absoluteFilePath(compressed ? "mappedCompressed.mhd" : "mapped.mhd");
+    auto data   = dir.absoluteFilePath(compressed ? "mappedCompressed.zraw" : "mapped.raw");
+
+    try
+    {
+      writeImage(header, compressed);
+
+      MappedVolume<ImageType> volume(QFileInfo{header});
+
+      if(volume.isMapped() == compressed)
+      {
+        cerr << "Compressed files can't be mapped and uncompressed files should be. Compressed: " << compressed << endl;
+        pass = false;
+      }
+
+      // complete slices are contiguous in the file.
+      auto slice = createRegion(0, 0, 7, 50, 40, 1);
+      pass &= checkRegion(volume, slice);
+
+      if(volume.isMapped())
+      {
+        auto first  = volume.read(slice);
+        auto second = volume.read(slice);
+
+        if(first->GetBufferPointer() != second->GetBufferPointer())
+        {
+          cerr << "Contiguous regions should be views of the mapped file" << endl;
+          pass = false;
+        }
+      }
+
+      // rows and groups of slices are also contiguous.
+      pass &= checkRegion(volume, createRegion(0, 12, 3, 50, 5, 1));
+      pass &= checkRegion(volume, createRegion(0, 0, 10, 50, 40, 4));
+
+      // sub-regions are copied.
+      pass &= checkRegion(volume, createRegion(10, 5, 2, 20, 30, 6));
+      pass &= checkRegion(volume, createRegion(49, 39, 29, 1, 1, 1));
+
+      // the buffer must stay valid after the volume is destroyed.
+      ImageType::Pointer view;
+      {
+        MappedVolume<ImageType> other(QFileInfo{header});
+        view = other.read(slice);
+      }
+
+      itk::ImageRegionConstIteratorWithIndex<ImageType> it(view, slice);
+      while(!it.IsAtEnd())
+      {
+        if(it.Value() != voxelValue(it.GetIndex()))
+        {
+          cerr << "Invalid value " << it.Value() << " at " << it.GetIndex() << " after destroying the volume" << endl;
+          pass = false;
+          break;
+        }
+
+        ++it;
+      }
+    }
+    catch(const EspinaException &excp)
+    {
+      qDebug() << "exception:" << excp.what();
+      qDebug() << "details:" << excp.details();
+      pass = false;
+    }
+    catch(const itk::ExceptionObject &excp)
+    {
+      qDebug() << "exception:" << QString(excp.what());
+      pass = false;
+    }
+
+    QFile::remove(header);
+    QFile::remove(data);
+  }
+
+  return !pass;
+}
@@ -0,0 +1,282 @@
+/*
+ File: streamedVolume_tile_cache.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Data/Volumetric/StreamedVolume.hxx"
+#include "Core/Analysis/Data/Volumetric/WritableStreamedVolume.hxx"
+#include "Core/Analysis/Data/Volumetric/StreamedTileCache.h"
+
+// ITK
+#include <itkImageRegionIteratorWithIndex.h>
+
+// Qt
+#include <QThreadPool>
+
+using namespace ESPINA;
+using namespace ESPINA::Core;
+using namespace ESPINA::Core::Utils;
+using namespace std;
+
+using ImageType = itk::Image<unsigned short, 3>;
+
+namespace
+{
+  ImageType::RegionType sliceRegion(const ImageType::RegionType &region, const unsigned int slice)
+  {
+    auto result = region;
+    result.SetIndex(2, region.GetIndex(2) + slice);
+    result.SetSize(2, 1);
+
+    return result;
+  }
+
+  bool checkSlice(ImageType::Pointer image, const unsigned int slice, const unsigned short offset)
+  {
+    itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+    while(!it.IsAtEnd())
+    {
+      auto index = it.GetIndex();
+      if(it.Value() != static_cast<unsigned short>(index[0] + index[1] + slice + offset))
+      {
+        cerr << "Invalid value " << it.Value() << " at " << index << " of slice " << slice << endl;
+        return false;
+      }
+
+      ++it;
+    }
+
+    return true;
+  }
+}
+
+int streamedVolume_tile_cache(int argc, char** argv)
+{
+  bool pass = true;
+
+  auto dir      = QDir::current();
+  auto filename = dir.absoluteFilePath("tileCache.mhd");
+  auto info     = QFileInfo(filename);
+
+  auto &cache = StreamedTileCache::instance();
+  cache.clear();
+  cache.setReadAhead(0);
+
+  const unsigned int SLICES = 6;
+
+  ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetIndex(2, 0);
+  region.SetSize(0, 300);
+  region.SetSize(1, 280);
+  region.SetSize(2, SLICES);
+
+  ImageType::SpacingType spacing;
+  spacing.Fill(1);
+
+  // 300x280 slices are stored in 4 tiles.
+  const unsigned int TILES_PER_SLICE = 4;
+
+  try
+  {
+    auto writable = std::make_shared<WritableStreamedVolume<ImageType>>(info, region, spacing);
+
+    for(unsigned int slice = 0; slice < SLICES; ++slice)
+    {
+      auto image = writable->read(sliceRegion(region, slice));
+
+      itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+      while(!it.IsAtEnd())
+      {
+        auto index = it.GetIndex();
+        it.Set(index[0] + index[1] + slice);
+        ++it;
+      }
+
+      writable->write(image);
+    }
+
+    info.refresh();
+    auto volume = std::make_shared<StreamedVolume<ImageType>>(info);
+
+    auto before = cache.statistics();
+
+    for(unsigned int slice = 0; slice < SLICES; ++slice)
+    {
+      pass &= checkSlice(volume->read(sliceRegion(region, slice)), slice, 0);
+    }
+
+    auto after = cache.statistics();
+    if(after.misses - before.misses != SLICES * TILES_PER_SLICE || after.hits != before.hits)
+    {
+      cerr << "Unexpected misses reading a non cached volume: " << after.misses - before.misses << endl;
+      pass = false;
+    }
+
+    // the returned images are copies, modifying them must not modify the cache.
+    auto modified = volume->read(sliceRegion(region, 0));
+    modified->FillBuffer(0);
+
+    before = cache.statistics();
+
+    for(unsigned int slice = 0; slice < SLICES; ++slice)
+    {
+      pass &= checkSlice(volume->read(sliceRegion(region, slice)), slice, 0);
+    }
+
+    after = cache.statistics();
+    if(after.hits - before.hits != SLICES * TILES_PER_SLICE || after.misses != before.misses)
+    {
+      cerr << "Unexpected misses reading a cached volume: " << after.misses - before.misses << endl;
+      pass = false;
+    }
+
+    // a region inside a tile only uses that tile.
+    auto inner = sliceRegion(region, 2);
+    inner.SetIndex(0, 10);
+    inner.SetIndex(1, 20);
+    inner.SetSize(0, 30);
+    inner.SetSize(1, 40);
+
+    before = cache.statistics();
+    pass &= checkSlice(volume->read(inner), 2, 0);
+    after = cache.statistics();
+
+    if(after.hits - before.hits != 1)
+    {
+      cerr << "Unexpected number of tiles used reading a region inside a tile: " << after.hits - before.hits << endl;
+      pass = false;
+    }
+
+    // writes invalidate the cached tiles.
+    auto image = writable->read(sliceRegion(region, 1));
+    itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+    while(!it.IsAtEnd())
+    {
+      it.Set(it.Value() + 7);
+      ++it;
+    }
+    writable->write(image);
+
+    pass &= checkSlice(volume->read(sliceRegion(region, 1)), 1, 7);
+    pass &= checkSlice(volume->read(sliceRegion(region, 0)), 0, 0);
+
+    // read-ahead loads the next slices in the browsing direction.
+    cache.clear();
+    cache.setReadAhead(2);
+
+    volume->read(sliceRegion(region, 1));
+    volume->read(sliceRegion(region, 2));
+    QThreadPool::globalInstance()->waitForDone();
+
+    before = cache.statistics();
+    volume->read(sliceRegion(region, 3));
+    volume->read(sliceRegion(region, 4));
+    after = cache.statistics();
+
+    if(after.misses != before.misses)
+    {
+      cerr << "Read-ahead slices weren't cached, misses: " << after.misses - before.misses << endl;
+      pass = false;
+    }
+
+    QThreadPool::globalInstance()->waitForDone();
+    cache.setReadAhead(0);
+
+    // XZ planes are read directly, without reading or evicting the tiles.
+    auto plane = region;
+    plane.SetIndex(1, 5);
+    plane.SetSize(1, 1);
+
+    before = cache.statistics();
+    auto usage = cache.memoryUsage();
+    auto planeImage = volume->read(plane);
+    after = cache.statistics();
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> planeIt(planeImage, plane);
+    while(!planeIt.IsAtEnd())
+    {
+      auto index = planeIt.GetIndex();
+      if(planeIt.Value() != static_cast<unsigned short>(index[0] + index[1] + index[2] + (index[2] == 1 ? 7 : 0)))
+      {
+        cerr << "Invalid value " << planeIt.Value() << " at " << index << " of the XZ plane" << endl;
+        pass = false;
+        break;
+      }
+
+      ++planeIt;
+    }
+
+    if(after.hits != before.hits || after.misses != before.misses || cache.memoryUsage() != usage)
+    {
+      cerr << "XZ plane read used the tile cache" << endl;
+      pass = false;
+    }
+
+    // memory budget is enforced evicting the least recently used tiles.
+    const unsigned long long sliceBytes = region.GetSize(0) * region.GetSize(1) * sizeof(ImageType::PixelType);
+    cache.setMemoryBudget(2 * sliceBytes);
+
+    if(cache.memoryUsage() > cache.memoryBudget())
+    {
+      cerr << "Cache memory usage " << cache.memoryUsage() << " exceeds the budget " << cache.memoryBudget() << endl;
+      pass = false;
+    }
+
+    for(unsigned int slice = 0; slice < SLICES; ++slice)
+    {
+      pass &= checkSlice(volume->read(sliceRegion(region, slice)), slice, slice == 1 ? 7 : 0);
+
+      if(cache.memoryUsage() > cache.memoryBudget())
+      {
+        cerr << "Cache memory usage " << cache.memoryUsage() << " exceeds the budget " << cache.memoryBudget() << endl;
+        pass = false;
+      }
+    }
+
+    before = cache.statistics();
+    volume->read(sliceRegion(region, 0));
+    after = cache.statistics();
+
+    if(after.misses - before.misses != TILES_PER_SLICE)
+    {
+      cerr << "Least recently used slice wasn't evicted" << endl;
+      pass = false;
+    }
+  }
+  catch(const EspinaException &excp)
+  {
+    qDebug() << "exception:" << excp.what();
+    qDebug() << "details:" << excp.details();
+    pass = false;
+  }
+  catch(const itk::ExceptionObject &excp)
+  {
+    qDebug() << "exception:" << QString(excp.what());
+    pass = false;
+  }
+
+  cache.setMemoryBudget(StreamedTileCache::DEFAULT_MEMORY_BUDGET);
+  cache.setReadAhead(StreamedTileCache::DEFAULT_READ_AHEAD);
+  cache.clear();
+
+  QFile::remove(info.absoluteFilePath());
+  QFile::remove(dir.absoluteFilePath("tileCache.raw"));
+
+  return !pass;
+}
@@ -0,0 +1,215 @@
+/*
+ File: volumePyramid_levels.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Data/Volumetric/VolumePyramid.hxx"
+
+// ITK
+#include <itkImageFileWriter.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+using namespace ESPINA;
+using namespace ESPINA::Core;
+using namespace ESPINA::Core::Utils;
+using namespace std;
+
+using ImageType = itk::Image<unsigned short, 3>;
+
+namespace
+{
+  const unsigned int WIDTH  = 600;
+  const unsigned int HEIGHT = 520;
+  const unsigned int DEPTH  = 3;
+
+  void writeImage(const QString &fileName)
+  {
+    ImageType::RegionType region;
+    region.SetIndex(0, 0);
+    region.SetIndex(1, 0);
+    region.SetIndex(2, 0);
+    region.SetSize(0, WIDTH);
+    region.SetSize(1, HEIGHT);
+    region.SetSize(2, DEPTH);
+
+    auto image = ImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+
+    itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+    while(!it.IsAtEnd())
+    {
+      auto index = it.GetIndex();
+      it.Set(index[0] + index[1] + index[2]);
+      ++it;
+    }
+
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetFileName(fileName.toStdString());
+    writer->SetInput(image);
+    writer->SetUseCompression(false);
+    writer->Update();
+  }
+
+  /** \brief Voxel (x,y,z) of level n averages voxels [x*2^n, (x+1)*2^n) x [y*2^n, (y+1)*2^n) of slice z,
+   * the mean of x+y+z over that block is 2^n*(x+y) + 2^n - 1 + z.
+   *
+   */
+  bool checkLevel(ImageType::Pointer image, const unsigned int level)
+  {
+    const unsigned int factor = 1 << level;
+
+    itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+    while(!it.IsAtEnd())
+    {
+      auto index = it.GetIndex();
+      if(it.Value() != factor * (index[0] + index[1]) + factor - 1 + index[2])
+      {
+        cerr << "Invalid value " << it.Value() << " at " << index << " of level " << level << endl;
+        return false;
+      }
+
+      ++it;
+    }
+
+    return true;
+  }
+}
+
+int volumePyramid_levels(int argc, char** argv)
+{
+  bool pass = true;
+
+  auto dir    = QDir::current();
+  auto header = dir.absoluteFilePath("pyramid.mhd");
+
+  try
+  {
+    writeImage(header);
+
+    auto volume = std::make_shared<MappedVolume<ImageType>>(QFileInfo{header});
+
+    // 600x520 -> 300x260 -> 150x130
+    const unsigned int LEVELS = 2;
+
+    if(VolumePyramid<ImageType>::numberOfLevels(volume->itkRegion()) != LEVELS)
+    {
+      cerr << "Unexpected number of levels " << VolumePyramid<ImageType>::numberOfLevels(volume->itkRegion()) << endl;
+      pass = false;
+    }
+
+    auto levels = VolumePyramid<ImageType>::create(volume.get(), dir);
+
+    if(levels.size() != LEVELS)
+    {
+      cerr << "Unexpected number of created levels " << levels.size() << endl;
+      return 1;
+    }
+
+    for(unsigned int level = 1; level <= LEVELS; ++level)
+    {
+      auto region = levels.at(level - 1)->itkRegion();
+
+      if(region.GetSize(0) != (WIDTH >> level) || region.GetSize(1) != (HEIGHT >> level) || region.GetSize(2) != DEPTH)
+      {
+        cerr << "Unexpected size of level " << level << ": " << region.GetSize() << endl;
+        pass = false;
+        continue;
+      }
+
+      pass &= checkLevel(levels.at(level - 1)->read(region), level);
+    }
+
+    // up to date levels are reused.
+    QFileInfo first{VolumePyramid<ImageType>::levelFileName(volume->fileName(), dir, 1)};
+    auto modified = first.lastModified();
+
+    levels = VolumePyramid<ImageType>::create(volume.get(), dir);
+    first.refresh();
+
+    if(levels.size() != LEVELS || first.lastModified() != modified)
+    {
+      cerr << "Existing levels have been rebuilt" << endl;
+      pass = false;
+    }
+
+    volume->setLevels(levels);
+
+    // full resolution is used for display resolutions smaller than twice the voxel size.
+    Bounds slice{-0.5, WIDTH - 0.5, -0.5, HEIGHT - 0.5, 0.5, 1.5};
+
+    auto image = volume->itkImage(slice, 1.5);
+    if(image->GetLargestPossibleRegion().GetSize(0) != WIDTH || image->GetSpacing()[0] != 1)
+    {
+      cerr << "Full resolution slice expected, got size " << image->GetLargestPossibleRegion().GetSize() << endl;
+      pass = false;
+    }
+
+    for(unsigned int level = 1; level <= LEVELS; ++level)
+    {
+      image = volume->itkImage(slice, 1 << level);
+
+      if(image->GetLargestPossibleRegion().GetSize(0) != (WIDTH >> level) || image->GetSpacing()[0] != (1 << level) || image->GetSpacing()[2] != 1)
+      {
+        cerr << "Level " << level << " slice expected, got size " << image->GetLargestPossibleRegion().GetSize() << " and spacing " << image->GetSpacing() << endl;
+        pass = false;
+        continue;
+      }
+
+      pass &= checkLevel(image, level);
+
+      // the level covers the same bounds as the requested slice.
+      auto bounds = equivalentBounds<ImageType>(image);
+      if(!areEqual(bounds[0], slice[0]) || !areEqual(bounds[1], slice[1]) || !areEqual(bounds[4], slice[4]) || !areEqual(bounds[5], slice[5]))
+      {
+        cerr << "Unexpected level " << level << " bounds " << bounds.toString().toStdString() << endl;
+        pass = false;
+      }
+    }
+
+    // display resolutions over the lowest level use the lowest level.
+    image = volume->itkImage(slice, 1000);
+    if(image->GetSpacing()[0] != (1 << LEVELS))
+    {
+      cerr << "Lowest level slice expected, got spacing " << image->GetSpacing() << endl;
+      pass = false;
+    }
+  }
+  catch(const EspinaException &excp)
+  {
+    qDebug() << "exception:" << excp.what();
+    qDebug() << "details:" << excp.details();
+    pass = false;
+  }
+  catch(const itk::ExceptionObject &excp)
+  {
+    qDebug() << "exception:" << QString(excp.what());
+    pass = false;
+  }
+
+  QFile::remove(header);
+  QFile::remove(dir.absoluteFilePath("pyramid.raw"));
+  for(unsigned int level = 1; level <= VolumePyramid<ImageType>::MAX_LEVELS; ++level)
+  {
+    auto levelHeader = VolumePyramid<ImageType>::levelFileName(QFileInfo{header}, dir, level);
+
+    QFile::remove(levelHeader);
+    QFile::remove(dir.absoluteFilePath(QFileInfo{levelHeader}.completeBaseName() + ".raw"));
+  }
+
+  return !pass;
+}
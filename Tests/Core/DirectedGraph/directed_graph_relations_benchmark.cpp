@@ -0,0 +1,147 @@
+/*
+ File: directed_graph_relations_benchmark.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Core/Analysis/Graph/DirectedGraph.h"
+
+#include "DummyItem.h"
+
+// C++
+#include <chrono>
+#include <iostream>
+
+using namespace ESPINA;
+using namespace UnitTesting;
+using namespace std;
+
+namespace
+{
+  double throughput(unsigned int operations, const std::chrono::steady_clock::time_point &start)
+  {
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return operations/std::max(elapsed, 1e-9);
+  }
+}
+
+int directed_graph_relations_benchmark(int argc, char** argv)
+{
+  bool error = false;
+
+  // a sample with a channel and a filter + segmentation pair per segmentation, like a big SEG file.
+  const int NUM_SEGMENTATIONS = 20000;
+
+  DirectedGraph graph;
+
+  DummyItemSPtr sample{new DummyItem()};
+  DummyItemSPtr channel{new DummyItem()};
+
+  QList<DummyItemSPtr> filters, segmentations;
+  for(int i = 0; i < NUM_SEGMENTATIONS; ++i)
+  {
+    filters       << DummyItemSPtr{new DummyItem()};
+    segmentations << DummyItemSPtr{new DummyItem()};
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  graph.add(sample);
+  graph.add(channel);
+  for(int i = 0; i < NUM_SEGMENTATIONS; ++i)
+  {
+    graph.add(filters[i]);
+    graph.add(segmentations[i]);
+  }
+
+  auto addThroughput = throughput(2 * NUM_SEGMENTATIONS + 2, start);
+
+  start = std::chrono::steady_clock::now();
+
+  graph.addRelation(sample, channel, "stain");
+  for(int i = 0; i < NUM_SEGMENTATIONS; ++i)
+  {
+    graph.addRelation(channel,    filters[i],       "input");
+    graph.addRelation(filters[i], segmentations[i], "output");
+    graph.addRelation(sample,     segmentations[i], "contains");
+  }
+
+  auto relationThroughput = throughput(3 * NUM_SEGMENTATIONS + 1, start);
+
+  start = std::chrono::steady_clock::now();
+
+  for(int i = 0; i < NUM_SEGMENTATIONS; ++i)
+  {
+    auto ancestors = graph.ancestors(segmentations[i], "output");
+
+    if(ancestors.size() != 1 || ancestors.first() != filters[i])
+    {
+      cerr << "Unexpected ancestors of segmentation " << i << endl;
+      error = true;
+      break;
+    }
+  }
+
+  auto queryThroughput = throughput(NUM_SEGMENTATIONS, start);
+
+  cout << "Add throughput (vertices/s): "       << addThroughput      << endl;
+  cout << "Relation throughput (relations/s): " << relationThroughput << endl;
+  cout << "Query throughput (queries/s): "      << queryThroughput    << endl;
+
+  if(graph.edges().size() != 3 * NUM_SEGMENTATIONS + 1)
+  {
+    cerr << "Unexpected number of edges" << endl;
+    error = true;
+  }
+
+  // removing vertices shifts the descriptors of the following ones.
+  const int REMOVE_STEP = 100;
+  for(int i = 0; i < NUM_SEGMENTATIONS; i += REMOVE_STEP)
+  {
+    graph.remove(filters[i]);
+  }
+
+  for(int i = 0; i < NUM_SEGMENTATIONS; ++i)
+  {
+    auto ancestors = graph.ancestors(segmentations[i], "output");
+    auto expected  = (i % REMOVE_STEP == 0) ? 0 : 1;
+
+    if(ancestors.size() != expected || graph.contains(filters[i]) != (expected == 1))
+    {
+      cerr << "Unexpected ancestors of segmentation " << i << " after removing filters" << endl;
+      error = true;
+      break;
+    }
+
+    if(expected == 1 && ancestors.first() != filters[i])
+    {
+      cerr << "Unexpected ancestor of segmentation " << i << " after removing filters" << endl;
+      error = true;
+      break;
+    }
+  }
+
+  graph.clear();
+
+  if(graph.contains(sample) || !graph.vertices().isEmpty())
+  {
+    cerr << "Graph is not empty after clear" << endl;
+    error = true;
+  }
+
+  return error;
+}
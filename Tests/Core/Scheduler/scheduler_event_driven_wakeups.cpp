@@ -0,0 +1,90 @@
+/*
+ File: scheduler_event_driven_wakeups.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Scheduler.h>
+
+#include "SleepyTask.h"
+
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+
+#include <QCoreApplication>
+
+using namespace ESPINA;
+using namespace std;
+
+int scheduler_event_driven_wakeups( int argc, char** argv )
+{
+  int error = 0;
+
+  QCoreApplication app(argc, argv);
+
+  int period    = 1000;
+  int sleepTime = 500;
+  int taskTime  = SleepyTask::Iterations*sleepTime;
+
+  auto scheduler  = make_shared<Scheduler>(period);
+  auto sleepyTask = make_shared<SleepyTask>(sleepTime, scheduler);
+  sleepyTask->setDescription("Simple Task");
+
+  usleep(10*period);
+
+  if (scheduler->wakeupStatistics().wakeups != 0) {
+    error = 1;
+    std::cerr << "Idle scheduler shouldn't have been woken up" << std::endl;
+  }
+
+  Task::submit(sleepyTask);
+
+  int waited = 0;
+  while (scheduler->numberOfTasks() > 0 && waited < 100*taskTime) {
+    usleep(taskTime);
+    waited += taskTime;
+  }
+
+  if (sleepyTask->Result != SleepyTask::Iterations) {
+    error = 1;
+    std::cerr << "Unexpected final sleepy task value" << std::endl;
+  }
+
+  auto statistics = scheduler->wakeupStatistics();
+
+  // at least insertion and completion
+  if (statistics.wakeups < 2) {
+    error = 1;
+    std::cerr << "Unexpected number of wakeups: " << statistics.wakeups << std::endl;
+  }
+
+  if (statistics.maxLatency < statistics.meanLatency || statistics.meanLatency < 0) {
+    error = 1;
+    std::cerr << "Unexpected wakeup latencies: " << statistics.meanLatency << " " << statistics.maxLatency << std::endl;
+  }
+
+  usleep(10*period);
+
+  if (scheduler->wakeupStatistics().wakeups != statistics.wakeups) {
+    error = 1;
+    std::cerr << "Idle scheduler shouldn't have been woken up" << std::endl;
+  }
+
+  scheduler->abort();
+
+  return error;
+}
@@ -0,0 +1,105 @@
+/*
+ File: scheduler_task_dependencies.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Scheduler.h>
+#include <ContinuationTask.h>
+
+#include "SleepyTask.h"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+
+#include <QCoreApplication>
+
+using namespace ESPINA;
+using namespace std;
+
+int scheduler_task_dependencies( int argc, char** argv )
+{
+  int error = 0;
+
+  QCoreApplication app(argc, argv);
+
+  int period    = 1000;
+  int sleepTime = 1000;
+  int taskTime  = SleepyTask::Iterations*sleepTime;
+
+  for (auto mode: {Scheduler::ExecutionMode::DISPATCHER, Scheduler::ExecutionMode::THREAD_POOL})
+  {
+    auto scheduler = make_shared<Scheduler>(period, mode);
+
+    auto first  = make_shared<SleepyTask>(sleepTime, scheduler);
+    auto second = make_shared<SleepyTask>(sleepTime, scheduler);
+    auto last   = make_shared<SleepyTask>(sleepTime, scheduler);
+    auto orphan = make_shared<SleepyTask>(sleepTime, scheduler);
+    auto child  = make_shared<SleepyTask>(sleepTime, scheduler);
+
+    Task::addDependency(last, first);
+    Task::addDependency(last, second);
+    Task::addDependency(child, orphan);
+
+    std::atomic<bool> joined{false};
+    std::atomic<bool> lastFinishedBeforeJoin{false};
+
+    // submitted in reverse order, the scheduler must respect the dependencies.
+    Task::submit(last);
+    Task::submit(child);
+    ContinuationTask::join(TaskSList{last}, [&]() { lastFinishedBeforeJoin = last->isFinished(); joined = true; }, scheduler);
+    Task::submit(second);
+    Task::submit(first);
+
+    orphan->abort();
+
+    usleep(taskTime/2);
+
+    if (!last->hasPendingDependencies() || last->Result != -1) {
+      error = 1;
+      std::cerr << "Task shouldn't be executed before its predecessors finish" << std::endl;
+    }
+
+    int waited = 0;
+    while (scheduler->numberOfTasks() > 0 && waited < 100*taskTime) {
+      usleep(taskTime);
+      waited += taskTime;
+    }
+
+    for (auto task: {first, second, last}) {
+      if (task->Result != SleepyTask::Iterations) {
+        error = 1;
+        std::cerr << "Task should have finished: " << task->Result << std::endl;
+      }
+    }
+
+    if (!child->isAborted() || child->Result != -1) {
+      error = 1;
+      std::cerr << "Successor of an aborted task should be aborted without being executed" << std::endl;
+    }
+
+    if (!joined || !lastFinishedBeforeJoin) {
+      error = 1;
+      std::cerr << "Continuation should be executed after its predecessors" << std::endl;
+    }
+
+    scheduler->abort();
+  }
+
+  return error;
+}
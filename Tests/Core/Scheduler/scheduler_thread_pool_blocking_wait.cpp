@@ -0,0 +1,119 @@
+/*
+ File: scheduler_thread_pool_blocking_wait.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Scheduler.h>
+
+#include "SleepyTask.h"
+
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QSemaphore>
+
+using namespace ESPINA;
+using namespace std;
+
+namespace
+{
+  /** \class WaitingTask
+   * \brief Task that submits a sub task and blocks until it finishes.
+   *
+   */
+  class WaitingTask
+  : public Task
+  {
+    public:
+      explicit WaitingTask(int sleepTime, SchedulerSPtr scheduler)
+      : Task       {scheduler}
+      , Finished   {false}
+      , m_sleepTime{sleepTime}
+      {}
+
+      std::shared_ptr<SleepyTask> SubTask;  /** task this one waits for.            */
+      bool                        Finished; /** true if the sub task has finished.  */
+
+    protected:
+      virtual void run() override
+      {
+        SubTask = make_shared<SleepyTask>(m_sleepTime, m_scheduler);
+        SubTask->setDescription(description() + " sub task");
+        SubTask->setCritical(true);
+
+        QObject::connect(SubTask.get(), &Task::finished, [this]() { m_done.release(); });
+
+        Task::submit(SubTask);
+
+        m_scheduler->beginBlockingWait();
+
+        // bounded, a deadlocked pool must fail the test instead of hanging it.
+        Finished = m_done.tryAcquire(1, 100*SleepyTask::Iterations*m_sleepTime/1000);
+
+        m_scheduler->endBlockingWait();
+      }
+
+    private:
+      int        m_sleepTime; /** sleep time of the sub task iterations. */
+      QSemaphore m_done;      /** released when the sub task finishes.   */
+  };
+}
+
+int scheduler_thread_pool_blocking_wait( int argc, char** argv )
+{
+  int error = 0;
+
+  QCoreApplication app(argc, argv);
+
+  int period    = 1000;
+  int sleepTime = 500;
+  int taskTime  = SleepyTask::Iterations*sleepTime;
+
+  auto scheduler = make_shared<Scheduler>(period, Scheduler::ExecutionMode::THREAD_POOL);
+
+  // more waiting tasks than workers, their sub tasks can only run on compensation workers.
+  int numTasks = scheduler->concurrency() + 1;
+
+  std::vector<shared_ptr<WaitingTask>> tasks;
+
+  for (int i = 0; i < numTasks; ++i) {
+    tasks.push_back(make_shared<WaitingTask>(sleepTime, scheduler));
+    tasks.at(i)->setDescription(QString("Waiting task %1").arg(i));
+    Task::submit(tasks.at(i));
+  }
+
+  int waited = 0;
+  while (scheduler->numberOfTasks() > 0 && waited < 200*taskTime) {
+    usleep(taskTime);
+    waited += taskTime;
+  }
+
+  for (int i = 0; i < numTasks; ++i) {
+    auto task = tasks.at(i);
+
+    if (!task->hasFinished() || !task->Finished || !task->SubTask || task->SubTask->Result != SleepyTask::Iterations) {
+      error = 1;
+      std::cerr << "Waiting task " << i << " didn't get the result of its sub task" << std::endl;
+    }
+  }
+
+  scheduler->abort();
+
+  return error;
+}
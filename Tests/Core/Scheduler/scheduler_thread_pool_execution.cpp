@@ -0,0 +1,96 @@
+/*
+ File: scheduler_thread_pool_execution.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Scheduler.h>
+
+#include "SleepyTask.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <unistd.h>
+
+#include <QCoreApplication>
+#include <QThread>
+
+using namespace ESPINA;
+using namespace std;
+
+int scheduler_thread_pool_execution( int argc, char** argv )
+{
+  int error = 0;
+
+  QCoreApplication app(argc, argv);
+
+  int period    = 1000;
+  int sleepTime = 500;
+  int taskTime  = SleepyTask::Iterations*sleepTime;
+
+  auto scheduler = make_shared<Scheduler>(period, Scheduler::ExecutionMode::THREAD_POOL);
+
+  unsigned int expectedWorkers = std::max(1, QThread::idealThreadCount());
+  if (scheduler->concurrency() != expectedWorkers) {
+    error = 1;
+    std::cerr << "Unexpected number of pool workers: " << scheduler->concurrency() << std::endl;
+  }
+
+  int numTasks = 2*scheduler->concurrency() + 1;
+
+  std::vector<shared_ptr<SleepyTask>> tasks;
+
+  for (int i = 0; i < numTasks; ++i) {
+    tasks.push_back(make_shared<SleepyTask>(sleepTime, scheduler));
+    tasks.at(i)->setDescription(QString("Task %1").arg(i));
+    tasks.at(i)->setPriority(i % 2 ? Priority::HIGH : Priority::LOW);
+    Task::submit(tasks.at(i));
+  }
+
+  auto lastTask = tasks.at(numTasks - 1);
+  lastTask->pause();
+
+  int waited = 0;
+  while (scheduler->numberOfTasks() > 1 && waited < 100*numTasks*taskTime) {
+    usleep(taskTime);
+    waited += taskTime;
+  }
+
+  if (lastTask->Result == SleepyTask::Iterations) {
+    error = 1;
+    std::cerr << "Paused task shouldn't have finished" << std::endl;
+  }
+
+  lastTask->resume();
+
+  waited = 0;
+  while (scheduler->numberOfTasks() > 0 && waited < 100*taskTime) {
+    usleep(taskTime);
+    waited += taskTime;
+  }
+
+  for (int i = 0; i < numTasks; ++i) {
+    if (tasks.at(i)->Result != SleepyTask::Iterations) {
+      error = 1;
+      std::cerr << "Task " << i << " should have finished: " << tasks.at(i)->Result << std::endl;
+    }
+  }
+
+  scheduler->abort();
+
+  return error;
+}
@@ -0,0 +1,182 @@
+/*
+ File: volume_overlap_engine_overlaps.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Utils/VolumeOverlapEngine.h>
+#include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include "testing_support_dummy_filter.h"
+
+using ESPINA::Testing::DummyFilter;
+
+using namespace ESPINA;
+using namespace ESPINA::Core::Utils;
+using namespace std;
+
+namespace
+{
+  struct Box
+  {
+    int min[3];
+    int max[3];
+
+    bool contains(int x, int y, int z) const
+    {
+      return min[0] <= x && x <= max[0] && min[1] <= y && y <= max[1] && min[2] <= z && z <= max[2];
+    }
+  };
+
+  /** \brief Returns an output with the voxels of the given box drawn.
+   *
+   */
+  OutputSPtr createOutput(DummyFilter &filter, const int id, const Box &box, const NmVector3 &spacing)
+  {
+    Bounds bounds;
+    for(int i = 0; i < 3; ++i)
+    {
+      bounds[2*i]   = (box.min[i] - 0.5) * spacing[i];
+      bounds[2*i+1] = (box.max[i] + 0.5) * spacing[i];
+    }
+
+    auto output = std::make_shared<Output>(&filter, id, spacing);
+    auto volume = std::make_shared<SparseVolume<itkVolumeType>>(bounds, spacing);
+    volume->draw(bounds, SEG_VOXEL_VALUE);
+
+    output->setData(volume);
+
+    return output;
+  }
+
+  /** \brief Returns the overlap of both boxes computed voxel by voxel.
+   *
+   */
+  VolumeOverlapEngine::Overlap bruteForce(const Box &lhs, const Box &rhs)
+  {
+    VolumeOverlapEngine::Overlap result{0, 0, 0, 0};
+
+    for(int z = -1; z < 40; ++z)
+    {
+      for(int y = -1; y < 40; ++y)
+      {
+        for(int x = -1; x < 40; ++x)
+        {
+          const bool inL = lhs.contains(x,y,z);
+          const bool inR = rhs.contains(x,y,z);
+
+          if(inL && inR) ++result.voxels;
+
+          result.contacts += (inL && rhs.contains(x+1,y,z)) + (inR && lhs.contains(x+1,y,z));
+          result.contacts += (inL && rhs.contains(x,y+1,z)) + (inR && lhs.contains(x,y+1,z));
+          result.contacts += (inL && rhs.contains(x,y,z+1)) + (inR && lhs.contains(x,y,z+1));
+        }
+      }
+    }
+
+    return result;
+  }
+}
+
+int volume_overlap_engine_overlaps(int argc, char** argv)
+{
+  bool error = false;
+
+  NmVector3 spacing{1, 1, 2};
+
+  DummyFilter filter;
+
+  QList<Box> boxes;
+  boxes << Box{{ 0,  0, 0}, { 9,  9, 4}}  // reference
+        << Box{{ 5,  0, 0}, {14,  9, 4}}  // overlaps the reference
+        << Box{{ 0, 10, 0}, { 4, 14, 4}}  // touches the reference on a block limit
+        << Box{{ 3,  3, 5}, { 6, 22, 9}}  // touches several boxes crossing blocks
+        << Box{{30, 30, 30}, {35, 35, 35}}; // isolated
+
+  VolumeOverlapEngine engine(4);
+
+  for(int i = 0; i < boxes.size(); ++i)
+  {
+    if(engine.add(createOutput(filter, i, boxes[i], spacing)) != i)
+    {
+      cerr << "Unexpected index of volume " << i << endl;
+      error = true;
+    }
+  }
+
+  if(engine.add(createOutput(filter, boxes.size(), boxes.first(), NmVector3{1, 1, 1})) != -1)
+  {
+    cerr << "Volume with different spacing shouldn't be added" << endl;
+    error = true;
+  }
+
+  if(engine.add(nullptr) != -1)
+  {
+    cerr << "Null output shouldn't be added" << endl;
+    error = true;
+  }
+
+  auto overlaps = engine.overlaps();
+
+  QList<VolumeOverlapEngine::Overlap> expected;
+  for(int i = 0; i < boxes.size(); ++i)
+  {
+    for(int j = i + 1; j < boxes.size(); ++j)
+    {
+      auto overlap = bruteForce(boxes[i], boxes[j]);
+
+      if(overlap.voxels > 0 || overlap.contacts > 0)
+      {
+        overlap.first  = i;
+        overlap.second = j;
+
+        expected << overlap;
+      }
+    }
+  }
+
+  if(overlaps.size() != expected.size())
+  {
+    cerr << "Found " << overlaps.size() << " overlapping pairs, expected " << expected.size() << endl;
+    error = true;
+  }
+  else
+  {
+    for(int i = 0; i < expected.size(); ++i)
+    {
+      auto &overlap   = overlaps.at(i);
+      auto &reference = expected.at(i);
+
+      if(overlap.first != reference.first || overlap.second != reference.second ||
+         overlap.voxels != reference.voxels || overlap.contacts != reference.contacts)
+      {
+        cerr << "Pair " << overlap.first << "-" << overlap.second << " has " << overlap.voxels << " voxels and "
+             << overlap.contacts << " contacts, expected pair " << reference.first << "-" << reference.second
+             << " with " << reference.voxels << " voxels and " << reference.contacts << " contacts" << endl;
+        error = true;
+      }
+    }
+  }
+
+  auto stopped = engine.overlaps([]() { return false; });
+  if(!stopped.isEmpty())
+  {
+    cerr << "Stopped computation returned overlaps" << endl;
+    error = true;
+  }
+
+  return error;
+}
@@ -0,0 +1,267 @@
+/*
+ File: adaptive_edges_creator_slice_borders.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Extensions/EdgeDistances/AdaptiveEdgesUtils.h>
+
+// VTK
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkOBBTree.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+
+// C++
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Extensions;
+
+using SliceBorder = AdaptiveEdgesUtils::SliceBorder;
+
+namespace
+{
+  const unsigned char BACKGROUND = 10;
+  const unsigned char THRESHOLD  = 5;
+
+  /** \brief Scalar computation of the slice border, pixel by pixel, as the edges were computed before
+   * the parallel version.
+   *
+   */
+  SliceBorder scalarSliceBorder(vtkImageData *image, const int z, const Bounds &bounds, const int lowerThreshold, const int upperThreshold)
+  {
+    int extent[6];
+    double spacing[3];
+    image->GetExtent(extent);
+    image->GetSpacing(spacing);
+
+    const auto numComponents = image->GetNumberOfScalarComponents();
+
+    auto nonBlackPixels = vtkSmartPointer<vtkPoints>::New();
+    nonBlackPixels->SetDataTypeToDouble();
+
+    for (auto y = extent[2]; y <= extent[3]; y++)
+    {
+      auto nonBlackPixelDetected = false;
+      double p1[3], p2[3];
+      auto singlePixel = true;
+
+      for (auto x = extent[0]; x <= extent[1]; x++)
+      {
+        auto nonBlackPixel = false;
+        auto pixelPtr = reinterpret_cast<unsigned char *>(image->GetScalarPointer(x,y,z));
+        for (int c = 0; c < numComponents; c++)
+        {
+          nonBlackPixel = nonBlackPixel || (pixelPtr[c] > upperThreshold) || (pixelPtr[c] < lowerThreshold);
+        }
+
+        if (nonBlackPixel)
+        {
+          if (nonBlackPixelDetected)
+          {
+            p2[0] = x * spacing[0];
+            p2[1] = y * spacing[1];
+            p2[2] = z * spacing[2];
+            singlePixel = false;
+          }
+          else
+          {
+            p1[0] = x * spacing[0];
+            p1[1] = y * spacing[1];
+            p1[2] = z * spacing[2];
+            nonBlackPixelDetected = true;
+            nonBlackPixels->InsertNextPoint(p1);
+          }
+        }
+      }
+
+      if (nonBlackPixelDetected && !singlePixel)
+      {
+        nonBlackPixels->InsertNextPoint(p2);
+      }
+    }
+
+    double corner[3], max[3], mid[3], min[3], size[3];
+    auto obb_tree = vtkSmartPointer<vtkOBBTree>::New();
+    obb_tree->ComputeOBB(nonBlackPixels, corner, max, mid, min, size);
+
+    SliceBorder border;
+    for(int i = 0; i < 3; ++i)
+    {
+      border.LT[i] = corner[i];
+      border.LB[i] = corner[i] + mid[i];
+      border.RT[i] = corner[i] + max[i];
+      border.RB[i] = corner[i] + max[i] + mid[i];
+    }
+
+    auto correctedLeft   = bounds[0] + vtkMath::Round((std::min(border.LB[0], border.LT[0]) - bounds[0]) / spacing[0]) * spacing[0];
+    auto correctedRight  = bounds[0] + (vtkMath::Round((std::max(border.RB[0], border.RT[0]) - bounds[0]) / spacing[0]) + 1) * spacing[0];
+    auto correctedTop    = bounds[2] + vtkMath::Round((std::min(border.LT[1], border.RT[1]) - bounds[2]) / spacing[1]) * spacing[1];
+    auto correctedBottom = bounds[2] + (vtkMath::Round((std::max(border.LB[1], border.RB[1]) - bounds[2]) / spacing[1]) + 1) * spacing[1];
+
+    border.LB[0] = correctedLeft;  border.LB[1] = correctedBottom; border.LB[2] -= 0.5*spacing[2];
+    border.LT[0] = correctedLeft;  border.LT[1] = correctedTop;    border.LT[2] -= 0.5*spacing[2];
+    border.RT[0] = correctedRight; border.RT[1] = correctedTop;    border.RT[2] -= 0.5*spacing[2];
+    border.RB[0] = correctedRight; border.RB[1] = correctedBottom; border.RB[2] -= 0.5*spacing[2];
+
+    return border;
+  }
+
+  /** \brief Returns a stack with a rotated and displaced foreground rectangle in each slice, background
+   * speckles, empty rows and rows with a single foreground pixel.
+   * \param[in] components number of components per pixel.
+   *
+   */
+  vtkSmartPointer<vtkImageData> createStack(const int components)
+  {
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->SetExtent(3, 75, 2, 52, 0, 7);
+    image->SetSpacing(1.5, 2.0, 3.0);
+    image->AllocateScalars(VTK_UNSIGNED_CHAR, components);
+
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<int> noise(BACKGROUND - THRESHOLD, BACKGROUND + THRESHOLD);
+    std::uniform_int_distribution<int> foreground(BACKGROUND + THRESHOLD + 1, 255);
+
+    int extent[6];
+    image->GetExtent(extent);
+
+    for(int z = extent[4]; z <= extent[5]; ++z)
+    {
+      const double angle = 0.1 * z;
+      const double cx = 38 + z, cy = 27 - z;
+
+      for(int y = extent[2]; y <= extent[3]; ++y)
+      {
+        for(int x = extent[0]; x <= extent[1]; ++x)
+        {
+          const double u =  std::cos(angle) * (x - cx) + std::sin(angle) * (y - cy);
+          const double v = -std::sin(angle) * (x - cx) + std::cos(angle) * (y - cy);
+
+          bool inside = (std::abs(u) < 25 - z) && (std::abs(v) < 15);
+
+          // a row with only one foreground pixel, at the last column in odd slices.
+          if(y == extent[2] + 1) inside = (x == ((z % 2) ? extent[1] : extent[0] + z));
+
+          // empty row inside the rectangle.
+          if(y == static_cast<int>(cy)) inside = false;
+
+          auto pixel = reinterpret_cast<unsigned char *>(image->GetScalarPointer(x, y, z));
+          for(int c = 0; c < components; ++c)
+          {
+            // only one of the components is foreground in multi-component stacks.
+            pixel[c] = (inside && c == (x + y) % components) ? foreground(generator) : noise(generator);
+          }
+        }
+      }
+    }
+
+    return image;
+  }
+
+  bool equalBorders(const SliceBorder &border, const SliceBorder &reference)
+  {
+    for(int i = 0; i < 3; ++i)
+    {
+      if(border.LB[i] != reference.LB[i] || border.LT[i] != reference.LT[i] ||
+         border.RT[i] != reference.RT[i] || border.RB[i] != reference.RB[i]) return false;
+    }
+
+    return true;
+  }
+}
+
+int adaptive_edges_creator_slice_borders(int argc, char** argv)
+{
+  bool error = false;
+
+  const unsigned char lower = BACKGROUND - THRESHOLD;
+  const unsigned char upper = BACKGROUND + THRESHOLD;
+
+  // row scans against the scalar scan, around the 16 values blocks limits.
+  std::mt19937 generator(23);
+  std::uniform_int_distribution<int> noise(lower, upper);
+
+  for(long long length = 0; length <= 70; ++length)
+  {
+    for(long long position = -1; position < length; ++position)
+    {
+      std::vector<unsigned char> row(length + 1);
+      for(auto &value: row) value = noise(generator);
+
+      if(position >= 0) row[position] = (position % 2) ? upper + 1 : lower - 1;
+
+      // value past the end of the row, must be ignored.
+      row[length] = 255;
+
+      long long first = -1, last = -1;
+      for(long long i = 0; i < length; ++i)
+      {
+        if(row[i] < lower || row[i] > upper)
+        {
+          if(first == -1) first = i;
+          last = i;
+        }
+      }
+
+      auto computedFirst = AdaptiveEdgesUtils::firstForeground(row.data(), length, lower, upper);
+      auto computedLast  = AdaptiveEdgesUtils::lastForeground(row.data(), length, lower, upper);
+
+      if(computedFirst != first || computedLast != last)
+      {
+        cerr << "Row of length " << length << " with foreground at " << position << ": first " << computedFirst << " last "
+             << computedLast << ", expected " << first << " and " << last << endl;
+        error = true;
+      }
+    }
+  }
+
+  // slice borders against the scalar computation, with one and three components per pixel.
+  for(auto components: {1, 3})
+  {
+    auto image = createStack(components);
+
+    int extent[6];
+    double spacing[3];
+    image->GetExtent(extent);
+    image->GetSpacing(spacing);
+
+    Bounds bounds{(extent[0] - 0.5) * spacing[0], (extent[1] + 0.5) * spacing[0],
+                  (extent[2] - 0.5) * spacing[1], (extent[3] + 0.5) * spacing[1],
+                  (extent[4] - 0.5) * spacing[2], (extent[5] + 0.5) * spacing[2]};
+
+    for(int z = extent[4]; z <= extent[5]; ++z)
+    {
+      auto border    = AdaptiveEdgesUtils::sliceBorder(image, z, bounds, lower, upper);
+      auto reference = scalarSliceBorder(image, z, bounds, lower, upper);
+
+      if(!equalBorders(border, reference))
+      {
+        cerr << "Unexpected border of slice " << z << " with " << components << " components" << endl;
+        error = true;
+      }
+    }
+  }
+
+  return error;
+}
@@ -0,0 +1,280 @@
+/*
+ File: edges_distance_index_cell_locator_comparison.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Extensions/EdgeDistances/EdgesDistanceIndex.h>
+
+// VTK
+#include <vtkCellArray.h>
+#include <vtkCellLocator.h>
+#include <vtkGenericCell.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+// C++
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Extensions;
+
+namespace
+{
+  const int    GRID      = 24;    /** vertices per side of the faces grids. */
+  const double SIZE      = 100.0; /** size of the box of the faces.         */
+  const double TOLERANCE = 1e-9;
+
+  /** \brief Returns a triangulated grid perpendicular to the given axis at the given position, with the vertices
+   * displaced randomly along the axis.
+   * \param[in] axis axis perpendicular to the face.
+   * \param[in] position position of the face along the axis.
+   * \param[in] generator random numbers generator.
+   *
+   */
+  vtkSmartPointer<vtkPolyData> wavyFace(const int axis, const double position, std::mt19937 &generator)
+  {
+    std::uniform_real_distribution<double> noise(-3, 3);
+
+    const int u = (axis + 1) % 3;
+    const int v = (axis + 2) % 3;
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+
+    for(int j = 0; j < GRID; ++j)
+    {
+      for(int i = 0; i < GRID; ++i)
+      {
+        double point[3];
+        point[axis] = position + noise(generator);
+        point[u]    = i * SIZE / (GRID - 1);
+        point[v]    = j * SIZE / (GRID - 1);
+
+        points->InsertNextPoint(point);
+      }
+    }
+
+    auto cells = vtkSmartPointer<vtkCellArray>::New();
+    for(int j = 0; j + 1 < GRID; ++j)
+    {
+      for(int i = 0; i + 1 < GRID; ++i)
+      {
+        const vtkIdType corner = j * GRID + i;
+
+        const vtkIdType first[3] {corner, corner + 1, corner + GRID + 1};
+        const vtkIdType second[3]{corner, corner + GRID + 1, corner + GRID};
+
+        cells->InsertNextCell(3, first);
+        cells->InsertNextCell(3, second);
+      }
+    }
+
+    auto face = vtkSmartPointer<vtkPolyData>::New();
+    face->SetPoints(points);
+    face->SetPolys(cells);
+
+    return face;
+  }
+
+  /** \brief Returns a planar face of quads perpendicular to the Z axis at the given position, with a pentagon
+   * over the last quads, to check the triangulation of polygons.
+   * \param[in] position position of the face along the Z axis.
+   *
+   */
+  vtkSmartPointer<vtkPolyData> planarFace(const double position)
+  {
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+
+    const int quads = 6;
+    for(int j = 0; j <= quads; ++j)
+    {
+      for(int i = 0; i <= quads; ++i)
+      {
+        // uneven columns width.
+        const double x = SIZE * (i * i) / (quads * quads);
+        const double y = SIZE * j / quads;
+
+        points->InsertNextPoint(x, y, position);
+      }
+    }
+
+    auto cells = vtkSmartPointer<vtkCellArray>::New();
+    for(int j = 0; j < quads - 1; ++j)
+    {
+      for(int i = 0; i < quads; ++i)
+      {
+        const vtkIdType corner = j * (quads + 1) + i;
+        const vtkIdType quad[4]{corner, corner + 1, corner + quads + 2, corner + quads + 1};
+
+        cells->InsertNextCell(4, quad);
+      }
+    }
+
+    // convex pentagon covering the last row.
+    const vtkIdType row = (quads - 1) * (quads + 1);
+    const vtkIdType pentagon[5]{row, row + quads, row + 2 * quads + 1, row + quads + 1 + quads / 2, row + quads + 1};
+    cells->InsertNextCell(5, pentagon);
+
+    auto face = vtkSmartPointer<vtkPolyData>::New();
+    face->SetPoints(points);
+    face->SetPolys(cells);
+
+    return face;
+  }
+
+  /** \brief Returns the distance from the point to the face computed by a VTK cell locator.
+   *
+   */
+  double locatorDistance(vtkCellLocator *locator, const double point[3])
+  {
+    double closest[3], dist2;
+    vtkIdType cellId;
+    int subId;
+
+    auto cell = vtkSmartPointer<vtkGenericCell>::New();
+    locator->FindClosestPoint(const_cast<double *>(point), closest, cell, cellId, subId, dist2);
+
+    return std::sqrt(dist2);
+  }
+
+  bool equal(const double value, const double expected)
+  {
+    return std::abs(value - expected) <= TOLERANCE * std::max(1.0, std::abs(expected));
+  }
+}
+
+int edges_distance_index_cell_locator_comparison(int argc, char** argv)
+{
+  bool error = false;
+
+  std::mt19937 generator(31);
+
+  // left, right, top, bottom, front and an empty back face.
+  vtkSmartPointer<vtkPolyData> faces[6];
+  faces[0] = wavyFace(0, 0,    generator);
+  faces[1] = wavyFace(0, SIZE, generator);
+  faces[2] = wavyFace(1, 0,    generator);
+  faces[3] = wavyFace(1, SIZE, generator);
+  faces[4] = planarFace(0);
+  faces[5] = vtkSmartPointer<vtkPolyData>::New();
+
+  EdgesDistanceIndex index(faces);
+
+  vtkSmartPointer<vtkCellLocator> locators[6];
+  for(int face = 0; face < 6; ++face)
+  {
+    if(index.isEmpty(face) != (face == 5))
+    {
+      cerr << "Face " << face << " has an unexpected empty state." << endl;
+      error = true;
+    }
+
+    if(face == 5) continue;
+
+    locators[face] = vtkSmartPointer<vtkCellLocator>::New();
+    locators[face]->SetDataSet(faces[face]);
+    locators[face]->BuildLocator();
+  }
+
+  // points inside and around the box, including the faces vertices.
+  auto points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+
+  std::uniform_real_distribution<double> coordinate(-0.2 * SIZE, 1.2 * SIZE);
+  for(int i = 0; i < 12000; ++i)
+  {
+    points->InsertNextPoint(coordinate(generator), coordinate(generator), coordinate(generator));
+  }
+
+  for(int face = 0; face < 5; ++face)
+  {
+    for(vtkIdType i = 0; i < faces[face]->GetNumberOfPoints(); i += 37)
+    {
+      points->InsertNextPoint(faces[face]->GetPoint(i));
+    }
+  }
+
+  double minimum[6];
+  std::fill(minimum, minimum + 6, VTK_DOUBLE_MAX);
+
+  for(vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double point[3];
+    points->GetPoint(i, point);
+
+    for(int face = 0; face < 6; ++face)
+    {
+      const auto computed = index.distance(face, point);
+
+      if(face == 5)
+      {
+        if(computed != VTK_DOUBLE_MAX)
+        {
+          cerr << "Distance to an empty face is " << computed << endl;
+          error = true;
+        }
+
+        continue;
+      }
+
+      const auto expected = locatorDistance(locators[face], point);
+      minimum[face] = std::min(minimum[face], expected);
+
+      if(!equal(computed, expected))
+      {
+        cerr << "Point " << point[0] << "," << point[1] << "," << point[2] << ": distance to face " << face << " is "
+             << computed << ", expected " << expected << endl;
+        error = true;
+      }
+
+      // the limit bounds the result without changing the closer distances.
+      const double limit = 10;
+      const auto limited = index.distance(face, point, limit);
+
+      if(!equal(limited, std::min(limit, expected)))
+      {
+        cerr << "Point " << point[0] << "," << point[1] << "," << point[2] << ": limited distance to face " << face << " is "
+             << limited << ", expected " << std::min(limit, expected) << endl;
+        error = true;
+      }
+    }
+
+    if(error) return error;
+  }
+
+  // minimum distances of the points, computed in parallel.
+  Nm distances[6];
+  index.distances(points, distances);
+
+  for(int face = 0; face < 6; ++face)
+  {
+    if(!equal(distances[face], minimum[face]))
+    {
+      cerr << "Minimum distance to face " << face << " is " << distances[face] << ", expected " << minimum[face] << endl;
+      error = true;
+    }
+  }
+
+  return error;
+}
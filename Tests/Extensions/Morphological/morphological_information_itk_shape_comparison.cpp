@@ -0,0 +1,187 @@
+/*
+ File: morphological_information_itk_shape_comparison.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Analysis/Segmentation.h>
+#include <Core/Analysis/Data/Mesh/RawMesh.h>
+#include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
+#include <Core/Factory/CoreFactory.h>
+#include <Extensions/Morphological/MorphologicalInformation.h>
+#include <Extensions/Morphological/MorphologicalInformationFactory.h>
+#include <testing_support_dummy_filter.h>
+
+// ITK
+#include <itkLabelImageToShapeLabelMapFilter.h>
+#include <itkLabelMap.h>
+#include <itkShapeLabelObject.h>
+
+// VTK
+#include <vtkPolyData.h>
+
+// C++
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Core;
+using namespace ESPINA::Extensions;
+using namespace ESPINA::Testing;
+
+using LabelObjectType = itk::ShapeLabelObject<unsigned int, 3>;
+using LabelMapType    = itk::LabelMap<LabelObjectType>;
+using ShapeFilterType = itk::LabelImageToShapeLabelMapFilter<itkVolumeType, LabelMapType>;
+
+namespace
+{
+  const NmVector3 SPACING{1, 2, 3};
+  const int       SIZE = 12;
+  const double    TOLERANCE = 1e-6;
+
+  using Fixture = std::function<bool(int x, int y, int z)>;
+
+  /** \brief Returns the value of the given key of the morphological extension.
+   *
+   */
+  double value(SegmentationExtensionSPtr extension, const QString &key)
+  {
+    return extension->information(SegmentationExtension::InformationKey(MorphologicalInformation::TYPE, key)).toDouble();
+  }
+
+  /** \brief Returns true if both values are equal within the tolerance, relative to the magnitude of the expected value.
+   *
+   */
+  bool equal(const double value, const double expected)
+  {
+    return std::abs(value - expected) <= TOLERANCE * std::max(1.0, std::abs(expected));
+  }
+
+  /** \brief Returns true if the morphological information of the fixture matches the one computed by the ITK shape filter.
+   * \param[in] name name of the fixture.
+   * \param[in] fixture returns true for the voxels of the segmentation.
+   *
+   */
+  bool checkFixture(const char *name, Fixture fixture)
+  {
+    bool error = false;
+
+    CoreFactory factory;
+
+    auto filter = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+    auto output = filter->output(0);
+
+    Bounds bounds{-SPACING[0]/2, (SIZE - 0.5) * SPACING[0], -SPACING[1]/2, (SIZE - 0.5) * SPACING[1], -SPACING[2]/2, (SIZE - 0.5) * SPACING[2]};
+    auto volume = std::make_shared<SparseVolume<itkVolumeType>>(bounds, SPACING);
+
+    for(int z = 0; z < SIZE; ++z)
+    {
+      for(int y = 0; y < SIZE; ++y)
+      {
+        for(int x = 0; x < SIZE; ++x)
+        {
+          if(fixture(x, y, z))
+          {
+            itkVolumeType::IndexType index;
+            index[0] = x; index[1] = y; index[2] = z;
+
+            volume->draw(index, SEG_VOXEL_VALUE);
+          }
+        }
+      }
+    }
+
+    output->setData(volume);
+    output->setData(std::make_shared<RawMesh>(vtkSmartPointer<vtkPolyData>::New(), SPACING));
+
+    auto segmentation = factory.createSegmentation(filter, 0);
+
+    MorphologicalInformationFactory extensionFactory;
+    auto extension = extensionFactory.createExtension(MorphologicalInformation::TYPE);
+    segmentation->extensions()->add(extension);
+
+    auto shapeFilter = ShapeFilterType::New();
+    shapeFilter->SetInput(volume->itkImage());
+    shapeFilter->SetComputeFeretDiameter(false);
+    shapeFilter->SetComputePerimeter(false);
+    shapeFilter->Update();
+
+    auto labelMap = shapeFilter->GetOutput();
+    if(!labelMap->HasLabel(SEG_VOXEL_VALUE))
+    {
+      cerr << name << ": ITK shape filter didn't find the segmentation." << endl;
+      return true;
+    }
+
+    auto object = labelMap->GetLabelObject(SEG_VOXEL_VALUE);
+
+    auto check = [&error, name](const QString &key, const double computed, const double expected)
+    {
+      if(!equal(computed, expected))
+      {
+        cerr << name << ": unexpected " << key.toStdString() << " value " << computed << ", expected " << expected << endl;
+        error = true;
+      }
+    };
+
+    check("Size",          value(extension, "Size"),          object->GetNumberOfPixels());
+    check("Physical Size", value(extension, "Physical Size"), object->GetPhysicalSize());
+
+    const QString axisNames[3]{"X", "Y", "Z"};
+
+    const auto centroid = object->GetCentroid();
+    const auto moments  = object->GetPrincipalMoments();
+    const auto axes     = object->GetPrincipalAxes();
+    const auto diameter = object->GetEquivalentEllipsoidDiameter();
+
+    for(int i = 0; i < 3; ++i)
+    {
+      auto centroidKey = QString("Centroid %1").arg(axisNames[i]);
+      auto momentKey   = QString("Binary Principal Moments %1").arg(axisNames[i]);
+      auto diameterKey = QString("Equivalent Ellipsoid Diameter %1").arg(axisNames[i]);
+
+      check(centroidKey, value(extension, centroidKey), centroid[i]);
+      check(momentKey,   value(extension, momentKey),   moments[i]);
+      check(diameterKey, value(extension, diameterKey), diameter[i]);
+
+      // the eigenvectors are defined up to their sign.
+      double dot = 0;
+      for(int j = 0; j < 3; ++j)
+      {
+        dot += value(extension, QString("Binary Principal Axes (%1 %2)").arg(i).arg(j)) * axes[i][j];
+      }
+
+      check(QString("Binary Principal Axes %1").arg(i), std::abs(dot), 1.0);
+    }
+
+    return error;
+  }
+}
+
+int morphological_information_itk_shape_comparison(int argc, char** argv)
+{
+  bool error = false;
+
+  error |= checkFixture("Box",       [](int x, int y, int z) { return 2 <= x && x < 6 && 1 <= y && y < 7 && 0 <= z && z < 9; });
+  error |= checkFixture("One slice", [](int x, int y, int z) { return 1 <= x && x < 6 && 2 <= y && y < 10 && z == 4; });
+  error |= checkFixture("One row",   [](int x, int y, int z) { return 3 <= x && x < 10 && y == 5 && z == 7; });
+  error |= checkFixture("Diagonal",  [](int x, int y, int z) { return std::abs(x - y) <= 1 && z < 3; });
+
+  return error;
+}
@@ -0,0 +1,364 @@
+/*
+ File: slic_rle_slices.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Utils/EspinaException.h>
+#include <Extensions/SLIC/StackSLICUtils.h>
+
+// ITK
+#include <itkImage.h>
+
+// Qt
+#include <QByteArray>
+#include <QDataStream>
+
+// C++
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <map>
+#include <vector>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Core::Utils;
+using namespace ESPINA::Extensions::StackSLICUtils;
+
+using Region     = ImageRegion;
+using LabelImage = itk::Image<unsigned int, 3>;
+
+namespace
+{
+  const long int     WIDTH       = 600; /** wider than the longest run. */
+  const long int     HEIGHT      = 9;
+  const long int     SLICES      = 5;
+  const unsigned int SUPERVOXELS = 20;
+
+  /** \brief Label of the voxel, with runs longer than the run limit in even rows, short runs in odd ones,
+   * and labels of non computed supervoxels.
+   *
+   */
+  unsigned int labelValue(const long int x, const long int y, const long int z)
+  {
+    if(y % 2 == 0) return 1 + x / 300 + y;
+
+    return (x * 7 + y + z) % (SUPERVOXELS + 5);
+  }
+
+  /** \brief Returns the label stored for the voxel of the given slice region.
+   *
+   */
+  unsigned int storedLabel(const Region &region, const long int x, const long int y)
+  {
+    if(!region.IsInside(Region::IndexType{x, y, region.GetIndex(2)})) return 0;
+
+    const auto label = labelValue(x, y, region.GetIndex(2));
+
+    return label < SUPERVOXELS ? label : 0;
+  }
+
+  /** \brief Returns the stored region of the slice, inside the stack edges like the computation does.
+   *
+   */
+  Region storedRegion(const long int z)
+  {
+    Region region;
+    region.SetIndex(0, 3 + z);
+    region.SetIndex(1, 1);
+    region.SetIndex(2, z);
+    region.SetSize(0, WIDTH - 7 - 2*z);
+    region.SetSize(1, HEIGHT - 1 - z % 2);
+    region.SetSize(2, 1);
+
+    return region;
+  }
+
+  /** \brief Returns the uncompressed RLE data of the stored region of the slice, as saved by the computation.
+   * \param[in] z slice number.
+   * \param[in] labelsRegion region of the labels buffer.
+   * \param[in] labels labels of the slice voxels of the labels region.
+   *
+   */
+  QByteArray encode(const long int z, const Region &labelsRegion, const std::vector<unsigned int> &labels)
+  {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_0);
+
+    encodeSlice(stream, storedRegion(z), labelsRegion, labels.data(), SUPERVOXELS);
+
+    return data;
+  }
+
+  /** \brief Returns true if the region of the image has the stored labels of the slice.
+   * \param[in] image decoded image.
+   * \param[in] imageIndex index of the region origin in the image.
+   * \param[in] slice stored slice region.
+   * \param[in] region decoded region.
+   *
+   */
+  bool checkLabels(LabelImage *image, const LabelImage::IndexType &imageIndex, const Region &slice, const Region &region)
+  {
+    for(long int y = 0; y < static_cast<long int>(region.GetSize(1)); ++y)
+    {
+      for(long int x = 0; x < static_cast<long int>(region.GetSize(0)); ++x)
+      {
+        const auto expected = storedLabel(slice, region.GetIndex(0) + x, region.GetIndex(1) + y);
+        const auto value    = image->GetPixel(LabelImage::IndexType{imageIndex[0] + x, imageIndex[1] + y, imageIndex[2]});
+
+        if(value != expected)
+        {
+          cerr << "Slice " << slice.GetIndex(2) << ": decoded label " << value << " at " << region.GetIndex(0) + x << ","
+               << region.GetIndex(1) + y << ", expected " << expected << endl;
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /** \brief Returns an image of the given size filled with zeros.
+   *
+   */
+  LabelImage::Pointer createImage(const unsigned long width, const unsigned long height)
+  {
+    Region imageRegion;
+    imageRegion.SetIndex(0, 0);
+    imageRegion.SetIndex(1, 0);
+    imageRegion.SetIndex(2, 0);
+    imageRegion.SetSize(0, width);
+    imageRegion.SetSize(1, height);
+    imageRegion.SetSize(2, 1);
+
+    auto image = LabelImage::New();
+    image->SetRegions(imageRegion);
+    image->Allocate();
+    image->FillBuffer(0);
+
+    return image;
+  }
+}
+
+int slic_rle_slices(int argc, char** argv)
+{
+  bool error = false;
+
+  Region labelsRegion;
+  labelsRegion.SetIndex(0, 0);
+  labelsRegion.SetIndex(1, 0);
+  labelsRegion.SetIndex(2, 0);
+  labelsRegion.SetSize(0, WIDTH);
+  labelsRegion.SetSize(1, HEIGHT);
+  labelsRegion.SetSize(2, 1);
+
+  std::vector<unsigned int> labels(WIDTH * HEIGHT);
+  std::map<int, QByteArray> encoded;
+
+  for(long int z = 0; z < SLICES; ++z)
+  {
+    for(long int y = 0; y < HEIGHT; ++y)
+    {
+      for(long int x = 0; x < WIDTH; ++x)
+      {
+        labels[x + y * WIDTH] = labelValue(x, y, z);
+      }
+    }
+
+    encoded[z] = encode(z, labelsRegion, labels);
+  }
+
+  RLESliceCache cache{256*1024*1024};
+
+  // reads the slice from the cache, decoding and inserting it if not cached.
+  auto rleSlice = [&cache, &encoded](const int z)
+  {
+    auto slice = cache.slice(z);
+    if(!slice) slice = cache.insert(z, decodeSlice(encoded[z], z));
+
+    return slice;
+  };
+
+  try
+  {
+    std::map<int, unsigned long long> sizes;
+
+    for(long int z = 0; z < SLICES; ++z)
+    {
+      const auto sliceRegion = storedRegion(z);
+
+      auto slice = rleSlice(z);
+
+      if(slice->region != sliceRegion)
+      {
+        cerr << "Unexpected region of slice " << z << ": " << slice->region << endl;
+        error = true;
+        continue;
+      }
+
+      sizes[z] = slice->size();
+
+      // voxel labels, inside and outside the slice region.
+      for(long int y = -1; y <= HEIGHT; ++y)
+      {
+        for(long int x = -1; x <= WIDTH; ++x)
+        {
+          const auto expected = storedLabel(sliceRegion, x, y);
+          const auto label    = slice->label(x, y);
+
+          if(label != expected)
+          {
+            cerr << "Slice " << z << ": label " << label << " at " << x << "," << y << ", expected " << expected << endl;
+            error = true;
+          }
+        }
+      }
+
+      // whole slice decoding.
+      auto image = createImage(sliceRegion.GetSize(0), sliceRegion.GetSize(1));
+      const LabelImage::IndexType origin{0, 0, 0};
+
+      slice->decode(sliceRegion, image.GetPointer(), origin, [](const unsigned int label) { return label; });
+
+      error |= !checkLabels(image.GetPointer(), origin, sliceRegion, sliceRegion);
+
+      // partial decoding, starting and ending inside the runs, into an image with a different origin.
+      for(auto offset: {0L, 1L, 254L, 255L, 256L, 299L})
+      {
+        auto decodeRegion = sliceRegion;
+        decodeRegion.SetIndex(0, sliceRegion.GetIndex(0) + offset);
+        decodeRegion.SetIndex(1, sliceRegion.GetIndex(1) + offset % 3);
+        decodeRegion.SetSize(0, std::min<long int>(260, sliceRegion.GetSize(0) - offset));
+        decodeRegion.SetSize(1, sliceRegion.GetSize(1) - offset % 3);
+
+        auto decoded = createImage(decodeRegion.GetSize(0) + 4, decodeRegion.GetSize(1) + 2);
+
+        const LabelImage::IndexType index{2, 1, 0};
+
+        slice->decode(decodeRegion, decoded.GetPointer(), index, [](const unsigned int label) { return label; });
+
+        error |= !checkLabels(decoded.GetPointer(), index, sliceRegion, decodeRegion);
+      }
+    }
+
+    if(error) return error;
+
+    // cached slices from most to least recently used.
+    if(cache.slices() != std::list<int>{4, 3, 2, 1, 0})
+    {
+      cerr << "Unexpected cached slices after reading all of them" << endl;
+      error = true;
+    }
+
+    unsigned long long total = 0;
+    for(auto size: sizes) total += size.second;
+
+    if(cache.size() != total)
+    {
+      cerr << "Cache size " << cache.size() << ", expected " << total << endl;
+      error = true;
+    }
+
+    // cached slices are reused, the slice inserted first is kept.
+    auto first  = rleSlice(1);
+    auto second = rleSlice(1);
+    auto other  = cache.insert(1, decodeSlice(encoded[1], 1));
+    if(first != second || first != other || cache.slices().front() != 1 || cache.size() != total)
+    {
+      cerr << "Cached slice wasn't reused" << endl;
+      error = true;
+    }
+
+    // the least recently used slices are evicted to keep the cache under the budget.
+    cache.clear();
+    cache.setBudget(sizes[0] + sizes[1] + sizes[2]);
+
+    std::list<int> expected;
+    unsigned long long expectedSize = 0;
+
+    for(auto z: {0, 1, 2, 0, 3, 4, 1, 0, 2})
+    {
+      rleSlice(z);
+
+      if(std::find(expected.begin(), expected.end(), z) == expected.end())
+      {
+        expectedSize += sizes[z];
+      }
+      expected.remove(z);
+      expected.push_front(z);
+
+      while(expectedSize > sizes[0] + sizes[1] + sizes[2] && expected.size() > 1)
+      {
+        expectedSize -= sizes[expected.back()];
+        expected.pop_back();
+      }
+
+      if(cache.slices() != expected || cache.size() != expectedSize)
+      {
+        cerr << "Unexpected cache contents after reading slice " << z << endl;
+        error = true;
+      }
+    }
+
+    // a slice bigger than the budget is the only cached one, evicted slices are still valid.
+    cache.setBudget(1);
+
+    auto evicted = rleSlice(3);
+    rleSlice(4);
+
+    if(cache.slices() != std::list<int>{4} || cache.size() != sizes[4])
+    {
+      cerr << "Unexpected cache contents with a budget smaller than a slice" << endl;
+      error = true;
+    }
+
+    if(evicted->label(storedRegion(3).GetIndex(0), 2) != storedLabel(storedRegion(3), storedRegion(3).GetIndex(0), 2))
+    {
+      cerr << "Evicted slice data isn't valid" << endl;
+      error = true;
+    }
+  }
+  catch(const EspinaException &e)
+  {
+    cerr << "Unexpected exception: " << e.what() << " " << e.details() << endl;
+    return true;
+  }
+
+  // truncated data is rejected, the labels of the encoded slice don't matter.
+  auto truncated = encode(2, labelsRegion, labels);
+  truncated.chop(RLESlice::RUN_SIZE + 1);
+
+  bool thrown = false;
+  try
+  {
+    decodeSlice(truncated, 2);
+  }
+  catch(const EspinaException &e)
+  {
+    thrown = true;
+  }
+
+  if(!thrown)
+  {
+    cerr << "Truncated slice data wasn't rejected" << endl;
+    error = true;
+  }
+
+  return error;
+}
@@ -0,0 +1,315 @@
+/*
+ File: slic_stack_slabs.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Extensions/SLIC/StackSLICUtils.h>
+
+// C++
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Extensions::StackSLICUtils;
+
+namespace
+{
+  const unsigned char S    = 4;
+  const unsigned char C    = 20;
+  const int           SIZE = 16;
+
+  /** \brief Value of the voxels of the synthetic stack, four regions of uniform color.
+   *
+   */
+  unsigned char voxelValue(const long int x, const long int z)
+  {
+    return (x < 7 ? 40 : 180) + (z < 9 ? 0 : 30);
+  }
+
+  /** \brief Sums of the voxels of each center computed assigning every voxel to the closest center of
+   * the whole stack, in the same order the slabs process the centers.
+   *
+   */
+  std::vector<CenterSums> expectedSums(const Centers &centers, itkVolumeType *image)
+  {
+    std::vector<CenterSums> sums(centers.size(), CenterSums{0, 0, 0, 0, 0, 0, 0});
+
+    for(long int z = 0; z < SIZE; ++z)
+    {
+      for(long int y = 0; y < SIZE; ++y)
+      {
+        for(long int x = 0; x < SIZE; ++x)
+        {
+          const float value = image->GetPixel(itkVolumeType::IndexType{x, y, z});
+
+          auto best     = std::numeric_limits<float>::max();
+          auto selected = std::numeric_limits<unsigned int>::max();
+
+          for(auto center: centers.order)
+          {
+            const auto cx = centers.x[center];
+            const auto cy = centers.y[center];
+            const auto cz = centers.z[center];
+
+            if(x < cx - S || x >= cx + S || y < cy - S || y >= cy + S || z < cz - S || z >= cz + S) continue;
+
+            const float color    = centers.color[center];
+            const float dz2      = (z - cz) * (z - cz);
+            const float dyz2     = dz2 + (y - cy) * (y - cy);
+            const float dc       = (value - color) * COLOR_NORMALIZATION;
+            const float distance = dc * dc + centers.normQuotient[center] * (dyz2 + (x - cx) * (x - cx));
+
+            if(distance < best)
+            {
+              best     = distance;
+              selected = center;
+            }
+          }
+
+          if(selected == std::numeric_limits<unsigned int>::max()) continue;
+
+          auto &centerSums = sums[selected];
+          ++centerSums.voxels;
+          centerSums.x     += x;
+          centerSums.y     += y;
+          centerSums.z     += z;
+          centerSums.color += static_cast<unsigned long long>(value);
+        }
+      }
+    }
+
+    return sums;
+  }
+
+  /** \brief Returns the sums of the center merging the ones of the slabs that have it in their halo.
+   *
+   */
+  CenterSums mergedSums(const std::vector<Slab> &slabs, const unsigned int position)
+  {
+    CenterSums total{0, 0, 0, 0, 0, 0, 0};
+
+    for(auto &slab: slabs)
+    {
+      if(position < slab.first || position >= slab.first + slab.sums.size()) continue;
+
+      const auto &sums = slab.sums[position - slab.first];
+
+      total.voxels += sums.voxels;
+      total.x      += sums.x;
+      total.y      += sums.y;
+      total.z      += sums.z;
+      total.color  += sums.color;
+    }
+
+    return total;
+  }
+}
+
+int slic_stack_slabs(int argc, char** argv)
+{
+  bool error = false;
+
+  auto image = create_itkImage<itkVolumeType>(Bounds{-0.5, SIZE - 0.5, -0.5, SIZE - 0.5, -0.5, SIZE - 0.5});
+  const auto region = image->GetLargestPossibleRegion();
+
+  for(long int z = 0; z < SIZE; ++z)
+  {
+    for(long int y = 0; y < SIZE; ++y)
+    {
+      for(long int x = 0; x < SIZE; ++x)
+      {
+        image->SetPixel(itkVolumeType::IndexType{x, y, z}, voxelValue(x, z));
+      }
+    }
+  }
+
+  // the whole slices are inside the stack edges.
+  std::vector<ImageRegion> sliceRegions;
+  for(long int z = 0; z < SIZE; ++z)
+  {
+    auto sliceRegion = region;
+    sliceRegion.SetIndex(2, z);
+    sliceRegion.SetSize(2, 1);
+
+    sliceRegions.push_back(sliceRegion);
+  }
+
+  // initial centers in a grid, like StackSLIC places them.
+  Centers centers;
+  for(long int z = S/2; z < SIZE; z += S)
+  {
+    for(long int y = S/2; y < SIZE; y += S)
+    {
+      for(long int x = S/2; x < SIZE; x += S)
+      {
+        centers.x.push_back(x);
+        centers.y.push_back(y);
+        centers.z.push_back(z);
+        centers.color.push_back(voxelValue(x, z));
+        centers.normQuotient.push_back(static_cast<float>(C * C) / (S * S));
+        centers.valid.push_back(true);
+      }
+    }
+  }
+
+  // SLIC variant, the normalization quotients don't change.
+  const NormalizationFunction normalization = [](const CenterSums &total, const float quotient) { return quotient; };
+  const auto canExecute = []() { return true; };
+
+  // slabs are one grid step thick.
+  auto slabs = createSlabs(region, S);
+
+  if(slabs.size() != SIZE/S)
+  {
+    cerr << "Unexpected number of slabs: " << slabs.size() << ", expected " << SIZE/S << endl;
+    return true;
+  }
+
+  for(unsigned int i = 0; i < slabs.size(); ++i)
+  {
+    if(slabs[i].region.GetIndex(2) != static_cast<long int>(i * S) || slabs[i].region.GetSize(2) != S ||
+       slabs[i].region.GetSize(0) != SIZE || slabs[i].region.GetSize(1) != SIZE)
+    {
+      cerr << "Unexpected region of slab " << i << ": " << slabs[i].region << endl;
+      error = true;
+    }
+  }
+
+  unsigned int iteration = 0;
+  bool converged = false;
+
+  while(!converged && iteration < 20)
+  {
+    updateLayers(centers, slabs, region, S);
+
+    // centers ordered by layer, the halo of a slab are the centers of its layer and the adjacent ones.
+    for(unsigned int position = 0; position < centers.size(); ++position)
+    {
+      const auto center = centers.order[position];
+      const auto layer  = std::min<long int>(slabs.size() - 1, std::max<long int>(0, centers.z[center] / S));
+
+      if(centers.layer[center] != layer || centers.position[center] != position ||
+         position < centers.layerStart[layer] || position >= centers.layerStart[layer + 1])
+      {
+        cerr << "Iteration " << iteration << ": center " << center << " has an unexpected layer " << centers.layer[center]
+             << " or position " << centers.position[center] << endl;
+        error = true;
+      }
+    }
+
+    for(unsigned int layer = 0; layer < slabs.size(); ++layer)
+    {
+      const auto first = centers.layerStart[layer > 0 ? layer - 1 : 0];
+      const auto last  = centers.layerStart[std::min<unsigned int>(layer + 2, slabs.size())];
+
+      if(slabs[layer].first != first || slabs[layer].sums.size() != last - first)
+      {
+        cerr << "Iteration " << iteration << ": unexpected halo of slab " << layer << ": " << slabs[layer].first << "-"
+             << slabs[layer].first + slabs[layer].sums.size() << ", expected " << first << "-" << last << endl;
+        error = true;
+      }
+    }
+
+    if(error) return error;
+
+    for(auto &slab: slabs)
+    {
+      std::vector<unsigned int> labels;
+
+      if(!computeSlab(slab, centers, image.GetPointer(), region, sliceRegions, S, false, labels, canExecute) || labels.size() != slab.region.GetNumberOfPixels())
+      {
+        cerr << "Iteration " << iteration << ": slab " << slab.region.GetIndex(2) / S << " not computed" << endl;
+        error = true;
+        continue;
+      }
+
+      unsigned long long assigned = 0;
+      for(auto &sums: slab.sums) assigned += sums.voxels;
+
+      if(assigned != slab.region.GetNumberOfPixels())
+      {
+        cerr << "Iteration " << iteration << ": " << assigned << " voxels of the slab " << slab.region.GetIndex(2) / S
+             << " assigned, expected " << slab.region.GetNumberOfPixels() << endl;
+        error = true;
+      }
+    }
+
+    // the halos must give the same assignment as searching all the centers.
+    auto expected = expectedSums(centers, image.GetPointer());
+
+    for(unsigned int center = 0; center < centers.size(); ++center)
+    {
+      auto sums = mergedSums(slabs, centers.position[center]);
+      auto &reference = expected[center];
+
+      if(sums.voxels != reference.voxels || sums.x != reference.x || sums.y != reference.y || sums.z != reference.z || sums.color != reference.color)
+      {
+        cerr << "Iteration " << iteration << ": unexpected sums of center " << center << ", " << sums.voxels << " voxels, expected "
+             << reference.voxels << endl;
+        error = true;
+      }
+    }
+
+    if(error) return error;
+
+    converged = true;
+    for(unsigned int layer = 0; layer < slabs.size(); ++layer)
+    {
+      converged &= updateCenters(centers, layer, slabs, 0.5, normalization);
+    }
+
+    // the centers are the mean of their voxels.
+    for(unsigned int center = 0; center < centers.size(); ++center)
+    {
+      auto &reference = expected[center];
+
+      if(reference.voxels == 0)
+      {
+        if(centers.valid[center])
+        {
+          cerr << "Iteration " << iteration << ": center " << center << " without voxels is valid" << endl;
+          error = true;
+        }
+
+        continue;
+      }
+
+      if(centers.x[center] != std::llround(static_cast<double>(reference.x) / reference.voxels) ||
+         centers.y[center] != std::llround(static_cast<double>(reference.y) / reference.voxels) ||
+         centers.z[center] != std::llround(static_cast<double>(reference.z) / reference.voxels) ||
+         centers.color[center] != reference.color / reference.voxels)
+      {
+        cerr << "Iteration " << iteration << ": center " << center << " isn't the mean of its voxels" << endl;
+        error = true;
+      }
+    }
+
+    ++iteration;
+  }
+
+  if(!converged)
+  {
+    cerr << "Centers haven't converged after " << iteration << " iterations" << endl;
+    error = true;
+  }
+
+  return error;
+}
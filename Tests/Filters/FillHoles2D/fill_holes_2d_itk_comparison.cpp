@@ -0,0 +1,231 @@
+/*
+ File: fill_holes_2d_itk_comparison.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Analysis/Data/VolumetricData.hxx>
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
+#include <Core/Factory/CoreFactory.h>
+#include <Filters/FillHoles2DFilter.h>
+#include <testing_support_dummy_filter.h>
+
+// ITK
+#include <itkBinaryFillholeImageFilter.h>
+#include <itkImage.h>
+
+// C++
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Testing;
+
+using SliceImageType = itk::Image<itkVolumeType::PixelType, 2>;
+using FillholeFilter = itk::BinaryFillholeImageFilter<SliceImageType>;
+
+namespace
+{
+  const long int SIZE[3]{15, 13, 11};
+
+  /** \brief Returns true if the voxel is inside the box.
+   *
+   */
+  bool inside(const itkVolumeType::IndexType &index, const long int min[3], const long int max[3])
+  {
+    for(int i = 0; i < 3; ++i)
+    {
+      if(index[i] < min[i] || index[i] > max[i]) return false;
+    }
+
+    return true;
+  }
+
+  /** \brief Returns true if the voxel is in the faces of the box.
+   *
+   */
+  bool shell(const itkVolumeType::IndexType &index, const long int min[3], const long int max[3])
+  {
+    if(!inside(index, min, max)) return false;
+
+    for(int i = 0; i < 3; ++i)
+    {
+      if(index[i] == min[i] || index[i] == max[i]) return true;
+    }
+
+    return false;
+  }
+
+  /** \brief Returns the input segmentation image: foreground noise with a closed hollow box, that makes holes
+   * in the slices of every direction, and a hollow box open at the X volume border, that makes areas enclosed
+   * in all but one side touching the border of the Z and Y slices.
+   *
+   */
+  itkVolumeType::Pointer createImage()
+  {
+    auto image = create_itkImage<itkVolumeType>(Bounds{-0.5, SIZE[0] - 0.5, -0.5, SIZE[1] - 0.5, -0.5, SIZE[2] - 0.5});
+
+    std::mt19937 generator(11);
+    std::bernoulli_distribution noise(0.55);
+
+    const long int closedMin[3]{8, 2, 2},  closedMax[3]{13, 8, 8};
+    const long int openMin[3]  {-1, 7, 3}, openMax[3]  {4, 12, 9};
+
+    for(long int z = 0; z < SIZE[2]; ++z)
+    {
+      for(long int y = 0; y < SIZE[1]; ++y)
+      {
+        for(long int x = 0; x < SIZE[0]; ++x)
+        {
+          const itkVolumeType::IndexType index{x, y, z};
+
+          bool foreground = noise(generator);
+
+          if(inside(index, closedMin, closedMax)) foreground = shell(index, closedMin, closedMax);
+          if(inside(index, openMin, openMax))     foreground = shell(index, openMin, openMax);
+
+          image->SetPixel(index, foreground ? SEG_VOXEL_VALUE : SEG_BG_VALUE);
+        }
+      }
+    }
+
+    return image;
+  }
+
+  /** \brief Returns the result of the ITK fill hole filter for the given slice of the image.
+   * \param[in] image input image.
+   * \param[in] dir slice direction.
+   * \param[in] slice slice number.
+   *
+   */
+  SliceImageType::Pointer itkFilledSlice(itkVolumeType::Pointer image, const int dir, const long int slice)
+  {
+    const int uAxis = (dir == 0) ? 1 : 0;
+    const int vAxis = (dir == 2) ? 1 : 2;
+
+    SliceImageType::RegionType region;
+    region.SetIndex(0, 0);
+    region.SetIndex(1, 0);
+    region.SetSize(0, SIZE[uAxis]);
+    region.SetSize(1, SIZE[vAxis]);
+
+    auto sliceImage = SliceImageType::New();
+    sliceImage->SetRegions(region);
+    sliceImage->Allocate();
+
+    for(long int v = 0; v < SIZE[vAxis]; ++v)
+    {
+      for(long int u = 0; u < SIZE[uAxis]; ++u)
+      {
+        itkVolumeType::IndexType index;
+        index[dir]   = slice;
+        index[uAxis] = u;
+        index[vAxis] = v;
+
+        sliceImage->SetPixel(SliceImageType::IndexType{u, v}, image->GetPixel(index));
+      }
+    }
+
+    auto filter = FillholeFilter::New();
+    filter->SetInput(sliceImage);
+    filter->SetForegroundValue(SEG_VOXEL_VALUE);
+    filter->SetFullyConnected(false);
+    filter->Update();
+
+    return filter->GetOutput();
+  }
+
+  /** \brief Returns true if the output of the filter in the given direction doesn't match the one of the ITK
+   * fill hole filter applied slice by slice.
+   * \param[in] axis filter direction.
+   *
+   */
+  bool checkDirection(const Axis axis)
+  {
+    bool error = false;
+
+    const int dir = idx(axis);
+    const int uAxis = (dir == 0) ? 1 : 0;
+    const int vAxis = (dir == 2) ? 1 : 2;
+
+    CoreFactory factory;
+
+    auto image  = createImage();
+    auto source = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+    source->output(0)->setData(std::make_shared<SparseVolume<itkVolumeType>>(image, equivalentBounds<itkVolumeType>(image)));
+
+    InputSList inputs;
+    inputs << getInput(source, 0);
+
+    auto filter = std::make_shared<FillHoles2DFilter>(inputs, "FillHoles2DFilter", SchedulerSPtr());
+    filter->setDirection(axis);
+    filter->update();
+
+    auto output = readLockVolume(filter->output(0))->itkImage(equivalentBounds<itkVolumeType>(image));
+
+    unsigned long long filled = 0;
+
+    for(long int slice = 0; slice < SIZE[dir]; ++slice)
+    {
+      auto expected = itkFilledSlice(image, dir, slice);
+
+      for(long int v = 0; v < SIZE[vAxis]; ++v)
+      {
+        for(long int u = 0; u < SIZE[uAxis]; ++u)
+        {
+          itkVolumeType::IndexType index;
+          index[dir]   = slice;
+          index[uAxis] = u;
+          index[vAxis] = v;
+
+          const bool expectedForeground = expected->GetPixel(SliceImageType::IndexType{u, v}) == SEG_VOXEL_VALUE;
+          const bool foreground         = output->GetPixel(index) == SEG_VOXEL_VALUE;
+
+          if(foreground != expectedForeground)
+          {
+            cerr << "Direction " << dir << ": unexpected value " << static_cast<int>(output->GetPixel(index)) << " at " << index << endl;
+            error = true;
+          }
+
+          if(expectedForeground && image->GetPixel(index) != SEG_VOXEL_VALUE) ++filled;
+        }
+      }
+    }
+
+    if(filled == 0)
+    {
+      cerr << "Direction " << dir << ": the input image has no holes" << endl;
+      error = true;
+    }
+
+    return error;
+  }
+}
+
+int fill_holes_2d_itk_comparison(int argc, char** argv)
+{
+  bool error = false;
+
+  for(auto axis: {Axis::X, Axis::Y, Axis::Z})
+  {
+    error |= checkDirection(axis);
+  }
+
+  return error;
+}
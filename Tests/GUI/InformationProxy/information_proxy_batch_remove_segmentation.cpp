@@ -0,0 +1,257 @@
+/*
+ File: information_proxy_batch_remove_segmentation.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Analysis/Extensions.h>
+#include <Core/MultiTasking/Scheduler.h>
+#include <GUI/ModelFactory.h>
+#include <GUI/Model/SegmentationAdapter.h>
+#include <GUI/Model/Proxies/InformationProxy.h>
+#include <testing_support_dummy_filter.h>
+
+// Qt
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+
+// C++
+#include <iostream>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Core;
+using namespace ESPINA::Testing;
+
+namespace ESPINA
+{
+  namespace Testing
+  {
+    /** \class InformationProxyTester
+     * \brief Gives the test access to the batch task of the information proxy.
+     *
+     */
+    class InformationProxyTester
+    : public InformationProxy
+    {
+      public:
+        using BatchFetcher     = InformationProxy::InformationBatchFetcher;
+        using BatchFetcherSPtr = InformationProxy::InformationBatchFetcherSPtr;
+    };
+  }
+}
+
+using BatchFetcher = InformationProxyTester::BatchFetcher;
+
+namespace
+{
+  const int     SEGMENTATIONS  = 40;
+  const QString EXTENSION_TYPE = "InformationProxyTestingExtension";
+
+  /** \class CountingExtension
+   * \brief Extension that counts the computations of its information and, if it has a gate, waits for
+   * it to be opened before computing it.
+   *
+   */
+  class CountingExtension
+  : public SegmentationExtension
+  {
+    public:
+      explicit CountingExtension(QSemaphore *entered = nullptr, QSemaphore *gate = nullptr)
+      : SegmentationExtension(InfoCache())
+      , m_computations{0}
+      , m_entered     {entered}
+      , m_gate        {gate}
+      {}
+
+      virtual Type type() const override
+      { return EXTENSION_TYPE; }
+
+      virtual bool invalidateOnChange() const override
+      { return false; }
+
+      virtual State state() const override
+      { return State(); }
+
+      virtual Snapshot snapshot() const override
+      { return Snapshot(); }
+
+      virtual const TypeList dependencies() const override
+      { return TypeList(); }
+
+      virtual bool validCategory(const QString &classificationName) const override
+      { return true; }
+
+      virtual bool validData(const OutputSPtr output) const override
+      { return true; }
+
+      virtual const InformationKeyList availableInformation() const override
+      { return InformationKeyList() << createKey("Value"); }
+
+      /** \brief Returns the number of computations of the information.
+       *
+       */
+      int computations() const
+      { return m_computations.load(); }
+
+    protected:
+      virtual void onExtendedItemSet(Segmentation *item) override
+      {}
+
+      virtual QVariant cacheFail(const InformationKey &key) const override
+      {
+        if (m_gate)
+        {
+          m_entered->release();
+          m_gate->acquire();
+        }
+
+        m_computations.fetchAndAddOrdered(1);
+
+        updateInfoCache(key.value(), 1);
+
+        return 1;
+      }
+
+    private:
+      mutable QAtomicInt m_computations; /** number of computations of the information.     */
+      QSemaphore        *m_entered;      /** released when the computation starts.           */
+      QSemaphore        *m_gate;         /** acquired before computing the information.      */
+  };
+
+  /** \brief Waits until the scheduler has executed all its tasks, returns false on timeout.
+   *
+   */
+  bool waitForTasks(SchedulerSPtr scheduler)
+  {
+    int waited = 0;
+    while(scheduler->numberOfTasks() > 0 && waited < 10000)
+    {
+      QThread::msleep(5);
+      waited += 5;
+    }
+
+    return scheduler->numberOfTasks() == 0;
+  }
+}
+
+int information_proxy_batch_remove_segmentation(int argc, char** argv)
+{
+  bool error = false;
+
+  ModelFactory factory{make_shared<CoreFactory>()};
+
+  auto filter = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+
+  QSemaphore entered, gate;
+
+  QList<SegmentationAdapterSPtr>            segmentations;
+  QList<std::shared_ptr<CountingExtension>> extensions;
+  SegmentationAdapterList                   batch;
+
+  for (int i = 0; i < SEGMENTATIONS; ++i)
+  {
+    auto segmentation = factory.createSegmentation(filter, 0);
+
+    // the computation of the first segmentation waits until the removals are done.
+    auto extension = (i == 0) ? std::make_shared<CountingExtension>(&entered, &gate) : std::make_shared<CountingExtension>();
+    segmentation->extensions()->add(extension);
+
+    segmentations << segmentation;
+    extensions    << extension;
+    batch         << segmentation.get();
+  }
+
+  const SegmentationExtension::InformationKey key(EXTENSION_TYPE, "Value");
+
+  SegmentationExtension::InformationKeyList keys;
+  keys << InformationProxy::NameKey() << key;
+
+  auto scheduler = make_shared<Scheduler>(1000, Scheduler::ExecutionMode::THREAD_POOL);
+  auto task      = make_shared<BatchFetcher>(batch, keys, scheduler);
+
+  Task::submit(task);
+
+  if (!entered.tryAcquire(1, 10000))
+  {
+    cerr << "The batch task hasn't started" << endl;
+    gate.release();
+    return true;
+  }
+
+  // removals in the running rows batch, in a later one and at the end of the task.
+  const QList<int> removed{5, 20, SEGMENTATIONS - 1};
+  for (auto i : removed)
+  {
+    task->removeSegmentation(batch.at(i));
+  }
+
+  gate.release();
+
+  if (!waitForTasks(scheduler))
+  {
+    cerr << "The batch task hasn't finished" << endl;
+    return true;
+  }
+
+  if (task->isAborted() || !task->hasFinished() || task->readySegmentations() != SEGMENTATIONS)
+  {
+    cerr << "The batch task didn't complete, " << task->readySegmentations() << " ready segmentations" << endl;
+    error = true;
+  }
+
+  SegmentationAdapterList expected;
+  for (int i = 0; i < SEGMENTATIONS; ++i)
+  {
+    auto segmentation = batch.at(i);
+    auto isRemoved    = removed.contains(i);
+
+    if (extensions.at(i)->computations() != (isRemoved ? 0 : 1))
+    {
+      cerr << "Segmentation " << i << " information computed " << extensions.at(i)->computations() << " times" << endl;
+      error = true;
+    }
+
+    if (task->isReady(segmentation) == isRemoved || segmentation->isReady(key) == isRemoved)
+    {
+      cerr << "Unexpected ready state of segmentation " << i << endl;
+      error = true;
+    }
+
+    if (!isRemoved) expected << segmentation;
+  }
+
+  // only the rest of the segmentations are notified, once.
+  if (task->takeReadySegmentations() != expected || !task->takeReadySegmentations().isEmpty())
+  {
+    cerr << "Unexpected ready segmentations" << endl;
+    error = true;
+  }
+
+  // removing a segmentation not in the task or from a finished task doesn't change it.
+  task->removeSegmentation(nullptr);
+  task->removeSegmentation(batch.at(0));
+
+  if (task->readySegmentations() != SEGMENTATIONS || !task->takeReadySegmentations().isEmpty())
+  {
+    cerr << "Unexpected ready segmentations after the task has finished" << endl;
+    error = true;
+  }
+
+  return error;
+}
@@ -0,0 +1,151 @@
+/*
+ File: model_adapter_lookup_indices.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Analysis/Analysis.h>
+#include <Core/Analysis/Channel.h>
+#include <Core/Analysis/Output.h>
+#include <Core/Analysis/Filter.h>
+#include <Core/Analysis/Segmentation.h>
+#include <Core/MultiTasking/Scheduler.h>
+
+#include <GUI/Model/ModelAdapter.h>
+#include <GUI/ModelFactory.h>
+
+#include "testing_support_dummy_filter.h"
+#include "ModelTest.h"
+
+using namespace std;
+using namespace ESPINA;
+using namespace Testing;
+
+namespace
+{
+  /** \brief Returns true if the rows and adapters obtained from the model indices match the
+   * model segmentations.
+   *
+   */
+  bool checkSegmentations(ModelAdapter &model, AnalysisSPtr analysis)
+  {
+    auto segmentations = model.segmentations();
+
+    for(int row = 0; row < segmentations.size(); ++row)
+    {
+      auto segmentation = segmentations.at(row);
+      auto index        = model.segmentationIndex(segmentation);
+
+      if(!index.isValid() || index.row() != row || itemAdapter(index) != segmentation.get())
+      {
+        cerr << "Unexpected index of segmentation at row " << row << endl;
+        return false;
+      }
+    }
+
+    if(analysis->segmentations().size() != segmentations.size())
+    {
+      cerr << "Unexpected number of segmentations in analysis" << endl;
+      return false;
+    }
+
+    for(auto segmentation: analysis->segmentations())
+    {
+      auto adapter = model.find(segmentation);
+
+      if(!adapter || adapter->uuid() != segmentation->uuid())
+      {
+        cerr << "Unexpected adapter of segmentation " << segmentation->name().toStdString() << endl;
+        return false;
+      }
+    }
+
+    return true;
+  }
+}
+
+int model_adapter_lookup_indices(int argc, char** argv)
+{
+  bool error = false;
+
+  auto analysis    = make_shared<Analysis>();
+  auto coreFactory = make_shared<CoreFactory>();
+  auto factory     = make_shared<ModelFactory>(coreFactory);
+
+  ModelAdapter modelAdapter;
+  ModelTest    modelTester(&modelAdapter);
+
+  modelAdapter.setAnalysis(analysis, factory);
+
+  InputSList inputs;
+  Filter::Type type{"DummyFilter"};
+
+  auto filter = factory->createFilter<DummyFilter>(inputs, type);
+
+  SegmentationAdapterSList segmentations;
+  for(int i = 0; i < 20; ++i)
+  {
+    segmentations << factory->createSegmentation(filter, 0);
+  }
+
+  modelAdapter.add(segmentations);
+  error |= !checkSegmentations(modelAdapter, analysis);
+
+  // non consecutive removals in batch mode shift the rows of the remaining segmentations.
+  SegmentationAdapterSList removed;
+  removed << segmentations[0] << segmentations[7] << segmentations[8] << segmentations[15];
+
+  modelAdapter.beginBatchMode();
+  modelAdapter.remove(removed);
+  modelAdapter.endBatchMode();
+
+  error |= !checkSegmentations(modelAdapter, analysis);
+
+  for(auto segmentation: removed)
+  {
+    if(modelAdapter.segmentationIndex(segmentation).isValid())
+    {
+      cerr << "Removed segmentation still has a valid index" << endl;
+      error = true;
+    }
+  }
+
+  // additions after removals.
+  auto added = factory->createSegmentation(filter, 0);
+  modelAdapter.add(added);
+
+  error |= !checkSegmentations(modelAdapter, analysis);
+
+  if(modelAdapter.segmentationIndex(added).row() != modelAdapter.segmentations().size() - 1)
+  {
+    cerr << "Unexpected row of the last added segmentation" << endl;
+    error = true;
+  }
+
+  // a removed segmentation can be added again.
+  modelAdapter.add(removed.first());
+  error |= !checkSegmentations(modelAdapter, analysis);
+
+  modelAdapter.clear();
+
+  if(modelAdapter.segmentationIndex(added).isValid())
+  {
+    cerr << "Segmentation has a valid index after clearing the model" << endl;
+    error = true;
+  }
+
+  return error;
+}
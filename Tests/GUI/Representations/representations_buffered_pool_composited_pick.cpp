@@ -0,0 +1,143 @@
+/*
+ File: representations_buffered_pool_composited_pick.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <GUI/ModelFactory.h>
+#include <GUI/Model/SegmentationAdapter.h>
+#include <GUI/Model/Utils/SegmentationLocator.h>
+#include <GUI/Representations/Frame.h>
+#include <GUI/Representations/ManualPipelineSources.h>
+#include <GUI/Representations/Pools/BufferedRepresentationPool.h>
+#include <GUI/View/ViewState.h>
+#include "representations_testing_support.h"
+#include <testing_support_dummy_filter.h>
+
+// VTK
+#include <vtkImageActor.h>
+
+// C++
+#include <iostream>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Testing;
+using namespace ESPINA::GUI::Model::Utils;
+using namespace ESPINA::GUI::Representations;
+using ViewState = GUI::View::ViewState;
+
+namespace
+{
+  /** \brief Returns true if the picked items are the expected ones, in any order.
+   *
+   */
+  bool checkPick(const ViewItemAdapterList &picked, const ViewItemAdapterList &expected, const char *method)
+  {
+    auto valid = (picked.size() == expected.size()) && (picked.toSet() == expected.toSet());
+
+    if(!valid)
+    {
+      cerr << "Unexpected items picked " << method << ": " << picked.size() << " expected " << expected.size() << endl;
+    }
+
+    return valid;
+  }
+}
+
+int representations_buffered_pool_composited_pick(int argc, char** argv)
+{
+  bool error = false;
+
+  ViewState             viewState;
+  ManualPipelineSources sources{viewState};
+  ModelFactory          factory{make_shared<CoreFactory>()};
+
+  // segmentations sharing the bounds, the pipeline decides which ones contain the point.
+  SegmentationAdapterSList segmentations;
+  ViewItemAdapterList      items;
+  for(int i = 0; i < 3; ++i)
+  {
+    auto filter = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+    filter->output(0)->setData(make_shared<DummyData>());
+
+    segmentations << factory.createSegmentation(filter, 0);
+    items << segmentations.last().get();
+  }
+
+  sources.addSource(items, Frame::InvalidFrame());
+
+  auto locator = make_shared<ManualSegmentationLocator>();
+  for(auto segmentation: segmentations) locator->insert(segmentation);
+
+  auto pipeline  = make_shared<CompositedTestingPipeline>();
+  auto scheduler = make_shared<Scheduler>(10000000);
+
+  TestingBufferedPool pool{pipeline, scheduler, locator};
+  pool.setPipelineSources(&sources);
+
+  TestingBufferedPool linearPool{pipeline, scheduler};
+  linearPool.setPipelineSources(&sources);
+
+  // the first two segmentations are composited, the last one has its own (temporal) actor.
+  auto composited = vtkSmartPointer<vtkImageActor>::New();
+  auto temporal   = vtkSmartPointer<vtkImageActor>::New();
+  auto unknown    = vtkSmartPointer<vtkImageActor>::New();
+
+  auto actors = make_shared<RepresentationPipeline::ActorsData>();
+  {
+    RepresentationPipeline::ActorsLocker locker(actors);
+    locker.get()[nullptr]  << composited;
+    locker.get()[items[2]] << temporal;
+  }
+
+  pool.setActors(viewState.createFrame(), actors);
+  linearPool.setActors(viewState.createFrame(), actors);
+
+  const NmVector3 point{0.5, 0.5, 0.5};
+
+  pipeline->picked = { items[0], items[2] };
+
+  // locator candidates.
+  error |= !checkPick(pool.pick(point, nullptr), { items[0], items[2] }, "with the locator");
+
+  // composited actor, resolved among the composited items.
+  error |= !checkPick(linearPool.pick(point, composited), { items[0] }, "with the composited actor");
+
+  // own actor.
+  error |= !checkPick(linearPool.pick(point, temporal), { items[2] }, "with the item actor");
+
+  // actor not in the pool.
+  error |= !checkPick(linearPool.pick(point, unknown), {}, "with an unknown actor");
+
+  // no actor, all the represented items.
+  error |= !checkPick(linearPool.pick(point, nullptr), { items[0], items[2] }, "without actor");
+
+  // nothing picked by the pipeline, the locator falls back to the linear methods.
+  pipeline->picked = {};
+
+  error |= !checkPick(pool.pick(point, composited), {}, "with the locator and the composited actor");
+  error |= !checkPick(pool.pick(point, nullptr),    {}, "with the locator and without actor");
+
+  // items removed from the sources aren't picked with the composited actor.
+  pipeline->picked = { items[0], items[1] };
+  sources.removeSource({ items[1] }, Frame::InvalidFrame());
+
+  error |= !checkPick(linearPool.pick(point, composited), { items[0] }, "after removing a source");
+
+  return error;
+}
@@ -0,0 +1,183 @@
+/*
+ File: representations_buffered_pool_reach.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <GUI/ModelFactory.h>
+#include <GUI/Model/SegmentationAdapter.h>
+#include <GUI/Representations/Frame.h>
+#include <GUI/Representations/ManualPipelineSources.h>
+#include <GUI/View/ViewState.h>
+#include "representations_testing_support.h"
+#include <testing_support_dummy_filter.h>
+
+// Qt
+#include <QThread>
+
+// C++
+#include <iostream>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Testing;
+using namespace ESPINA::GUI::Representations;
+using ViewState = GUI::View::ViewState;
+
+namespace
+{
+  const unsigned WINDOW_SIZE = 4;
+
+  /** \brief Waits until the scheduler has executed all its tasks, returns false on timeout.
+   *
+   */
+  bool waitForTasks(SchedulerSPtr scheduler)
+  {
+    int waited = 0;
+    while(scheduler->numberOfTasks() > 0 && waited < 10000)
+    {
+      QThread::msleep(5);
+      waited += 5;
+    }
+
+    return scheduler->numberOfTasks() == 0;
+  }
+
+  /** \brief Moves the pool crosshair to the given slice.
+   *
+   */
+  void moveTo(TestingBufferedPool &pool, TimeStamp &time, const Nm z)
+  {
+    auto frame = std::make_shared<Frame>();
+    frame->time      = ++time;
+    frame->crosshair = NmVector3{0, 0, z};
+
+    pool.updatePipelines(frame);
+  }
+
+  /** \brief Returns true if the reach of the pool is the expected one.
+   *
+   */
+  bool checkReach(const TestingBufferedPool &pool, const int ahead, const int behind, const char *when)
+  {
+    auto valid = (pool.reachAhead() == ahead) && (pool.reachBehind() == behind);
+
+    if(!valid)
+    {
+      cerr << "Unexpected reach " << when << ": " << pool.reachAhead() << " ahead and " << pool.reachBehind()
+           << " behind, expected " << ahead << " and " << behind << endl;
+    }
+
+    return valid;
+  }
+}
+
+int representations_buffered_pool_reach(int argc, char** argv)
+{
+  bool error = false;
+
+  ViewState             viewState;
+  ManualPipelineSources sources{viewState};
+  ModelFactory          factory{make_shared<CoreFactory>()};
+
+  auto filter = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+  auto segmentation = factory.createSegmentation(filter, 0);
+
+  sources.addSource({ segmentation.get() }, Frame::InvalidFrame());
+
+  auto pipeline  = make_shared<SliceTestingPipeline>();
+  auto scheduler = make_shared<Scheduler>(1000, Scheduler::ExecutionMode::THREAD_POOL);
+
+  TestingBufferedPool pool{pipeline, scheduler, nullptr, WINDOW_SIZE};
+  pool.setPipelineSources(&sources);
+
+  TimeStamp time = 0;
+
+  // idle, one slice at each side of the crosshair.
+  moveTo(pool, time, 0);
+  error |= !waitForTasks(scheduler);
+
+  if(pool.lastUpdateTimeStamp() != time)
+  {
+    cerr << "Current slice actors not ready" << endl;
+    error = true;
+  }
+
+  error |= !checkReach(pool, 1, 1, "when idle");
+
+  // the next slice was computed ahead.
+  moveTo(pool, time, 1);
+
+  if(pool.hits() != 1 || pool.misses() != 0)
+  {
+    cerr << "Unexpected buffer statistics: " << pool.hits() << " hits and " << pool.misses() << " misses" << endl;
+    error = true;
+  }
+
+  error |= !checkReach(pool, 2, 1, "after a slow scroll");
+  error |= !waitForTasks(scheduler);
+
+  // fast scrolls reach the whole window in the scroll direction.
+  for(int z = 2; z < 10; ++z) moveTo(pool, time, z);
+
+  error |= !checkReach(pool, WINDOW_SIZE, 1, "after a fast forward scroll");
+
+  if(pool.hits() + pool.misses() == 0)
+  {
+    cerr << "Buffer statistics not updated" << endl;
+    error = true;
+  }
+
+  error |= !waitForTasks(scheduler);
+
+  for(int z = 8; z > 0; --z) moveTo(pool, time, z);
+
+  error |= !checkReach(pool, 1, WINDOW_SIZE, "after a fast backward scroll");
+  error |= !waitForTasks(scheduler);
+
+  if(pipeline->aliveActors() < 3)
+  {
+    cerr << "Unexpected number of buffered slices: " << pipeline->aliveActors() << endl;
+    error = true;
+  }
+
+  // the memory budget limits the reach, trailing slices first.
+  pool.setMemoryBudget(2 * SliceTestingPipeline::sliceSize());
+
+  moveTo(pool, time, 0);
+
+  error |= !checkReach(pool, 0, 1, "with a budget of two slices");
+  error |= !waitForTasks(scheduler);
+
+  // slices out of reach release their actors.
+  pool.setMemoryBudget(1);
+
+  moveTo(pool, time, 100);
+
+  error |= !checkReach(pool, 0, 0, "with a budget smaller than a slice");
+  error |= !waitForTasks(scheduler);
+
+  if(pipeline->aliveActors() > 2)
+  {
+    cerr << "Slices out of reach not released: " << pipeline->aliveActors() << " actors alive" << endl;
+    error = true;
+  }
+
+  scheduler->abort();
+
+  return error;
+}
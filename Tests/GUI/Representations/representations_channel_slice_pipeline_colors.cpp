@@ -0,0 +1,313 @@
+/*
+ File: representations_channel_slice_pipeline_colors.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ESPINA
+#include <Core/Analysis/Data/VolumetricDataUtils.hxx>
+#include <Core/Analysis/Data/Volumetric/SparseVolume.hxx>
+#include <GUI/ModelFactory.h>
+#include <GUI/Model/ChannelAdapter.h>
+#include <GUI/Representations/Pipelines/ChannelSlicePipeline.h>
+#include <GUI/Representations/Settings/PipelineStateUtils.h>
+#include <GUI/Utils/RepresentationUtils.h>
+#include <testing_support_dummy_filter.h>
+
+// VTK
+#include <vtkImageActor.h>
+#include <vtkImageData.h>
+#include <vtkImageMapper3D.h>
+#include <vtkImageMapToColors.h>
+#include <vtkImageShiftScale.h>
+#include <vtkLookupTable.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+// C++
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::Representations;
+using namespace ESPINA::Testing;
+
+namespace
+{
+  const long int WIDTH  = 24;
+  const long int HEIGHT = 17;
+  const long int DEPTH  = 6;
+
+  /** \brief Intensity of the voxels of the synthetic stack, covering the whole range of values.
+   *
+   */
+  unsigned char voxelValue(const long int x, const long int y, const long int z)
+  {
+    return (x * 13 + y * 7 + z * 31) % 256;
+  }
+
+  /** \brief Returns the representation state of the channel slice with the given settings.
+   * \param[in] slice slice number.
+   * \param[in] brightnessValue brightness in [-1,1].
+   * \param[in] contrastValue contrast in [0,2].
+   * \param[in] stainColor stain color.
+   *
+   */
+  RepresentationState sliceState(const long int slice, const double brightnessValue, const double contrastValue, const QColor &stainColor)
+  {
+    RepresentationState state;
+
+    state.setValue<double>(VISIBLE,    true);
+    state.setValue<double>(OPACITY,    1.0);
+    state.setValue<double>(BRIGHTNESS, brightnessValue);
+    state.setValue<double>(CONTRAST,   contrastValue);
+    state.setValue<QColor>(STAIN,      stainColor);
+
+    setCrosshairPoint(NmVector3{WIDTH/2.0, HEIGHT/2.0, static_cast<Nm>(slice)}, state);
+    GUI::RepresentationUtils::setDisplayResolution(state, 1);
+
+    return state;
+  }
+
+  /** \brief Returns the colors of the intensities of the slice computed with the shift-scale and the
+   * map-to-colors filters, as the pipeline computed them before fusing both in a single table.
+   * \param[in] slice slice image with the intensities array.
+   * \param[in] state representation state.
+   *
+   */
+  vtkSmartPointer<vtkUnsignedCharArray> referenceColors(vtkImageData *slice, const RepresentationState &state)
+  {
+    auto image = vtkSmartPointer<vtkImageData>::New();
+    image->CopyStructure(slice);
+    image->GetPointData()->SetScalars(slice->GetPointData()->GetArray("Intensities"));
+
+    auto shiftScaleFilter = vtkSmartPointer<vtkImageShiftScale>::New();
+    shiftScaleFilter->SetInputData(image);
+    shiftScaleFilter->SetNumberOfThreads(1);
+    shiftScaleFilter->SetShift(static_cast<int>(brightness(state)*255));
+    shiftScaleFilter->SetScale(contrast(state));
+    shiftScaleFilter->SetClampOverflow(true);
+    shiftScaleFilter->SetOutputScalarType(image->GetScalarType());
+
+    auto color = stain(state);
+    auto lut = vtkSmartPointer<vtkLookupTable>::New();
+    lut->Allocate();
+    lut->SetTableRange(0,255);
+    lut->SetValueRange(0.0, 1.0);
+    lut->SetAlphaRange(1.0,1.0);
+    lut->SetNumberOfColors(256);
+    lut->SetRampToLinear();
+    lut->SetHueRange(color.hueF(), color.hueF());
+    lut->SetSaturationRange(0.0, color.saturationF());
+    lut->Build();
+
+    auto mapToColors = vtkSmartPointer<vtkImageMapToColors>::New();
+    mapToColors->SetInputConnection(shiftScaleFilter->GetOutputPort());
+    mapToColors->SetLookupTable(lut);
+    mapToColors->SetNumberOfThreads(1);
+    mapToColors->UpdateWholeExtent();
+
+    return vtkUnsignedCharArray::SafeDownCast(mapToColors->GetOutput()->GetPointData()->GetScalars());
+  }
+
+  /** \brief Returns the image of the actor of the slice or nullptr if there isn't a single image actor.
+   *
+   */
+  vtkImageData *actorImage(const RepresentationPipeline::ActorList &actors)
+  {
+    if(actors.size() != 1) return nullptr;
+
+    auto actor = vtkImageActor::SafeDownCast(actors.first().Get());
+
+    return actor ? actor->GetMapper()->GetInput() : nullptr;
+  }
+
+  /** \brief Returns true if the actors represent the given slice with the colors of the state.
+   * \param[in] actors pipeline actors.
+   * \param[in] slice slice number.
+   * \param[in] state representation state.
+   * \param[in] context description of the checked step.
+   *
+   */
+  bool checkSlice(const RepresentationPipeline::ActorList &actors, const long int slice, const RepresentationState &state, const QString &context)
+  {
+    auto image = actorImage(actors);
+
+    if(!image)
+    {
+      cerr << context.toStdString() << ": unexpected actors" << endl;
+      return false;
+    }
+
+    auto intensities = vtkUnsignedCharArray::SafeDownCast(image->GetPointData()->GetArray("Intensities"));
+    auto colors      = vtkUnsignedCharArray::SafeDownCast(image->GetPointData()->GetScalars());
+
+    if(!intensities || !colors || colors->GetNumberOfComponents() != 3 ||
+       intensities->GetNumberOfTuples() != WIDTH * HEIGHT || colors->GetNumberOfTuples() != WIDTH * HEIGHT)
+    {
+      cerr << context.toStdString() << ": unexpected arrays of the slice image" << endl;
+      return false;
+    }
+
+    auto reference = referenceColors(image, state);
+
+    for(vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+      double point[3];
+      image->GetPoint(i, point);
+
+      const auto expected = voxelValue(std::lround(point[0]), std::lround(point[1]), std::lround(point[2]));
+
+      if(std::lround(point[2]) != slice || intensities->GetValue(i) != expected)
+      {
+        cerr << context.toStdString() << ": intensity " << static_cast<int>(intensities->GetValue(i)) << " at " << point[0] << ","
+             << point[1] << "," << point[2] << ", expected " << static_cast<int>(expected) << " of slice " << slice << endl;
+        return false;
+      }
+
+      for(int c = 0; c < 3; ++c)
+      {
+        if(colors->GetComponent(i, c) != reference->GetComponent(i, c))
+        {
+          cerr << context.toStdString() << ": color component " << c << " of intensity " << static_cast<int>(expected) << " is "
+               << colors->GetComponent(i, c) << ", expected " << reference->GetComponent(i, c) << endl;
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
+
+int representations_channel_slice_pipeline_colors(int argc, char** argv)
+{
+  bool error = false;
+
+  auto image = create_itkImage<itkVolumeType>(Bounds{-0.5, WIDTH - 0.5, -0.5, HEIGHT - 0.5, -0.5, DEPTH - 0.5});
+
+  for(long int z = 0; z < DEPTH; ++z)
+  {
+    for(long int y = 0; y < HEIGHT; ++y)
+    {
+      for(long int x = 0; x < WIDTH; ++x)
+      {
+        image->SetPixel(itkVolumeType::IndexType{x, y, z}, voxelValue(x, y, z));
+      }
+    }
+  }
+
+  ModelFactory factory{make_shared<CoreFactory>()};
+
+  auto filter = factory.createFilter<DummyFilter>(InputSList(), "DummyFilter");
+  filter->output(0)->setData(std::make_shared<SparseVolume<itkVolumeType>>(image, equivalentBounds<itkVolumeType>(image)));
+
+  auto channel = factory.createChannel(filter, 0);
+  auto item    = channel.get();
+
+  ChannelSlicePipeline pipeline{Plane::XY};
+
+  // more combinations of brightness, contrast and stain than cached color tables.
+  const QColor stains[4]{QColor::fromHsvF(0, 0, 1.0), QColor::fromHsvF(0.0, 1.0, 1.0), QColor::fromHsvF(0.33, 0.5, 1.0), QColor::fromHsvF(0.75, 0.8, 1.0)};
+
+  long int slice = 0;
+  for(auto brightnessValue: {-0.6, -0.2, 0.0, 0.3, 0.7})
+  {
+    for(auto contrastValue: {0.5, 1.0, 1.4, 2.0})
+    {
+      for(auto &stainColor: stains)
+      {
+        auto state  = sliceState(slice, brightnessValue, contrastValue, stainColor);
+        auto actors = pipeline.createActors(item, state);
+
+        auto context = QString("Brightness %1, contrast %2 and stain %3").arg(brightnessValue).arg(contrastValue).arg(stainColor.name());
+
+        error |= !checkSlice(actors, slice, state, context);
+
+        slice = (slice + 1) % DEPTH;
+      }
+    }
+  }
+
+  if(error) return error;
+
+  // the actors in use by the views are never modified, new ones replace them.
+  auto shownState  = sliceState(1, 0.1, 1.2, stains[2]);
+  auto shownActors = pipeline.createActors(item, shownState);
+
+  auto shownImage = actorImage(shownActors);
+
+  auto state  = sliceState(4, -0.3, 1.7, stains[3]);
+  auto actors = pipeline.createActors(item, state);
+
+  error |= !checkSlice(actors, 4, state, "Next slice");
+
+  // the colors change in a new actor.
+  auto previousActor = actors.first().Get();
+
+  state = sliceState(4, 0.5, 0.8, stains[1]);
+  pipeline.updateColors(actors, item, state);
+
+  if(actors.size() == 1 && actors.first().Get() == previousActor)
+  {
+    cerr << "The colors of the shown actor have been modified" << endl;
+    error = true;
+  }
+
+  error |= !checkSlice(actors, 4, state, "Updated colors");
+
+  // actors that already have the colors of the state aren't replaced.
+  previousActor = actors.first().Get();
+  pipeline.updateColors(actors, item, state);
+
+  if(actors.size() != 1 || actors.first().Get() != previousActor)
+  {
+    cerr << "Actor with the colors of the state has been replaced" << endl;
+    error = true;
+  }
+
+  auto previousActors = shownActors;
+  pipeline.updateColors(shownActors, item, state);
+
+  if(actorImage(shownActors) == shownImage)
+  {
+    cerr << "The colors of the shown image have been modified" << endl;
+    error = true;
+  }
+
+  error |= !checkSlice(previousActors, 1, shownState, "Shown slice");
+  error |= !checkSlice(shownActors,    1, state,      "Updated colors of the shown slice");
+
+  // hidden or out of bounds slices have no actors.
+  auto hidden = sliceState(2, 0, 1, stains[0]);
+  hidden.setValue<double>(VISIBLE, false);
+
+  if(!pipeline.createActors(item, hidden).isEmpty())
+  {
+    cerr << "Hidden channel has actors" << endl;
+    error = true;
+  }
+
+  if(!pipeline.createActors(item, sliceState(DEPTH + 1, 0, 1, stains[0])).isEmpty())
+  {
+    cerr << "Slice out of bounds has actors" << endl;
+    error = true;
+  }
+
+  return error;
+}
@@ -0,0 +1,170 @@
+/*
+ File: representations_testing_support.h
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTING_REPRESENTATIONS_SUPPORT_H
+#define TESTING_REPRESENTATIONS_SUPPORT_H
+
+// ESPINA
+#include <GUI/Representations/Frame.h>
+#include <GUI/Representations/Pools/BufferedRepresentationPool.h>
+#include <GUI/Representations/RepresentationPipeline.h>
+
+// VTK
+#include <vtkImageActor.h>
+#include <vtkImageData.h>
+#include <vtkWeakPointer.h>
+
+// Qt
+#include <QMutex>
+
+namespace ESPINA
+{
+  namespace Testing
+  {
+    /** \class CompositedTestingPipeline
+     * \brief Composited pipeline without actors whose picks are the items in the picked list.
+     *
+     */
+    class CompositedTestingPipeline
+    : public RepresentationPipeline
+    {
+      public:
+        explicit CompositedTestingPipeline()
+        : RepresentationPipeline{"CompositedTestingPipeline"}
+        {}
+
+        virtual RepresentationState representationState(ConstViewItemAdapterPtr item, const RepresentationState &settings) override
+        { return settings; }
+
+        virtual bool pick(ConstViewItemAdapterPtr item, const NmVector3 &point) const override
+        { return picked.contains(item); }
+
+        virtual RepresentationPipeline::ActorList createActors(ConstViewItemAdapterPtr item, const RepresentationState &state) override
+        { return RepresentationPipeline::ActorList(); }
+
+        virtual void updateColors(RepresentationPipeline::ActorList &actors, ConstViewItemAdapterPtr item, const RepresentationState &state) override
+        {}
+
+        virtual bool isComposited() const override
+        { return true; }
+
+        QList<ConstViewItemAdapterPtr> picked; /** items containing any point. */
+    };
+
+    /** \class SliceTestingPipeline
+     * \brief Pipeline that represents each item with an image actor of a fixed size and keeps track
+     * of the actors it has created.
+     *
+     */
+    class SliceTestingPipeline
+    : public RepresentationPipeline
+    {
+      public:
+        static const int SIZE = 64; /** size of the slice images. */
+
+        explicit SliceTestingPipeline()
+        : RepresentationPipeline{"SliceTestingPipeline"}
+        {}
+
+        virtual RepresentationState representationState(ConstViewItemAdapterPtr item, const RepresentationState &settings) override
+        { return settings; }
+
+        virtual bool pick(ConstViewItemAdapterPtr item, const NmVector3 &point) const override
+        { return false; }
+
+        virtual RepresentationPipeline::ActorList createActors(ConstViewItemAdapterPtr item, const RepresentationState &state) override
+        {
+          auto actor = vtkSmartPointer<vtkImageActor>::New();
+          actor->SetInputData(createSlice());
+
+          QMutexLocker lock(&m_lock);
+          m_actors << vtkWeakPointer<vtkProp>(actor.GetPointer());
+
+          return RepresentationPipeline::ActorList{actor};
+        }
+
+        virtual void updateColors(RepresentationPipeline::ActorList &actors, ConstViewItemAdapterPtr item, const RepresentationState &state) override
+        {}
+
+        /** \brief Returns the number of created actors that haven't been destroyed.
+         *
+         */
+        int aliveActors()
+        {
+          QMutexLocker lock(&m_lock);
+
+          int alive = 0;
+          for(auto actor: m_actors)
+          {
+            if(actor) ++alive;
+          }
+
+          return alive;
+        }
+
+        /** \brief Returns the size in bytes of a slice image.
+         *
+         */
+        static unsigned long long sliceSize()
+        { return createSlice()->GetActualMemorySize() * 1024ULL; }
+
+      private:
+        /** \brief Returns a slice image.
+         *
+         */
+        static vtkSmartPointer<vtkImageData> createSlice()
+        {
+          auto image = vtkSmartPointer<vtkImageData>::New();
+          image->SetDimensions(SIZE, SIZE, 1);
+          image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+          return image;
+        }
+
+        QMutex                         m_lock;   /** protects the list of actors. */
+        QList<vtkWeakPointer<vtkProp>> m_actors; /** created actors.              */
+    };
+
+    /** \class TestingBufferedPool
+     * \brief Buffered XY segmentation pool whose actors can be set directly.
+     *
+     */
+    class TestingBufferedPool
+    : public BufferedRepresentationPool
+    {
+      public:
+        explicit TestingBufferedPool(RepresentationPipelineSPtr pipeline,
+                                     SchedulerSPtr              scheduler,
+                                     SegmentationLocatorSPtr    locator = nullptr,
+                                     unsigned                   windowSize = 2)
+        : BufferedRepresentationPool{ItemAdapter::Type::SEGMENTATION, Plane::XY, pipeline, scheduler, windowSize, locator}
+        {}
+
+        /** \brief Stores the actors as the ones of the given frame.
+         * \param[in] frame frame object.
+         * \param[in] actors actors of the frame.
+         *
+         */
+        void setActors(const GUI::Representations::FrameCSPtr frame, RepresentationPipeline::Actors actors)
+        { onActorsReady(frame, actors); }
+    };
+  }
+}
+
+#endif // TESTING_REPRESENTATIONS_SUPPORT_H
@@ -0,0 +1,144 @@
+/*
+ File: io_seg_file_codec_format_info.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Analysis/Analysis.h>
+#include <Core/Analysis/Channel.h>
+#include <Core/Analysis/Sample.h>
+#include <Core/Analysis/Segmentation.h>
+#include <Core/IO/SegFile.h>
+#include <Core/IO/SegFile_V5.h>
+#include <Core/IO/VolumeCodec.h>
+#include <Core/IO/ZipUtils.h>
+#include <Core/Factory/CoreFactory.h>
+#include "io_testing_support.h"
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::IO;
+using namespace ESPINA::IO::SegFile;
+using namespace ESPINA::IO_Testing;
+
+namespace
+{
+  /** \brief Returns the contents of the given entry of the zip file or an empty string if it doesn't exist.
+   *
+   */
+  QString zipEntry(const QFileInfo &file, const QString &name)
+  {
+    QuaZip zip(file.absoluteFilePath());
+    if (!zip.open(QuaZip::mdUnzip) || !zip.setCurrentFile(name)) return QString();
+
+    return ZipUtils::readCurrentFileFromZip(zip);
+  }
+}
+
+int io_seg_file_codec_format_info(int argc, char** argv)
+{
+  bool error = false;
+
+  auto factory = make_shared<CoreFactory>();
+
+  Analysis analysis;
+
+  auto classification = make_shared<Classification>("Test");
+  analysis.setClassification(classification);
+
+  auto sample = make_shared<Sample>("C3P0");
+  analysis.add(sample);
+
+  auto filter  = make_shared<DummyFilter>();
+  auto channel = make_shared<Channel>(getInput(filter, 0));
+  channel->setName("channel");
+
+  analysis.add(channel);
+
+  analysis.addRelation(sample, channel, "Stain");
+
+  auto segmentation = std::make_shared<Segmentation>(getInput(std::make_shared<DummyFilter>(), 0));
+  segmentation->setNumber(1);
+
+  analysis.add(segmentation);
+
+  QFileInfo file("analysis_codec.seg");
+
+  for (auto codec: {VolumeCodec::Type::DEFLATE, VolumeCodec::Type::ZSTD})
+  {
+    if (!VolumeCodec::isAvailable(codec)) continue;
+
+    const auto name    = VolumeCodec::name(codec).toStdString();
+    const bool encoded = (codec != VolumeCodec::Type::DEFLATE);
+
+    try
+    {
+      SegFile::setVolumeCodec(codec);
+      SegFile::save(&analysis, file);
+    }
+    catch (...)
+    {
+      cerr << "Couldn't save seg file with codec " << name << endl;
+      error = true;
+      continue;
+    }
+
+    // previous versions only look for the default format info file and refuse to open encoded files.
+    auto info        = zipEntry(file, SegFile_V5::FORMAT_INFO_FILE);
+    auto codecInfo   = zipEntry(file, SegFile_V5::CODEC_FORMAT_INFO_FILE);
+    auto currentInfo = encoded ? codecInfo : info;
+
+    if (info.isEmpty() == !encoded || codecInfo.isEmpty() == encoded)
+    {
+      cerr << "Unexpected format info files with codec " << name << endl;
+      error = true;
+    }
+
+    if (!currentInfo.contains(encoded ? "SegFile Version=7" : "SegFile Version=6"))
+    {
+      cerr << "Unexpected format version with codec " << name << ": " << currentInfo.toStdString() << endl;
+      error = true;
+    }
+
+    if (currentInfo.contains(VolumeCodec::FORMAT_INFO_KEY) != encoded)
+    {
+      cerr << "Unexpected codec in format info with codec " << name << ": " << currentInfo.toStdString() << endl;
+      error = true;
+    }
+
+    try
+    {
+      auto loaded = SegFile::load(file, factory);
+
+      if (analysis != *(loaded.get()))
+      {
+        cerr << "Loaded analysis don't match saved analysis with codec " << name << endl;
+        error = true;
+      }
+    }
+    catch (...)
+    {
+      cerr << "Couldn't load seg file with codec " << name << endl;
+      error = true;
+    }
+  }
+
+  SegFile::setVolumeCodec(VolumeCodec::Type::DEFLATE);
+
+  file.absoluteDir().remove(file.fileName());
+
+  return error;
+}
@@ -0,0 +1,186 @@
+/*
+ File: io_volume_codec_benchmark.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/IO/VolumeCodec.h>
+#include <Core/IO/ZipUtils.h>
+#include <Core/Utils/EspinaException.h>
+
+// Qt
+#include <QBuffer>
+
+// C++
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::IO;
+
+namespace
+{
+  const int WIDTH  = 512;
+  const int HEIGHT = 512;
+  const int DEPTH  = 64;
+
+  struct Result
+  {
+    qint64 size;   /** size of the zip container.            */
+    double encode; /** throughput of the save (MB/s).        */
+    double decode; /** throughput of the load (MB/s).        */
+    bool   valid;  /** true if the data survived the trip.   */
+  };
+
+  /** \brief Returns a segmentation-like volume of random boxes.
+   *
+   */
+  QByteArray createVolume()
+  {
+    QByteArray volume(WIDTH * HEIGHT * DEPTH, 0);
+
+    std::mt19937 generator(25);
+    std::uniform_int_distribution<int> size(5, 40);
+
+    for(int i = 0; i < 200; ++i)
+    {
+      const int extent[3]{size(generator), size(generator), std::min(size(generator), DEPTH)};
+      const int start[3] {std::uniform_int_distribution<int>(0, WIDTH  - extent[0])(generator),
+                          std::uniform_int_distribution<int>(0, HEIGHT - extent[1])(generator),
+                          std::uniform_int_distribution<int>(0, DEPTH  - extent[2])(generator)};
+
+      for(int z = start[2]; z < start[2] + extent[2]; ++z)
+      {
+        for(int y = start[1]; y < start[1] + extent[1]; ++y)
+        {
+          auto row = volume.data() + (z * HEIGHT + y) * WIDTH;
+          std::fill(row + start[0], row + start[0] + extent[0], static_cast<char>(255));
+        }
+      }
+    }
+
+    return volume;
+  }
+
+  /** \brief Returns the MB/s of processing the given data since start.
+   *
+   */
+  double throughput(const QByteArray &data, const std::chrono::steady_clock::time_point &start)
+  {
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return data.size()/(1024.*1024.)/std::max(elapsed, 1e-9);
+  }
+
+  /** \brief Stores the volume as a SEG file entry in a memory zip and reads it back.
+   *
+   */
+  Result roundTrip(const QByteArray &volume, const VolumeCodec::Type codec)
+  {
+    const QString fileName = "Filters/volume.raw";
+    const bool    compress = (codec == VolumeCodec::Type::DEFLATE);
+
+    Result result{0, 0, 0, false};
+
+    QBuffer buffer;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      QuaZip zip(&buffer);
+      zip.open(QuaZip::mdCreate);
+      ZipUtils::AddFileToZip(fileName, VolumeCodec::encode(volume, codec), zip, compress);
+      zip.close();
+    }
+    result.encode = throughput(volume, start);
+    result.size   = buffer.size();
+
+    start = std::chrono::steady_clock::now();
+    QByteArray data;
+    {
+      QuaZip zip(&buffer);
+      zip.open(QuaZip::mdUnzip);
+      data = VolumeCodec::decode(ZipUtils::readFileFromZip(fileName, zip), codec);
+    }
+    result.decode = throughput(volume, start);
+    result.valid  = (data == volume);
+
+    return result;
+  }
+}
+
+int io_volume_codec_benchmark(int argc, char** argv)
+{
+  bool error = false;
+
+  const auto volume = createVolume();
+
+  for(auto codec: {VolumeCodec::Type::DEFLATE, VolumeCodec::Type::ZSTD})
+  {
+    const auto name = VolumeCodec::name(codec);
+
+    if(VolumeCodec::type(name) != codec)
+    {
+      cerr << "Unexpected codec for name " << name.toStdString() << endl;
+      error = true;
+    }
+
+    if(!VolumeCodec::isAvailable(codec))
+    {
+      try
+      {
+        VolumeCodec::encode(volume, codec);
+
+        cerr << "Codec " << name.toStdString() << " isn't available but can encode" << endl;
+        error = true;
+      }
+      catch(const Core::Utils::EspinaException &e)
+      {
+        cout << "Codec " << name.toStdString() << " not available in this build" << endl;
+      }
+
+      continue;
+    }
+
+    try
+    {
+      auto result = roundTrip(volume, codec);
+
+      cout << "Codec " << name.toStdString() << ": " << result.size << " bytes (" << 100.*result.size/volume.size()
+           << "%), save " << result.encode << " MB/s, load " << result.decode << " MB/s" << endl;
+
+      if(!result.valid)
+      {
+        cerr << "Codec " << name.toStdString() << " round trip modified the volume" << endl;
+        error = true;
+      }
+    }
+    catch(const Core::Utils::EspinaException &e)
+    {
+      cerr << "Codec " << name.toStdString() << " round trip failed: " << e.what() << endl;
+      error = true;
+    }
+  }
+
+  if(VolumeCodec::isVolumeData("Filters/volume.mhd") || !VolumeCodec::isVolumeData("Filters/volume.raw"))
+  {
+    cerr << "Unexpected volume data entries" << endl;
+    error = true;
+  }
+
+  return error;
+}
@@ -0,0 +1,294 @@
+/*
+ File: pipeline_single_filter_incremental_save.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Analysis/Analysis.h>
+#include <Core/Analysis/Channel.h>
+#include <Core/Analysis/Sample.h>
+#include <Core/Analysis/Segmentation.h>
+#include <Core/Analysis/Data/MeshData.h>
+#include <Core/MultiTasking/Scheduler.h>
+#include <Core/IO/SegFile.h>
+#include <Core/IO/SegFile_V5.h>
+#include <Core/IO/ZipUtils.h>
+#include <Core/IO/DataFactory/RawDataFactory.h>
+#include <Core/Factory/FilterFactory.h>
+#include <Core/Factory/CoreFactory.h>
+#include <testing_support_channel_input.h>
+#include <Filters/SeedGrowSegmentationFilter.h>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::IO;
+
+namespace
+{
+  class TestFilterFactory
+  : public FilterFactory
+  {
+    virtual const FilterTypeList providedFilters() const
+    {
+      FilterTypeList list;
+      list << "SGS";
+      return list;
+    }
+
+    virtual FilterSPtr createFilter(InputSList inputs, const Filter::Type& type, SchedulerSPtr scheduler) const
+    {
+      FilterSPtr filter;
+
+      if (type == "SGS")
+      {
+        filter = std::make_shared<SeedGrowSegmentationFilter>(inputs, type, scheduler);
+        filter->setDataFactory(std::make_shared<RawDataFactory>());
+      }
+
+      return filter;
+    }
+  };
+
+  /** \brief Returns the number of voxels of the volume of the first segmentation of the analysis.
+   *
+   */
+  unsigned long long segmentationVoxels(AnalysisSPtr analysis)
+  {
+    unsigned long long result = 0;
+
+    auto output = analysis->segmentations().first()->output();
+    auto volume = readLockVolume(output);
+
+    if (volume->isValid())
+    {
+      auto image = volume->itkImage();
+      auto size  = image->GetLargestPossibleRegion().GetNumberOfPixels();
+      auto data  = image->GetBufferPointer();
+
+      for (unsigned long long i = 0; i < size; ++i)
+      {
+        if (data[i] == SEG_VOXEL_VALUE) ++result;
+      }
+    }
+
+    return result;
+  }
+
+  /** \brief Returns the number of entries of the zip file, including the repeated ones.
+   *
+   */
+  int zipEntries(const QFileInfo &file)
+  {
+    QuaZip zip(file.absoluteFilePath());
+    if (!zip.open(QuaZip::mdUnzip)) return -1;
+
+    return zip.getEntriesCount();
+  }
+
+  /** \brief Returns the CRC of the entries of the zip file indexed by name.
+   *
+   */
+  QMap<QString, quint32> zipCRCs(const QFileInfo &file)
+  {
+    QMap<QString, quint32> crcs;
+
+    QuaZip zip(file.absoluteFilePath());
+    if (zip.open(QuaZip::mdUnzip))
+    {
+      for (auto entry : ZipUtils::indexZip(zip))
+      {
+        crcs.insert(entry.name, entry.crc);
+      }
+    }
+
+    return crcs;
+  }
+}
+
+int pipeline_single_filter_incremental_save( int argc, char** argv )
+{
+  bool error = false;
+
+  auto factory = std::make_shared<CoreFactory>();
+  factory->registerFilterFactory(std::make_shared<TestFilterFactory>());
+
+  Analysis analysis;
+
+  auto classification = std::make_shared<Classification>("Test");
+  classification->createNode("Synapse");
+  analysis.setClassification(classification);
+
+  auto sample = std::make_shared<Sample>("C3P0");
+  analysis.add(sample);
+
+  auto channel = std::make_shared<Channel>(Testing::channelInput());
+  channel->setName("channel");
+
+  analysis.add(channel);
+
+  analysis.addRelation(sample, channel, "Stain");
+
+  InputSList inputs;
+  inputs << channel->asInput();
+
+  auto segFilter = std::make_shared<SeedGrowSegmentationFilter>(inputs, "SGS", SchedulerSPtr());
+  segFilter->update();
+
+  auto generateMesh = readLockMesh(segFilter->output(0));
+
+  auto segmentation = std::make_shared<Segmentation>(getInput(segFilter, 0));
+  segmentation->setNumber(1);
+
+  analysis.add(segmentation);
+
+  QFileInfo file("analysis_incremental.seg");
+  try
+  {
+    SegFile::save(&analysis, file);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't save seg file" << endl;
+    return true;
+  }
+
+  const auto entries = zipEntries(file);
+  const auto crcs    = zipCRCs(file);
+  const auto files   = file.absoluteDir().entryList(QDir::Files).size();
+
+  // nothing changed, the entries are copied as they are.
+  try
+  {
+    SegFile::save(&analysis, file, nullptr, ErrorHandlerSPtr(), SegFile::SaveMode::INCREMENTAL);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't save seg file incrementally" << endl;
+    error = true;
+  }
+
+  if (zipEntries(file) != entries || zipCRCs(file) != crcs)
+  {
+    cerr << "Unexpected entries in unmodified seg file: " << zipEntries(file) - entries << endl;
+    error = true;
+  }
+
+  {
+    auto volume = writeLockVolume(segFilter->output(0));
+    volume->draw(volume->bounds().bounds(), SEG_VOXEL_VALUE);
+  }
+
+  try
+  {
+    SegFile::save(&analysis, file, nullptr, ErrorHandlerSPtr(), SegFile::SaveMode::INCREMENTAL);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't save modified seg file incrementally" << endl;
+    error = true;
+  }
+
+  if (zipEntries(file) != entries)
+  {
+    cerr << "Modified filter data wasn't replaced in seg file: " << zipEntries(file) - entries << endl;
+    error = true;
+  }
+
+  if (zipCRCs(file) == crcs)
+  {
+    cerr << "Modified filter data wasn't saved to seg file" << endl;
+    error = true;
+  }
+
+  unsigned long long expected = 0;
+  {
+    auto volume = readLockVolume(segFilter->output(0));
+    auto image  = volume->itkImage();
+    auto data   = image->GetBufferPointer();
+
+    for (unsigned long long i = 0; i < image->GetLargestPossibleRegion().GetNumberOfPixels(); ++i)
+    {
+      if (data[i] == SEG_VOXEL_VALUE) ++expected;
+    }
+  }
+
+  try
+  {
+    auto loaded = SegFile::load(file, factory);
+
+    if (segmentationVoxels(loaded) != expected)
+    {
+      cerr << "Unexpected volume after loading incrementally saved seg file" << endl;
+      error = true;
+    }
+  }
+  catch (...)
+  {
+    cerr << "Couldn't load incrementally saved seg file" << endl;
+    error = true;
+  }
+
+  // repeated modifications replace the entries without leaving temporal files behind.
+  for (int i = 0; i < 3; ++i)
+  {
+    {
+      auto volume = writeLockVolume(segFilter->output(0));
+      volume->draw(volume->bounds().bounds(), SEG_VOXEL_VALUE);
+    }
+
+    try
+    {
+      SegFile::save(&analysis, file, nullptr, ErrorHandlerSPtr(), SegFile::SaveMode::INCREMENTAL);
+    }
+    catch (...)
+    {
+      cerr << "Couldn't save modified seg file incrementally" << endl;
+      error = true;
+    }
+
+    if (zipEntries(file) != entries)
+    {
+      cerr << "Unexpected entries in repeatedly saved seg file: " << zipEntries(file) - entries << endl;
+      error = true;
+    }
+
+    if (file.absoluteDir().entryList(QDir::Files).size() != files)
+    {
+      cerr << "Temporal files left next to the seg file" << endl;
+      error = true;
+    }
+  }
+
+  try
+  {
+    auto loaded = SegFile::load(file, factory);
+
+    if (segmentationVoxels(loaded) != expected)
+    {
+      cerr << "Unexpected volume after loading repeatedly saved seg file" << endl;
+      error = true;
+    }
+  }
+  catch (...)
+  {
+    cerr << "Couldn't load repeatedly saved seg file" << endl;
+    error = true;
+  }
+
+  file.absoluteDir().remove(file.fileName());
+
+  return error;
+}
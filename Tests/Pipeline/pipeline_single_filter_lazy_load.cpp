@@ -0,0 +1,215 @@
+/*
+ File: pipeline_single_filter_lazy_load.cpp
+ Created on: 17/10/2026
+ Author: Felix de las Pozas Alvarez
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <Core/Analysis/Analysis.h>
+#include <Core/Analysis/Channel.h>
+#include <Core/Analysis/Sample.h>
+#include <Core/Analysis/Segmentation.h>
+#include <Core/Analysis/Data/MeshData.h>
+#include <Core/MultiTasking/Scheduler.h>
+#include <Core/IO/SegFile.h>
+#include <Core/IO/SegFile_V5.h>
+#include <Core/IO/DataFactory/RawDataFactory.h>
+#include <Core/Factory/FilterFactory.h>
+#include <Core/Factory/CoreFactory.h>
+#include <testing_support_channel_input.h>
+#include <Filters/SeedGrowSegmentationFilter.h>
+
+using namespace std;
+using namespace ESPINA;
+using namespace ESPINA::IO;
+
+namespace
+{
+  class TestFilterFactory
+  : public FilterFactory
+  {
+    virtual const FilterTypeList providedFilters() const
+    {
+      FilterTypeList list;
+      list << "SGS";
+      return list;
+    }
+
+    virtual FilterSPtr createFilter(InputSList inputs, const Filter::Type& type, SchedulerSPtr scheduler) const
+    {
+      FilterSPtr filter;
+
+      if (type == "SGS")
+      {
+        filter = std::make_shared<SeedGrowSegmentationFilter>(inputs, type, scheduler);
+        filter->setDataFactory(std::make_shared<RawDataFactory>());
+      }
+
+      return filter;
+    }
+  };
+
+  /** \brief Returns the number of voxels of the volume of the first segmentation of the analysis.
+   *
+   */
+  unsigned long long segmentationVoxels(AnalysisSPtr analysis)
+  {
+    unsigned long long result = 0;
+
+    auto output = analysis->segmentations().first()->output();
+    auto volume = readLockVolume(output);
+
+    if (volume->isValid())
+    {
+      auto image = volume->itkImage();
+      auto size  = image->GetLargestPossibleRegion().GetNumberOfPixels();
+      auto data  = image->GetBufferPointer();
+
+      for (unsigned long long i = 0; i < size; ++i)
+      {
+        if (data[i] == SEG_VOXEL_VALUE) ++result;
+      }
+    }
+
+    return result;
+  }
+}
+
+int pipeline_single_filter_lazy_load( int argc, char** argv )
+{
+  bool error = false;
+
+  auto factory = std::make_shared<CoreFactory>();
+  factory->registerFilterFactory(std::make_shared<TestFilterFactory>());
+
+  Analysis analysis;
+
+  auto classification = std::make_shared<Classification>("Test");
+  classification->createNode("Synapse");
+  analysis.setClassification(classification);
+
+  auto sample = std::make_shared<Sample>("C3P0");
+  analysis.add(sample);
+
+  auto channel = std::make_shared<Channel>(Testing::channelInput());
+  channel->setName("channel");
+
+  analysis.add(channel);
+
+  analysis.addRelation(sample, channel, "Stain");
+
+  InputSList inputs;
+  inputs << channel->asInput();
+
+  auto segFilter = std::make_shared<SeedGrowSegmentationFilter>(inputs, "SGS", SchedulerSPtr());
+  segFilter->update();
+
+  auto generateMesh = readLockMesh(segFilter->output(0));
+
+  auto segmentation = std::make_shared<Segmentation>(getInput(segFilter, 0));
+  segmentation->setNumber(1);
+
+  analysis.add(segmentation);
+
+  QFileInfo file("analysis_lazy.seg");
+  try
+  {
+    SegFile::save(&analysis, file);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't save seg file" << endl;
+    return true;
+  }
+
+  LoadOptions options;
+  options.insert(SegFile::SegFile_V5::LAZY_LOADING_OPTION, true);
+
+  AnalysisSPtr lazyAnalysis, sequentialAnalysis;
+  try
+  {
+    lazyAnalysis       = SegFile::load(file, factory, nullptr, ErrorHandlerSPtr(), options);
+    sequentialAnalysis = SegFile::load(file, factory);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't load seg file" << endl;
+    file.absoluteDir().remove(file.fileName());
+    return true;
+  }
+
+  if (lazyAnalysis->storage()->deferredSnapshots() == 0)
+  {
+    cerr << "Expected deferred filter data after lazy load" << endl;
+    error = true;
+  }
+
+  if (sequentialAnalysis->storage()->deferredSnapshots() != 0)
+  {
+    cerr << "Unexpected deferred filter data after sequential load" << endl;
+    error = true;
+  }
+
+  auto voxels = segmentationVoxels(sequentialAnalysis);
+
+  if (voxels == 0 || segmentationVoxels(lazyAnalysis) != voxels)
+  {
+    cerr << "Lazy loaded volume differs from sequentially loaded one" << endl;
+    error = true;
+  }
+
+  if (!readLockMesh(lazyAnalysis->segmentations().first()->output())->mesh())
+  {
+    cerr << "Expected Mesh Data Polydata" << endl;
+    error = true;
+  }
+
+  // saving over the file still referenced by the lazy session must extract its remaining data first.
+  try
+  {
+    SegFile::save(lazyAnalysis.get(), file);
+  }
+  catch (...)
+  {
+    cerr << "Couldn't save lazy loaded seg file" << endl;
+    error = true;
+  }
+
+  if (lazyAnalysis->storage()->deferredSnapshots() != 0)
+  {
+    cerr << "Unexpected deferred filter data after saving over the original file" << endl;
+    error = true;
+  }
+
+  try
+  {
+    auto reloaded = SegFile::load(file, factory, nullptr, ErrorHandlerSPtr(), options);
+
+    if (segmentationVoxels(reloaded) != voxels)
+    {
+      cerr << "Unexpected volume after reloading lazy loaded seg file" << endl;
+      error = true;
+    }
+  }
+  catch (...)
+  {
+    cerr << "Couldn't reload seg file" << endl;
+    error = true;
+  }
+
+  file.absoluteDir().remove(file.fileName());
+
+  return error;
+}